@@ -0,0 +1,122 @@
+#include <random>
+#include <vector>
+
+#include "../include/egg/aggregate.hpp"
+#include "benchmark.hpp"
+
+// Naive loop: type switch and as_* call per element
+static long double
+naive(
+  const std::vector<egg::variable>& values,
+  std::size_t& count)
+{
+  using egg::variable;
+
+  long double sum = 0;
+  count = 0;
+
+  for (const auto& v : values)
+  {
+    switch (v.type())
+    {
+      case variable::content::is_int8:        sum += v.as_int8();        break;
+      case variable::content::is_uint8:       sum += v.as_uint8();       break;
+      case variable::content::is_int16:       sum += v.as_int16();       break;
+      case variable::content::is_uint16:      sum += v.as_uint16();      break;
+      case variable::content::is_int32:       sum += v.as_int32();       break;
+      case variable::content::is_uint32:      sum += v.as_uint32();      break;
+      case variable::content::is_int64:       sum += v.as_int64();       break;
+      case variable::content::is_uint64:      sum += v.as_uint64();      break;
+      case variable::content::is_float:       sum += v.as_float();       break;
+      case variable::content::is_double:      sum += v.as_double();      break;
+      case variable::content::is_long_double: sum += v.as_long_double(); break;
+      default: continue;
+    }
+
+    ++count;
+  }
+
+  return sum;
+}
+
+static void
+run(
+  const std::string&                title,
+  const std::vector<egg::variable>& values)
+{
+  bench::header(title);
+
+  const std::size_t n = values.size();
+  const egg::variable_vector columns(values);
+
+  bench::measure("naive type switch + as_*", n, [&] {
+    std::size_t count = 0;
+    bench::keep(naive(values, count));
+  });
+
+  bench::measure("aggregate(std::vector<variable>)", n, [&] {
+    bench::keep(egg::aggregate(values));
+  });
+
+  bench::measure("aggregate(variable_vector)", n, [&] {
+    bench::keep(egg::aggregate(columns));
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  using egg::variable;
+
+  const std::size_t n = 1 << 20;
+  std::mt19937_64 random(42);
+
+  // Homogeneous int64
+  {
+    std::vector<variable> values;
+    values.reserve(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+      values.push_back(static_cast<std::int64_t>(random() >> 8));
+
+    run("Aggregate of 1M int64", values);
+  }
+
+  // Homogeneous double (boxed in variable)
+  {
+    std::vector<variable> values;
+    values.reserve(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+      values.push_back(static_cast<double>(random() % 100000) / 7);
+
+    run("Aggregate of 1M double", values);
+  }
+
+  // Runs of 64 values of mixed types
+  {
+    std::vector<variable> values;
+    values.reserve(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      switch ((i / 64) % 4)
+      {
+        case 0: values.push_back(static_cast<std::int8_t>(random()));   break;
+        case 1: values.push_back(static_cast<std::uint32_t>(random())); break;
+        case 2: values.push_back(static_cast<float>(random() % 1000));  break;
+        case 3: values.push_back(static_cast<std::int64_t>(random() >> 4)); break;
+      }
+    }
+
+    run("Aggregate of 1M values in runs of 64", values);
+  }
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,95 @@
+#include <random>
+#include <vector>
+#include <unordered_set>
+
+#include "../include/egg/bulk.hpp"
+#include "benchmark.hpp"
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  using egg::variable;
+
+  const std::size_t n = 1 << 20;
+  std::mt19937_64 random(42);
+  std::vector<variable> lhs, rhs;
+
+  lhs.reserve(n);
+  rhs.reserve(n);
+
+  // Half integers, half strings, 1/8 of pairs differ
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const std::uint64_t x = random() % (n / 4);
+
+    if (i % 2)
+    {
+      lhs.push_back(static_cast<std::int64_t>(x));
+      rhs.push_back(static_cast<std::int64_t>(i % 8 ? x : x + 1));
+    }
+    else
+    {
+      lhs.push_back("host-" + std::to_string(x) + ".example.com");
+      rhs.push_back("host-" + std::to_string(i % 8 ? x : x + 1) + ".example.com");
+    }
+  }
+
+  bench::header("Bulk compare and hash of 1M variables");
+
+  std::vector<char> out(n);
+  std::vector<std::uint64_t> hashes(n);
+
+  bench::measure("per-element operator==", n, [&] {
+    std::size_t equal = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      equal += (out[i] = (lhs[i] == rhs[i]));
+    bench::keep(equal);
+  });
+
+  bench::measure("equal_all()", n, [&] {
+    bench::keep(egg::equal_all(lhs.data(), rhs.data(), n,
+                               reinterpret_cast<bool *>(out.data())));
+  });
+
+  bench::measure("per-element std::hash<variable>", n, [&] {
+    std::hash<variable> hasher;
+    for (std::size_t i = 0; i < n; ++i)
+      hashes[i] = hasher(lhs[i]);
+    bench::keep(hashes);
+  });
+
+  bench::measure("hash_all()", n, [&] {
+    egg::hash_all(lhs, hashes.data());
+    bench::keep(hashes);
+  });
+
+  bench::footer();
+
+  bench::header("Dedup of 1M variables (~50% distinct)");
+
+  bench::measure("std::unordered_set<variable>", n, [&] {
+    std::unordered_set<variable> seen;
+    std::vector<variable> result;
+    for (const auto& v : lhs)
+      if (seen.insert(v).second)
+        result.push_back(v);
+    bench::keep(result);
+  }, 3);
+
+  bench::measure("egg::dedup()", n, [&] {
+    std::vector<variable> copy(lhs);
+    bench::keep(egg::dedup(copy));
+  }, 3);
+
+  bench::measure("egg::distinct()", n, [&] {
+    bench::keep(egg::distinct(lhs.data(), n));
+  }, 3);
+
+  bench::footer();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,90 @@
+#include <map>
+#include <random>
+#include <vector>
+#include <unordered_map>
+
+#include "../include/egg/variable_hash_map.hpp"
+#include "benchmark.hpp"
+
+template <typename M>
+static void
+run(
+  const std::string&                name,
+  const std::vector<egg::variable>& keys,
+  const std::vector<egg::variable>& probes,
+  const int                         rounds)
+{
+  const std::size_t n = keys.size() * rounds;
+
+  bench::measure(name + " insert", n, [&] {
+    for (int r = 0; r < rounds; ++r)
+    {
+      M m;
+      for (std::size_t i = 0; i < keys.size(); ++i)
+        m[keys[i]] = static_cast<std::int64_t>(i);
+      bench::keep(m);
+    }
+  }, 3);
+
+  M m;
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    m[keys[i]] = static_cast<std::int64_t>(i);
+
+  bench::measure(name + " lookup", probes.size() * rounds, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& k : probes)
+      {
+        auto i = m.find(k);
+        if (i != m.end())
+          sum += i->second.as_int64();
+      }
+    bench::keep(sum);
+  }, 3);
+}
+
+static void
+suite(
+  const std::string& title,
+  const std::size_t  count,
+  const int          rounds)
+{
+  using egg::variable;
+
+  std::mt19937_64 random(42);
+  std::vector<variable> keys, probes;
+
+  // Config-like keys: half strings, half integers
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (i % 2)
+      keys.push_back(static_cast<std::int64_t>(random()));
+    else
+      keys.push_back("section.module." + std::to_string(random() % 100000000));
+  }
+
+  // Hits and misses
+  for (std::size_t i = 0; i < count; ++i)
+    probes.push_back(i % 4 ? keys[random() % count] : variable(static_cast<std::int64_t>(random())));
+
+  bench::header(title);
+
+  run<std::map<variable, variable>>("std::map", keys, probes, rounds);
+  run<std::unordered_map<variable, variable>>("std::unordered_map", keys, probes, rounds);
+  run<egg::variable_hash_map<variable>>("egg::variable_hash_map", keys, probes, rounds);
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite("Config-sized table (64 keys)", 64, 10000);
+  suite("Large table (1M keys)", 1 << 20, 1);
+
+  return 0;
+}
+
+/* End of file */
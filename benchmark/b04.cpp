@@ -0,0 +1,91 @@
+#include <map>
+#include <random>
+#include <vector>
+#include <unordered_map>
+
+#include "../include/egg/frozen_map.hpp"
+#include "../include/egg/variable_hash_map.hpp"
+#include "benchmark.hpp"
+
+static void
+suite(
+  const std::size_t count,
+  const int         rounds)
+{
+  using egg::variable;
+
+  std::mt19937_64 random(42);
+  std::map<variable, variable> source;
+
+  while (source.size() < count)
+    source["config.section." + std::to_string(random() % 100000000)] =
+      static_cast<std::int64_t>(source.size());
+
+  std::vector<variable> probes;
+  for (const auto& e : source)
+    probes.push_back(e.first);
+
+  std::shuffle(probes.begin(), probes.end(), random);
+
+  const std::unordered_map<variable, variable> unordered(source.begin(), source.end());
+  egg::variable_hash_map<variable> flat;
+  for (const auto& e : source)
+    flat[e.first] = e.second;
+
+  const std::size_t n = probes.size() * rounds;
+
+  bench::header("Lookup in " + std::to_string(count) + " string keys");
+
+  bench::measure("freeze()", count, [&] {
+    bench::keep(egg::frozen_map::freeze(source));
+  }, 1);
+
+  const egg::frozen_map frozen = egg::frozen_map::freeze(source);
+
+  bench::measure("std::map::find", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& k : probes)
+        sum += source.find(k)->second.as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("std::unordered_map::find", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& k : probes)
+        sum += unordered.find(k)->second.as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("egg::variable_hash_map::find", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& k : probes)
+        sum += flat.find(k)->second.as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("egg::frozen_map::find", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& k : probes)
+        sum += frozen.find(k)->as_int64();
+    bench::keep(sum);
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(100, 10000);
+  suite(1 << 20, 1);
+
+  return 0;
+}
+
+/* End of file */
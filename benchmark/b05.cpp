@@ -0,0 +1,154 @@
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/egg/tree.hpp"
+#include "benchmark.hpp"
+
+// The map-of-maps shape of test/t01.cpp
+struct value
+{
+  egg::variable                   _v;
+  std::map<egg::variable, value>  _d;
+};
+
+static std::int64_t
+traverse(
+  const value& v)
+{
+  std::int64_t sum = 0;
+
+  for (const auto& c : v._d)
+    sum += c.second._v.hash() + traverse(c.second);
+
+  return sum;
+}
+
+static std::int64_t
+traverse(
+  const egg::tree::const_node n)
+{
+  std::int64_t sum = 0;
+
+  for (const auto c : n)
+    sum += c.value().hash() + traverse(c);
+
+  return sum;
+}
+
+static void
+suite(
+  const std::size_t sections,
+  const std::size_t groups,
+  const std::size_t keys,
+  const int         rounds)
+{
+  using egg::variable;
+
+  // Keys repeat across parents, as in real configurations
+  std::vector<variable> s, g, k;
+
+  for (std::size_t i = 0; i < sections; ++i)
+    s.push_back("section-" + std::to_string(i));
+  for (std::size_t i = 0; i < groups; ++i)
+    g.push_back("group-" + std::to_string(i));
+  for (std::size_t i = 0; i < keys; ++i)
+    k.push_back("key-" + std::to_string(i));
+
+  const std::size_t nodes = sections * (1 + groups * (1 + keys));
+
+  std::mt19937_64 random(42);
+  std::vector<std::size_t> paths(1 << 16);
+  for (auto& p : paths)
+    p = random() % (sections * groups * keys);
+
+  bench::header("Tree of " + std::to_string(nodes) + " nodes");
+
+  bench::measure("build map of maps", nodes, [&] {
+    value root;
+    for (std::size_t a = 0; a < sections; ++a)
+      for (std::size_t b = 0; b < groups; ++b)
+        for (std::size_t c = 0; c < keys; ++c)
+          root._d[s[a]]._d[g[b]]._d[k[c]]._v = static_cast<std::int64_t>(c);
+    bench::keep(root);
+  }, 3);
+
+  bench::measure("build egg::tree", nodes, [&] {
+    egg::tree root;
+    for (std::size_t a = 0; a < sections; ++a)
+      for (std::size_t b = 0; b < groups; ++b)
+        for (std::size_t c = 0; c < keys; ++c)
+          root[s[a]][g[b]][k[c]] = static_cast<std::int64_t>(c);
+    bench::keep(root);
+  }, 3);
+
+  value mm;
+  egg::tree t;
+
+  for (std::size_t a = 0; a < sections; ++a)
+    for (std::size_t b = 0; b < groups; ++b)
+      for (std::size_t c = 0; c < keys; ++c)
+      {
+        mm._d[s[a]]._d[g[b]]._d[k[c]]._v = static_cast<std::int64_t>(c);
+        t[s[a]][g[b]][k[c]] = static_cast<std::int64_t>(c);
+      }
+
+  const egg::tree& ct = t;
+  const std::size_t n = paths.size() * rounds;
+
+  bench::measure("deep lookup map of maps", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const std::size_t p : paths)
+      {
+        const variable& a = s[p / (groups * keys)];
+        const variable& b = g[p / keys % groups];
+        const variable& c = k[p % keys];
+        sum += mm._d.find(a)->second._d.find(b)->second._d.find(c)->second._v.as_int64();
+      }
+    bench::keep(sum);
+  });
+
+  bench::measure("deep lookup egg::tree", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const std::size_t p : paths)
+      {
+        const variable& a = s[p / (groups * keys)];
+        const variable& b = g[p / keys % groups];
+        const variable& c = k[p % keys];
+        sum += ct[a][b][c].value().as_int64();
+      }
+    bench::keep(sum);
+  });
+
+  bench::measure("traverse map of maps", nodes, [&] {
+    bench::keep(traverse(mm));
+  });
+
+  bench::measure("traverse egg::tree", nodes, [&] {
+    bench::keep(traverse(ct.root()));
+  });
+
+  t.compact();
+
+  bench::measure("traverse egg::tree after compact()", nodes, [&] {
+    bench::keep(traverse(ct.root()));
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(5, 10, 10, 10);
+  suite(50, 100, 10, 10);
+
+  return 0;
+}
+
+/* End of file */
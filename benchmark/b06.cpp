@@ -0,0 +1,86 @@
+#include <string>
+#include <vector>
+
+#include "../include/egg/path.hpp"
+#include "benchmark.hpp"
+
+static void
+suite(
+  const std::size_t sections,
+  const std::size_t groups,
+  const std::size_t keys,
+  const int         rounds)
+{
+  using egg::variable;
+
+  egg::tree t;
+
+  for (std::size_t a = 0; a < sections; ++a)
+    for (std::size_t b = 0; b < groups; ++b)
+      for (std::size_t c = 0; c < keys; ++c)
+        t["section-" + std::to_string(a)]["group-" + std::to_string(b)]["key-" + std::to_string(c)] =
+          static_cast<std::int64_t>(c);
+
+  const egg::tree& ct = t;
+
+  // A few settings read in a hot loop
+  const char* hot[][3] = {
+    { "section-0", "group-0", "key-0" },
+    { "section-1", "group-3", "key-7" },
+    { "section-2", "group-5", "key-2" },
+    { "section-4", "group-9", "key-9" } };
+
+  std::vector<egg::path> paths;
+  for (const auto& h : hot)
+    paths.push_back(egg::path(std::string(h[0]) + "." + h[1] + "." + h[2]));
+
+  const std::size_t n = 4 * rounds;
+
+  bench::header("Hot reads in a tree of " + std::to_string(ct.size()) + " nodes");
+
+  bench::measure("chained operator[] with temporary keys", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& h : hot)
+        sum += ct[h[0]][h[1]][h[2]].value().as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("egg::path::resolve", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& p : paths)
+        sum += p.resolve(ct).value().as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("egg::path::find (cached)", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& p : paths)
+        sum += p.find(ct).value().as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("egg::path parse + find", n, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      for (const auto& h : hot)
+        sum += egg::path(std::string(h[0]) + "." + h[1] + "." + h[2]).find(ct).value().as_int64();
+    bench::keep(sum);
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(5, 10, 10, 250000);
+
+  return 0;
+}
+
+/* End of file */
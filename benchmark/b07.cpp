@@ -0,0 +1,111 @@
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../include/egg/atomic_variable.hpp"
+#include "benchmark.hpp"
+
+// What the tunables look like today
+struct locked_variable
+{
+  egg::variable load() const
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    return _v;
+  }
+
+  void store(const egg::variable& v)
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    _v = v;
+  }
+
+  mutable std::mutex  _m;
+  egg::variable       _v;
+};
+
+template <typename V, typename R>
+static void
+contend(
+  const std::string&   name,
+  V&                   shared,
+  R                    reader,
+  const egg::variable& a,
+  const egg::variable& b,
+  const int            readers,
+  const std::size_t    reads)
+{
+  bench::measure(name + ", " + std::to_string(readers) + " readers", reads * readers, [&] {
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+
+    // One writer flips the value all the time
+    std::thread writer([&] {
+      bool flip = false;
+      while (!stop.load(std::memory_order_relaxed))
+      {
+        shared.store(flip ? a : b);
+        flip = !flip;
+      }
+    });
+
+    for (int r = 0; r < readers; ++r)
+      threads.emplace_back([&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < reads; ++i)
+          sum += reader(shared);
+        bench::keep(sum);
+      });
+
+    for (auto& t : threads)
+      t.join();
+
+    stop = true;
+    writer.join();
+  }, 3);
+}
+
+static void
+suite(
+  const std::string&   title,
+  const egg::variable& a,
+  const egg::variable& b)
+{
+  const std::size_t reads = 200000;
+
+  bench::header(title);
+
+  for (int readers : { 1, 2, 4, 8 })
+  {
+    locked_variable locked;
+    egg::atomic_variable atomic;
+
+    contend("mutex + variable", locked,
+            [](const locked_variable& v) { return v.load().hash(); }, a, b, readers, reads);
+    contend("egg::atomic_variable::load", atomic,
+            [](const egg::atomic_variable& v) { return v.load().hash(); }, a, b, readers, reads);
+    contend("egg::atomic_variable::read", atomic,
+            [](const egg::atomic_variable& v) {
+              std::uint32_t h = 0;
+              v.read([&h](const egg::variable& x) { h = x.hash(); });
+              return h;
+            }, a, b, readers, reads);
+  }
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite("Contended loads of an int32 (one writer)", 1, 2);
+  suite("Contended loads of a string (one writer)",
+        "a tunable that is long enough to allocate", "another tunable that is long enough");
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,135 @@
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <shared_mutex>
+
+#include "../include/egg/snapshot.hpp"
+#include "benchmark.hpp"
+
+typedef std::map<egg::variable, egg::variable> variable_map;
+
+static variable_map
+configuration(
+  const std::size_t entries,
+  const int         generation)
+{
+  variable_map m;
+
+  for (std::size_t i = 0; i < entries; ++i)
+    m["key-" + std::to_string(i)] = static_cast<std::int64_t>(generation);
+
+  return m;
+}
+
+// Readers look up keys while one writer reloads the whole map all the time
+template <typename Read, typename Reload>
+static void
+contend(
+  const std::string& name,
+  const int          readers,
+  const std::size_t  reads,
+  Read               read,
+  Reload             reload)
+{
+  int reloads = 0;
+
+  bench::measure(name + ", " + std::to_string(readers) + " readers", reads * readers, [&] {
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+
+    std::thread writer([&] {
+      int g = 0;
+      for (; !stop.load(std::memory_order_relaxed); ++g)
+        reload(g);
+      reloads = g;
+    });
+
+    for (int r = 0; r < readers; ++r)
+      threads.emplace_back([&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < reads; ++i)
+          sum += read(i);
+        bench::keep(sum);
+      });
+
+    for (auto& t : threads)
+      t.join();
+
+    stop = true;
+    writer.join();
+  }, 3);
+
+  // A blocked writer reloads less, which flatters the readers
+  std::cout << "  reloads during the last run: " << reloads << std::endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  const std::size_t entries = 1000;
+  const std::size_t reads = 200000;
+
+  std::vector<egg::variable> keys;
+  for (std::size_t i = 0; i < entries; ++i)
+    keys.push_back("key-" + std::to_string(i));
+
+  bench::header("Reads of a " + std::to_string(entries) + " entry map during continuous reloads");
+
+  for (int readers : { 1, 2, 4, 8 })
+  {
+    {
+      std::mutex m;
+      variable_map shared = configuration(entries, 0);
+
+      contend("std::mutex", readers, reads,
+        [&](std::size_t i) {
+          std::lock_guard<std::mutex> lock(m);
+          return shared.find(keys[i % entries])->second.as_int64();
+        },
+        [&](int g) {
+          variable_map next = configuration(entries, g);
+          std::lock_guard<std::mutex> lock(m);
+          shared.swap(next);
+        });
+    }
+
+    {
+      std::shared_timed_mutex m;
+      variable_map shared = configuration(entries, 0);
+
+      contend("std::shared_timed_mutex", readers, reads,
+        [&](std::size_t i) {
+          std::shared_lock<std::shared_timed_mutex> lock(m);
+          return shared.find(keys[i % entries])->second.as_int64();
+        },
+        [&](int g) {
+          variable_map next = configuration(entries, g);
+          std::unique_lock<std::shared_timed_mutex> lock(m);
+          shared.swap(next);
+        });
+    }
+
+    {
+      egg::snapshot_registry<variable_map> registry(configuration(entries, 0));
+
+      contend("egg::snapshot_registry", readers, reads,
+        [&](std::size_t i) {
+          const auto s = registry.acquire();
+          return s->find(keys[i % entries])->second.as_int64();
+        },
+        [&](int g) {
+          registry.publish(configuration(entries, g));
+        });
+    }
+  }
+
+  bench::footer();
+
+  return 0;
+}
+
+/* End of file */
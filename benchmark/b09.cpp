@@ -0,0 +1,109 @@
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../include/egg/concurrent_map.hpp"
+#include "benchmark.hpp"
+
+// What the daemon modules share today
+struct locked_map
+{
+  bool get(const egg::variable& k, egg::variable& out) const
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    const auto i = _map.find(k);
+    if (i == _map.end())
+      return false;
+    out = i->second;
+    return true;
+  }
+
+  void put(const egg::variable& k, const egg::variable& v)
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    _map[k] = v;
+  }
+
+  mutable std::mutex                        _m;
+  std::map<egg::variable, egg::variable>    _map;
+};
+
+template <typename M>
+static void
+run(
+  const std::string&                name,
+  M&                                map,
+  const std::vector<egg::variable>& keys,
+  const int                         threads,
+  const int                         reads_percent,
+  const std::size_t                 operations)
+{
+  bench::measure(name + ", " + std::to_string(threads) + " threads", operations * threads, [&] {
+    std::vector<std::thread> pool;
+
+    for (int t = 0; t < threads; ++t)
+      pool.emplace_back([&, t] {
+        std::mt19937 random(t);
+        egg::variable out;
+        std::size_t found = 0;
+
+        for (std::size_t i = 0; i < operations; ++i)
+        {
+          const egg::variable& k = keys[random() % keys.size()];
+
+          if (static_cast<int>(random() % 100) < reads_percent)
+            found += map.get(k, out);
+          else
+            map.put(k, static_cast<std::int64_t>(i));
+        }
+
+        bench::keep(found);
+      });
+
+    for (auto& p : pool)
+      p.join();
+  }, 3);
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  const std::size_t count = 100000;
+  const std::size_t operations = 200000;
+
+  std::vector<egg::variable> keys;
+  for (std::size_t i = 0; i < count; ++i)
+    keys.push_back("module.key-" + std::to_string(i));
+
+  std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl << std::endl;
+
+  for (int reads : { 50, 90, 99 })
+  {
+    locked_map locked;
+    egg::concurrent_map<> sharded;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      locked.put(keys[i], static_cast<std::int64_t>(i));
+      sharded.put(keys[i], static_cast<std::int64_t>(i));
+    }
+
+    bench::header(std::to_string(reads) + "% reads over " + std::to_string(count) + " keys");
+
+    for (int threads : { 1, 2, 4, 8, 16 })
+    {
+      run("std::map + std::mutex", locked, keys, threads, reads, operations);
+      run("egg::concurrent_map", sharded, keys, threads, reads, operations);
+    }
+
+    bench::footer();
+  }
+
+  return 0;
+}
+
+/* End of file */
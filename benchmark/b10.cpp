@@ -0,0 +1,161 @@
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "../include/egg/variable_queue.hpp"
+#include "benchmark.hpp"
+
+// What the modules use today
+struct locked_queue
+{
+  explicit locked_queue(std::size_t) {}
+
+  bool try_push(egg::variable&& v)
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    _q.push_back(v);            // copies, as the modules do
+    return true;
+  }
+
+  bool try_pop(egg::variable& out)
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    if (_q.empty())
+      return false;
+    out = _q.front();
+    _q.pop_front();
+    return true;
+  }
+
+  std::mutex                _m;
+  std::deque<egg::variable> _q;
+};
+
+template <typename Q>
+static void
+throughput(
+  const std::string&   name,
+  const int            producers,
+  const egg::variable& message,
+  const std::size_t    count)
+{
+  bench::measure(name + ", " + std::to_string(producers) + " producers", count * producers, [&] {
+    Q q(1024);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p)
+      threads.emplace_back([&] {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          egg::variable v(message);
+          while (!q.try_push(std::move(v)))
+            std::this_thread::yield();
+        }
+      });
+
+    egg::variable out;
+    std::size_t received = 0;
+
+    while (received < count * producers)
+      if (q.try_pop(out))
+        ++received;
+      else
+        std::this_thread::yield();
+
+    for (auto& t : threads)
+      t.join();
+  }, 3);
+}
+
+// Round trip through two queues
+template <typename Q>
+static void
+latency(
+  const std::string&   name,
+  const egg::variable& message,
+  const std::size_t    count)
+{
+  Q there(64), back(64);
+  std::vector<double> samples;
+  samples.reserve(count);
+
+  std::thread echo([&] {
+    egg::variable v;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      while (!there.try_pop(v))
+        std::this_thread::yield();
+      while (!back.try_push(std::move(v)))
+        std::this_thread::yield();
+    }
+  });
+
+  egg::variable v;
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    egg::variable m(message);
+    while (!there.try_push(std::move(m)))
+      std::this_thread::yield();
+    while (!back.try_pop(v))
+      std::this_thread::yield();
+
+    samples.push_back(std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count());
+  }
+
+  echo.join();
+
+  std::sort(samples.begin(), samples.end());
+
+  std::cout << std::left << std::setw(48) << (name + " round trip")
+            << std::right << std::fixed << std::setprecision(0)
+            << " p50 " << samples[samples.size() / 2] << " ns"
+            << ", p99 " << samples[samples.size() * 99 / 100] << " ns" << std::endl;
+}
+
+static void
+suite(
+  const std::string&   title,
+  const egg::variable& message)
+{
+  const std::size_t count = 200000;
+
+  bench::header(title);
+
+  throughput<locked_queue>("std::deque + std::mutex", 1, message, count);
+  throughput<egg::spsc_variable_queue>("egg::spsc_variable_queue", 1, message, count);
+  throughput<egg::mpsc_variable_queue>("egg::mpsc_variable_queue", 1, message, count);
+
+  for (int producers : { 2, 4 })
+  {
+    throughput<locked_queue>("std::deque + std::mutex", producers, message, count);
+    throughput<egg::mpsc_variable_queue>("egg::mpsc_variable_queue", producers, message, count);
+  }
+
+  latency<locked_queue>("std::deque + std::mutex", message, 20000);
+  latency<egg::spsc_variable_queue>("egg::spsc_variable_queue", message, 20000);
+  latency<egg::mpsc_variable_queue>("egg::mpsc_variable_queue", message, 20000);
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl << std::endl;
+
+  suite("int64 messages", std::int64_t(42));
+  suite("string messages", "a message that is long enough to allocate");
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,131 @@
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "../include/egg/binary.hpp"
+#include "benchmark.hpp"
+
+// Text baseline: to_string and a typed parse back, the way values travel
+// through configuration files and command lines today
+static egg::variable
+parse(
+  const egg::variable::content t,
+  const std::string&           s)
+{
+  using egg::variable;
+
+  switch (t)
+  {
+    case variable::content::is_int64:   return variable(static_cast<std::int64_t>(std::strtoll(s.c_str(), nullptr, 10)));
+    case variable::content::is_uint32:  return variable(static_cast<std::uint32_t>(std::strtoul(s.c_str(), nullptr, 10)));
+    case variable::content::is_double:  return variable(std::strtod(s.c_str(), nullptr));
+    default:                            return variable(s);
+  }
+}
+
+static void
+suite(
+  const std::size_t count)
+{
+  using egg::variable;
+
+  std::vector<variable> values;
+  values.reserve(count);
+
+  for (std::size_t i = 0; i < count; ++i)
+    switch (i % 4)
+    {
+      case 0: values.push_back(variable(static_cast<std::int64_t>(i) * 7919 - 1000000)); break;
+      case 1: values.push_back(variable(static_cast<std::uint32_t>(i & 0xffff))); break;
+      case 2: values.push_back(variable(static_cast<double>(i) / 7.0)); break;
+      case 3: values.push_back(variable("key-" + std::to_string(i))); break;
+    }
+
+  std::vector<std::uint8_t> binary;
+  for (const variable& v : values)
+    egg::encode(v, binary);
+
+  std::vector<std::string> text;
+  text.reserve(count);
+  for (const variable& v : values)
+    text.push_back(v.to_string());
+
+  std::size_t text_bytes = 0;
+  for (const std::string& s : text)
+    text_bytes += s.size() + 1;
+
+  bench::header("Serialization of " + std::to_string(count) + " mixed variables, " +
+                std::to_string(binary.size()) + " bytes binary, " +
+                std::to_string(text_bytes) + " bytes text");
+
+  bench::measure("text: to_string", count, [&] {
+    std::size_t n = 0;
+    for (const variable& v : values)
+      n += v.to_string().size();
+    bench::keep(n);
+  });
+
+  bench::measure("binary: encode into a vector", count, [&] {
+    std::vector<std::uint8_t> out;
+    out.reserve(binary.size());
+    for (const variable& v : values)
+      egg::encode(v, out);
+    bench::keep(out.size());
+  });
+
+  bench::measure("binary: encode into a fixed buffer", count, [&] {
+    std::vector<std::uint8_t> out(binary.size());
+    std::uint8_t* p = out.data();
+    std::uint8_t* end = p + out.size();
+    for (const variable& v : values)
+      p += egg::encode(v, p, end - p);
+    bench::keep(p);
+  });
+
+  bench::measure("text: typed parse", count, [&] {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i)
+      n += parse(values[i].type(), text[i]).hash();
+    bench::keep(n);
+  });
+
+  bench::measure("binary: decode into variables", count, [&] {
+    const std::uint8_t* p = binary.data();
+    const std::uint8_t* end = p + binary.size();
+    std::size_t n = 0;
+    variable v;
+    while (p < end)
+    {
+      p += egg::decode(p, end - p, v);
+      n += v.hash();
+    }
+    bench::keep(n);
+  });
+
+  bench::measure("binary: decode into views", count, [&] {
+    const std::uint8_t* p = binary.data();
+    const std::uint8_t* end = p + binary.size();
+    std::size_t n = 0;
+    egg::variable_view v;
+    while (p < end)
+    {
+      p += egg::decode(p, end - p, v);
+      n += static_cast<std::size_t>(v.type());
+    }
+    bench::keep(n);
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(1000000);
+
+  return 0;
+}
+
+/* End of file */
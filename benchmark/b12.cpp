@@ -0,0 +1,152 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/egg/mapped_tree.hpp"
+#include "../include/egg/path.hpp"
+#include "benchmark.hpp"
+
+static const char* _text = "b12.conf";
+static const char* _snapshot = "b12.snapshot";
+
+// Drop the file from the page cache, so the next open reads the disk
+static void
+evict(
+  const char* file)
+{
+  const int fd = ::open(file, O_RDONLY);
+
+  if (fd >= 0)
+  {
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+}
+
+// Text baseline: one "section.group.key=value" line per leaf
+static egg::tree
+parse(
+  const char* file)
+{
+  egg::tree t;
+  std::ifstream in(file);
+  std::string line;
+
+  while (std::getline(in, line))
+  {
+    const std::string::size_type eq = line.find('=');
+    const std::string value = line.substr(eq + 1);
+    egg::tree::node n = egg::path(line.substr(0, eq)).make(t);
+
+    char* end = nullptr;
+    const long long x = std::strtoll(value.c_str(), &end, 10);
+
+    if (*end == 0 && !value.empty())
+      n = static_cast<std::int64_t>(x);
+    else
+      n = value;
+  }
+
+  return t;
+}
+
+static void
+suite(
+  const std::size_t sections,
+  const std::size_t keys,
+  const std::size_t lookups)
+{
+  using egg::variable;
+  using egg::mapped_tree;
+
+  {
+    std::ofstream out(_text, std::ios::trunc);
+
+    for (std::size_t s = 0; s < sections; ++s)
+      for (std::size_t k = 0; k < keys; ++k)
+      {
+        out << "section-" << s << ".group-" << (k % 4) << ".key-" << k << "=";
+
+        if (k % 2)
+          out << s * k << "\n";
+        else
+          out << "/var/lib/daemon/" << s << "/" << k << "\n";
+      }
+  }
+
+  mapped_tree::write(parse(_text), _snapshot);
+
+  // What a daemon reads right after the start
+  std::vector<std::pair<std::string, std::string>> probes;
+  for (std::size_t i = 0; i < lookups; ++i)
+  {
+    const std::size_t s = (i * 7919) % sections;
+    const std::size_t k = (i * 31 + 1) % keys | 1;
+
+    probes.push_back(std::make_pair("section-" + std::to_string(s), "key-" + std::to_string(k)));
+  }
+
+  auto query = [&probes](const mapped_tree& m) {
+    std::int64_t sum = 0;
+    for (const auto& p : probes)
+    {
+      const std::size_t k = std::strtoul(p.second.c_str() + 4, nullptr, 10);
+      sum += m[p.first]["group-" + std::to_string(k % 4)][p.second].value().as_int64();
+    }
+    return sum;
+  };
+
+  const mapped_tree probe = mapped_tree::open(_snapshot);
+
+  bench::header("Startup with " + std::to_string(probe.size()) + " nodes and " +
+                std::to_string(lookups) + " lookups, snapshot of " +
+                std::to_string(probe.bytes() >> 20) + " MiB, times per startup");
+
+  bench::measure("text: parse into a tree (warm)", 1, [&] {
+    bench::keep(parse(_text).size());
+  }, 3);
+
+  bench::measure("snapshot: load() into a tree (warm)", 1, [&] {
+    bench::keep(mapped_tree::open(_snapshot, false).load().size());
+  }, 3);
+
+  bench::measure("snapshot: open verified + lookups (warm)", 1, [&] {
+    bench::keep(query(mapped_tree::open(_snapshot, true)));
+  });
+
+  bench::measure("snapshot: open trusted + lookups (warm)", 1, [&] {
+    bench::keep(query(mapped_tree::open(_snapshot, false)));
+  });
+
+  bench::measure("snapshot: open verified + lookups (cold)", 1, [&] {
+    evict(_snapshot);
+    bench::keep(query(mapped_tree::open(_snapshot, true)));
+  });
+
+  bench::measure("snapshot: open trusted + lookups (cold)", 1, [&] {
+    evict(_snapshot);
+    bench::keep(query(mapped_tree::open(_snapshot, false)));
+  });
+
+  bench::footer();
+
+  std::remove(_text);
+  std::remove(_snapshot);
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(50000, 20, 1000);
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,138 @@
+#include <string>
+#include <sstream>
+
+#include "../include/egg/json.hpp"
+#include "benchmark.hpp"
+
+#if defined(EGG_WITH_JSONCPP)
+#include <json/json.h>
+#endif
+
+// Counts the events, the cost of the scanner alone
+struct counter : egg::json::handler
+{
+  void begin_object() override		{ ++_events;	}
+  void end_object() override		{ ++_events;	}
+  void begin_array() override		{ ++_events;	}
+  void end_array() override		{ ++_events;	}
+  void key(const char*, std::size_t) override { ++_events; }
+  void value(egg::variable&&) override	{ ++_events;	}
+
+  std::size_t _events = 0;
+};
+
+// A null stream, so the writers are measured without the string growth
+struct sink : std::streambuf
+{
+  std::streamsize xsputn(const char*, std::streamsize n) override { _bytes += n; return n; }
+  int overflow(int c) override { ++_bytes; return c; }
+
+  std::streamsize _bytes = 0;
+};
+
+static std::string
+document(
+  const std::size_t records)
+{
+  std::ostringstream out;
+
+  out << "{\"service\":\"inventory\",\"version\":3,\"records\":[";
+
+  for (std::size_t i = 0; i < records; ++i)
+  {
+    if (i)
+      out << ',';
+
+    out << "{\"id\":" << i
+        << ",\"name\":\"item number " << i << "\""
+        << ",\"price\":" << (i * 37 % 10000) / 100.0
+        << ",\"stock\":" << (i * 7919 % 100000) - 5000
+        << ",\"active\":" << (i % 3 ? "true" : "false")
+        << ",\"tags\":[\"tag-" << i % 10 << "\",\"group-" << i % 7 << "\"]"
+        << ",\"note\":\"line one\\nline \\\"two\\\"\"}";
+  }
+
+  out << "]}";
+
+  return out.str();
+}
+
+static void
+suite(
+  const std::size_t records)
+{
+  using egg::json;
+
+  const std::string text = document(records);
+  const egg::tree tree = json::read_tree(text);
+  const double mb = text.size() / 1e6;
+
+  bench::header("JSON with " + std::to_string(records) + " records, " +
+                std::to_string(text.size() >> 20) + " MiB, times per byte");
+
+  bench::measure("egg::json::parse, events only", text.size(), [&] {
+    counter c;
+    json::parse(text.data(), text.size(), c);
+    bench::keep(c._events);
+  });
+
+  const double read = bench::measure("egg::json::read_tree", text.size(), [&] {
+    bench::keep(json::read_tree(text).size());
+  });
+
+  const double write = bench::measure("egg::json::write (tree)", text.size(), [&] {
+    sink s;
+    std::ostream out(&s);
+    json::write(tree, out);
+    bench::keep(s._bytes);
+  });
+
+#if defined(EGG_WITH_JSONCPP)
+  const double jread = bench::measure("jsoncpp: CharReader::parse", text.size(), [&] {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value root;
+    std::string errors;
+    reader->parse(text.data(), text.data() + text.size(), &root, &errors);
+    bench::keep(root.size());
+  });
+
+  Json::Value root;
+  {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string errors;
+    reader->parse(text.data(), text.data() + text.size(), &root, &errors);
+  }
+
+  const double jwrite = bench::measure("jsoncpp: StreamWriter::write", text.size(), [&] {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    sink s;
+    std::ostream out(&s);
+    writer->write(root, &out);
+    bench::keep(s._bytes);
+  });
+
+  std::cout << "read " << std::setprecision(2) << jread / read << "x, write "
+            << jwrite / write << "x faster than jsoncpp" << std::endl;
+#endif
+
+  std::cout << "read " << std::setprecision(0) << mb / (read / 1e9) << " MB/s, write "
+            << mb / (write / 1e9) << " MB/s" << std::endl;
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(200000);
+
+  return 0;
+}
+
+/* End of file */
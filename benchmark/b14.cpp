@@ -0,0 +1,160 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <csignal>
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+#include "../include/egg/shared_store.hpp"
+#include "benchmark.hpp"
+
+// IPC baseline: a process owns the variables and answers key requests over a
+// socket with the encoded value
+static void
+serve(
+  const int                                   fd,
+  const std::map<egg::variable, egg::variable>& values)
+{
+  std::int32_t key;
+  std::vector<std::uint8_t> reply;
+
+  while (::read(fd, &key, sizeof(key)) == sizeof(key))
+  {
+    reply.clear();
+    egg::encode(values.at(egg::variable(key)), reply);
+
+    if (::write(fd, reply.data(), reply.size()) != static_cast<ssize_t>(reply.size()))
+      break;
+  }
+}
+
+static void
+suite(
+  const int keys,
+  const int rounds)
+{
+  using egg::variable;
+  using egg::shared_store;
+
+  const std::string name = "/egg-b14-" + std::to_string(::getpid());
+
+  shared_store::options geometry;
+  geometry._capacity = keys * 2;
+
+  shared_store s = shared_store::create(name, geometry);
+  std::map<variable, variable> values;
+
+  for (int k = 0; k < keys; ++k)
+  {
+    const variable v = k % 2 ? variable(std::int64_t(k) * 1000) : variable("/var/lib/daemon/value/" + std::to_string(k));
+
+    s.set(std::int32_t(k), v);
+    values[variable(std::int32_t(k))] = v;
+  }
+
+  bench::header("Shared store latency, " + std::to_string(keys) + " keys");
+
+  bench::measure("get() of an integer", rounds, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      sum += s.get(std::int32_t((r % (keys / 2)) * 2 + 1)).as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("get() of a string", rounds, [&] {
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      sum += s.get(std::int32_t((r % (keys / 2)) * 2)).as_string().size();
+    bench::keep(sum);
+  });
+
+  bench::measure("read() of a string, no allocation", rounds, [&] {
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      s.read(std::int32_t((r % (keys / 2)) * 2), [&sum](const egg::variable_view& v) { sum += v.size(); });
+    bench::keep(sum);
+  });
+
+  bench::measure("set() of a string", rounds, [&] {
+    for (int r = 0; r < rounds; ++r)
+      s.set(std::int32_t((r % (keys / 2)) * 2), "/var/lib/daemon/value/updated");
+  });
+
+  bench::measure("add() to a counter", rounds, [&] {
+    for (int r = 0; r < rounds; ++r)
+      s.add("counter", 1);
+  });
+
+  // Another process keeps writing
+  const pid_t writer = ::fork();
+
+  if (writer == 0)
+  {
+    shared_store w = shared_store::open(name);
+
+    for (std::int64_t i = 0; ; ++i)
+      w.set(std::int32_t((i % (keys / 2)) * 2 + 1), i);
+  }
+
+  bench::measure("get() with a writer process", rounds, [&] {
+    std::int64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      sum += s.get(std::int32_t((r % (keys / 2)) * 2 + 1)).as_int64();
+    bench::keep(sum);
+  });
+
+  ::kill(writer, SIGKILL);
+  ::waitpid(writer, nullptr, 0);
+
+  // The slot the writer held when it was killed may stay locked
+  shared_store::remove(name);
+
+  int fds[2];
+  ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+
+  const pid_t server = ::fork();
+
+  if (server == 0)
+  {
+    ::close(fds[0]);
+    serve(fds[1], values);
+    ::_exit(0);
+  }
+
+  ::close(fds[1]);
+
+  bench::measure("socket round trip to an owner process", rounds / 10, [&] {
+    std::uint8_t reply[512];
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds / 10; ++r)
+    {
+      const std::int32_t key = (r % (keys / 2)) * 2 + 1;
+      (void)::write(fds[0], &key, sizeof(key));
+
+      const ssize_t n = ::read(fds[0], reply, sizeof(reply));
+      variable v;
+      egg::decode(reply, static_cast<std::size_t>(n), v);
+      sum += v.hash();
+    }
+    bench::keep(sum);
+  });
+
+  ::close(fds[0]);
+  ::waitpid(server, nullptr, 0);
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(1000, 1000000);
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,114 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "../include/egg/usage.hpp"
+#include "benchmark.hpp"
+
+// Help text of a large tool: a command per line, flags and valued options
+static std::string
+document(
+  const int commands,
+  const int options)
+{
+  std::string doc = "Usage:\n";
+
+  for (int c = 0; c < commands; ++c)
+    doc += "  tool cmd" + std::to_string(c) + " [options] <target>...\n";
+
+  doc += "  tool (-h | --help)\n\nOptions:\n  -h --help  Show this screen.\n";
+
+  for (int o = 0; o < options; ++o)
+    if (o % 2)
+      doc += "  --opt-" + std::to_string(o) + "=<v>  Option " + std::to_string(o) +
+             " [default: " + std::to_string(o) + "].\n";
+    else
+      doc += "  --flag-" + std::to_string(o) + "  Flag " + std::to_string(o) + ".\n";
+
+  return doc;
+}
+
+// Baseline: hand written loop into strings, no patterns and no types
+static std::map<std::string, std::string>
+naive(
+  const std::vector<const char*>& argv)
+{
+  std::map<std::string, std::string> result;
+
+  for (std::size_t i = 1; i < argv.size(); ++i)
+  {
+    const char* a = argv[i];
+    const char* eq = std::strchr(a, '=');
+
+    if (a[0] == '-')
+      result[eq ? std::string(a, eq - a) : std::string(a)] = eq ? eq + 1 : "true";
+    else
+      result["#" + std::to_string(i)] = a;
+  }
+
+  return result;
+}
+
+static void
+suite(
+  const int commands,
+  const int options,
+  const int rounds)
+{
+  using egg::usage;
+
+  const std::string doc = document(commands, options);
+  const std::string command = "cmd" + std::to_string(commands - 1);
+
+  const std::vector<const char*> argv { "tool", command.c_str(), "--flag-0", "--opt-1=42", "--opt-3", "3.5",
+                                        "--flag-10", "build/a.o", "build/b.o", "build/c.o" };
+
+  bench::header("Usage of " + std::to_string(commands) + " commands, " + std::to_string(options) +
+                " options (" + std::to_string(doc.size()) + " bytes)");
+
+  bench::measure("compile the help text", rounds / 100, [&] {
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds / 100; ++r)
+      sum += usage(doc).names();
+    bench::keep(sum);
+  });
+
+  const usage u(doc);
+
+  bench::measure("parse() of a compiled usage", rounds, [&] {
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      sum += u.parse(argv).size();
+    bench::keep(sum);
+  });
+
+  bench::measure("compile and parse() once (startup)", rounds / 100, [&] {
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds / 100; ++r)
+      sum += usage(doc).parse(argv)["--opt-1"].as_int64();
+    bench::keep(sum);
+  });
+
+  bench::measure("naive loop into map<string, string>", rounds, [&] {
+    std::size_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+      sum += naive(argv).size();
+    bench::keep(sum);
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(10, 30, 100000);
+  suite(100, 300, 10000);
+
+  return 0;
+}
+
+/* End of file */
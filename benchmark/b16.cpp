@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include <unistd.h>
+
+#include "../include/egg/settings.hpp"
+#include "benchmark.hpp"
+
+// Key-value file in sections of 100 keys, a mix of integers, reals and text
+static void
+generate(
+  const std::string& file,
+  const int          entries)
+{
+  std::ofstream out(file);
+
+  for (int i = 0; i < entries; ++i)
+  {
+    if (i % 100 == 0)
+      out << "\n[section" << i / 100 << "]\n";
+
+    out << "key" << i % 100 << " = ";
+
+    switch (i % 3)
+    {
+      case 0:  out << i * 7;                                  break;
+      case 1:  out << i * 0.25;                               break;
+      default: out << "\"/var/lib/daemon/path/" << i << "\""; break;
+    }
+
+    out << "\n";
+  }
+}
+
+// Baseline: getline, a string per key and value, typed later on demand
+static std::unordered_map<std::string, egg::variable>
+naive(
+  const std::string& file)
+{
+  std::unordered_map<std::string, egg::variable> result;
+  std::ifstream in(file);
+  std::string line, section;
+
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    if (line[0] == '[')
+    {
+      section = line.substr(1, line.find(']') - 1);
+      continue;
+    }
+
+    const std::string::size_type eq = line.find('=');
+    std::string key = line.substr(0, line.find_last_not_of(' ', eq - 1) + 1);
+    std::string value = line.substr(line.find_first_not_of(' ', eq + 1));
+
+    if (value.size() >= 2 && value.front() == '"')
+      value = value.substr(1, value.size() - 2);
+
+    result[section + "." + key] = egg::variable(value);
+  }
+
+  return result;
+}
+
+static void
+suite(
+  const int entries)
+{
+  using egg::variable;
+  using egg::settings;
+
+  const std::string file = "/tmp/egg-b16-" + std::to_string(::getpid()) + ".ini";
+  generate(file, entries);
+
+  std::vector<std::string> keys;
+
+  for (int i = 0; i < entries; ++i)
+    keys.push_back("section" + std::to_string(i / 100) + ".key" + std::to_string(i % 100));
+
+  bench::header("Settings of " + std::to_string(entries) + " entries");
+
+  bench::measure("settings::load_file()", entries, [&] {
+    settings s;
+    s.load_file(file);
+    bench::keep(s.size());
+  });
+
+  bench::measure("load_file() and type every value", entries, [&] {
+    settings s;
+    s.load_file(file);
+    s.resolve();
+    bench::keep(s.size());
+  });
+
+  settings s;
+  s.load_file(file);
+  s.resolve();
+
+  bench::measure("find() of a typed value", entries, [&] {
+    std::size_t sum = 0;
+    for (const std::string& k : keys)
+      sum += s.find(k)->hash();
+    bench::keep(sum);
+  });
+
+  bench::measure("naive getline into variable(std::string)", entries, [&] {
+    bench::keep(naive(file).size());
+  });
+
+  const std::unordered_map<std::string, variable> n = naive(file);
+
+  bench::measure("naive find() and number parse", entries, [&] {
+    std::size_t sum = 0;
+    for (const std::string& k : keys)
+    {
+      const std::string& v = n.at(k).as_string();
+      sum += v[0] == '/' ? v.size() : static_cast<std::size_t>(std::stod(v));
+    }
+    bench::keep(sum);
+  });
+
+  std::remove(file.c_str());
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(100000);
+
+  return 0;
+}
+
+/* End of file */
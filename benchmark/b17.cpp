@@ -0,0 +1,100 @@
+#include <map>
+#include <string>
+
+#include "../include/egg/diff.hpp"
+#include "benchmark.hpp"
+
+// Reload of a tree where only a few values changed
+static void
+trees(
+  const int sections,
+  const int keys,
+  const int changes)
+{
+  using egg::tree;
+  using egg::diff;
+
+  tree running;
+
+  for (int s = 0; s < sections; ++s)
+    for (int k = 0; k < keys; ++k)
+      running["section-" + std::to_string(s)]["key-" + std::to_string(k)] =
+        "/var/lib/daemon/section-" + std::to_string(s) + "/value-" + std::to_string(k);
+
+  tree reloaded(running);
+
+  for (int c = 0; c < changes; ++c)
+    reloaded["section-" + std::to_string(c * sections / changes)]["key-" + std::to_string(c % keys)] = c;
+
+  const std::size_t nodes = running.size();
+
+  bench::header("Tree of " + std::to_string(nodes) + " nodes, " + std::to_string(changes) + " changed");
+
+  bench::measure("diff::compare()", nodes, [&] {
+    bench::keep(diff::compare(running, reloaded).size());
+  });
+
+  bench::measure("diff::compare(), verified", nodes, [&] {
+    bench::keep(diff::compare(running, reloaded, true).size());
+  });
+
+  const diff d = diff::compare(running, reloaded);
+  tree replica(running);
+
+  bench::measure("diff::apply() to a replica", d.size(), [&] {
+    d.apply(replica);
+    bench::keep(replica.size());
+  });
+
+  bench::measure("rebuild: copy the whole tree", nodes, [&] {
+    tree copy(reloaded);
+    bench::keep(copy.size());
+  });
+
+  bench::footer();
+}
+
+static void
+maps(
+  const int entries,
+  const int changes)
+{
+  using egg::variable;
+  using egg::diff;
+
+  std::map<variable, variable> running;
+
+  for (int i = 0; i < entries; ++i)
+    running[variable(i)] = variable("/var/lib/daemon/value-" + std::to_string(i));
+
+  std::map<variable, variable> reloaded(running);
+
+  for (int c = 0; c < changes; ++c)
+    reloaded[variable(c * (entries / changes))] = variable(c);
+
+  bench::header("Map of " + std::to_string(entries) + " entries, " + std::to_string(changes) + " changed");
+
+  bench::measure("diff::compare()", entries, [&] {
+    bench::keep(diff::compare(running, reloaded).size());
+  });
+
+  bench::measure("rebuild: copy the whole map", entries, [&] {
+    std::map<variable, variable> copy(reloaded);
+    bench::keep(copy.size());
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  trees(1000, 100, 10);
+  maps(100000, 10);
+
+  return 0;
+}
+
+/* End of file */
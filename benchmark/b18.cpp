@@ -0,0 +1,101 @@
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+
+#include "../include/egg/intern.hpp"
+#include "benchmark.hpp"
+
+// Metadata table: rows of a few columns drawn from a small set of values
+static void
+rows(
+  const int count,
+  const int distinct)
+{
+  using egg::variable;
+  using egg::interned;
+  using egg::intern_table;
+
+  std::vector<variable> source;
+
+  for (int i = 0; i < distinct; ++i)
+    if (i % 4 == 0)
+      source.emplace_back(variable::stringlist{
+        "/usr/lib/daemon/plugins/group-" + std::to_string(i),
+        "/usr/local/lib/daemon/plugins/group-" + std::to_string(i),
+        "/opt/daemon/plugins/group-" + std::to_string(i) });
+    else
+      source.emplace_back("/var/lib/daemon/profiles/profile-" + std::to_string(i) + "/settings");
+
+  bench::header("Table of " + std::to_string(count) + " values, " + std::to_string(distinct) + " distinct");
+
+  bench::measure("copy every value", count, [&] {
+    std::vector<variable> table;
+    table.reserve(count);
+
+    for (int i = 0; i < count; ++i)
+      table.push_back(source[i % distinct]);
+
+    bench::keep(table.size());
+  });
+
+  bench::measure("intern every value", count, [&] {
+    intern_table strings;
+    std::vector<interned> table;
+    table.reserve(count);
+
+    for (int i = 0; i < count; ++i)
+      table.push_back(strings.intern(source[i % distinct]));
+
+    bench::keep(table.size());
+  });
+
+  std::vector<variable> copies;
+  intern_table strings;
+  std::vector<interned> handles;
+
+  for (int i = 0; i < count; ++i)
+  {
+    copies.push_back(source[i % distinct]);
+    handles.push_back(strings.intern(source[i % distinct]));
+  }
+
+  bench::measure("compare copies", count, [&] {
+    std::size_t equal = 0;
+
+    for (int i = 1; i < count; ++i)
+      equal += copies[i] == copies[(i * 7) % count];
+
+    bench::keep(equal);
+  });
+
+  bench::measure("compare handles", count, [&] {
+    std::size_t equal = 0;
+
+    for (int i = 1; i < count; ++i)
+      equal += handles[i] == handles[(i * 7) % count];
+
+    bench::keep(equal);
+  });
+
+  const intern_table::statistics s = strings.stats();
+
+  std::cout << "heap of the table " << s._bytes / 1024 << " KiB, saved "
+            << s._saved / 1024 << " KiB over " << s._handles << " handles ("
+            << std::setprecision(1) << 100.0 * s._hits / s._requests << "% hits)" << std::endl;
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  rows(200000, 100);
+  rows(200000, 50000);
+
+  return 0;
+}
+
+/* End of file */
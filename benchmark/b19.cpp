@@ -0,0 +1,107 @@
+#include <string>
+#include <vector>
+
+#include "../include/egg/variable.hpp"
+#include "../include/egg/binary.hpp"
+#include "benchmark.hpp"
+
+// Sample vector kept as a string list, as before, and as a double array
+static void
+samples(
+  const int count)
+{
+  using egg::variable;
+
+  std::vector<double> values;
+  variable::stringlist strings;
+
+  for (int i = 0; i < count; ++i)
+  {
+    values.push_back(i * 0.37 - 100.0);
+    strings.push_back(std::to_string(values.back()));
+  }
+
+  bench::header("Vector of " + std::to_string(count) + " doubles");
+
+  bench::measure("build: string list", count, [&] {
+    variable::stringlist l;
+    l.reserve(values.size());
+
+    for (const double d : values)
+      l.push_back(std::to_string(d));
+
+    bench::keep(variable(l).hash());
+  });
+
+  bench::measure("build: double array", count, [&] {
+    bench::keep(variable(values).hash());
+  });
+
+  const variable list(strings);
+  const variable array(values);
+
+  bench::measure("copy: string list", count, [&] {
+    variable copy(list);
+    bench::keep(copy.hash());
+  });
+
+  bench::measure("copy: double array", count, [&] {
+    variable copy(array);
+    bench::keep(copy.hash());
+  });
+
+  bench::measure("sum: parse the string list", count, [&] {
+    double sum = 0;
+
+    for (const std::string& s : list.as_string_list())
+      sum += variable(s).as_double();
+
+    bench::keep(sum);
+  });
+
+  bench::measure("sum: view the double array", count, [&] {
+    double sum = 0;
+
+    for (const double d : array.as_double_array())
+      sum += d;
+
+    bench::keep(sum);
+  });
+
+  bench::measure("copy and compare: string list", count, [&] {
+    variable copy(list);
+    bench::keep(copy == list);
+  });
+
+  bench::measure("copy and compare: double array", count, [&] {
+    variable copy(array);
+    bench::keep(copy == array);
+  });
+
+  std::vector<std::uint8_t> buffer;
+
+  bench::measure("encode: string list", count, [&] {
+    buffer.clear();
+    bench::keep(egg::encode(list, buffer));
+  });
+
+  bench::measure("encode: double array", count, [&] {
+    buffer.clear();
+    bench::keep(egg::encode(array, buffer));
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  samples(10000);
+  samples(1000000);
+
+  return 0;
+}
+
+/* End of file */
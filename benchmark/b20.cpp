@@ -0,0 +1,185 @@
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/egg/variable.hpp"
+#include "benchmark.hpp"
+
+// The wrapper test/t01.cpp uses for nested settings
+struct value
+{
+  egg::variable                   _v;
+  std::map<egg::variable, value>  _d;
+};
+
+static bool
+equal(
+  const value& a,
+  const value& b)
+{
+  if (a._v != b._v || a._d.size() != b._d.size())
+    return false;
+
+  for (auto i = a._d.begin(), j = b._d.begin(); i != a._d.end(); ++i, ++j)
+    if (i->first != j->first || !equal(i->second, j->second))
+      return false;
+
+  return true;
+}
+
+static std::int64_t
+traverse(
+  const value& v)
+{
+  std::int64_t sum = 0;
+
+  for (const auto& c : v._d)
+    sum += c.second._v.hash() + traverse(c.second);
+
+  return sum;
+}
+
+static std::int64_t
+traverse(
+  const egg::variable& v)
+{
+  std::int64_t sum = 0;
+
+  for (const auto& c : v.as_map())
+    sum += c.second.hash() + (c.second.type() == egg::variable::content::is_map ? traverse(c.second) : 0);
+
+  return sum;
+}
+
+static void
+suite(
+  const std::size_t sections,
+  const std::size_t keys)
+{
+  using egg::variable;
+
+  std::vector<variable> s, k;
+
+  for (std::size_t i = 0; i < sections; ++i)
+    s.push_back("section-" + std::to_string(i));
+  for (std::size_t i = 0; i < keys; ++i)
+    k.push_back("key-" + std::to_string(i));
+
+  const std::size_t nodes = sections * (1 + keys);
+
+  bench::header("Settings of " + std::to_string(sections) + " sections, " + std::to_string(keys) + " keys each");
+
+  bench::measure("build: wrapper with std::map", nodes, [&] {
+    value root;
+
+    for (std::size_t a = 0; a < sections; ++a)
+      for (std::size_t c = 0; c < keys; ++c)
+        root._d[s[a]]._d[k[c]]._v = static_cast<std::int64_t>(c);
+
+    bench::keep(root);
+  });
+
+  bench::measure("build: nested is_map", nodes, [&] {
+    std::vector<variable::map::value_type> top;
+    top.reserve(sections);
+
+    for (std::size_t a = 0; a < sections; ++a)
+    {
+      std::vector<variable::map::value_type> section;
+      section.reserve(keys);
+
+      for (std::size_t c = 0; c < keys; ++c)
+        section.emplace_back(k[c], static_cast<std::int64_t>(c));
+
+      top.emplace_back(s[a], variable(variable::map(std::move(section))));
+    }
+
+    bench::keep(variable(variable::map(std::move(top))));
+  });
+
+  value wrapper;
+  std::vector<variable::map::value_type> top;
+
+  for (std::size_t a = 0; a < sections; ++a)
+  {
+    std::vector<variable::map::value_type> section;
+
+    for (std::size_t c = 0; c < keys; ++c)
+    {
+      wrapper._d[s[a]]._d[k[c]]._v = static_cast<std::int64_t>(c);
+      section.emplace_back(k[c], static_cast<std::int64_t>(c));
+    }
+
+    top.emplace_back(s[a], variable(variable::map(std::move(section))));
+  }
+
+  const variable nested(variable::map(std::move(top)));
+
+  bench::measure("copy: wrapper with std::map", nodes, [&] {
+    value copy(wrapper);
+    bench::keep(copy);
+  });
+
+  bench::measure("copy: nested is_map", nodes, [&] {
+    variable copy(nested);
+    bench::keep(copy);
+  });
+
+  const value wrapper_copy(wrapper);
+  const variable nested_copy(nested);
+
+  bench::measure("compare: wrapper with std::map", nodes, [&] {
+    bench::keep(equal(wrapper, wrapper_copy));
+  });
+
+  bench::measure("compare: nested is_map", nodes, [&] {
+    bench::keep(nested == nested_copy);
+  });
+
+  std::mt19937_64 random(42);
+  std::vector<std::size_t> paths(1 << 16);
+  for (auto& p : paths)
+    p = random() % (sections * keys);
+
+  bench::measure("lookup: wrapper with std::map", paths.size(), [&] {
+    std::int64_t sum = 0;
+
+    for (const std::size_t p : paths)
+      sum += wrapper._d.find(s[p / keys])->second._d.find(k[p % keys])->second._v.as_int64();
+
+    bench::keep(sum);
+  });
+
+  bench::measure("lookup: nested is_map", paths.size(), [&] {
+    std::int64_t sum = 0;
+
+    for (const std::size_t p : paths)
+      sum += nested.as_map().find(s[p / keys])->as_map().find(k[p % keys])->as_int64();
+
+    bench::keep(sum);
+  });
+
+  bench::measure("traverse: wrapper with std::map", nodes, [&] {
+    bench::keep(traverse(wrapper));
+  });
+
+  bench::measure("traverse: nested is_map", nodes, [&] {
+    bench::keep(traverse(nested));
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  suite(10, 10);
+  suite(100, 1000);
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,84 @@
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "../include/egg/variable.hpp"
+#include "benchmark.hpp"
+
+// Allowlist growing by one entry at a time
+static void
+allowlist(
+  const std::size_t entries,
+  const std::size_t appends)
+{
+  using egg::variable;
+
+  variable::stringlist base;
+
+  for (std::size_t i = 0; i < entries; ++i)
+    base.push_back("10.0." + std::to_string(i / 256 % 256) + "." + std::to_string(i % 256) + "/32");
+
+  bench::header("Allowlist of " + std::to_string(entries) + " entries, " + std::to_string(appends) + " appends");
+
+  const variable list(base);
+  const variable rope(variable::string_rope{ base });
+
+  bench::measure("append: copy the string list", appends, [&] {
+    variable v(list);
+
+    for (std::size_t i = 0; i < appends; ++i)
+    {
+      variable::stringlist l = v.as_string_list();
+      l.push_back("192.168.0." + std::to_string(i));
+      v = variable(l);
+    }
+
+    bench::keep(v.hash());
+  }, 1);
+
+  bench::measure("append: string rope", appends, [&] {
+    variable v(rope);
+
+    for (std::size_t i = 0; i < appends; ++i)
+      v.append("192.168.0." + std::to_string(i));
+
+    bench::keep(v.hash());
+  });
+
+  bench::measure("copy: string list", entries, [&] {
+    variable copy(list);
+    bench::keep(copy.hash());
+  });
+
+  bench::measure("copy: string rope", entries, [&] {
+    variable copy(rope);
+    bench::keep(copy.hash());
+  });
+
+  bench::measure("stream: to_string() of the list", entries, [&] {
+    std::ostringstream out;
+    out << list.to_string();
+    bench::keep(out.tellp());
+  });
+
+  bench::measure("stream: chunks of the rope", entries, [&] {
+    std::ostringstream out;
+    out << rope;
+    bench::keep(out.tellp());
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  allowlist(100000, 100);
+  allowlist(1000000, 10);
+
+  return 0;
+}
+
+/* End of file */
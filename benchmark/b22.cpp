@@ -0,0 +1,80 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../include/egg/variable.hpp"
+#include "benchmark.hpp"
+
+// What callers did before contains()
+static bool
+scan(
+  const egg::variable&  v,
+  const std::string&    s)
+{
+  const egg::variable::stringlist& l = v.as_string_list();
+
+  return std::find(l.begin(), l.end(), s) != l.end();
+}
+
+static void
+allowlist(
+  const std::size_t entries)
+{
+  using egg::variable;
+
+  variable::stringlist base;
+  for (std::size_t i = 0; i < entries; ++i)
+    base.push_back("service-" + std::to_string(i) + ".cluster.local");
+
+  const variable hosts(base);
+
+  // Half of the queries hit
+  std::mt19937_64 random(42);
+  std::vector<std::string> queries(1 << 14);
+  for (auto& q : queries)
+    q = "service-" + std::to_string(random() % (2 * entries)) + ".cluster.local";
+
+  const std::size_t repeat = entries > 10000 ? 1 : 5;
+
+  bench::header("Allowlist of " + std::to_string(entries) + " hosts, half of the queries hit");
+
+  bench::measure("linear scan of as_string_list()", queries.size(), [&] {
+    std::size_t n = 0;
+
+    for (const std::string& q : queries)
+      n += scan(hosts, q) ? 1 : 0;
+
+    bench::keep(n);
+  }, repeat);
+
+  bench::measure("copy, then first contains() builds the index", 1, [&] {
+    const variable fresh(base);
+    bench::keep(fresh.contains(queries[0]));
+  });
+
+  bench::measure("contains()", queries.size(), [&] {
+    std::size_t n = 0;
+
+    for (const std::string& q : queries)
+      n += hosts.contains(q) ? 1 : 0;
+
+    bench::keep(n);
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  allowlist(16);
+  allowlist(1000);
+  allowlist(100000);
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,97 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../include/egg/variable.hpp"
+#include "benchmark.hpp"
+
+static void
+suite(
+  const std::string&                  name,
+  const egg::variable::stringlist&    entries)
+{
+  using egg::variable;
+
+  const variable plain(entries);
+  const variable compact(variable::compact_string_list{ entries });
+
+  bench::header(name + ", " + std::to_string(entries.size()) + " entries");
+
+  std::cout << "memory: string list                " << plain.memory_usage() / 1024 << " KiB" << std::endl;
+  std::cout << "memory: compact string list        " << compact.memory_usage() / 1024 << " KiB" << std::endl;
+
+  bench::measure("build: string list", entries.size(), [&] {
+    bench::keep(variable(entries));
+  });
+
+  bench::measure("build: compact string list", entries.size(), [&] {
+    bench::keep(variable(variable::compact_string_list{ entries }));
+  });
+
+  bench::measure("scan: string list", entries.size(), [&] {
+    std::size_t n = 0;
+
+    for (const std::string& s : plain.as_string_list())
+      n += s.size();
+
+    bench::keep(n);
+  });
+
+  bench::measure("scan: compact each()", entries.size(), [&] {
+    std::size_t n = 0;
+
+    compact.as_compact_string_list().each([&n](const std::string& s) { n += s.size(); });
+
+    bench::keep(n);
+  });
+
+  const variable::compact_string_list& c = compact.as_compact_string_list();
+  const std::size_t step = 7919;
+
+  bench::measure("random access: string list", entries.size(), [&] {
+    std::size_t n = 0;
+
+    for (std::size_t i = 0, k = 0; i < entries.size(); ++i, k = (k + step) % entries.size())
+      n += plain.as_string_list()[k].size();
+
+    bench::keep(n);
+  });
+
+  bench::measure("random access: compact operator[]", entries.size(), [&] {
+    std::size_t n = 0;
+
+    for (std::size_t i = 0, k = 0; i < entries.size(); ++i, k = (k + step) % entries.size())
+      n += c[k].size();
+
+    bench::keep(n);
+  });
+
+  bench::footer();
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  egg::variable::stringlist paths, hosts;
+
+  for (int a = 0; a < 100; ++a)
+    for (int b = 0; b < 100; ++b)
+      for (int f = 0; f < 20; ++f)
+        paths.push_back("/srv/data/projects/project-" + std::to_string(a) + "/assets/images/set-" +
+                        std::to_string(b) + "/thumbnail-" + std::to_string(f) + ".png");
+
+  for (int i = 0; i < 200000; ++i)
+    hosts.push_back("worker-" + std::to_string(i) + ".eu-west-1.compute.internal");
+
+  std::sort(paths.begin(), paths.end());
+  std::sort(hosts.begin(), hosts.end());
+
+  suite("Sorted paths", paths);
+  suite("Sorted host names", hosts);
+
+  return 0;
+}
+
+/* End of file */
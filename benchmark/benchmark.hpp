@@ -0,0 +1,80 @@
+/*!
+ *	\file		benchmark.hpp
+ *	\brief		Timing helpers shared by the benchmarks
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_BENCHMARK
+#define EGG_BENCHMARK
+
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <iostream>
+
+namespace bench
+{
+
+// Keep the optimizer from dropping the measured work
+template <typename T>
+inline void
+keep(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Run the body a number of times, report the best run per item
+template <typename F>
+inline double
+measure(
+    const std::string&  name,
+    const std::size_t   items,
+    F                   body,
+    const int           repeat = 5)
+{
+  using clock = std::chrono::steady_clock;
+
+  double best = 0;
+
+  for (int r = 0; r < repeat; ++r)
+  {
+    const clock::time_point start = clock::now();
+    body();
+    const double ns = std::chrono::duration<double, std::nano>(
+      clock::now() - start).count();
+
+    if (r == 0 || ns < best)
+      best = ns;
+  }
+
+  std::cout << std::left << std::setw(48) << name
+            << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+            << best / (items ? items : 1) << " ns/item"
+            << std::setw(14) << std::setprecision(3) << best / 1e6 << " ms"
+            << std::endl;
+
+  return best;
+}
+
+inline void
+header(const std::string& title)
+{
+  std::cout << title << std::endl
+            << "---------------------------------------------------------" << std::endl;
+}
+
+inline void
+footer()
+{
+  std::cout << "---------------------------------------------------------" << std::endl
+            << "Done." << std::endl << std::endl;
+}
+
+} // End of bench namespace
+
+#endif  // EGG_BENCHMARK
+
+/* End of file */
@@ -0,0 +1,90 @@
+/*!
+ *	\file		aggregate.hpp
+ *	\brief		Declares batch aggregate kernels over collections of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_AGGREGATE
+#define EGG_AGGREGATE
+
+#include <vector>
+
+#include <egg/variable.hpp>
+#include <egg/variable_vector.hpp>
+
+
+namespace egg
+{
+
+// Result of the aggregation. Integer and floating point kinds are numeric,
+// bool, strings, lists, arrays and blobs are only counted by type.
+struct EGG_PUBLIC statistics
+{
+	typedef variable::content content;
+
+	static const std::size_t types = static_cast<std::size_t>(content::last);
+
+	statistics() noexcept;
+
+	// Numeric values seen
+	std::size_t	count;
+
+	// All values seen, by type
+	std::size_t	by_type[types];
+
+	// Sum, minimum and maximum of the numeric values, widened.
+	// Minimum and maximum are +inf and -inf if there were none
+	long double	sum;
+	long double	min;
+	long double	max;
+
+	long double mean() const noexcept;
+	std::size_t count_of(content /*type*/) const noexcept;
+
+	// Merge the result of another batch
+	statistics& operator += (const statistics& /*other*/) noexcept;
+};
+
+// Type is checked once per run of same-typed values, the payloads of the run
+// are gathered into a block and folded by vectorizable kernels.
+EGG_PUBLIC statistics
+aggregate(
+	const variable*		/*first*/,
+	std::size_t		/*count*/) noexcept;
+
+EGG_PUBLIC statistics
+aggregate(
+	const std::vector<variable>&	/*values*/) noexcept;
+
+// Same on the columnar vector, the kernels run over the payload column directly
+EGG_PUBLIC statistics
+aggregate(
+	const variable_vector&	/*values*/) noexcept;
+
+inline long double
+statistics::mean() const noexcept
+{
+  return count ? sum / count : 0.0L;
+}
+
+inline std::size_t
+statistics::count_of(content t) const noexcept
+{
+  return t < content::last ? by_type[static_cast<std::size_t>(t)] : 0;
+}
+
+inline statistics
+aggregate(
+    const std::vector<variable>& values) noexcept
+{
+  return aggregate(values.data(), values.size());
+}
+
+} // End of egg namespace
+
+#endif  // EGG_AGGREGATE
+
+/* End of file */
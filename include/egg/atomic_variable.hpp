@@ -0,0 +1,111 @@
+/*!
+ *	\file		atomic_variable.hpp
+ *	\brief		Declares lock-free shared variable
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_ATOMIC_VARIABLE
+#define EGG_ATOMIC_VARIABLE
+
+#include <atomic>
+
+#include <egg/variable.hpp>
+#include <egg/epoch.hpp>
+
+
+namespace egg
+{
+
+// Variable shared between threads without locks. The value is one atomic
+// 64 bit word: small scalars (bool, 8..32 bit integers, float, and 64 bit
+// integers that fit in 56 bits) are stored in the word itself with a type
+// tag. Anything else is an immutable heap copy the word points to, replaced
+// as a whole on store() and reclaimed through an epoch_domain. load() never
+// waits for writers, store() and compare_exchange() never take a lock.
+struct EGG_PUBLIC atomic_variable
+{
+	typedef variable::content content;
+
+	/// Shares the value through the domain
+	explicit atomic_variable(
+		const variable& /*value*/ = variable(),
+		epoch_domain&	/*domain*/ = epoch_domain::global());
+
+	~atomic_variable() noexcept;
+
+	atomic_variable(const atomic_variable&) = delete;
+	atomic_variable& operator=(const atomic_variable&) = delete;
+
+	// Copy of the current value
+	variable load() const;
+	operator variable() const				{ return load();		}
+
+	// Call f(const variable&) on the current value without copying it
+	template <typename F>
+	void read(F /*f*/) const;
+
+	// Publish a new value
+	void store(const variable& /*value*/);
+	atomic_variable& operator=(const variable& v)	{ store(v); return *this;	}
+
+	// Publish a new value, returns the previous one
+	variable exchange(const variable& /*value*/);
+
+	// Replace the value with desired if it equals expected, otherwise load
+	// the current value into expected
+	bool compare_exchange(variable& /*expected*/, const variable& /*desired*/);
+
+	content type() const noexcept;
+
+	// True if the value lives in the word itself
+	static bool is_inline(const variable& /*value*/) noexcept;
+
+private:
+
+	typedef std::uint64_t word;
+
+	static bool encode(const variable& /*value*/, word& /*result*/) noexcept;
+	static word publish(const variable& /*value*/);
+	static variable decode(word /*w*/);
+
+	static bool boxed(word w) noexcept		{ return (w & 1) == 0;		}
+	static const variable* box(word w) noexcept	{ return reinterpret_cast<const variable*>(w); }
+
+	void retire(word /*w*/);
+
+private:
+
+	std::atomic<word>	_word;
+	epoch_domain*		_domain;
+};
+
+template <typename F>
+inline void
+atomic_variable::read(
+    F f) const
+{
+  const word w = _word.load(std::memory_order_acquire);
+
+  if (!boxed(w))
+  {
+    f(decode(w));
+    return;
+  }
+
+  epoch_domain::guard g(*_domain);
+  const word p = _word.load(std::memory_order_seq_cst);
+
+  if (boxed(p))
+    f(*box(p));
+  else
+    f(decode(p));
+}
+
+} // End of egg namespace
+
+#endif  // EGG_ATOMIC_VARIABLE
+
+/* End of file */
@@ -0,0 +1,159 @@
+/*!
+ *	\file		binary.hpp
+ *	\brief		Declares compact binary encoding of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_BINARY
+#define EGG_BINARY
+
+#include <vector>
+#include <string>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+// Encoding of one variable: the content byte, then the payload
+//	empty			nothing
+//	bool			one byte, 0 or 1
+//	int8 .. int64		zig-zag LEB128 varint
+//	uint8 .. uint64		LEB128 varint
+//	float, double		IEEE 754, little endian, 4 and 8 bytes
+//	long double		64 bit mantissa, 32 bit exponent, sign and class byte
+//	string			varint length, bytes
+//	string list, rope,	varint count, then every string as above,
+//	compact string list	a compact list is coded again when decoded
+//	arrays			varint count, then the elements, little endian
+//	blob			varint length, bytes
+//	list			varint count, then every value encoded as above
+//	map			varint count, then every key and value
+// Lossless for every type, and a list is never confused with a string that
+// contains commas.
+
+// Read-only view of an encoded variable. Scalars are decoded into the view,
+// strings and blobs point into the encoded buffer, which must outlive the
+// view. Array elements are read by materialize().
+struct EGG_PUBLIC variable_view
+{
+	typedef variable::content content;
+	typedef std::size_t size_type;
+
+	variable_view() noexcept;
+
+	content type() const noexcept			{ return _type;		}
+	bool is_empty() const noexcept			{ return _type == content::is_empty; }
+
+	// Scalars, widened. Throw std::invalid_argument if the type does not match
+	bool as_bool() const;
+	std::int64_t as_int64() const;		// any signed integer
+	std::uint64_t as_uint64() const;	// any unsigned integer
+	double as_double() const;		// float or double
+	long double as_long_double() const;	// any floating point
+
+	// String or blob bytes, not terminated
+	const char* data() const;
+	size_type size() const;
+	std::string as_string() const;
+
+	// String list, array, list or map: number of elements
+	size_type count() const;
+
+	// String list, rope or compact list: a walk over the elements
+
+	template <typename F>
+	void each(F /*f(const char*, size_type)*/) const;
+
+	// Owning copy
+	variable materialize() const;
+
+private:
+
+	friend std::size_t decode(const std::uint8_t*, std::size_t, variable_view&) noexcept;
+
+	// Lists and maps nest at most depth levels more
+	static std::size_t parse(const std::uint8_t* /*data*/, std::size_t /*size*/, variable_view& /*out*/, unsigned /*depth*/) noexcept;
+
+	void throw_if_not(bool /*ok*/, const char* /*expected*/) const;
+
+	static std::size_t varint(const std::uint8_t* /*p*/, const std::uint8_t* /*end*/, std::uint64_t& /*x*/) noexcept;
+
+	content			_type;
+
+	union
+	{
+		std::int64_t	_int64;
+		std::uint64_t	_uint64;
+		double		_double;
+		long double	_long_double;
+	};
+
+	const std::uint8_t*	_data;		// strings, lists, arrays and maps
+	std::size_t		_size;		// string length or element count
+	std::size_t		_bytes;		// encoded payload of the containers
+};
+
+// Bytes the encoding takes
+EGG_PUBLIC std::size_t
+encoded_size(
+	const variable&	/*value*/) noexcept;
+
+// Write into the buffer. Returns the bytes written, 0 if it doesn't fit
+EGG_PUBLIC std::size_t
+encode(
+	const variable&	/*value*/,
+	std::uint8_t*	/*buffer*/,
+	std::size_t	/*capacity*/) noexcept;
+
+// Append to the buffer. Returns the bytes appended
+EGG_PUBLIC std::size_t
+encode(
+	const variable&			/*value*/,
+	std::vector<std::uint8_t>&	/*buffer*/);
+
+// Read one variable. Returns the bytes consumed, 0 if the data is truncated
+// or malformed
+EGG_PUBLIC std::size_t
+decode(
+	const std::uint8_t*	/*data*/,
+	std::size_t		/*size*/,
+	variable&		/*out*/);
+
+// Same without copying strings, see variable_view
+EGG_PUBLIC std::size_t
+decode(
+	const std::uint8_t*	/*data*/,
+	std::size_t		/*size*/,
+	variable_view&		/*out*/) noexcept;
+
+template <typename F>
+inline void
+variable_view::each(
+    F f) const
+{
+  throw_if_not(_type == content::is_string_list || _type == content::is_string_rope ||
+               _type == content::is_compact_string_list, "string list");
+
+  const std::uint8_t* p = _data;
+  const std::uint8_t* end = _data + _bytes;
+
+  for (size_type i = 0; i < _size; ++i)
+  {
+    std::uint64_t length = 0;
+    p += varint(p, end, length);
+
+    f(reinterpret_cast<const char*>(p), static_cast<size_type>(length));
+    p += length;
+  }
+}
+
+} // End of egg namespace
+
+#endif  // EGG_BINARY
+
+/* End of file */
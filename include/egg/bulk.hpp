@@ -0,0 +1,68 @@
+/*!
+ *	\file		bulk.hpp
+ *	\brief		Declares bulk hash, compare and dedup operations over variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_BULK
+#define EGG_BULK
+
+#include <vector>
+
+#include <egg/variable.hpp>
+#include <egg/variable_vector.hpp>
+
+
+namespace egg
+{
+
+// Copy the cached hashes of count values into out, widened to 64 bit
+EGG_PUBLIC void
+hash_all(
+	const variable*		/*first*/,
+	std::size_t		/*count*/,
+	std::uint64_t*		/*out*/) noexcept;
+
+EGG_PUBLIC void
+hash_all(
+	const variable_vector&	/*values*/,
+	std::uint64_t*		/*out*/) noexcept;
+
+// Element-wise equality of two arrays of count values. Type, cached hash and
+// inline scalars are compared block-wise without branches, the deep
+// comparison runs for boxed candidates only. Returns the number of equal pairs
+EGG_PUBLIC std::size_t
+equal_all(
+	const variable*		/*lhs*/,
+	const variable*		/*rhs*/,
+	std::size_t		/*count*/,
+	bool*			/*out*/) noexcept;
+
+// Remove repeated values, keeping the first occurrence and the order.
+// Returns the number of removed values
+EGG_PUBLIC std::size_t
+dedup(
+	std::vector<variable>&	/*values*/);
+
+// Positions of the first occurrence of every distinct value, in order
+EGG_PUBLIC std::vector<std::size_t>
+distinct(
+	const variable*		/*first*/,
+	std::size_t		/*count*/);
+
+inline void
+hash_all(
+    const std::vector<variable>& values,
+    std::uint64_t*               out) noexcept
+{
+  hash_all(values.data(), values.size(), out);
+}
+
+} // End of egg namespace
+
+#endif  // EGG_BULK
+
+/* End of file */
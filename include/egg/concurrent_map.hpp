@@ -0,0 +1,316 @@
+/*!
+ *	\file		concurrent_map.hpp
+ *	\brief		Declares sharded concurrent map with variable keys
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_CONCURRENT_MAP
+#define EGG_CONCURRENT_MAP
+
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <shared_mutex>
+
+#include <egg/variable.hpp>
+#include <egg/variable_hash_map.hpp>
+
+
+namespace egg
+{
+
+// Map shared between threads. Keys are spread over lock-striped shards by
+// their cached hash. Each shard is a variable_hash_map behind its own
+// reader-writer lock, padded away from its neighbours. Operations on
+// different shards never contend, lookups in the same shard run in parallel.
+// Values are copied out, or visited under the shard lock.
+template <typename T = variable>
+struct concurrent_map
+{
+	typedef variable key_type;
+	typedef T mapped_type;
+	typedef std::size_t size_type;
+
+	// Shards, rounded up to a power of two. Zero picks a number from the
+	// hardware concurrency
+	explicit concurrent_map(size_type /*shards*/ = 0);
+	~concurrent_map() noexcept;
+
+	concurrent_map(const concurrent_map&) = delete;
+	concurrent_map& operator=(const concurrent_map&) = delete;
+
+	// Copy the value into out. Returns false if the key is missing
+	bool get(const variable& /*key*/, T& /*out*/) const;
+
+	// Call f(const T&) under the shard lock. Returns false if the key is missing
+	template <typename F>
+	bool visit(const variable& /*key*/, F /*f*/) const;
+
+	bool contains(const variable& /*key*/) const;
+
+	// Insert or replace. Returns true if the key was inserted
+	bool put(const variable& /*key*/, T /*value*/);
+
+	// Insert if the key is missing. Returns true if it was inserted
+	bool insert(const variable& /*key*/, T /*value*/);
+
+	// Returns the number of removed elements
+	size_type erase(const variable& /*key*/);
+
+	// Value of the key; if it is missing, make() builds it, once, under the
+	// shard lock
+	template <typename F>
+	T compute_if_absent(const variable& /*key*/, F /*make*/);
+
+	// Call f(T&) on the value under the shard lock. Returns false if the key is missing
+	template <typename F>
+	bool update(const variable& /*key*/, F /*f*/);
+
+	// Call f(const variable&, const T&) for every element, shard by shard.
+	// Elements changed concurrently may or may not be seen
+	template <typename F>
+	void for_each(F /*f*/) const;
+
+	// Exact only when nobody writes
+	size_type size() const;
+	bool empty() const				{ return size() == 0;	}
+
+	void clear();
+
+	size_type shards() const noexcept		{ return _mask + 1;	}
+
+private:
+
+	typedef std::shared_timed_mutex lock_type;
+	typedef std::shared_lock<lock_type> read_lock;
+	typedef std::unique_lock<lock_type> write_lock;
+
+	// Padded, so the lock of a shard and the map of its neighbour never
+	// share a cache line
+	struct shard
+	{
+		mutable lock_type		_lock;
+		variable_hash_map<T>		_map;
+		char				_pad[64];
+	};
+
+	shard& select(const variable& /*key*/) const noexcept;
+
+private:
+
+	std::unique_ptr<shard[]>	_shards;
+	size_type			_mask;
+};
+
+template <typename T>
+inline
+concurrent_map<T>::concurrent_map(
+    size_type n)
+  : _mask(0)
+{
+  if (n == 0)
+    n = 4 * std::max<size_type>(std::thread::hardware_concurrency(), 4);
+
+  size_type count = 1;
+  while (count < n)
+    count *= 2;
+
+  _shards.reset(new shard[count]);
+  _mask = count - 1;
+}
+
+template <typename T>
+inline
+concurrent_map<T>::~concurrent_map() noexcept
+{}
+
+template <typename T>
+inline typename concurrent_map<T>::shard&
+concurrent_map<T>::select(
+    const variable& key) const noexcept
+{
+  // Top bits of a multiplicative hash, the shard map uses the low ones
+  const std::uint32_t h = key.hash() * 0x9e3779b9u;
+
+  return _shards[(h >> 16) & _mask];
+}
+
+template <typename T>
+inline bool
+concurrent_map<T>::get(
+    const variable& key,
+    T&              out) const
+{
+  const shard& s = select(key);
+  read_lock lock(s._lock);
+
+  const auto i = s._map.find(key);
+
+  if (i == s._map.end())
+    return false;
+
+  out = i->second;
+  return true;
+}
+
+template <typename T>
+template <typename F>
+inline bool
+concurrent_map<T>::visit(
+    const variable& key,
+    F               f) const
+{
+  const shard& s = select(key);
+  read_lock lock(s._lock);
+
+  const auto i = s._map.find(key);
+
+  if (i == s._map.end())
+    return false;
+
+  f(i->second);
+  return true;
+}
+
+template <typename T>
+inline bool
+concurrent_map<T>::contains(
+    const variable& key) const
+{
+  const shard& s = select(key);
+  read_lock lock(s._lock);
+
+  return s._map.contains(key);
+}
+
+template <typename T>
+inline bool
+concurrent_map<T>::put(
+    const variable& key,
+    T               value)
+{
+  shard& s = select(key);
+  write_lock lock(s._lock);
+
+  return s._map.insert_or_assign(key, std::move(value)).second;
+}
+
+template <typename T>
+inline bool
+concurrent_map<T>::insert(
+    const variable& key,
+    T               value)
+{
+  shard& s = select(key);
+  write_lock lock(s._lock);
+
+  return s._map.emplace(key, std::move(value)).second;
+}
+
+template <typename T>
+inline typename concurrent_map<T>::size_type
+concurrent_map<T>::erase(
+    const variable& key)
+{
+  shard& s = select(key);
+  write_lock lock(s._lock);
+
+  return s._map.erase(key);
+}
+
+template <typename T>
+template <typename F>
+inline T
+concurrent_map<T>::compute_if_absent(
+    const variable& key,
+    F               make)
+{
+  shard& s = select(key);
+
+  // Most calls find the value, try without excluding other readers first
+  {
+    read_lock lock(s._lock);
+    const auto i = s._map.find(key);
+
+    if (i != s._map.end())
+      return i->second;
+  }
+
+  write_lock lock(s._lock);
+  auto i = s._map.find(key);
+
+  if (i == s._map.end())
+    i = s._map.emplace(key, make()).first;
+
+  return i->second;
+}
+
+template <typename T>
+template <typename F>
+inline bool
+concurrent_map<T>::update(
+    const variable& key,
+    F               f)
+{
+  shard& s = select(key);
+  write_lock lock(s._lock);
+
+  const auto i = s._map.find(key);
+
+  if (i == s._map.end())
+    return false;
+
+  f(i->second);
+  return true;
+}
+
+template <typename T>
+template <typename F>
+inline void
+concurrent_map<T>::for_each(
+    F f) const
+{
+  for (size_type n = 0; n <= _mask; ++n)
+  {
+    const shard& s = _shards[n];
+    read_lock lock(s._lock);
+
+    for (const auto& e : s._map)
+      f(e.first, e.second);
+  }
+}
+
+template <typename T>
+inline typename concurrent_map<T>::size_type
+concurrent_map<T>::size() const
+{
+  size_type result = 0;
+
+  for (size_type n = 0; n <= _mask; ++n)
+  {
+    read_lock lock(_shards[n]._lock);
+    result += _shards[n]._map.size();
+  }
+
+  return result;
+}
+
+template <typename T>
+inline void
+concurrent_map<T>::clear()
+{
+  for (size_type n = 0; n <= _mask; ++n)
+  {
+    write_lock lock(_shards[n]._lock);
+    _shards[n]._map.clear();
+  }
+}
+
+} // End of egg namespace
+
+#endif  // EGG_CONCURRENT_MAP
+
+/* End of file */
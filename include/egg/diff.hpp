@@ -0,0 +1,207 @@
+/*!
+ *	\file		diff.hpp
+ *	\brief		Declares change sets between maps and trees of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_DIFF
+#define EGG_DIFF
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include <egg/variable.hpp>
+#include <egg/tree.hpp>
+#include <egg/path.hpp>
+
+
+namespace egg
+{
+
+// Changes that turn one version of settings into another, e.g. on a reload:
+//
+//	const diff d = diff::compare(running, reloaded);
+//	for (const diff::change& c : d) ...	rebuild what depends on c._path
+//	d.apply(replica);
+//
+// Ordered maps are merged in one pass, other maps are probed key by key.
+// Values with different cached hashes are told apart without a deep
+// comparison. Trees get a digest per node, mixed from the cached key and
+// value hashes of its subtree in one linear pass. A subtree whose digest
+// matches is skipped, so deep comparisons and changes are proportional to
+// what changed. Digests are 64 bit, but made of 32 bit value hashes: pass
+// verify to confirm every skipped subtree deeply.
+struct EGG_PUBLIC diff
+{
+	typedef std::size_t size_type;
+
+	struct EGG_PUBLIC change
+	{
+		enum class kind : std::uint8_t
+		{
+			added,		// a node or key that is new
+			removed,	// a key, or a node with its subtree
+			modified	// a value that differs
+		};
+
+		kind		_kind;
+		path		_path;
+		variable	_value;		// new value, empty if removed
+	};
+
+	typedef std::vector<change>::const_iterator const_iterator;
+
+	/// No changes
+	diff() noexcept;
+	~diff() noexcept;
+
+	// Copy
+	diff(const diff& /*other*/);
+	diff& operator=(const diff& /*other*/);
+
+	// Move
+	diff(diff&& /*other*/) noexcept;
+	diff& operator=(diff&& /*other*/) noexcept;
+
+	// Any map of variable keys and values. Paths have one segment, the key
+	template <typename M>
+	static diff compare(const M& /*from*/, const M& /*to*/);
+
+	// Added nodes are listed parent first, each with its value. A removed
+	// node stands for its whole subtree. The roots are not compared
+	static diff compare(const tree& /*from*/, const tree& /*to*/, bool /*verify*/ = false);
+
+	// Replay on another instance. Modified keys that are missing are added,
+	// removed keys that are missing are ignored. Maps throw
+	// std::invalid_argument on paths longer than one key
+	template <typename M>
+	void apply(M& /*map*/) const;
+
+	void apply(tree& /*tree*/) const;
+
+	size_type size() const noexcept			{ return _changes.size();	}
+	bool empty() const noexcept			{ return _changes.empty();	}
+	const change& operator[] (size_type i) const noexcept	{ return _changes[i];	}
+
+	const_iterator begin() const noexcept		{ return _changes.begin();	}
+	const_iterator end() const noexcept		{ return _changes.end();	}
+
+	// Changes of a kind
+	size_type count(change::kind /*kind*/) const noexcept;
+
+private:
+
+	// Ordered maps are merged in one pass, others are probed
+	template <typename T, typename = void>
+	struct ordered : std::false_type {};
+
+	template <typename T>
+	struct ordered<T, decltype(void(std::declval<const T&>().key_comp()))>
+	  : std::true_type {};
+
+	template <typename M>
+	void compare(const M& /*from*/, const M& /*to*/, std::true_type);
+
+	template <typename M>
+	void compare(const M& /*from*/, const M& /*to*/, std::false_type);
+
+	void add(change::kind /*kind*/, const variable& /*key*/, const variable& /*value*/);
+
+	static void check(const change& /*change*/);
+
+private:
+
+	std::vector<change>	_changes;
+};
+
+template <typename M>
+inline diff
+diff::compare(
+    const M& from,
+    const M& to)
+{
+  diff result;
+  result.compare(from, to, ordered<M>());
+
+  return result;
+}
+
+template <typename M>
+inline void
+diff::compare(
+    const M& from,
+    const M& to,
+    std::true_type)
+{
+  const auto less = from.key_comp();
+  auto a = from.begin();
+  auto b = to.begin();
+
+  while (a != from.end() || b != to.end())
+    if (b == to.end() || (a != from.end() && less(a->first, b->first)))
+    {
+      add(change::kind::removed, a->first, variable());
+      ++a;
+    }
+    else if (a == from.end() || less(b->first, a->first))
+    {
+      add(change::kind::added, b->first, b->second);
+      ++b;
+    }
+    else
+    {
+      if (a->second != b->second)
+        add(change::kind::modified, b->first, b->second);
+
+      ++a;
+      ++b;
+    }
+}
+
+template <typename M>
+inline void
+diff::compare(
+    const M& from,
+    const M& to,
+    std::false_type)
+{
+  for (const auto& e : to)
+  {
+    const auto i = from.find(e.first);
+
+    if (i == from.end())
+      add(change::kind::added, e.first, e.second);
+    else if (i->second != e.second)
+      add(change::kind::modified, e.first, e.second);
+  }
+
+  for (const auto& e : from)
+    if (to.find(e.first) == to.end())
+      add(change::kind::removed, e.first, variable());
+}
+
+template <typename M>
+inline void
+diff::apply(
+    M& map) const
+{
+  for (const change& c : _changes)
+  {
+    check(c);
+
+    if (c._kind == change::kind::removed)
+      map.erase(c._path[0]);
+    else
+      map[c._path[0]] = c._value;
+  }
+}
+
+} // End of egg namespace
+
+#endif  // EGG_DIFF
+
+/* End of file */
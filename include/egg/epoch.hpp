@@ -0,0 +1,101 @@
+/*!
+ *	\file		epoch.hpp
+ *	\brief		Declares epoch-based memory reclamation
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_EPOCH
+#define EGG_EPOCH
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include <egg/common.hpp>
+
+
+namespace egg
+{
+
+// Epoch-based reclamation for lock-free readers. A reader pins the current
+// epoch with a guard before it follows a shared pointer. A writer unlinks an
+// object and retires it, the object is deleted once the global epoch moved
+// twice past the retirement, i.e. when no guard can still see it. Pinning is
+// wait-free, retiring is lock-free, and a collection never waits for readers.
+// A domain must outlive every thread that uses it, the global() one does.
+struct EGG_PUBLIC epoch_domain
+{
+	typedef std::size_t size_type;
+	typedef void (*deleter)(void*);
+
+	struct record;
+
+	// Pins the epoch for the calling thread. Guards nest. A guard may be
+	// moved, but must be destroyed by the thread that created it
+	struct EGG_PUBLIC guard
+	{
+		explicit guard(epoch_domain& /*domain*/ = epoch_domain::global());
+		~guard() noexcept;
+
+		guard(const guard&) = delete;
+		guard& operator=(const guard&) = delete;
+
+		guard(guard&& other) noexcept : _record(other._record) { other._record = nullptr; }
+		guard& operator=(guard&&) = delete;
+
+	private:
+
+		record*	_record;
+	};
+
+	/// An empty domain
+	epoch_domain();
+	~epoch_domain() noexcept;
+
+	epoch_domain(const epoch_domain&) = delete;
+	epoch_domain& operator=(const epoch_domain&) = delete;
+
+	// Domain shared by default
+	static epoch_domain& global();
+
+	// Delete the object once no reader can reach it
+	void retire(void* /*pointer*/, deleter /*deleter*/);
+
+	template <typename T>
+	void retire(T* p) { retire(p, [](void* q) { delete static_cast<T*>(q); }); }
+
+	// Try to advance the epoch and delete what became unreachable. Returns
+	// the number of deleted objects. Does nothing if another thread collects
+	size_type collect() noexcept;
+
+	// Retired objects not deleted yet
+	size_type pending() const noexcept;
+
+	std::uint64_t epoch() const noexcept;
+
+private:
+
+	struct retired;
+
+	record* acquire();
+	bool advance() noexcept;
+
+private:
+
+	std::atomic<std::uint64_t>	_epoch;
+	std::atomic<record*>		_records;
+	std::atomic<retired*>		_retired;
+	std::atomic<size_type>		_pending;
+	std::atomic_flag		_collecting;
+
+	std::uint64_t			_id;
+};
+
+} // End of egg namespace
+
+#endif  // EGG_EPOCH
+
+/* End of file */
@@ -0,0 +1,214 @@
+/*!
+ *	\file		frozen_map.hpp
+ *	\brief		Declares immutable perfect-hash map of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_FROZEN_MAP
+#define EGG_FROZEN_MAP
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include <egg/variable.hpp>
+#include <egg/tree.hpp>
+
+
+namespace egg
+{
+
+// Read-only snapshot of a map of variables, or of a nested map of maps. Every
+// level gets a minimal perfect hash (hash and displace): the key hash selects
+// a bucket, the bucket displacement selects the slot, so a lookup is one hash
+// and one key comparison. Distinct keys with the same hash are chained from
+// the slot of the first of them and told apart by ==. Entries (hash, key,
+// value, child and chain links) of all levels live in one contiguous array.
+// Nothing is mutated after freeze(), so a frozen map can be shared between
+// threads without synchronization.
+struct EGG_PUBLIC frozen_map
+{
+	typedef std::size_t size_type;
+
+	static const size_type npos = static_cast<size_type>(-1);
+
+	// Position in a level, used to walk nested maps
+	struct EGG_PUBLIC node
+	{
+		node() noexcept : _map(nullptr), _entry(npos), _level(npos) {}
+
+		bool valid() const noexcept		{ return _map != nullptr;	}
+		explicit operator bool() const noexcept	{ return valid();		}
+
+		// Key and value of the entry. The root node has none
+		const variable* key() const noexcept;
+		const variable* value() const noexcept;
+
+		// Children. Invalid node if there is no such key
+		node operator[] (const variable& /*key*/) const noexcept;
+		size_type size() const noexcept;
+		node child(size_type /*position*/) const noexcept;
+
+	private:
+
+		friend struct frozen_map;
+
+		node(const frozen_map* m, size_type e, size_type l) noexcept
+		  : _map(m), _entry(e), _level(l) {}
+
+		const frozen_map*	_map;
+		size_type		_entry;
+		size_type		_level;
+	};
+
+	/// An empty map
+	frozen_map() noexcept;
+	~frozen_map() noexcept;
+
+	// Copy
+	frozen_map(const frozen_map& /*other*/);
+	frozen_map& operator=(const frozen_map& /*other*/);
+
+	// Move
+	frozen_map(frozen_map&& /*other*/) noexcept;
+	frozen_map& operator=(frozen_map&& /*other*/) noexcept;
+
+	// Build from any map of variable keys. Mapped values that are maps
+	// themselves (begin()/end() over pairs) are frozen recursively
+	template <typename M>
+	static frozen_map freeze(const M& /*map*/);
+
+	// Build from a tree, every node with children becomes a nested level
+	static frozen_map freeze(const tree& /*tree*/);
+
+	// Size of the top level
+	size_type size() const noexcept;
+	bool empty() const noexcept;
+
+	// Top level lookup
+	const variable* find(const variable& /*key*/) const noexcept;
+
+	// Throws std::out_of_range if the key is missing
+	const variable& at(const variable& /*key*/) const;
+
+	// Nested lookup
+	node root() const noexcept;
+	node operator[] (const variable& /*key*/) const noexcept;
+
+private:
+
+	// The hash is compared before the key; _next is the next entry with the
+	// same hash, npos at the end of the chain
+	struct entry
+	{
+		std::uint32_t	_hash;
+		size_type	_child;
+		size_type	_next;
+		variable	_key;
+		variable	_value;
+	};
+
+	struct level
+	{
+		size_type	_offset;	// first entry
+		size_type	_size;		// entries
+		size_type	_seeds;		// first bucket displacement
+		size_type	_buckets;	// buckets
+	};
+
+	// Entry of the level for the key, npos if there is none
+	size_type lookup(size_type /*level*/, const variable& /*key*/) const noexcept;
+
+	// Place staged entries of one level, returns the level index
+	size_type place(
+		std::vector<variable>&	/*keys*/,
+		std::vector<variable>&	/*values*/,
+		std::vector<size_type>&	/*children*/);
+
+	template <typename M>
+	size_type build(const M& /*map*/);
+
+	size_type build(const tree::const_node& /*node*/);
+
+	// Detect nested maps
+	template <typename T, typename = void>
+	struct nested : std::false_type {};
+
+	template <typename T>
+	struct nested<T, decltype(void(std::declval<const T&>().begin()->second))>
+	  : std::true_type {};
+
+	template <typename T>
+	size_type child(const T& v, std::true_type) { return v.begin() == v.end() ? npos : build(v); }
+
+	template <typename T>
+	size_type child(const T&, std::false_type) { return npos; }
+
+	// Mapped values that are not variables (plain nested maps) become empty
+	template <typename T>
+	static variable value_of(const T& v, std::true_type) { return v; }
+
+	template <typename T>
+	static variable value_of(const T&, std::false_type) { return variable(); }
+
+private:
+
+	std::vector<level>		_levels;
+	std::vector<std::uint32_t>	_seeds;
+
+	std::vector<entry>		_entries;
+
+	size_type			_root;
+};
+
+template <typename M>
+inline frozen_map
+frozen_map::freeze(
+    const M& m)
+{
+  frozen_map result;
+  result._root = result.build(m);
+
+  return result;
+}
+
+template <typename M>
+inline frozen_map::size_type
+frozen_map::build(
+    const M& m)
+{
+  typedef typename std::decay<decltype(m.begin()->second)>::type mapped;
+
+  std::vector<variable> keys, values;
+  std::vector<size_type> children;
+
+  for (const auto& e : m)
+  {
+    keys.push_back(e.first);
+    values.push_back(value_of(e.second, std::is_convertible<const mapped&, variable>()));
+    children.push_back(child(e.second, nested<mapped>()));
+  }
+
+  return place(keys, values, children);
+}
+
+inline frozen_map::node
+frozen_map::root() const noexcept
+{
+  return node(this, npos, _root);
+}
+
+inline frozen_map::node
+frozen_map::operator[] (const variable& key) const noexcept
+{
+  return root()[key];
+}
+
+} // End of egg namespace
+
+#endif  // EGG_FROZEN_MAP
+
+/* End of file */
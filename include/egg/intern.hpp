@@ -0,0 +1,167 @@
+/*!
+ *	\file		intern.hpp
+ *	\brief		Declares hash-consing table of immutable variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_INTERN
+#define EGG_INTERN
+
+#include <memory>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+struct intern_table;
+
+// Shared, immutable handle of a canonical value. Copies share the payload,
+// nothing is deep copied. Handles of one table are equal exactly when
+// their values are, so the comparison is a pointer compare. A handle may
+// outlive its table
+struct EGG_PUBLIC interned
+{
+	typedef std::size_t size_type;
+
+	/// Refers to an empty value
+	interned() noexcept;
+	~interned() noexcept;
+
+	// Copy
+	interned(const interned& /*other*/) noexcept;
+	interned& operator=(const interned& /*other*/) noexcept;
+
+	// Move
+	interned(interned&& /*other*/) noexcept;
+	interned& operator=(interned&& /*other*/) noexcept;
+
+	const variable& operator*() const noexcept	{ return *get();		}
+	const variable* operator->() const noexcept	{ return get();			}
+	const variable* get() const noexcept;
+
+	// False for the default handle
+	explicit operator bool() const noexcept		{ return _node != nullptr;	}
+
+	std::uint32_t hash() const noexcept		{ return get()->hash();		}
+
+	// Handles of the value, including this one
+	size_type use_count() const noexcept;
+
+	bool operator==(const interned& o) const noexcept { return _node == o._node;	}
+	bool operator!=(const interned& o) const noexcept { return _node != o._node;	}
+
+private:
+
+	friend struct intern_table;
+
+	struct node;
+
+	explicit interned(node* /*node*/) noexcept;
+
+	void release() noexcept;
+
+private:
+
+	node*	_node;
+};
+
+// Opt-in hash-consing: intern() returns the handle of the one canonical
+// copy of each distinct value, so values repeated many times across tables
+// are stored once:
+//
+//	egg::intern_table& names = egg::intern_table::global();
+//	record._owner = names.intern(variable("www-data"));
+//
+// Values are found by their cached hash, then compared deeply. The table is
+// split into lock-striped shards by hash, interning in different shards
+// never contends. Values stay in the table while handles refer to them,
+// purge() drops the others.
+struct EGG_PUBLIC intern_table
+{
+	typedef std::size_t size_type;
+
+	struct EGG_PUBLIC statistics
+	{
+		size_type	_requests;	// intern() calls
+		size_type	_hits;		// calls that found the value
+		size_type	_values;	// distinct values in the table
+		size_type	_handles;	// live handles of them
+		size_type	_bytes;		// heap held by the table
+		size_type	_saved;		// heap the handles would hold as copies, less _bytes
+	};
+
+	// Shards, rounded up to a power of two. Zero picks a number from the
+	// hardware concurrency
+	explicit intern_table(size_type /*shards*/ = 0);
+
+	// Live handles keep their values
+	~intern_table() noexcept;
+
+	intern_table(const intern_table&) = delete;
+	intern_table& operator=(const intern_table&) = delete;
+
+	// The canonical handle of the value, added if it is new
+	interned intern(const variable& /*value*/);
+	interned intern(variable&& /*value*/);
+
+	// Handle of the value if it is in the table, else the default handle
+	interned find(const variable& /*value*/) const;
+
+	// Drop values no handle refers to. Returns the number of dropped values
+	size_type purge();
+
+	// Distinct values. Exact only when nobody interns
+	size_type size() const;
+	bool empty() const				{ return size() == 0;		}
+
+	// Walks every shard. Exact only when nobody interns
+	statistics stats() const;
+
+	size_type shards() const noexcept		{ return _mask + 1;		}
+
+	// Process-wide table, made on first use
+	static intern_table& global();
+
+private:
+
+	struct shard;
+
+	shard& select(std::uint32_t /*hash*/) const noexcept;
+
+	template <typename V>
+	interned insert(V&& /*value*/);
+
+private:
+
+	std::unique_ptr<shard[]>	_shards;
+	size_type			_mask;
+};
+
+} // End of egg namespace
+
+namespace std
+{
+
+template <>
+struct hash<egg::interned>
+{
+
+  size_t
+  operator()(
+      const egg::interned& v) const noexcept
+  {
+    return v.hash();
+  }
+
+};
+
+}
+
+#endif  // EGG_INTERN
+
+/* End of file */
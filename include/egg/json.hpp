@@ -0,0 +1,135 @@
+/*!
+ *	\file		json.hpp
+ *	\brief		Declares streaming JSON reader and writer of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_JSON
+#define EGG_JSON
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include <egg/variable.hpp>
+#include <egg/tree.hpp>
+
+
+namespace egg
+{
+
+// JSON to variables and back, without a document model in between.
+// Mapping of the values:
+//	null			empty
+//	true, false		bool
+//	integer			smallest of int8 .. int64 that holds it, uint64
+//				above the int64 range, double above uint64.
+//				Without narrowing always int64 (or uint64)
+//	number with . or e	double
+//	string			string
+//	array of strings	string list
+// Arrays of numbers, lists, string ropes and compact string lists are written
+// as JSON arrays and maps as objects. Read back, ropes and compact lists
+// become string lists and the others nodes. A blob is written as a string of
+// hex digits.
+// In a tree an object is a node with a child per member. Any other array is
+// a node with children keyed 0, 1, ... (uint32) and is written back as an
+// array. An empty object is a node without children, written back as null.
+// Errors throw std::invalid_argument with the offset in the input.
+struct EGG_PUBLIC json
+{
+	typedef std::size_t size_type;
+
+	// Events of the reader. Keys and strings point into the input or into
+	// a scratch buffer, both valid during the call only
+	struct EGG_PUBLIC handler
+	{
+		virtual ~handler() noexcept;
+
+		virtual void begin_object() = 0;
+		virtual void end_object() = 0;
+		virtual void begin_array() = 0;
+		virtual void end_array() = 0;
+
+		virtual void key(const char* /*data*/, size_type /*size*/) = 0;
+
+		// Scalars, strings included
+		virtual void value(variable&& /*value*/) = 0;
+	};
+
+	// Writes compact JSON straight to a stream through a small buffer
+	struct EGG_PUBLIC writer
+	{
+		explicit writer(std::ostream& /*out*/);
+		~writer() noexcept;
+
+		writer(const writer&) = delete;
+		writer& operator=(const writer&) = delete;
+
+		void begin_object();
+		void end_object();
+		void begin_array();
+		void end_array();
+
+		// Keys that are not strings are written through to_string()
+		void key(const variable& /*key*/);
+		void key(const char* /*data*/, size_type /*size*/);
+
+		// NaN and infinities become null, JSON has no such numbers
+		void value(const variable& /*value*/);
+
+		void flush();
+
+	private:
+
+		void separate();
+		void number(std::int64_t /*x*/);
+		void number(std::uint64_t /*x*/);
+		void number(long double /*x*/, variable::content /*type*/);
+
+		template <typename T, typename F>
+		void elements(const variable::array_view<T>& /*array*/, F /*f*/);
+
+		void string(const char* /*data*/, size_type /*size*/);
+		void raw(const char* /*data*/, size_type /*size*/);
+		void put(char c)	{ if (_used == sizeof(_buffer)) drain(); _buffer[_used++] = c; }
+		void drain();
+
+		std::ostream&		_out;
+		std::vector<bool>	_first;		// per open container
+		bool			_after_key;
+		size_type		_used;
+		char			_buffer[4096];
+	};
+
+	// Feed the events of one document to the handler
+	static void parse(
+		const char*	/*data*/,
+		size_type	/*size*/,
+		handler&	/*handler*/,
+		bool		/*narrow*/ = true);
+
+	// A scalar or an array of strings
+	static variable read_value(const std::string& /*text*/, bool /*narrow*/ = true);
+
+	// Any document. A top level scalar becomes the value of the root
+	static tree read_tree(const char* /*data*/, size_type /*size*/, bool /*narrow*/ = true);
+	static tree read_tree(const std::string& t, bool n = true)	{ return read_tree(t.data(), t.size(), n); }
+
+	// A node with children is written as an object or an array, its own
+	// value is not written
+	static void write(const variable& /*value*/, std::ostream& /*out*/);
+	static void write(const tree& /*tree*/, std::ostream& /*out*/);
+
+	static std::string to_string(const variable& /*value*/);
+	static std::string to_string(const tree& /*tree*/);
+};
+
+} // End of egg namespace
+
+#endif  // EGG_JSON
+
+/* End of file */
@@ -0,0 +1,183 @@
+/*!
+ *	\file		mapped_tree.hpp
+ *	\brief		Declares memory-mapped read-only snapshot of a tree
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_MAPPED_TREE
+#define EGG_MAPPED_TREE
+
+#include <string>
+
+#include <egg/variable.hpp>
+#include <egg/tree.hpp>
+#include <egg/binary.hpp>
+
+
+namespace egg
+{
+
+// Snapshot of a tree in a file, queried in place after mmap. Nothing is
+// parsed or allocated on open. The file holds, at offsets from its start:
+//	header		magic, version, byte order, section offsets, checksum
+//	keys		interned keys: offset and size of the encoding, key hash
+//	nodes		key id, parent, first child, children, value offset.
+//			Nodes are in breadth-first order, children are contiguous
+//	index		open addressing table (parent, key) -> node
+//	data		keys and values in the binary encoding (see binary.hpp)
+// Keys are hashed over their encoding, so a file works with any build that
+// has the same byte order.
+struct EGG_PUBLIC mapped_tree
+{
+	typedef std::uint32_t index_type;
+	typedef std::size_t size_type;
+
+	static const index_type npos = static_cast<index_type>(-1);
+
+	// Position in the tree, valid while the mapped_tree is open
+	struct EGG_PUBLIC node
+	{
+		node() noexcept : _tree(nullptr), _index(npos) {}
+
+		bool valid() const noexcept		{ return _index != npos;	}
+		explicit operator bool() const noexcept	{ return valid();		}
+		index_type index() const noexcept	{ return _index;		}
+
+		// Views into the mapping. The root has an empty key and value
+		variable_view key() const noexcept;
+		variable_view value() const noexcept;
+
+		// Children. Invalid node if there is no such key
+		size_type size() const noexcept;
+		bool empty() const noexcept		{ return size() == 0;	}
+
+		node find(const variable& /*key*/) const;
+		node operator[] (const variable& k) const	{ return find(k);	}
+
+		node child(size_type /*position*/) const noexcept;
+		node parent() const noexcept;
+
+	private:
+
+		friend struct mapped_tree;
+
+		node(const mapped_tree* t, index_type i) noexcept : _tree(t), _index(i) {}
+
+		const mapped_tree*	_tree;
+		index_type		_index;
+	};
+
+	/// Nothing mapped
+	mapped_tree() noexcept;
+	~mapped_tree() noexcept;
+
+	mapped_tree(const mapped_tree&) = delete;
+	mapped_tree& operator=(const mapped_tree&) = delete;
+
+	// Move
+	mapped_tree(mapped_tree&& /*other*/) noexcept;
+	mapped_tree& operator=(mapped_tree&& /*other*/) noexcept;
+
+	// Write the snapshot. The file is replaced atomically (written aside, then
+	// renamed). Throws std::runtime_error on I/O errors
+	static void write(const tree& /*tree*/, const std::string& /*file*/);
+
+	// Flat map of variable keys, written as the children of the root
+	template <typename M>
+	static void write_map(const M& /*map*/, const std::string& /*file*/);
+
+	// Map the snapshot. The header and the section bounds are always checked.
+	// With verify every key, node, index slot and value is checked and the
+	// checksum is compared, so a damaged file can't be read out of bounds.
+	// Without it the content is trusted and open() is O(1).
+	// Throws std::runtime_error if the file can't be mapped or is invalid
+	static mapped_tree open(const std::string& /*file*/, bool /*verify*/ = true);
+
+	void close() noexcept;
+	bool is_open() const noexcept		{ return _base != nullptr;	}
+
+	node root() const noexcept;
+	node operator[] (const variable& k) const	{ return root()[k];	}
+
+	// Nodes without the root, distinct keys, bytes mapped
+	size_type size() const noexcept;
+	size_type keys() const noexcept;
+	size_type bytes() const noexcept	{ return _size;			}
+
+	// Copy everything back into a mutable tree
+	tree load() const;
+
+private:
+
+	struct header;
+
+	struct key_record
+	{
+		std::uint64_t	_offset;	// in the data section
+		std::uint32_t	_size;
+		std::uint32_t	_hash;
+	};
+
+	struct node_record
+	{
+		index_type	_key;
+		index_type	_parent;
+		index_type	_first;		// first child
+		index_type	_children;
+		std::uint64_t	_value;		// offset in the data section
+	};
+
+	// Node with the key under the parent, npos if there is none
+	index_type lookup(
+		index_type		/*parent*/,
+		const std::uint8_t*	/*key*/,
+		std::size_t		/*size*/) const noexcept;
+
+	void validate(bool /*verify*/) const;
+
+	void copy(node /*from*/, tree::node /*to*/) const;
+
+private:
+
+	const std::uint8_t*	_base;
+	std::size_t		_size;
+
+	const key_record*	_keys;
+	const node_record*	_nodes;
+	const index_type*	_index;
+	const std::uint8_t*	_data;
+
+	std::size_t		_key_count;
+	std::size_t		_node_count;
+	std::size_t		_slots;
+	std::size_t		_data_size;
+};
+
+template <typename M>
+inline void
+mapped_tree::write_map(
+    const M&           m,
+    const std::string& file)
+{
+  tree t;
+
+  for (const auto& e : m)
+    t[e.first] = e.second;
+
+  write(t, file);
+}
+
+inline mapped_tree::node
+mapped_tree::root() const noexcept
+{
+  return node(this, _node_count == 0 ? npos : 0);
+}
+
+} // End of egg namespace
+
+#endif  // EGG_MAPPED_TREE
+
+/* End of file */
@@ -0,0 +1,87 @@
+/*!
+ *	\file		path.hpp
+ *	\brief		Declares precompiled path lookups in a tree
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_PATH
+#define EGG_PATH
+
+#include <vector>
+#include <string>
+#include <initializer_list>
+
+#include <egg/tree.hpp>
+
+
+namespace egg
+{
+
+// Path of keys, e.g. "cmd.log.level", parsed once. The segments are ready
+// variables with cached hashes, so resolving a path doesn't allocate. The
+// node found last is cached together with the tree generation and reused
+// until nodes are added to or removed from the tree. Because of the cache a
+// path object must not be shared between threads, use resolve() for that.
+struct EGG_PUBLIC path
+{
+	typedef std::size_t size_type;
+
+	/// An empty path, resolves to the root
+	path() noexcept;
+	~path() noexcept;
+
+	// Split by the separator into string keys.
+	// Throws std::invalid_argument on an empty segment
+	explicit path(const std::string& /*dotted*/, const char /*separator*/ = '.');
+	explicit path(const char* d) : path(std::string(d)) {}
+
+	// Keys of any type
+	path(std::initializer_list<variable> /*segments*/);
+	explicit path(std::vector<variable> /*segments*/) noexcept;
+
+	// Copy
+	path(const path& /*other*/);
+	path& operator=(const path& /*other*/);
+
+	// Move
+	path(path&& /*other*/) noexcept;
+	path& operator=(path&& /*other*/) noexcept;
+
+	size_type size() const noexcept		{ return _segments.size();	}
+	bool empty() const noexcept		{ return _segments.empty();	}
+	const variable& operator[] (size_type i) const noexcept { return _segments[i]; }
+
+	// Cached lookup, invalid node if any segment is missing
+	tree::const_node find(const tree& /*tree*/) const noexcept;
+	tree::node find(tree& /*tree*/) const noexcept;
+
+	// Lookup without the cache, safe to call concurrently
+	tree::const_node resolve(const tree& /*tree*/) const noexcept;
+
+	// Node at the path, missing nodes are created
+	tree::node make(tree& /*tree*/) const;
+
+	// Segments joined by the separator
+	std::string to_string(const char /*separator*/ = '.') const;
+
+private:
+
+	tree::index_type walk(const tree& /*tree*/) const noexcept;
+	tree::index_type lookup(const tree& /*tree*/) const noexcept;
+
+private:
+
+	std::vector<variable>		_segments;
+
+	mutable std::uint64_t		_generation;
+	mutable tree::index_type	_node;
+};
+
+} // End of egg namespace
+
+#endif  // EGG_PATH
+
+/* End of file */
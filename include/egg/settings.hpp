@@ -0,0 +1,176 @@
+/*!
+ *	\file		settings.hpp
+ *	\brief		Declares bulk loader of environment and key-value files
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_SETTINGS
+#define EGG_SETTINGS
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+// Key-value settings from the environment and from INI or .env files:
+//
+//	# comment, ; comment
+//	export PATH_PREFIX=/opt		"export " is skipped
+//	[server]
+//	port = 8080			key "server.port"
+//	name = "main node"		quotes are stripped
+//	zip = '01234'			quoted values stay strings
+//
+// Files are mapped, the environment is copied into one block. The text is
+// split with 16 byte delimiter scans and every entry keeps slices of its key
+// and value, nothing is allocated per entry. A value becomes a variable on
+// first access: bool (true/false, yes/no, on/off), int64, uint64, double or
+// string. A value in quotes is always a string. Later sources override the
+// keys of earlier ones.
+//
+// Typing on access writes to the loader, call resolve() before sharing it
+// between threads.
+struct EGG_PUBLIC settings
+{
+	typedef std::size_t size_type;
+	typedef std::uint32_t index_type;
+
+	static const index_type npos = static_cast<index_type>(-1);
+
+	// Text in a loaded source, valid while the settings live
+	struct EGG_PUBLIC slice
+	{
+		slice() noexcept : _data(nullptr), _size(0) {}
+		slice(const char* d, size_type s) noexcept : _data(d), _size(s) {}
+
+		const char* data() const noexcept	{ return _data;			}
+		size_type size() const noexcept		{ return _size;			}
+		bool empty() const noexcept		{ return _size == 0;		}
+
+		std::string to_string() const		{ return std::string(_data, _size); }
+
+	private:
+
+		const char*	_data;
+		size_type	_size;
+	};
+
+	/// No sources
+	settings();
+	~settings() noexcept;
+
+	settings(const settings&) = delete;
+	settings& operator=(const settings&) = delete;
+
+	// Move
+	settings(settings&& /*other*/) noexcept;
+	settings& operator=(settings&& /*other*/) noexcept;
+
+	// Map and split a file. Throws std::runtime_error if it can't be read and
+	// std::invalid_argument on a line that is not a key, a section or a comment
+	void load_file(const std::string& /*file*/);
+
+	// Copy and split the text, same format as the files
+	void load_text(const std::string& /*text*/);
+
+	// Copy and split "KEY=value" strings, the process environment by default
+	void load_environment();
+	void load_environment(const char* const* /*environment*/);
+
+	// Typed value, nullptr if the key is missing
+	const variable* find(const std::string& /*key*/) const;
+	const variable* find(const char* /*key*/, size_type /*size*/) const;
+
+	// Throws std::out_of_range if the key is missing
+	const variable& operator[] (const std::string& /*key*/) const;
+
+	bool contains(const std::string& /*key*/) const noexcept;
+
+	// The value as written, an empty slice if the key is missing
+	slice raw(const std::string& /*key*/) const noexcept;
+
+	// Type every value now
+	void resolve() const;
+
+	// Distinct keys
+	size_type size() const noexcept		{ return _count;		}
+	bool empty() const noexcept		{ return _count == 0;		}
+
+	// Bytes of the loaded sources
+	size_type bytes() const noexcept;
+
+	// All keys and typed values
+	std::map<variable, variable> to_map() const;
+
+private:
+
+	enum class format : std::uint8_t
+	{
+		text,		// lines, sections and comments
+		environment	// NUL separated KEY=value
+	};
+
+	// A mapped file or an owned copy
+	struct block
+	{
+		const char*	_data;
+		size_type	_size;
+		bool		_mapped;
+	};
+
+	// Key is "section.name" when the section is not empty
+	struct entry
+	{
+		const char*		_section;
+		const char*		_name;
+		const char*		_value;
+		std::uint32_t		_section_size;
+		std::uint32_t		_name_size;
+		std::uint32_t		_value_size;
+		std::uint32_t		_hash;
+		mutable bool		_typed;
+		bool			_quoted;	// typed as a string
+		mutable variable	_variable;
+	};
+
+	// Append the entries of a block, throws if the block is malformed
+	static void split(
+		const block&		/*block*/,
+		format			/*format*/,
+		const std::string&	/*source*/,
+		std::vector<entry>&	/*out*/);
+
+	void add(const block& /*block*/, format /*format*/, const std::string& /*source*/);
+	void insert(index_type /*entry*/);
+
+	// Slot of the key, or the empty slot where it belongs
+	size_type lookup(const char* /*key*/, size_type /*size*/, std::uint32_t /*hash*/) const noexcept;
+	void rehash(size_type /*slots*/);
+
+	const variable& value(const entry& /*entry*/) const;
+
+	void release() noexcept;
+
+private:
+
+	std::vector<block>		_blocks;
+	std::vector<entry>		_entries;
+
+	// Open addressing key -> entry, a power of two at most half full
+	std::vector<index_type>		_slots;
+	size_type			_count;
+};
+
+} // End of egg namespace
+
+#endif  // EGG_SETTINGS
+
+/* End of file */
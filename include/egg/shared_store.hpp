@@ -0,0 +1,166 @@
+/*!
+ *	\file		shared_store.hpp
+ *	\brief		Declares variable store in POSIX shared memory
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_SHARED_STORE
+#define EGG_SHARED_STORE
+
+#include <string>
+#include <vector>
+
+#include <egg/variable.hpp>
+#include <egg/binary.hpp>
+
+
+namespace egg
+{
+
+// Fixed-capacity map of variables in a POSIX shared memory segment, shared
+// by the processes on a host. Every slot holds the key and the value in the
+// binary encoding (see binary.hpp), which has no pointers, so the segment may
+// be mapped at any address. Keys are inserted once and never move, the value
+// of each slot is guarded by a sequence lock: writers of different processes
+// take the slot by making the sequence odd, readers copy the value and retry
+// if the sequence changed meanwhile. Readers never block writers and take
+// no lock. Keys and values larger than the slot limits are rejected. A
+// process that dies inside a write leaves its slot locked.
+struct EGG_PUBLIC shared_store
+{
+	typedef std::size_t size_type;
+
+	// Geometry, fixed when the segment is created
+	struct options
+	{
+		options() noexcept : _capacity(1024), _key_bytes(64), _value_bytes(256) {}
+
+		size_type	_capacity;	// slots, rounded up to a power of two
+		size_type	_key_bytes;	// encoded key limit
+		size_type	_value_bytes;	// encoded value limit
+	};
+
+	/// Nothing mapped
+	shared_store() noexcept;
+	~shared_store() noexcept;
+
+	shared_store(const shared_store&) = delete;
+	shared_store& operator=(const shared_store&) = delete;
+
+	// Move
+	shared_store(shared_store&& /*other*/) noexcept;
+	shared_store& operator=(shared_store&& /*other*/) noexcept;
+
+	// Open the segment, creating it if nobody did. An existing segment must
+	// have the same geometry. Names get a leading slash if they have none.
+	// Throw std::runtime_error on system errors and mismatches
+	static shared_store create(const std::string& /*name*/, const options& /*geometry*/ = options());
+	static shared_store open(const std::string& /*name*/);
+
+	// Remove the name. Mappings stay valid until they are closed
+	static bool remove(const std::string& /*name*/) noexcept;
+
+	void close() noexcept;
+	bool is_open() const noexcept		{ return _base != nullptr;	}
+
+	// Store the value. Throws std::length_error if the key or the value
+	// don't fit a slot or the store is full
+	void set(const variable& /*key*/, const variable& /*value*/);
+
+	// Add to an integer value, an empty or missing value counts as 0.
+	// Atomic across processes. Throws std::invalid_argument if the value is
+	// not an integer and std::overflow_error if the sum does not fit int64,
+	// the value is left as it was
+	std::int64_t add(const variable& /*key*/, std::int64_t /*delta*/);
+
+	// Make the value empty. The key keeps its slot
+	bool erase(const variable& /*key*/);
+
+	// Consistent copy of the value. False if the key is missing
+	bool get(const variable& /*key*/, variable& /*value*/) const;
+
+	// Empty if the key is missing
+	variable get(const variable& /*key*/) const;
+
+	// Call f(const variable_view&) with a consistent copy of the encoded
+	// value on the stack, nothing is allocated for values up to 512 bytes.
+	// False if the key is missing
+	template <typename F>
+	bool read(const variable& /*key*/, F /*f*/) const;
+
+	// Keys stored, slots, slot limits
+	size_type size() const noexcept;
+	size_type capacity() const noexcept;
+	size_type key_bytes() const noexcept;
+	size_type value_bytes() const noexcept;
+
+private:
+
+	struct header;
+	struct slot;
+
+	static shared_store attach(const std::string& /*name*/, const options* /*geometry*/);
+
+	slot* at(size_type /*index*/) const noexcept;
+
+	// Slot of the key, nullptr if it is missing (find) or the store is full
+	slot* find(const std::uint8_t* /*key*/, size_type /*size*/) const noexcept;
+	slot* insert(const std::uint8_t* /*key*/, size_type /*size*/);
+
+	// Encoded key into the buffer, throws if it doesn't fit a slot
+	size_type key(const variable& /*key*/, std::uint8_t* /*buffer*/) const;
+
+	// Copy the value under the sequence lock, returns the size
+	size_type fetch(const slot& /*slot*/, std::uint8_t* /*buffer*/) const noexcept;
+
+	// Copy of the value into the buffer, 0 if the key is missing
+	size_type fetch(const variable& /*key*/, std::uint8_t* /*buffer*/) const;
+
+	// Sequence lock of a writer
+	static std::uint32_t lock(slot& /*slot*/) noexcept;
+	static void unlock(slot& /*slot*/, std::uint32_t /*sequence*/) noexcept;
+
+private:
+
+	std::uint8_t*	_base;
+	std::size_t	_size;
+	header*		_header;
+};
+
+template <typename F>
+inline bool
+shared_store::read(
+    const variable& k,
+    F               f) const
+{
+  const size_type limit = value_bytes();
+  std::uint8_t small[512];
+  std::vector<std::uint8_t> large;
+  std::uint8_t* buffer = small;
+
+  if (limit > sizeof(small))
+  {
+    large.resize(limit);
+    buffer = large.data();
+  }
+
+  const size_type n = fetch(k, buffer);
+
+  if (n == 0)
+    return false;
+
+  variable_view v;
+  decode(buffer, n, v);
+  f(static_cast<const variable_view&>(v));
+
+  return true;
+}
+
+} // End of egg namespace
+
+#endif  // EGG_SHARED_STORE
+
+/* End of file */
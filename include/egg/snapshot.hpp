@@ -0,0 +1,206 @@
+/*!
+ *	\file		snapshot.hpp
+ *	\brief		Declares registry of versioned immutable snapshots
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_SNAPSHOT
+#define EGG_SNAPSHOT
+
+#include <map>
+#include <atomic>
+#include <utility>
+
+#include <egg/variable.hpp>
+#include <egg/epoch.hpp>
+
+
+namespace egg
+{
+
+// Read-copy-update registry of a whole configuration. The current version is
+// an immutable object behind one atomic pointer. A reader pins the epoch and
+// reads the pointer, so taking a snapshot costs a couple of atomic operations
+// and never waits. A writer builds a new version aside and publishes it with
+// one compare-and-swap; the old version is deleted through the epoch domain
+// once no snapshot can still see it. Hold snapshots briefly: while one is
+// held, nothing retired after it was taken can be reclaimed.
+template <typename T = std::map<variable, variable>>
+struct snapshot_registry
+{
+	typedef T value_type;
+
+private:
+
+	struct version_data
+	{
+		T		_value;
+		std::uint64_t	_version;
+	};
+
+public:
+
+	// Pinned view of one version. Move-only, release it on the same thread
+	struct snapshot
+	{
+		const T& operator*() const noexcept	{ return _data->_value;		}
+		const T* operator->() const noexcept	{ return &_data->_value;	}
+		const T& get() const noexcept		{ return _data->_value;		}
+
+		std::uint64_t version() const noexcept	{ return _data->_version;	}
+
+	private:
+
+		friend struct snapshot_registry;
+
+		snapshot(epoch_domain& d, const std::atomic<const version_data*>& current)
+		  : _guard(d),
+		    _data(current.load(std::memory_order_seq_cst))
+		{}
+
+		epoch_domain::guard	_guard;
+		const version_data*	_data;
+	};
+
+	/// Registry with the first version
+	explicit snapshot_registry(
+		T		/*initial*/ = T(),
+		epoch_domain&	/*domain*/ = epoch_domain::global());
+
+	~snapshot_registry() noexcept;
+
+	snapshot_registry(const snapshot_registry&) = delete;
+	snapshot_registry& operator=(const snapshot_registry&) = delete;
+
+	// Current version
+	snapshot acquire() const				{ return snapshot(*_domain, _current);	}
+
+	// Call f(const T&) on the current version, returns what f returns
+	template <typename F>
+	auto read(F f) const -> decltype(f(std::declval<const T&>()));
+
+	// Publish a new version, returns its number
+	std::uint64_t publish(T /*value*/);
+
+	// Copy the current version, let f(T&) change the copy and publish it.
+	// Retried if another writer published in between. Returns the number
+	template <typename F>
+	std::uint64_t update(F /*f*/);
+
+	std::uint64_t version() const;
+
+private:
+
+	std::uint64_t install(version_data* /*next*/);
+
+private:
+
+	std::atomic<const version_data*>	_current;
+	epoch_domain*				_domain;
+};
+
+template <typename T>
+inline
+snapshot_registry<T>::snapshot_registry(
+    T             initial,
+    epoch_domain& d)
+  : _current(new version_data { std::move(initial), 1 }),
+    _domain(&d)
+{}
+
+template <typename T>
+inline
+snapshot_registry<T>::~snapshot_registry() noexcept
+{
+  delete _current.load(std::memory_order_acquire);
+}
+
+template <typename T>
+template <typename F>
+inline auto
+snapshot_registry<T>::read(
+    F f) const -> decltype(f(std::declval<const T&>()))
+{
+  const snapshot s = acquire();
+  return f(*s);
+}
+
+template <typename T>
+inline std::uint64_t
+snapshot_registry<T>::install(
+    version_data* next)
+{
+  epoch_domain::guard g(*_domain);
+
+  const version_data* current = _current.load(std::memory_order_seq_cst);
+  std::uint64_t result;
+
+  do
+    next->_version = result = current->_version + 1;
+  while (!_current.compare_exchange_weak(current, next, std::memory_order_seq_cst));
+
+  _domain->retire(const_cast<version_data*>(current));
+
+  return result;
+}
+
+template <typename T>
+inline std::uint64_t
+snapshot_registry<T>::publish(
+    T value)
+{
+  return install(new version_data { std::move(value), 0 });
+}
+
+template <typename T>
+template <typename F>
+inline std::uint64_t
+snapshot_registry<T>::update(
+    F f)
+{
+  // The guard keeps the base alive, so its address can't be reused and
+  // the compare-and-swap below can't succeed over a different version
+  epoch_domain::guard g(*_domain);
+
+  for (;;)
+  {
+    const version_data* base = _current.load(std::memory_order_seq_cst);
+    const std::uint64_t result = base->_version + 1;
+    version_data* next = new version_data { base->_value, result };
+
+    try
+    {
+      f(next->_value);
+    }
+    catch (...)
+    {
+      delete next;
+      throw;
+    }
+
+    // Publish only over the version the copy was made of
+    if (_current.compare_exchange_strong(base, next, std::memory_order_seq_cst))
+    {
+      _domain->retire(const_cast<version_data*>(base));
+      return result;
+    }
+
+    delete next;
+  }
+}
+
+template <typename T>
+inline std::uint64_t
+snapshot_registry<T>::version() const
+{
+  return acquire().version();
+}
+
+} // End of egg namespace
+
+#endif  // EGG_SNAPSHOT
+
+/* End of file */
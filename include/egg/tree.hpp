@@ -0,0 +1,395 @@
+/*!
+ *	\file		tree.hpp
+ *	\brief		Declares arena-backed hierarchical tree of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_TREE
+#define EGG_TREE
+
+#include <vector>
+#include <iterator>
+
+#include <egg/variable.hpp>
+#include <egg/variable_hash_map.hpp>
+
+
+namespace egg
+{
+
+// Hierarchical repository of variables, e.g. tree["cmd"]["log"]["level"] = 9.
+// All nodes live in one contiguous arena and refer to each other by index.
+// Keys are interned once per tree, a child is found through a single flat
+// index keyed by (parent, key id). Children keep the insertion order.
+struct EGG_PUBLIC tree
+{
+	typedef std::uint32_t index_type;
+	typedef std::size_t size_type;
+
+	static const index_type npos = static_cast<index_type>(-1);
+
+	struct node;
+	struct const_node;
+
+	// Iterator over children of a node
+	template <typename N>
+	struct basic_iterator
+	{
+		typedef std::forward_iterator_tag iterator_category;
+		typedef N value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const N* pointer;
+		typedef N reference;
+
+		basic_iterator() noexcept : _node() {}
+		explicit basic_iterator(const N& n) noexcept : _node(n) {}
+
+		// Rebind the handle, node::operator= would copy the value
+		basic_iterator(const basic_iterator& /*other*/) noexcept = default;
+		basic_iterator& operator=(const basic_iterator& o) noexcept
+		{
+		  _node._tree = o._node._tree;
+		  _node._index = o._node._index;
+		  return *this;
+		}
+
+		N operator*() const noexcept		{ return _node;		}
+		const N* operator->() const noexcept	{ return &_node;	}
+
+		basic_iterator& operator++() noexcept	{ _node._index = _node.next()._index; return *this; }
+
+		basic_iterator operator++(int) noexcept
+		{
+		  basic_iterator result(*this);
+		  ++*this;
+		  return result;
+		}
+
+		bool operator==(const basic_iterator& o) const noexcept { return _node._index == o._node._index; }
+		bool operator!=(const basic_iterator& o) const noexcept { return _node._index != o._node._index; }
+
+	private:
+
+		N	_node;
+	};
+
+	// Read-only handle of a node. Stays valid while the node exists
+	struct EGG_PUBLIC const_node
+	{
+		typedef basic_iterator<const_node> iterator;
+
+		const_node() noexcept : _tree(nullptr), _index(npos) {}
+
+		bool valid() const noexcept		{ return _index != npos;	}
+		explicit operator bool() const noexcept	{ return valid();		}
+		index_type index() const noexcept	{ return _index;		}
+
+		const variable& key() const noexcept;
+		const variable& value() const noexcept;
+
+		// Children
+		size_type size() const noexcept;
+		bool empty() const noexcept		{ return size() == 0;	}
+
+		const_node find(const variable& /*key*/) const noexcept;
+		const_node operator[] (const variable& k) const noexcept { return find(k); }
+
+		iterator begin() const noexcept;
+		iterator end() const noexcept		{ return iterator();	}
+
+		const_node parent() const noexcept;
+		const_node next() const noexcept;
+
+	private:
+
+		friend struct tree;
+		template <typename N> friend struct basic_iterator;
+
+		const_node(const tree* t, index_type i) noexcept : _tree(t), _index(i) {}
+
+		const tree*	_tree;
+		index_type	_index;
+	};
+
+	// Mutable handle of a node
+	struct EGG_PUBLIC node
+	{
+		typedef basic_iterator<node> iterator;
+
+		node() noexcept : _tree(nullptr), _index(npos) {}
+
+		operator const_node() const noexcept	{ return const_node(_tree, _index); }
+
+		bool valid() const noexcept		{ return _index != npos;	}
+		explicit operator bool() const noexcept	{ return valid();		}
+		index_type index() const noexcept	{ return _index;		}
+
+		const variable& key() const noexcept;
+		const variable& value() const noexcept;
+
+		// Handles behave like references, d["a"] = d["b"] copies the value
+		node(const node& /*other*/) noexcept = default;
+		node& operator=(const node& other)	{ return *this = other.value(); }
+
+		// Replace the value
+		node& operator=(const variable& /*value*/);
+		node& operator=(variable&& /*value*/);
+
+		// Children
+		size_type size() const noexcept;
+		bool empty() const noexcept		{ return size() == 0;	}
+
+		node find(const variable& /*key*/) const noexcept;
+
+		// Child with the key, created empty if it is missing
+		node operator[] (const variable& /*key*/);
+
+		// Remove the child with the key and its subtree.
+		// Returns the number of removed nodes
+		size_type erase(const variable& /*key*/) noexcept;
+
+		iterator begin() const noexcept;
+		iterator end() const noexcept		{ return iterator();	}
+
+		node parent() const noexcept;
+		node next() const noexcept;
+
+	private:
+
+		friend struct tree;
+		template <typename N> friend struct basic_iterator;
+
+		node(tree* t, index_type i) noexcept : _tree(t), _index(i) {}
+
+		tree*		_tree;
+		index_type	_index;
+	};
+
+	/// An empty tree (root node only)
+	tree();
+	~tree() noexcept;
+
+	// Copy
+	tree(const tree& /*other*/);
+	tree& operator=(const tree& /*other*/);
+
+	// Move. The moved-from tree may only be assigned or destroyed
+	tree(tree&& /*other*/) noexcept;
+	tree& operator=(tree&& /*other*/) noexcept;
+
+	// Root has an empty key and an empty value
+	node root() noexcept			{ return node(this, 0);		}
+	const_node root() const noexcept	{ return const_node(this, 0);	}
+
+	node operator[] (const variable& k)			{ return root()[k];		}
+	const_node operator[] (const variable& k) const noexcept	{ return root().find(k);	}
+
+	// Live nodes, without the root
+	size_type size() const noexcept;
+	bool empty() const noexcept;
+
+	// Distinct keys interned so far
+	size_type keys() const noexcept;
+
+	void reserve(size_type /*nodes*/);
+	void clear();
+
+	// Rebuild the arena without the erased nodes, in depth-first order.
+	// Invalidates all handles
+	void compact();
+
+	// Changes whenever nodes are added or removed. Stamps are unique across
+	// all trees, a copy shares the stamp while its structure is the same
+	std::uint64_t generation() const noexcept	{ return _generation;	}
+
+	// Interned key id, npos if the key never was used in this tree
+	index_type key_id(const variable& /*key*/) const noexcept;
+
+	// Child of the parent with the interned key, npos if there is none
+	index_type child(index_type /*parent*/, index_type /*key_id*/) const noexcept;
+
+private:
+
+	friend struct path;
+
+	struct node_data
+	{
+		index_type	_key;		// interned key id
+		index_type	_parent;
+		index_type	_first;		// first child
+		index_type	_last;		// last child
+		index_type	_next;		// next sibling
+		index_type	_children;	// number of children
+		variable	_value;
+	};
+
+	// Flat (parent, key id) -> node index
+	struct link
+	{
+		index_type	_parent;
+		index_type	_key;
+		index_type	_node;
+	};
+
+	node handle(index_type i) noexcept			{ return node(this, i);		}
+	const_node handle(index_type i) const noexcept	{ return const_node(this, i);	}
+
+	index_type intern(const variable& /*key*/);
+	index_type add(index_type /*parent*/, index_type /*key_id*/);
+	size_type remove(index_type /*parent*/, index_type /*key_id*/) noexcept;
+
+	void link_insert(index_type /*parent*/, index_type /*key_id*/, index_type /*node*/);
+	void link_erase(index_type /*parent*/, index_type /*key_id*/) noexcept;
+	void link_rehash(size_type /*capacity*/);
+
+	static std::size_t link_hash(index_type /*parent*/, index_type /*key_id*/) noexcept;
+
+private:
+
+	std::vector<node_data>		_nodes;
+	std::vector<variable>		_keys;
+	variable_hash_map<index_type>	_key_ids;
+
+	std::vector<link>		_links;
+	size_type			_link_count;
+	size_type			_link_deleted;
+
+	size_type			_size;
+	std::uint64_t			_generation;
+};
+
+// Const node
+inline const variable&
+tree::const_node::key() const noexcept
+{
+  return _tree->_keys[_tree->_nodes[_index]._key];
+}
+
+inline const variable&
+tree::const_node::value() const noexcept
+{
+  return _tree->_nodes[_index]._value;
+}
+
+inline tree::size_type
+tree::const_node::size() const noexcept
+{
+  return _tree->_nodes[_index]._children;
+}
+
+inline tree::const_node
+tree::const_node::find(const variable& k) const noexcept
+{
+  if (_index == npos)
+    return const_node();
+
+  const index_type id = _tree->key_id(k);
+
+  return const_node(_tree, id == npos ? npos : _tree->child(_index, id));
+}
+
+inline tree::const_node::iterator
+tree::const_node::begin() const noexcept
+{
+  return iterator(const_node(_tree, _tree->_nodes[_index]._first));
+}
+
+inline tree::const_node
+tree::const_node::parent() const noexcept
+{
+  return const_node(_tree, _tree->_nodes[_index]._parent);
+}
+
+inline tree::const_node
+tree::const_node::next() const noexcept
+{
+  return const_node(_tree, _tree->_nodes[_index]._next);
+}
+
+// Node
+inline const variable&
+tree::node::key() const noexcept
+{
+  return _tree->_keys[_tree->_nodes[_index]._key];
+}
+
+inline const variable&
+tree::node::value() const noexcept
+{
+  return _tree->_nodes[_index]._value;
+}
+
+inline tree::node&
+tree::node::operator=(const variable& v)
+{
+  _tree->_nodes[_index]._value = v;
+  return *this;
+}
+
+inline tree::node&
+tree::node::operator=(variable&& v)
+{
+  _tree->_nodes[_index]._value = std::move(v);
+  return *this;
+}
+
+inline tree::size_type
+tree::node::size() const noexcept
+{
+  return _tree->_nodes[_index]._children;
+}
+
+inline tree::node
+tree::node::find(const variable& k) const noexcept
+{
+  if (_index == npos)
+    return node();
+
+  const index_type id = _tree->key_id(k);
+
+  return node(_tree, id == npos ? npos : _tree->child(_index, id));
+}
+
+inline tree::node
+tree::node::operator[] (const variable& k)
+{
+  const index_type id = _tree->intern(k);
+  const index_type c = _tree->child(_index, id);
+
+  return node(_tree, c != npos ? c : _tree->add(_index, id));
+}
+
+inline tree::size_type
+tree::node::erase(const variable& k) noexcept
+{
+  const index_type id = _tree->key_id(k);
+
+  return id == npos ? 0 : _tree->remove(_index, id);
+}
+
+inline tree::node::iterator
+tree::node::begin() const noexcept
+{
+  return iterator(node(_tree, _tree->_nodes[_index]._first));
+}
+
+inline tree::node
+tree::node::parent() const noexcept
+{
+  return node(_tree, _tree->_nodes[_index]._parent);
+}
+
+inline tree::node
+tree::node::next() const noexcept
+{
+  return node(_tree, _tree->_nodes[_index]._next);
+}
+
+} // End of egg namespace
+
+#endif  // EGG_TREE
+
+/* End of file */
@@ -0,0 +1,190 @@
+/*!
+ *	\file		usage.hpp
+ *	\brief		Declares DocOpt-style command line parser
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_USAGE
+#define EGG_USAGE
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <egg/variable.hpp>
+#include <egg/variable_hash_map.hpp>
+
+
+namespace egg
+{
+
+// Command line parser driven by the help text, as DocOpt does it:
+//
+//	Usage:
+//	  daemon [options] <file>...
+//	  daemon serve [--port=<n>] [-v | -q]
+//
+//	Options:
+//	  -h --help        Show this text.
+//	  -p --port=<n>    Port to listen on [default: 8080].
+//	  -I <dir>         Include directory.
+//
+// Patterns know commands, <arguments> or ARGUMENTS, -s and --long options,
+// [optional] and (required) groups, alternatives a | b, repetition with ...
+// and [options] for every option of the Options section. The text is
+// compiled once, parse() then only matches argv against the patterns.
+// Result names are the command, "<file>", "--port" (long name if any)
+// with these values:
+//	command, flag		bool, count (int64) if repeated
+//	option argument		value, string list if repeated
+//	positional		value, string list if repeated
+// Values that are whole integers or reals become int64 or double, unless
+// typing is off. Options that are not given get their default, flags false.
+// Arguments like -2.5 are positional unless a -2 option exists.
+struct EGG_PUBLIC usage
+{
+	typedef std::size_t size_type;
+	typedef std::uint32_t index_type;
+
+	static const index_type npos = static_cast<index_type>(-1);
+
+	// Result of parse(). Refers to its usage, which must outlive it
+	struct EGG_PUBLIC arguments
+	{
+		// Value of a name of the patterns, throws std::out_of_range for
+		// unknown names
+		const variable& operator[] (const std::string& /*name*/) const;
+
+		// nullptr for unknown names
+		const variable* find(const std::string& /*name*/) const noexcept;
+
+		// Argument text of every occurrence: pointers into argv, nothing
+		// is copied. Empty for flags and commands
+		std::vector<const char*> raw(const std::string& /*name*/) const;
+
+		// All names and values
+		std::map<variable, variable> to_map() const;
+
+		size_type size() const noexcept		{ return _values.size();	}
+
+	private:
+
+		friend struct usage;
+
+		const usage*					_usage;
+		std::vector<variable>				_values;	// by name id
+		std::vector<std::pair<index_type, const char*>>	_raw;
+	};
+
+	// Compile the help text. Throws std::invalid_argument if it has no
+	// usage section or a pattern is malformed
+	explicit usage(const std::string& /*doc*/, bool /*typed*/ = true);
+	~usage() noexcept;
+
+	// Match the arguments after argv[0]. Throws std::invalid_argument
+	// on unknown options, missing option arguments and when no pattern
+	// matches
+	arguments parse(int /*argc*/, const char* const /*argv*/[]) const;
+	arguments parse(const std::vector<const char*>& /*argv*/) const;
+
+	// The usage section, for error messages
+	const std::string& text() const noexcept	{ return _text;		}
+
+	// Names of the patterns
+	size_type names() const noexcept		{ return _names.size();	}
+
+private:
+
+	enum class kind : std::uint8_t
+	{
+		required,
+		optional,
+		either,
+		one_or_more,
+		options,	// [options]
+		argument,
+		command,
+		option
+	};
+
+	// Pattern tree in one array, children of a node are contiguous in
+	// _children
+	struct node
+	{
+		kind		_kind;
+		index_type	_name;		// leaves
+		index_type	_first;		// groups
+		index_type	_count;
+	};
+
+	struct option
+	{
+		std::string	_short;		// "-p"
+		std::string	_long;		// "--port"
+		bool		_argument;
+		bool		_has_default;
+		std::string	_default;
+		index_type	_name;
+	};
+
+	struct name
+	{
+		std::string	_text;
+		kind		_kind;		// argument, command or option
+		bool		_repeated;
+		index_type	_option;
+	};
+
+	// Option (or npos for a positional) and its text
+	struct token
+	{
+		index_type	_option;
+		const char*	_text;
+	};
+
+	struct state;
+
+	// Compile
+	void parse_options(const std::string& /*doc*/);
+	index_type option_of(const std::string& /*text*/, bool /*long_name*/, bool /*argument*/);
+	index_type name_of(const std::string& /*text*/, kind /*kind*/, index_type /*option*/);
+	index_type add(kind /*kind*/, index_type /*name*/, const std::vector<index_type>& /*children*/);
+
+	index_type expression(const std::vector<std::string>& /*words*/, size_type& /*at*/);
+	index_type sequence(const std::vector<std::string>& /*words*/, size_type& /*at*/);
+	void atom(const std::vector<std::string>& /*words*/, size_type& /*at*/, std::vector<index_type>& /*out*/);
+
+	void count(index_type /*node*/, std::vector<int>& /*seen*/, int /*weight*/) const;
+	void shortcuts(index_type /*node*/, const std::vector<int>& /*seen*/, index_type /*leaves*/);
+
+	// Parse
+	index_type find_option(const char* /*text*/, size_type /*size*/, bool /*long_name*/) const;
+	void tokenize(int /*argc*/, const char* const /*argv*/[], std::vector<token>& /*out*/) const;
+	bool match(index_type /*node*/, state& /*state*/) const;
+	variable typed(const char* /*text*/) const;
+
+private:
+
+	std::string			_text;
+	bool				_typed;
+
+	std::vector<node>		_nodes;
+	std::vector<index_type>		_children;
+	index_type			_root;
+
+	std::vector<option>		_options;
+	std::vector<name>		_names;
+
+	// Sorted "-p" and "--port" spellings for the argv scan
+	std::vector<std::pair<std::string, index_type>>	_spellings;
+	variable_hash_map<index_type>			_name_ids;
+};
+
+} // End of egg namespace
+
+#endif  // EGG_USAGE
+
+/* End of file */
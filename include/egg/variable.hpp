@@ -13,6 +13,9 @@
 #include <string>
 #include <vector>
 #include <ostream>
+#include <memory>
+#include <utility>
+#include <initializer_list>
 
 #include <egg/common.hpp>
 
@@ -49,12 +52,59 @@ struct EGG_PUBLIC variable
 		is_string	= 13,
 		is_string_list	= 14,
 
+		is_int32_array	= 15,
+		is_int64_array	= 16,
+		is_uint64_array	= 17,
+		is_double_array	= 18,
+		is_blob		= 19,
+
+		is_list		= 20,
+		is_map		= 21,
+
+		is_string_rope	= 22,
+
+		is_compact_string_list = 23,
+
 		first		= is_empty,
-		last		= is_string_list + 1
+		last		= is_compact_string_list + 1
 	};
 
 	typedef std::vector<std::string> stringlist;
 
+	// Nested values, the children of both are contiguous
+	typedef std::vector<variable> list;
+	struct map;
+
+	// String list for millions of entries, see below
+	struct string_rope;
+
+	// Front coded string list for entries with long shared prefixes
+	struct compact_string_list;
+
+	// Read-only view of an array payload, valid while the variable is
+	// neither changed nor destroyed
+	template <typename T>
+	struct array_view
+	{
+		array_view() noexcept : _data(nullptr), _size(0) {}
+		array_view(const T* d, std::size_t s) noexcept : _data(d), _size(s) {}
+
+		const T* data() const noexcept			{ return _data;			}
+		std::size_t size() const noexcept		{ return _size;			}
+		bool empty() const noexcept			{ return _size == 0;		}
+
+		const T* begin() const noexcept			{ return _data;			}
+		const T* end() const noexcept			{ return _data + _size;		}
+		const T& operator[] (std::size_t i) const noexcept { return _data[i];		}
+
+		std::vector<T> to_vector() const		{ return std::vector<T>(begin(), end()); }
+
+	private:
+
+		const T*	_data;
+		std::size_t	_size;
+	};
+
 	/// An empty value
 	variable() noexcept;
 	virtual ~variable() noexcept;
@@ -87,6 +137,34 @@ struct EGG_PUBLIC variable
 	variable(const std::string&	/*value*/);
 	variable(const stringlist&	/*value*/);
 
+	// Arrays, the elements in one allocation aligned to 16 bytes
+	variable(const std::vector<std::int32_t>&	/*value*/);
+	variable(const std::vector<std::int64_t>&	/*value*/);
+	variable(const std::vector<std::uint64_t>&	/*value*/);
+	variable(const std::vector<double>&		/*value*/);
+
+	// Blob of raw bytes
+	variable(const std::vector<std::uint8_t>&	/*value*/);
+
+	// Same from raw memory
+	static variable array(const std::int32_t*	/*data*/, std::size_t /*size*/);
+	static variable array(const std::int64_t*	/*data*/, std::size_t /*size*/);
+	static variable array(const std::uint64_t*	/*data*/, std::size_t /*size*/);
+	static variable array(const double*		/*data*/, std::size_t /*size*/);
+	static variable blob(const void*		/*data*/, std::size_t /*size*/);
+
+	// Lists and maps of any values, nested as deep as needed
+	variable(const list&		/*value*/);
+	variable(list&&			/*value*/);
+	variable(const map&		/*value*/);
+	variable(map&&			/*value*/);
+
+	variable(const string_rope&	/*value*/);
+	variable(string_rope&&		/*value*/);
+
+	variable(const compact_string_list&	/*value*/);
+	variable(compact_string_list&&		/*value*/);
+
 	// Checkers
 	bool is_empty() const noexcept;
 	explicit operator bool() const;
@@ -117,17 +195,58 @@ struct EGG_PUBLIC variable
 	const std::string&  as_string() const;
 	const stringlist&   as_string_list() const;
 
+	// Arrays and blobs are viewed in place, nothing is copied
+	array_view<std::int32_t>  as_int32_array() const;
+	array_view<std::int64_t>  as_int64_array() const;
+	array_view<std::uint64_t> as_uint64_array() const;
+	array_view<double>        as_double_array() const;
+	array_view<std::uint8_t>  as_blob() const;
+
+	const list&         as_list() const;
+	const map&          as_map() const;
+	const string_rope&  as_string_rope() const;
+	const compact_string_list& as_compact_string_list() const;
+
+	// Append to a string rope in O(1), the hash is updated, not recomputed.
+	// An empty value becomes a rope. Throws std::invalid_argument for other
+	// types
+	void append(const std::string& /*value*/);
+
+	// Membership of a string list. The first query of a list longer than a
+	// few entries builds an index, later ones are a hash probe. Copies share
+	// the index, assigning new entries drops it. Throws std::invalid_argument
+	// for other types
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+	bool contains(const std::string& /*value*/) const;
+
+	// Position of the first entry equal to value, npos if there is none
+	std::size_t find(const std::string& /*value*/) const;
+
 	// Hashing
 	std::uint32_t hash() const noexcept;
 
-	// equality is based on hash-equality
-	bool operator == (const variable&) noexcept;
-	bool operator != (const variable&) noexcept;
+	// Hash a string value would have, without building the variable
+	static std::uint32_t hash_of(const std::string& /*value*/) noexcept;
+
+	// equality is based on hash-equality: values with different cached
+	// hashes are rejected before the deep comparison
+	bool operator == (const variable&) const noexcept;
+	bool operator != (const variable&) const noexcept;
 
 	// To string
 	std::string to_string() const;
 	const std::string& to_type_string() const noexcept;
 
+	// Same text as to_string(), streamed. Ropes and compact lists are
+	// written entry by entry
+	void write(std::ostream& /*out*/) const;
+
+	// Bytes of the variable and of the heap it owns. Parts shared between
+	// copies, the chunks of a rope or the index of a string list, are
+	// counted in full
+	std::size_t memory_usage() const noexcept;
+
 	// Reset
 	void reset() noexcept;
 
@@ -170,6 +289,12 @@ private:
 
 	EGG_PRIVATE void __rehash();
 
+	template <typename T>
+	EGG_PRIVATE array_view<T> view(content /*expected*/) const;
+
+	// Raw access for the containers and kernels of the library
+	friend struct variable_access;
+
 private:
 
 	content		_type;
@@ -177,6 +302,160 @@ private:
 	std::uint32_t	_hash;
 };
 
+// Payload of is_map: a flat map, the entries sorted by the cached hash of
+// their keys in one vector. Lookups are a binary search on the hashes and a
+// deep comparison of the keys that share the hash. Inserting in the middle
+// moves the entries after it, build large maps from a vector instead.
+struct EGG_PUBLIC variable::map
+{
+	typedef std::pair<variable, variable> value_type;
+	typedef std::vector<value_type>::const_iterator const_iterator;
+	typedef std::size_t size_type;
+
+	/// No entries
+	map() noexcept;
+
+	// Later entries replace earlier ones with the same key
+	map(std::initializer_list<value_type> /*entries*/);
+	explicit map(std::vector<value_type> /*entries*/);
+
+	// Value of the key, inserted empty if the key is missing
+	variable& operator[] (const variable& /*key*/);
+
+	// Returns true if the key was inserted, false if it was replaced
+	bool insert_or_assign(const variable& /*key*/, variable /*value*/);
+
+	// Returns the number of removed entries
+	size_type erase(const variable& /*key*/);
+
+	// nullptr if the key is missing
+	const variable* find(const variable& /*key*/) const noexcept;
+	bool contains(const variable& k) const noexcept		{ return find(k) != nullptr;	}
+
+	// Throws std::out_of_range if the key is missing
+	const variable& at(const variable& /*key*/) const;
+
+	size_type size() const noexcept				{ return _entries.size();	}
+	bool empty() const noexcept				{ return _entries.empty();	}
+	void reserve(size_type n)				{ _entries.reserve(n);		}
+	void clear() noexcept					{ _entries.clear();		}
+
+	const_iterator begin() const noexcept			{ return _entries.begin();	}
+	const_iterator end() const noexcept			{ return _entries.end();	}
+
+	// Same keys with equal values, in any order
+	bool operator == (const map& /*other*/) const noexcept;
+	bool operator != (const map& o) const noexcept		{ return !(*this == o);		}
+
+private:
+
+	// First entry of the key hash, the position of the key or of its run end
+	size_type position(const variable& /*key*/, bool& /*found*/) const noexcept;
+
+	std::vector<value_type>	_entries;
+};
+
+// Payload of is_string_rope: a string list in chunks of chunk_size entries.
+// Chunks are shared between copies, so a copy takes a pointer per chunk,
+// not per string. Only the last chunk may be partly filled; push_back()
+// copies it first if another rope shares it. The hash is folded entry by
+// entry as they are appended. Ropes and string lists with the same entries
+// are different values.
+struct EGG_PUBLIC variable::string_rope
+{
+	typedef std::size_t size_type;
+
+	static const size_type chunk_size = 1024;
+
+	/// No entries
+	string_rope() noexcept;
+	explicit string_rope(const stringlist& /*entries*/);
+
+	void push_back(const std::string& /*value*/);
+
+	size_type size() const noexcept			{ return _size;			}
+	bool empty() const noexcept			{ return _size == 0;		}
+	size_type chunks() const noexcept		{ return _chunks.size();	}
+
+	const std::string& operator[] (size_type i) const noexcept
+	{
+		return (*_chunks[i / chunk_size])[i % chunk_size];
+	}
+
+	// Call f(const std::string&) for every entry, in order
+	template <typename F>
+	void each(F /*f*/) const;
+
+	stringlist to_string_list() const;
+
+	std::uint32_t hash() const noexcept;
+
+	// Shared chunks are not compared
+	bool operator == (const string_rope& /*other*/) const noexcept;
+	bool operator != (const string_rope& o) const noexcept	{ return !(*this == o);		}
+
+private:
+
+	std::vector<std::shared_ptr<stringlist>>	_chunks;
+	size_type					_size;
+	std::uint32_t					_state;		// hash of the entries so far
+};
+
+// Payload of is_compact_string_list: a string list front coded in blocks of
+// block_size entries. The first entry of a block is kept whole, the others
+// as the length of the prefix shared with the entry before, then the rest.
+// Sorted paths and host names shrink to a fraction of a stringlist, one
+// allocation holds them all. operator[] decodes from the start of the block,
+// each() walks the entries with one buffer. Compact lists and string lists
+// with the same entries are different values.
+struct EGG_PUBLIC variable::compact_string_list
+{
+	typedef std::size_t size_type;
+
+	static const size_type block_size = 16;
+
+	/// No entries
+	compact_string_list() noexcept;
+	explicit compact_string_list(const stringlist& /*entries*/);
+
+	void push_back(const std::string& /*value*/);
+
+	// Drop the spare capacity push_back() leaves
+	void shrink_to_fit();
+
+	size_type size() const noexcept			{ return _size;			}
+	bool empty() const noexcept			{ return _size == 0;		}
+
+	std::string operator[] (size_type /*i*/) const;
+
+	// Call f(const std::string&) for every entry, in order
+	template <typename F>
+	void each(F /*f*/) const;
+
+	stringlist to_string_list() const;
+
+	// Bytes of the list and of its heap
+	size_type bytes() const noexcept;
+
+	std::uint32_t hash() const noexcept;
+
+	// The coding is the same for the same entries
+	bool operator == (const compact_string_list& /*other*/) const noexcept;
+	bool operator != (const compact_string_list& o) const noexcept	{ return !(*this == o);		}
+
+private:
+
+	// Read the entry at p over s, which holds the entry before it
+	static const char* decode(const char* /*p*/, std::string& /*s*/, bool /*whole*/);
+	static const char* varint(const char* /*p*/, size_type& /*v*/) noexcept;
+
+	std::vector<char>		_bytes;
+	std::vector<size_type>		_blocks;	// offset of the first entry of each block
+	std::string			_last;		// the entry push_back() codes against
+	size_type			_size;
+	std::uint32_t			_state;		// hash of the entries so far
+};
+
 } // End of egg namespace
 
 namespace std
@@ -214,7 +493,7 @@ operator<<(
     std::ostream&               str,
     const egg::variable&  v)
 {
-  str << v.to_string();
+  v.write(str);
 
   return str;
 }
@@ -244,7 +523,7 @@ inline variable::content variable::type() const noexcept
 }
 
 inline bool
-variable::operator != (const variable& other) noexcept
+variable::operator != (const variable& other) const noexcept
 {
   return !(*this == other);
 }
@@ -274,6 +553,82 @@ template <> inline long double variable::as<long double>() noexcept { return as_
 template <> inline std::string variable::as<std::string>() noexcept { return as_string(); }
 template <> inline variable::stringlist variable::as<variable::stringlist>() noexcept { return as_string_list(); }
 
+template <> inline std::vector<std::int32_t> variable::as<std::vector<std::int32_t>>() noexcept { return as_int32_array().to_vector(); }
+template <> inline std::vector<std::int64_t> variable::as<std::vector<std::int64_t>>() noexcept { return as_int64_array().to_vector(); }
+template <> inline std::vector<std::uint64_t> variable::as<std::vector<std::uint64_t>>() noexcept { return as_uint64_array().to_vector(); }
+template <> inline std::vector<double> variable::as<std::vector<double>>() noexcept { return as_double_array().to_vector(); }
+template <> inline std::vector<std::uint8_t> variable::as<std::vector<std::uint8_t>>() noexcept { return as_blob().to_vector(); }
+
+template <> inline variable::list variable::as<variable::list>() noexcept { return as_list(); }
+template <> inline variable::map variable::as<variable::map>() noexcept { return as_map(); }
+template <> inline variable::string_rope variable::as<variable::string_rope>() noexcept { return as_string_rope(); }
+template <> inline variable::compact_string_list variable::as<variable::compact_string_list>() noexcept { return as_compact_string_list(); }
+
+template <typename F>
+inline void
+variable::string_rope::each(
+    F f) const
+{
+  for (const std::shared_ptr<stringlist>& c : _chunks)
+    for (const std::string& s : *c)
+      f(s);
+}
+
+inline const char*
+variable::compact_string_list::varint(
+    const char* p,
+    size_type&  v) noexcept
+{
+  unsigned shift = 0;
+  unsigned char b;
+
+  v = 0;
+
+  do
+  {
+    b = static_cast<unsigned char>(*p++);
+    v |= static_cast<size_type>(b & 0x7f) << shift;
+    shift += 7;
+  }
+  while (b & 0x80);
+
+  return p;
+}
+
+inline const char*
+variable::compact_string_list::decode(
+    const char*   p,
+    std::string&  s,
+    bool          whole)
+{
+  size_type shared = 0, n;
+
+  if (!whole)
+    p = varint(p, shared);
+
+  p = varint(p, n);
+
+  s.resize(shared);
+  s.append(p, n);
+
+  return p + n;
+}
+
+template <typename F>
+inline void
+variable::compact_string_list::each(
+    F f) const
+{
+  std::string s;
+  const char* p = _bytes.data();
+
+  for (size_type i = 0; i < _size; ++i)
+  {
+    p = decode(p, s, i % block_size == 0);
+    f(static_cast<const std::string&>(s));
+  }
+}
+
 template <typename T>
 inline T
 variable::as() noexcept
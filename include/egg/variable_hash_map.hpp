@@ -0,0 +1,777 @@
+/*!
+ *	\file		variable_hash_map.hpp
+ *	\brief		Declares open-addressing hash map with variable keys
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_VARIABLE_HASH_MAP
+#define EGG_VARIABLE_HASH_MAP
+
+#include <new>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+// Flat open-addressing map. Every slot has a control byte (empty, deleted or
+// 7 bits of the hash) and the cached 32 bit hash of its key. A lookup matches
+// 16 control bytes at once (SSE2 if available), then compares the cached hash
+// and only then the key itself. Keys and values are stored inline in one
+// contiguous slot array.
+template <typename T>
+struct variable_hash_map
+{
+	typedef variable key_type;
+	typedef T mapped_type;
+	typedef std::pair<const variable, T> value_type;
+	typedef std::size_t size_type;
+
+	template <bool Const> struct basic_iterator;
+
+	typedef basic_iterator<false> iterator;
+	typedef basic_iterator<true>  const_iterator;
+
+	/// An empty map
+	variable_hash_map() noexcept;
+	~variable_hash_map() noexcept;
+
+	// Copy
+	variable_hash_map(const variable_hash_map& /*other*/);
+	variable_hash_map& operator=(const variable_hash_map& /*other*/);
+
+	// Move
+	variable_hash_map(variable_hash_map&& /*other*/) noexcept;
+	variable_hash_map& operator=(variable_hash_map&& /*other*/) noexcept;
+
+	// Size
+	bool empty() const noexcept		{ return _size == 0;	}
+	size_type size() const noexcept		{ return _size;		}
+	size_type capacity() const noexcept	{ return _capacity;	}
+
+	void reserve(size_type /*count*/);
+	void clear() noexcept;
+
+	// Iteration. Order is unspecified
+	iterator begin() noexcept;
+	iterator end() noexcept;
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+	const_iterator cbegin() const noexcept	{ return begin();	}
+	const_iterator cend() const noexcept	{ return end();		}
+
+	// Lookup
+	iterator find(const variable& /*key*/) noexcept;
+	const_iterator find(const variable& /*key*/) const noexcept;
+
+	// Lookup of a string key without building a variable
+	iterator find(const std::string& /*key*/) noexcept;
+	const_iterator find(const std::string& /*key*/) const noexcept;
+
+	iterator find(const char* k)			{ return find(std::string(k)); }
+	const_iterator find(const char* k) const	{ return find(std::string(k)); }
+
+	bool contains(const variable& /*key*/) const noexcept;
+	size_type count(const variable& /*key*/) const noexcept;
+
+	// Throws std::out_of_range if the key is missing
+	T& at(const variable& /*key*/);
+	const T& at(const variable& /*key*/) const;
+
+	T& operator[] (const variable& /*key*/);
+	T& operator[] (variable&& /*key*/);
+
+	// Insert. Returns the element and true if it was inserted
+	std::pair<iterator, bool> insert(const value_type& /*value*/);
+
+	template <typename K, typename... A>
+	std::pair<iterator, bool> emplace(K&& /*key*/, A&&... /*args*/);
+
+	template <typename V>
+	std::pair<iterator, bool> insert_or_assign(const variable& /*key*/, V&& /*value*/);
+
+	// Erase. Returns the number of removed elements
+	size_type erase(const variable& /*key*/) noexcept;
+	iterator erase(iterator /*position*/) noexcept;
+
+private:
+
+	typedef std::int8_t ctrl_t;
+
+	static const ctrl_t _empty   = -128;
+	static const ctrl_t _deleted = -2;
+	static const size_type _group = 16;
+	static const size_type _npos = static_cast<size_type>(-1);
+
+	typedef typename std::aligned_storage<
+		sizeof(value_type), alignof(value_type)>::type slot_t;
+
+	static std::uint64_t mix(std::uint32_t h) noexcept;
+	static size_type h1(std::uint64_t m) noexcept	{ return static_cast<size_type>(m >> 7); }
+	static ctrl_t h2(std::uint64_t m) noexcept	{ return static_cast<ctrl_t>(m & 0x7f); }
+
+	static std::uint32_t match(const ctrl_t* /*group*/, ctrl_t /*value*/) noexcept;
+	static std::uint32_t match_free(const ctrl_t* /*group*/) noexcept;
+
+	value_type* slot(size_type i) noexcept
+	{ return reinterpret_cast<value_type *>(_slots + i); }
+	const value_type* slot(size_type i) const noexcept
+	{ return reinterpret_cast<const value_type *>(_slots + i); }
+
+	void set_ctrl(size_type /*index*/, ctrl_t /*value*/) noexcept;
+
+	template <typename E>
+	size_type lookup(std::uint32_t /*hash*/, E /*equal*/) const noexcept;
+
+	size_type free_slot(std::uint32_t /*hash*/) const noexcept;
+	size_type prepare_insert(std::uint32_t /*hash*/);
+
+	void allocate(size_type /*capacity*/);
+	void release() noexcept;
+	void resize(size_type /*capacity*/);
+	size_type next(size_type /*index*/) const noexcept;
+
+private:
+
+	ctrl_t*		_ctrl;
+	std::uint32_t*	_hashes;
+	slot_t*		_slots;
+	size_type	_capacity;
+	size_type	_size;
+	size_type	_deleted_count;
+};
+
+template <typename T>
+const typename variable_hash_map<T>::ctrl_t variable_hash_map<T>::_empty;
+
+template <typename T>
+const typename variable_hash_map<T>::ctrl_t variable_hash_map<T>::_deleted;
+
+template <typename T>
+const typename variable_hash_map<T>::size_type variable_hash_map<T>::_group;
+
+template <typename T>
+const typename variable_hash_map<T>::size_type variable_hash_map<T>::_npos;
+
+// Iterator
+template <typename T>
+template <bool Const>
+struct variable_hash_map<T>::basic_iterator
+{
+	typedef std::forward_iterator_tag iterator_category;
+	typedef typename variable_hash_map<T>::value_type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+	typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+	typedef typename std::conditional<Const,
+		const variable_hash_map<T>*, variable_hash_map<T>*>::type owner;
+
+	basic_iterator() noexcept : _map(nullptr), _index(0) {}
+	basic_iterator(owner m, size_type i) noexcept : _map(m), _index(i) {}
+
+	// Mutable to const
+	template <bool C, typename = typename std::enable_if<Const && !C>::type>
+	basic_iterator(const basic_iterator<C>& other) noexcept
+	  : _map(other._map), _index(other._index) {}
+
+	reference operator*() const noexcept	{ return *_map->slot(_index);	}
+	pointer operator->() const noexcept	{ return _map->slot(_index);	}
+
+	basic_iterator& operator++() noexcept
+	{
+	  _index = _map->next(_index + 1);
+	  return *this;
+	}
+
+	basic_iterator operator++(int) noexcept
+	{
+	  basic_iterator result(*this);
+	  ++*this;
+	  return result;
+	}
+
+	bool operator==(const basic_iterator& other) const noexcept { return _index == other._index; }
+	bool operator!=(const basic_iterator& other) const noexcept { return _index != other._index; }
+
+	owner		_map;
+	size_type	_index;
+};
+
+// Construct/destruct
+template <typename T>
+inline
+variable_hash_map<T>::variable_hash_map() noexcept
+  : _ctrl(nullptr),
+    _hashes(nullptr),
+    _slots(nullptr),
+    _capacity(0),
+    _size(0),
+    _deleted_count(0)
+{}
+
+template <typename T>
+inline
+variable_hash_map<T>::~variable_hash_map() noexcept
+{
+  release();
+}
+
+// Copy
+template <typename T>
+inline
+variable_hash_map<T>::variable_hash_map(
+    const variable_hash_map& other)
+  : variable_hash_map()
+{
+  reserve(other._size);
+
+  for (const auto& e : other)
+    emplace(e.first, e.second);
+}
+
+template <typename T>
+inline variable_hash_map<T>&
+variable_hash_map<T>::operator=(
+    const variable_hash_map& other)
+{
+  if (this != &other)
+  {
+    variable_hash_map copy(other);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+// Move
+template <typename T>
+inline
+variable_hash_map<T>::variable_hash_map(
+    variable_hash_map&& other) noexcept
+  : _ctrl(other._ctrl),
+    _hashes(other._hashes),
+    _slots(other._slots),
+    _capacity(other._capacity),
+    _size(other._size),
+    _deleted_count(other._deleted_count)
+{
+  other._ctrl = nullptr;
+  other._hashes = nullptr;
+  other._slots = nullptr;
+  other._capacity = other._size = other._deleted_count = 0;
+}
+
+template <typename T>
+inline variable_hash_map<T>&
+variable_hash_map<T>::operator=(
+    variable_hash_map&& other) noexcept
+{
+  if (this != &other)
+  {
+    release();
+
+    _ctrl = other._ctrl;
+    _hashes = other._hashes;
+    _slots = other._slots;
+    _capacity = other._capacity;
+    _size = other._size;
+    _deleted_count = other._deleted_count;
+
+    other._ctrl = nullptr;
+    other._hashes = nullptr;
+    other._slots = nullptr;
+    other._capacity = other._size = other._deleted_count = 0;
+  }
+
+  return *this;
+}
+
+// Size
+template <typename T>
+inline void
+variable_hash_map<T>::reserve(
+    size_type n)
+{
+  // Max load factor is 7/8
+  size_type capacity = _group;
+  while (capacity - capacity / 8 < n)
+    capacity <<= 1;
+
+  if (capacity > _capacity)
+    resize(capacity);
+}
+
+template <typename T>
+inline void
+variable_hash_map<T>::clear() noexcept
+{
+  for (size_type i = 0; i < _capacity; ++i)
+    if (_ctrl[i] >= 0)
+      slot(i)->~value_type();
+
+  if (_capacity)
+    std::fill(_ctrl, _ctrl + _capacity + _group, _empty);
+
+  _size = 0;
+  _deleted_count = 0;
+}
+
+// Iteration
+template <typename T>
+inline typename variable_hash_map<T>::iterator
+variable_hash_map<T>::begin() noexcept
+{
+  return iterator(this, next(0));
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::iterator
+variable_hash_map<T>::end() noexcept
+{
+  return iterator(this, _capacity);
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::const_iterator
+variable_hash_map<T>::begin() const noexcept
+{
+  return const_iterator(this, next(0));
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::const_iterator
+variable_hash_map<T>::end() const noexcept
+{
+  return const_iterator(this, _capacity);
+}
+
+// Lookup
+template <typename T>
+inline typename variable_hash_map<T>::iterator
+variable_hash_map<T>::find(
+    const variable& key) noexcept
+{
+  const size_type i = lookup(key.hash(),
+    [&key](const variable& k) { return k == key; });
+
+  return iterator(this, i == _npos ? _capacity : i);
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::const_iterator
+variable_hash_map<T>::find(
+    const variable& key) const noexcept
+{
+  const size_type i = lookup(key.hash(),
+    [&key](const variable& k) { return k == key; });
+
+  return const_iterator(this, i == _npos ? _capacity : i);
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::iterator
+variable_hash_map<T>::find(
+    const std::string& key) noexcept
+{
+  const size_type i = lookup(variable::hash_of(key),
+    [&key](const variable& k) {
+      return k.type() == variable::content::is_string && k.as_string() == key; });
+
+  return iterator(this, i == _npos ? _capacity : i);
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::const_iterator
+variable_hash_map<T>::find(
+    const std::string& key) const noexcept
+{
+  const size_type i = lookup(variable::hash_of(key),
+    [&key](const variable& k) {
+      return k.type() == variable::content::is_string && k.as_string() == key; });
+
+  return const_iterator(this, i == _npos ? _capacity : i);
+}
+
+template <typename T>
+inline bool
+variable_hash_map<T>::contains(
+    const variable& key) const noexcept
+{
+  return find(key) != end();
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::size_type
+variable_hash_map<T>::count(
+    const variable& key) const noexcept
+{
+  return find(key) != end() ? 1 : 0;
+}
+
+template <typename T>
+inline T&
+variable_hash_map<T>::at(
+    const variable& key)
+{
+  iterator i = find(key);
+
+  if (i == end())
+    throw std::out_of_range("variable_hash_map::at(): key " +
+                            key.to_string() + " not found");
+
+  return i->second;
+}
+
+template <typename T>
+inline const T&
+variable_hash_map<T>::at(
+    const variable& key) const
+{
+  const_iterator i = find(key);
+
+  if (i == end())
+    throw std::out_of_range("variable_hash_map::at(): key " +
+                            key.to_string() + " not found");
+
+  return i->second;
+}
+
+template <typename T>
+inline T&
+variable_hash_map<T>::operator[] (
+    const variable& key)
+{
+  return emplace(key).first->second;
+}
+
+template <typename T>
+inline T&
+variable_hash_map<T>::operator[] (
+    variable&& key)
+{
+  return emplace(std::move(key)).first->second;
+}
+
+// Insert
+template <typename T>
+inline std::pair<typename variable_hash_map<T>::iterator, bool>
+variable_hash_map<T>::insert(
+    const value_type& value)
+{
+  return emplace(value.first, value.second);
+}
+
+template <typename T>
+template <typename K, typename... A>
+inline std::pair<typename variable_hash_map<T>::iterator, bool>
+variable_hash_map<T>::emplace(
+    K&&     key,
+    A&&...  args)
+{
+  const variable& k = key;
+  const std::uint32_t h = k.hash();
+  const size_type found = lookup(h,
+    [&k](const variable& other) { return other == k; });
+
+  if (found != _npos)
+    return std::make_pair(iterator(this, found), false);
+
+  const size_type i = prepare_insert(h);
+
+  new (slot(i)) value_type(
+    std::piecewise_construct,
+    std::forward_as_tuple(std::forward<K>(key)),
+    std::forward_as_tuple(std::forward<A>(args)...));
+
+  if (_ctrl[i] == _deleted)
+    --_deleted_count;
+
+  set_ctrl(i, h2(mix(h)));
+  _hashes[i] = h;
+  ++_size;
+
+  return std::make_pair(iterator(this, i), true);
+}
+
+template <typename T>
+template <typename V>
+inline std::pair<typename variable_hash_map<T>::iterator, bool>
+variable_hash_map<T>::insert_or_assign(
+    const variable& key,
+    V&&             value)
+{
+  std::pair<iterator, bool> result = emplace(key);
+  result.first->second = std::forward<V>(value);
+
+  return result;
+}
+
+// Erase
+template <typename T>
+inline typename variable_hash_map<T>::size_type
+variable_hash_map<T>::erase(
+    const variable& key) noexcept
+{
+  iterator i = find(key);
+
+  if (i == end())
+    return 0;
+
+  erase(i);
+
+  return 1;
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::iterator
+variable_hash_map<T>::erase(
+    iterator position) noexcept
+{
+  const size_type i = position._index;
+
+  slot(i)->~value_type();
+  set_ctrl(i, _deleted);
+  ++_deleted_count;
+  --_size;
+
+  return iterator(this, next(i + 1));
+}
+
+// Internals
+template <typename T>
+inline std::uint64_t
+variable_hash_map<T>::mix(
+    std::uint32_t h) noexcept
+{
+  // std::hash of integers is identity, spread the bits before splitting
+  std::uint64_t x = h;
+  x *= 0x9e3779b97f4a7c15ull;
+
+  return x ^ (x >> 32);
+}
+
+template <typename T>
+inline std::uint32_t
+variable_hash_map<T>::match(
+    const ctrl_t* g,
+    ctrl_t        value) noexcept
+{
+#if defined(__SSE2__)
+  const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(g));
+  return static_cast<std::uint32_t>(
+    _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl)));
+#else
+  std::uint32_t result = 0;
+
+  for (size_type i = 0; i < _group; ++i)
+    result |= static_cast<std::uint32_t>(g[i] == value) << i;
+
+  return result;
+#endif
+}
+
+template <typename T>
+inline std::uint32_t
+variable_hash_map<T>::match_free(
+    const ctrl_t* g) noexcept
+{
+  // Empty and deleted have the sign bit set
+#if defined(__SSE2__)
+  return static_cast<std::uint32_t>(
+    _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(g))));
+#else
+  std::uint32_t result = 0;
+
+  for (size_type i = 0; i < _group; ++i)
+    result |= static_cast<std::uint32_t>(g[i] < 0) << i;
+
+  return result;
+#endif
+}
+
+template <typename T>
+inline void
+variable_hash_map<T>::set_ctrl(
+    size_type i,
+    ctrl_t    value) noexcept
+{
+  _ctrl[i] = value;
+
+  // The first group is mirrored after the end, so unaligned group loads
+  // never wrap around
+  if (i < _group)
+    _ctrl[_capacity + i] = value;
+}
+
+template <typename T>
+template <typename E>
+inline typename variable_hash_map<T>::size_type
+variable_hash_map<T>::lookup(
+    std::uint32_t h,
+    E             equal) const noexcept
+{
+  if (_size == 0)
+    return _npos;
+
+  const std::uint64_t m = mix(h);
+  const size_type mask = _capacity - 1;
+  const ctrl_t tag = h2(m);
+  size_type position = h1(m) & mask;
+
+  for (size_type step = _group; ; step += _group)
+  {
+    const ctrl_t* g = _ctrl + position;
+
+    for (std::uint32_t bits = match(g, tag); bits != 0; bits &= bits - 1)
+    {
+      const size_type i = (position + __builtin_ctz(bits)) & mask;
+
+      if (_hashes[i] == h && equal(slot(i)->first))
+        return i;
+    }
+
+    if (match(g, _empty) != 0)
+      return _npos;
+
+    position = (position + step) & mask;
+  }
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::size_type
+variable_hash_map<T>::free_slot(
+    std::uint32_t h) const noexcept
+{
+  const size_type mask = _capacity - 1;
+  size_type position = h1(mix(h)) & mask;
+
+  for (size_type step = _group; ; step += _group)
+  {
+    const std::uint32_t bits = match_free(_ctrl + position);
+
+    if (bits != 0)
+      return (position + __builtin_ctz(bits)) & mask;
+
+    position = (position + step) & mask;
+  }
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::size_type
+variable_hash_map<T>::prepare_insert(
+    std::uint32_t h)
+{
+  if (_capacity == 0)
+    resize(_group);
+
+  else if (_size + _deleted_count + 1 > _capacity - _capacity / 8)
+  {
+    // Many tombstones: clean up in place, otherwise grow
+    if (_deleted_count > _capacity / 4)
+      resize(_capacity);
+    else
+      resize(_capacity * 2);
+  }
+
+  return free_slot(h);
+}
+
+template <typename T>
+inline void
+variable_hash_map<T>::allocate(
+    size_type capacity)
+{
+  // Slots, hashes and control bytes share one allocation
+  const size_type bytes = capacity * (sizeof(slot_t) + sizeof(std::uint32_t)) +
+                          capacity + _group;
+  slot_t* block = new slot_t[(bytes + sizeof(slot_t) - 1) / sizeof(slot_t)];
+
+  _slots = block;
+  _hashes = reinterpret_cast<std::uint32_t *>(block + capacity);
+  _ctrl = reinterpret_cast<ctrl_t *>(_hashes + capacity);
+
+  std::fill(_ctrl, _ctrl + capacity + _group, _empty);
+
+  _capacity = capacity;
+}
+
+template <typename T>
+inline void
+variable_hash_map<T>::release() noexcept
+{
+  clear();
+
+  delete[] _slots;
+
+  _ctrl = nullptr;
+  _hashes = nullptr;
+  _slots = nullptr;
+  _capacity = 0;
+}
+
+template <typename T>
+inline void
+variable_hash_map<T>::resize(
+    size_type capacity)
+{
+  ctrl_t* ctrl = _ctrl;
+  std::uint32_t* hashes = _hashes;
+  slot_t* slots = _slots;
+  const size_type old = _capacity;
+
+  // Leaves the map untouched if it throws
+  allocate(capacity);
+
+  // Move the elements over, the cached hashes make it a pure memory pass
+  for (size_type i = 0; i < old; ++i)
+  {
+    if (ctrl[i] < 0)
+      continue;
+
+    value_type* e = reinterpret_cast<value_type *>(slots + i);
+    const size_type j = free_slot(hashes[i]);
+
+    // The source is destroyed right away, so its key may be moved from
+    new (slot(j)) value_type(
+      std::move(const_cast<variable&>(e->first)), std::move(e->second));
+    e->~value_type();
+
+    set_ctrl(j, ctrl[i]);
+    _hashes[j] = hashes[i];
+  }
+
+  _deleted_count = 0;
+
+  delete[] slots;
+}
+
+template <typename T>
+inline typename variable_hash_map<T>::size_type
+variable_hash_map<T>::next(
+    size_type i) const noexcept
+{
+  while (i < _capacity && _ctrl[i] < 0)
+    ++i;
+
+  return i;
+}
+
+} // End of egg namespace
+
+#endif  // EGG_VARIABLE_HASH_MAP
+
+/* End of file */
@@ -0,0 +1,226 @@
+/*!
+ *	\file		variable_queue.hpp
+ *	\brief		Declares bounded lock-free queues of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_VARIABLE_QUEUE
+#define EGG_VARIABLE_QUEUE
+
+#include <atomic>
+#include <memory>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+namespace queue_detail
+{
+
+// Keeps the indices written by different threads on different cache lines
+const std::size_t _cs_line = 64;
+
+inline std::size_t
+round_up(std::size_t n) noexcept
+{
+  std::size_t result = 2;
+  while (result < n)
+    result *= 2;
+  return result;
+}
+
+} // End of queue_detail namespace
+
+// Ring buffer for one producer and one consumer. Slots are variables built
+// once, messages are moved in and out, so nothing is copied or allocated on
+// the way (scalars live inside the variable). Each side caches the index of
+// the other and reads the shared one only when the ring looks full or empty.
+struct EGG_PUBLIC spsc_variable_queue
+{
+	typedef std::size_t size_type;
+
+	// Capacity is rounded up to a power of two
+	explicit spsc_variable_queue(size_type /*capacity*/);
+	~spsc_variable_queue() noexcept;
+
+	spsc_variable_queue(const spsc_variable_queue&) = delete;
+	spsc_variable_queue& operator=(const spsc_variable_queue&) = delete;
+
+	// Producer. False if the queue is full, the value is left untouched
+	bool try_push(variable&& /*value*/) noexcept;
+	bool try_push(const variable&) = delete;
+
+	// Consumer. False if the queue is empty
+	bool try_pop(variable& /*out*/) noexcept;
+
+	// Exact only when called by the producer or the consumer
+	size_type size() const noexcept;
+	bool empty() const noexcept			{ return size() == 0;	}
+	size_type capacity() const noexcept		{ return _mask + 1;	}
+
+private:
+
+	std::unique_ptr<variable[]>	_slots;
+	size_type			_mask;
+
+	char				_pad0[queue_detail::_cs_line];
+
+	// Producer side
+	std::atomic<size_type>		_tail;
+	size_type			_head_cache;
+
+	char				_pad1[queue_detail::_cs_line];
+
+	// Consumer side
+	std::atomic<size_type>		_head;
+	size_type			_tail_cache;
+
+	char				_pad2[queue_detail::_cs_line];
+};
+
+// Bounded ring buffer for many producers and one consumer (D. Vyukov). Every
+// slot carries a sequence number telling whose turn it is, producers claim
+// positions with one compare-and-swap and never wait for each other.
+struct EGG_PUBLIC mpsc_variable_queue
+{
+	typedef std::size_t size_type;
+
+	// Capacity is rounded up to a power of two
+	explicit mpsc_variable_queue(size_type /*capacity*/);
+	~mpsc_variable_queue() noexcept;
+
+	mpsc_variable_queue(const mpsc_variable_queue&) = delete;
+	mpsc_variable_queue& operator=(const mpsc_variable_queue&) = delete;
+
+	// Any thread. False if the queue is full, the value is left untouched
+	bool try_push(variable&& /*value*/) noexcept;
+	bool try_push(const variable&) = delete;
+
+	// Consumer. False if the queue is empty
+	bool try_pop(variable& /*out*/) noexcept;
+
+	// Approximate while producers push
+	size_type size() const noexcept;
+	bool empty() const noexcept			{ return size() == 0;	}
+	size_type capacity() const noexcept		{ return _mask + 1;	}
+
+private:
+
+	struct slot
+	{
+		std::atomic<size_type>	_sequence;
+		variable		_value;
+	};
+
+	std::unique_ptr<slot[]>		_slots;
+	size_type			_mask;
+
+	char				_pad0[queue_detail::_cs_line];
+
+	std::atomic<size_type>		_tail;		// producers
+
+	char				_pad1[queue_detail::_cs_line];
+
+	std::atomic<size_type>		_head;		// consumer
+
+	char				_pad2[queue_detail::_cs_line];
+};
+
+// SPSC
+inline bool
+spsc_variable_queue::try_push(
+    variable&& value) noexcept
+{
+  const size_type tail = _tail.load(std::memory_order_relaxed);
+
+  if (tail - _head_cache > _mask)
+  {
+    _head_cache = _head.load(std::memory_order_acquire);
+
+    if (tail - _head_cache > _mask)
+      return false;
+  }
+
+  _slots[tail & _mask] = std::move(value);
+  _tail.store(tail + 1, std::memory_order_release);
+
+  return true;
+}
+
+inline bool
+spsc_variable_queue::try_pop(
+    variable& out) noexcept
+{
+  const size_type head = _head.load(std::memory_order_relaxed);
+
+  if (head == _tail_cache)
+  {
+    _tail_cache = _tail.load(std::memory_order_acquire);
+
+    if (head == _tail_cache)
+      return false;
+  }
+
+  out = std::move(_slots[head & _mask]);
+  _head.store(head + 1, std::memory_order_release);
+
+  return true;
+}
+
+// MPSC
+inline bool
+mpsc_variable_queue::try_push(
+    variable&& value) noexcept
+{
+  size_type tail = _tail.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    slot& s = _slots[tail & _mask];
+    const size_type sequence = s._sequence.load(std::memory_order_acquire);
+    const std::ptrdiff_t d = static_cast<std::ptrdiff_t>(sequence - tail);
+
+    if (d == 0)
+    {
+      if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+      {
+        s._value = std::move(value);
+        s._sequence.store(tail + 1, std::memory_order_release);
+
+        return true;
+      }
+    }
+    else if (d < 0)
+      return false;		// A lap behind: full
+    else
+      tail = _tail.load(std::memory_order_relaxed);
+  }
+}
+
+inline bool
+mpsc_variable_queue::try_pop(
+    variable& out) noexcept
+{
+  const size_type head = _head.load(std::memory_order_relaxed);
+  slot& s = _slots[head & _mask];
+
+  if (s._sequence.load(std::memory_order_acquire) != head + 1)
+    return false;
+
+  out = std::move(s._value);
+  s._sequence.store(head + _mask + 1, std::memory_order_release);
+  _head.store(head + 1, std::memory_order_relaxed);
+
+  return true;
+}
+
+} // End of egg namespace
+
+#endif  // EGG_VARIABLE_QUEUE
+
+/* End of file */
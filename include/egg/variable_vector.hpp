@@ -0,0 +1,169 @@
+/*!
+ *	\file		variable_vector.hpp
+ *	\brief		Declares columnar (structure-of-arrays) vector of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_VARIABLE_VECTOR
+#define EGG_VARIABLE_VECTOR
+
+#include <vector>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+// Keeps type tags, widened scalar payloads and cached hashes in separate
+// contiguous columns. Signed integers are stored as int64, bool and unsigned
+// integers as uint64, float and double unboxed as double. Long double, string
+// and string list values stay in a side heap column, their payload is the slot
+// index in that column.
+struct EGG_PUBLIC variable_vector
+{
+	typedef variable::content content;
+	typedef std::size_t size_type;
+
+	union scalar
+	{
+		std::int64_t	_int64;
+		std::uint64_t	_uint64;
+		double		_double;
+	};
+
+	/// An empty vector
+	variable_vector() noexcept;
+	~variable_vector() noexcept;
+
+	// Copy
+	variable_vector(const variable_vector& /*other*/);
+	variable_vector& operator=(const variable_vector& /*other*/);
+
+	// Move
+	variable_vector(variable_vector&& /*other*/) noexcept;
+	variable_vector& operator=(variable_vector&& /*other*/) noexcept;
+
+	// Build from the plain array
+	explicit variable_vector(const std::vector<variable>& /*values*/);
+
+	// Size
+	size_type size() const noexcept;
+	bool empty() const noexcept;
+
+	void reserve(size_type /*capacity*/);
+	void clear() noexcept;
+
+	// Modifiers
+	void push_back(const variable& /*value*/);
+	void pop_back() noexcept;
+
+	// Replace the value at position, the vector is unchanged if it throws.
+	// Throws std::out_of_range
+	void set(size_type /*position*/, const variable& /*value*/);
+
+	// Materialize the value at position. Throws std::out_of_range
+	variable at(size_type /*position*/) const;
+	std::vector<variable> to_vector() const;
+
+	// Element inspection without materialization
+	content type(size_type /*position*/) const noexcept;
+	std::uint32_t hash(size_type /*position*/) const noexcept;
+	const scalar& payload(size_type /*position*/) const noexcept;
+
+	// Number of values of the given type
+	size_type count(content /*type*/) const noexcept;
+
+	// Columns. Valid until the next modification
+	const content*       types() const noexcept;
+	const scalar*        payloads() const noexcept;
+	const std::uint32_t* hashes() const noexcept;
+
+	// Heap column (long double, string and string list values)
+	const variable&      heap(const scalar& /*payload*/) const noexcept;
+
+private:
+
+	EGG_PRIVATE void
+	store(
+		size_type	/*position*/,
+		const variable&	/*value*/);
+
+	// Frees the heap slot of a value that was stored
+	EGG_PRIVATE void
+	release(
+		content		/*type*/,
+		const scalar&	/*payload*/) noexcept;
+
+private:
+
+	std::vector<content>		_types;
+	std::vector<scalar>		_payloads;
+	std::vector<std::uint32_t>	_hashes;
+
+	std::vector<variable>		_heap;
+	std::vector<size_type>		_free;
+};
+
+inline variable_vector::size_type
+variable_vector::size() const noexcept
+{
+  return _types.size();
+}
+
+inline bool
+variable_vector::empty() const noexcept
+{
+  return _types.empty();
+}
+
+inline variable_vector::content
+variable_vector::type(size_type i) const noexcept
+{
+  return _types[i];
+}
+
+inline std::uint32_t
+variable_vector::hash(size_type i) const noexcept
+{
+  return _hashes[i];
+}
+
+inline const variable_vector::scalar&
+variable_vector::payload(size_type i) const noexcept
+{
+  return _payloads[i];
+}
+
+inline const variable_vector::content*
+variable_vector::types() const noexcept
+{
+  return _types.data();
+}
+
+inline const variable_vector::scalar*
+variable_vector::payloads() const noexcept
+{
+  return _payloads.data();
+}
+
+inline const std::uint32_t*
+variable_vector::hashes() const noexcept
+{
+  return _hashes.data();
+}
+
+inline const variable&
+variable_vector::heap(const scalar& p) const noexcept
+{
+  return _heap[p._uint64];
+}
+
+} // End of egg namespace
+
+#endif  // EGG_VARIABLE_VECTOR
+
+/* End of file */
@@ -0,0 +1,169 @@
+/*!
+ *	\file		watchable_store.hpp
+ *	\brief		Declares variable store with batched change notifications
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_WATCHABLE_STORE
+#define EGG_WATCHABLE_STORE
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include <egg/variable.hpp>
+#include <egg/variable_hash_map.hpp>
+
+
+namespace egg
+{
+
+// Store of variables that tells subscribers what changed instead of being
+// polled. A write that doesn't change the value is dropped (the cached hash
+// is compared first). Changed keys are marked, and repeated writes to a key
+// before the next flush() coalesce into one change with the last value.
+// flush() hands every subscriber one batch of the changes it is interested
+// in (exact keys or string key prefixes) through an executor. All buffers
+// are kept between flushes, so in steady state the notification path
+// allocates nothing: changed values are copied into buffers that reuse their
+// storage.
+struct EGG_PUBLIC watchable_store
+{
+	typedef std::size_t size_type;
+	typedef std::uint64_t subscription;
+
+	// Value is empty if the key was erased
+	struct change
+	{
+		variable	_key;
+		variable	_value;
+
+		const variable& key() const noexcept	{ return _key;		}
+		const variable& value() const noexcept	{ return _value;	}
+	};
+
+	// Changes delivered to one subscriber
+	struct EGG_PUBLIC batch
+	{
+		size_type size() const noexcept		{ return _size;			}
+		bool empty() const noexcept		{ return _size == 0;		}
+
+		const change& operator[] (size_type i) const noexcept { return _changes[_selected[i]]; }
+
+	private:
+
+		friend struct watchable_store;
+
+		batch(const change* c, const std::uint32_t* s, size_type n) noexcept
+		  : _changes(c), _selected(s), _size(n) {}
+
+		const change*		_changes;
+		const std::uint32_t*	_selected;
+		size_type		_size;
+	};
+
+	typedef std::function<void(const batch&)> callback;
+
+	// Runs deliveries. Must call fn(argument) exactly once, on any thread
+	struct EGG_PUBLIC executor
+	{
+		virtual ~executor() noexcept;
+		virtual void execute(void (*fn)(void*), void* /*argument*/) = 0;
+	};
+
+	// Delivers on the thread calling flush()
+	static executor& inline_executor() noexcept;
+
+	/// An empty store
+	explicit watchable_store(executor& /*executor*/ = inline_executor());
+	~watchable_store() noexcept;
+
+	watchable_store(const watchable_store&) = delete;
+	watchable_store& operator=(const watchable_store&) = delete;
+
+	// Values. set() and erase() return false if nothing changed
+	bool set(const variable& /*key*/, const variable& /*value*/);
+	bool erase(const variable& /*key*/);
+	bool get(const variable& /*key*/, variable& /*out*/) const;
+
+	size_type size() const;
+
+	// Subscriptions. Callbacks must not subscribe, unsubscribe or flush,
+	// they may read and write the store. An exception thrown by a callback
+	// doesn't stop the other deliveries, flush() rethrows it
+	subscription subscribe(const variable& /*key*/, callback /*f*/);
+	subscription subscribe_prefix(const std::string& /*prefix*/, callback /*f*/);
+
+	// No callback of the subscription runs after it returns
+	bool unsubscribe(subscription /*id*/);
+
+	// Deliver the changes made since the last flush, waits until all
+	// callbacks returned. Returns the number of changed keys. If the
+	// executor throws, the batches it didn't take are delivered on this
+	// thread, then the exception is rethrown. Otherwise the first exception
+	// thrown by a callback is rethrown once all of them returned
+	size_type flush();
+
+	// Keys changed since the last flush
+	size_type pending() const;
+
+	// Writes dropped because the value was the same
+	size_type suppressed() const;
+
+private:
+
+	struct slot
+	{
+		variable	_key;
+		variable	_value;
+		bool		_alive;
+		bool		_dirty;
+	};
+
+	struct subscriber;
+
+	static void deliver(void* /*subscriber*/);
+
+	void finished(const std::exception_ptr& /*failure*/);
+	void mark(std::uint32_t /*slot*/);
+
+private:
+
+	executor*				_executor;
+
+	// Values
+	mutable std::mutex			_lock;
+	std::vector<slot>			_slots;
+	std::vector<std::uint32_t>		_free;
+	variable_hash_map<std::uint32_t>	_index;
+	std::vector<std::uint32_t>		_dirty;
+	size_type				_suppressed;
+
+	// Subscriptions and delivery, in flush order
+	std::mutex				_flush_lock;
+	std::vector<std::unique_ptr<subscriber>>	_subscribers;
+	variable_hash_map<std::vector<subscriber*>>	_exact;
+	std::vector<subscriber*>		_prefixed;
+	subscription				_next_id;
+
+	std::vector<std::uint32_t>		_flushing;
+	std::vector<change>			_changes;
+
+	std::mutex				_delivery_lock;
+	std::condition_variable			_delivered;
+	size_type				_outstanding;
+	std::exception_ptr			_failure;
+};
+
+} // End of egg namespace
+
+#endif  // EGG_WATCHABLE_STORE
+
+/* End of file */
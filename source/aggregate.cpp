@@ -0,0 +1,361 @@
+/*!
+ *	\file		aggregate.cpp
+ *	\brief		Implements batch aggregate kernels over collections of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <limits>
+#include <algorithm>
+
+#include <egg/aggregate.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+namespace
+{
+
+typedef variable::content content;
+typedef variable_vector::scalar scalar;
+typedef variable_access::variant variant;
+
+// Gather buffer size, fits into L1 together with the source
+const std::size_t _cs_block = 256;
+
+// Limit of a single integer kernel call, keeps the low-half sum exact
+const std::size_t _cs_chunk = std::size_t(1) << 24;
+
+// Kernels. Written branch-free over contiguous payloads so the compiler turns
+// them into SIMD loops. The 64 bit integer sums are split into high and low
+// halves, which can't overflow within a chunk.
+void
+fold_signed(
+    const scalar* p,
+    std::size_t   n,
+    statistics&   s) noexcept
+{
+  for (std::size_t offset = 0; offset < n; offset += _cs_chunk)
+  {
+    const std::size_t m = std::min(n - offset, _cs_chunk);
+    const scalar* q = p + offset;
+
+    std::uint64_t lo = 0;
+    std::int64_t  hi = 0;
+    std::int64_t  mn = std::numeric_limits<std::int64_t>::max(),
+                  mx = std::numeric_limits<std::int64_t>::min();
+
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      const std::int64_t x = q[i]._int64;
+
+      lo += static_cast<std::uint64_t>(x) & 0xffffffffu;
+      hi += x >> 32;
+      mn = x < mn ? x : mn;
+      mx = x > mx ? x : mx;
+    }
+
+    s.sum += static_cast<long double>(hi) * 4294967296.0L + lo;
+    s.min = std::min<long double>(s.min, mn);
+    s.max = std::max<long double>(s.max, mx);
+  }
+
+  s.count += n;
+}
+
+void
+fold_unsigned(
+    const scalar* p,
+    std::size_t   n,
+    statistics&   s) noexcept
+{
+  for (std::size_t offset = 0; offset < n; offset += _cs_chunk)
+  {
+    const std::size_t m = std::min(n - offset, _cs_chunk);
+    const scalar* q = p + offset;
+
+    std::uint64_t lo = 0, hi = 0;
+    std::uint64_t mn = std::numeric_limits<std::uint64_t>::max(),
+                  mx = 0;
+
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      const std::uint64_t x = q[i]._uint64;
+
+      lo += x & 0xffffffffu;
+      hi += x >> 32;
+      mn = x < mn ? x : mn;
+      mx = x > mx ? x : mx;
+    }
+
+    s.sum += static_cast<long double>(hi) * 4294967296.0L + lo;
+    s.min = std::min<long double>(s.min, mn);
+    s.max = std::max<long double>(s.max, mx);
+  }
+
+  s.count += n;
+}
+
+void
+fold_double(
+    const scalar* p,
+    std::size_t   n,
+    statistics&   s) noexcept
+{
+  double sum = 0,
+         mn = std::numeric_limits<double>::infinity(),
+         mx = -std::numeric_limits<double>::infinity();
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const double x = p[i]._double;
+
+    sum += x;
+    mn = x < mn ? x : mn;
+    mx = x > mx ? x : mx;
+  }
+
+  s.sum += sum;
+  s.min = std::min<long double>(s.min, mn);
+  s.max = std::max<long double>(s.max, mx);
+  s.count += n;
+}
+
+void
+fold_long_double(
+    const long double x,
+    statistics&       s) noexcept
+{
+  s.sum += x;
+  s.min = std::min(s.min, x);
+  s.max = std::max(s.max, x);
+  s.count += 1;
+}
+
+// Gather a run of variables of the same type into the block, widened
+template <typename T>
+void
+gather_signed(
+    const variable* v,
+    std::size_t     n,
+    T variant::*    member,
+    scalar*         out) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i)
+    out[i]._int64 = variable_access::data(v[i]).*member;
+}
+
+template <typename T>
+void
+gather_unsigned(
+    const variable* v,
+    std::size_t     n,
+    T variant::*    member,
+    scalar*         out) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i)
+    out[i]._uint64 = variable_access::data(v[i]).*member;
+}
+
+template <typename T>
+void
+gather_floating(
+    const variable* v,
+    std::size_t     n,
+    scalar*         out) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const void* p = variable_access::data(v[i])._pointer;
+    out[i]._double = (p == nullptr ? 0.0 : *static_cast<const T *>(p));
+  }
+}
+
+void
+fold_run(
+    const variable* v,
+    std::size_t     n,
+    const content   t,
+    statistics&     s) noexcept
+{
+  scalar block[_cs_block];
+
+  if (t == content::is_long_double)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const void* p = variable_access::data(v[i])._pointer;
+      fold_long_double(p == nullptr ? 0.0L : *static_cast<const long double *>(p), s);
+    }
+
+    return;
+  }
+
+  for (std::size_t offset = 0; offset < n; offset += _cs_block)
+  {
+    const std::size_t m = std::min(n - offset, _cs_block);
+    const variable* w = v + offset;
+
+    switch (t)
+    {
+      case content::is_int8:
+        gather_signed(w, m, &variant::_int8, block);
+        fold_signed(block, m, s);
+        break;
+      case content::is_int16:
+        gather_signed(w, m, &variant::_int16, block);
+        fold_signed(block, m, s);
+        break;
+      case content::is_int32:
+        gather_signed(w, m, &variant::_int32, block);
+        fold_signed(block, m, s);
+        break;
+      case content::is_int64:
+        gather_signed(w, m, &variant::_int64, block);
+        fold_signed(block, m, s);
+        break;
+      case content::is_uint8:
+        gather_unsigned(w, m, &variant::_uint8, block);
+        fold_unsigned(block, m, s);
+        break;
+      case content::is_uint16:
+        gather_unsigned(w, m, &variant::_uint16, block);
+        fold_unsigned(block, m, s);
+        break;
+      case content::is_uint32:
+        gather_unsigned(w, m, &variant::_uint32, block);
+        fold_unsigned(block, m, s);
+        break;
+      case content::is_uint64:
+        gather_unsigned(w, m, &variant::_uint64, block);
+        fold_unsigned(block, m, s);
+        break;
+      case content::is_float:
+        gather_floating<float>(w, m, block);
+        fold_double(block, m, s);
+        break;
+      case content::is_double:
+        gather_floating<double>(w, m, block);
+        fold_double(block, m, s);
+        break;
+      default:
+        return;
+    }
+  }
+}
+
+inline void
+count_type(
+    const content t,
+    std::size_t   n,
+    statistics&   s) noexcept
+{
+  if (t < content::last)
+    s.by_type[static_cast<std::size_t>(t)] += n;
+}
+
+} // End of anonymous namespace
+
+// Statistics
+statistics::statistics() noexcept
+  : count(0),
+    sum(0.0L),
+    min(std::numeric_limits<long double>::infinity()),
+    max(-std::numeric_limits<long double>::infinity())
+{
+  std::fill(by_type, by_type + types, 0);
+}
+
+statistics&
+statistics::operator += (
+    const statistics& other) noexcept
+{
+  count += other.count;
+  sum += other.sum;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+
+  for (std::size_t i = 0; i < types; ++i)
+    by_type[i] += other.by_type[i];
+
+  return *this;
+}
+
+// Array of variables
+statistics
+aggregate(
+    const variable* v,
+    std::size_t     n) noexcept
+{
+  statistics s;
+  std::size_t i = 0;
+
+  while (i < n)
+  {
+    const content t = variable_access::type(v[i]);
+    const std::size_t limit = std::min(n, i + _cs_block);
+    std::size_t j = i + 1;
+
+    // Long runs are cut into blocks, so the gather finds them in cache
+    while (j < limit && variable_access::type(v[j]) == t)
+      ++j;
+
+    count_type(t, j - i, s);
+    fold_run(v + i, j - i, t, s);
+
+    i = j;
+  }
+
+  return s;
+}
+
+// Columnar vector
+statistics
+aggregate(
+    const variable_vector& vv) noexcept
+{
+  statistics s;
+  const content* types = vv.types();
+  const scalar* payloads = vv.payloads();
+  const std::size_t n = vv.size();
+  std::size_t i = 0;
+
+  while (i < n)
+  {
+    const content t = types[i];
+    std::size_t j = i + 1;
+
+    while (j < n && types[j] == t)
+      ++j;
+
+    count_type(t, j - i, s);
+
+    if (variable_access::is_signed(t))
+      fold_signed(payloads + i, j - i, s);
+
+    else if (t != content::is_bool && variable_access::is_unsigned(t))
+      fold_unsigned(payloads + i, j - i, s);
+
+    else if (t == content::is_float || t == content::is_double)
+      fold_double(payloads + i, j - i, s);
+
+    else if (t == content::is_long_double)
+    {
+      for (std::size_t k = i; k < j; ++k)
+        fold_long_double(vv.heap(payloads[k]).as_long_double(), s);
+    }
+
+    i = j;
+  }
+
+  return s;
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,261 @@
+/*!
+ *	\file		atomic_variable.cpp
+ *	\brief		Implements lock-free shared variable
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cstring>
+
+#include <egg/atomic_variable.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+namespace
+{
+
+// Word layout: bit 0 is set for inline values, bits 1..7 hold the content,
+// bits 8..63 the payload. Heap copies are aligned, so bit 0 of a pointer is 0
+const int _cs_payload_shift = 8;
+
+const std::int64_t _cs_signed_max = (std::int64_t(1) << 55) - 1;
+const std::int64_t _cs_signed_min = -(std::int64_t(1) << 55);
+const std::uint64_t _cs_unsigned_max = (std::uint64_t(1) << 56) - 1;
+
+inline std::uint64_t
+tag(
+    variable::content t,
+    std::uint64_t     payload) noexcept
+{
+  return (payload << _cs_payload_shift) | (static_cast<std::uint64_t>(t) << 1) | 1;
+}
+
+} // End of anonymous namespace
+
+// Construct/destruct
+atomic_variable::atomic_variable(
+    const variable& v,
+    epoch_domain&   d)
+  : _word(publish(v)),
+    _domain(&d)
+{}
+
+atomic_variable::~atomic_variable() noexcept
+{
+  const word w = _word.load(std::memory_order_acquire);
+
+  if (boxed(w))
+    delete box(w);
+}
+
+// Encoding
+bool
+atomic_variable::encode(
+    const variable& v,
+    word&           result) noexcept
+{
+  typedef variable_access access;
+
+  const content t = access::type(v);
+
+  if (t == content::is_empty)
+  {
+    result = tag(t, 0);
+    return true;
+  }
+
+  if (access::is_signed(t))
+  {
+    const std::int64_t x = access::signed_value(v);
+
+    if (x < _cs_signed_min || x > _cs_signed_max)
+      return false;
+
+    result = tag(t, static_cast<std::uint64_t>(x));
+    return true;
+  }
+
+  if (access::is_unsigned(t))
+  {
+    const std::uint64_t x = access::unsigned_value(v);
+
+    if (x > _cs_unsigned_max)
+      return false;
+
+    result = tag(t, x);
+    return true;
+  }
+
+  if (t == content::is_float)
+  {
+    const float f = v.as_float();
+    std::uint32_t bits;
+
+    std::memcpy(&bits, &f, sizeof(bits));
+    result = tag(t, bits);
+    return true;
+  }
+
+  return false;
+}
+
+atomic_variable::word
+atomic_variable::publish(
+    const variable& v)
+{
+  word w;
+
+  if (encode(v, w))
+    return w;
+
+  return reinterpret_cast<word>(new variable(v));
+}
+
+variable
+atomic_variable::decode(
+    word w)
+{
+  typedef variable_access access;
+
+  const content t = static_cast<content>((w >> 1) & 0x7f);
+  variable result;
+
+  if (access::is_signed(t))
+  {
+    // Arithmetic shift restores the sign of the 56 bit payload
+    access::assign_signed(result, t, static_cast<std::int64_t>(w) >> _cs_payload_shift);
+    access::rehash(result);
+  }
+  else if (access::is_unsigned(t))
+  {
+    access::assign_unsigned(result, t, w >> _cs_payload_shift);
+    access::rehash(result);
+  }
+  else if (t == content::is_float)
+  {
+    const std::uint32_t bits = static_cast<std::uint32_t>(w >> _cs_payload_shift);
+    float f;
+
+    std::memcpy(&f, &bits, sizeof(f));
+    result = variable(f);
+  }
+
+  return result;
+}
+
+bool
+atomic_variable::is_inline(
+    const variable& v) noexcept
+{
+  word w;
+  return encode(v, w);
+}
+
+void
+atomic_variable::retire(
+    word w)
+{
+  if (boxed(w))
+    _domain->retire(const_cast<variable*>(box(w)));
+}
+
+// Load
+variable
+atomic_variable::load() const
+{
+  const word w = _word.load(std::memory_order_acquire);
+
+  if (!boxed(w))
+    return decode(w);
+
+  epoch_domain::guard g(*_domain);
+  const word p = _word.load(std::memory_order_seq_cst);
+
+  return boxed(p) ? *box(p) : decode(p);
+}
+
+atomic_variable::content
+atomic_variable::type() const noexcept
+{
+  const word w = _word.load(std::memory_order_acquire);
+
+  if (!boxed(w))
+    return static_cast<content>((w >> 1) & 0x7f);
+
+  epoch_domain::guard g(*_domain);
+  const word p = _word.load(std::memory_order_seq_cst);
+
+  return boxed(p) ? box(p)->type() : static_cast<content>((p >> 1) & 0x7f);
+}
+
+// Store
+void
+atomic_variable::store(
+    const variable& v)
+{
+  retire(_word.exchange(publish(v), std::memory_order_seq_cst));
+}
+
+variable
+atomic_variable::exchange(
+    const variable& v)
+{
+  const word old = _word.exchange(publish(v), std::memory_order_seq_cst);
+
+  if (!boxed(old))
+    return decode(old);
+
+  // Nobody can publish the old copy again, but readers may still see it
+  variable result(*box(old));
+  retire(old);
+
+  return result;
+}
+
+bool
+atomic_variable::compare_exchange(
+    variable&       expected,
+    const variable& desired)
+{
+  word want = publish(desired);
+  word inline_expected = 0;
+  const bool expected_inline = encode(expected, inline_expected);
+
+  epoch_domain::guard g(*_domain);
+
+  for (;;)
+  {
+    word current = _word.load(std::memory_order_seq_cst);
+
+    // Encoding is canonical, an inline value never equals a heap copy
+    const bool equal = boxed(current)
+      ? (!expected_inline && *box(current) == expected)
+      : (expected_inline && current == inline_expected);
+
+    if (!equal)
+    {
+      expected = boxed(current) ? *box(current) : decode(current);
+
+      if (boxed(want))
+        delete box(want);
+
+      return false;
+    }
+
+    if (_word.compare_exchange_strong(current, want, std::memory_order_seq_cst))
+    {
+      retire(current);
+      return true;
+    }
+  }
+}
+
+} // End of egg namespace
+
+/* End of file */
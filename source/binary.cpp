@@ -0,0 +1,983 @@
+/*!
+ *	\file		binary.cpp
+ *	\brief		Implements compact binary encoding of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <egg/binary.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+namespace
+{
+
+typedef variable::content content;
+
+// Longest LEB128 encoding of 64 bits
+const std::size_t _cs_varint = 10;
+
+// Levels of nested lists and maps a decoder follows
+const unsigned _cs_depth = 128;
+
+inline std::uint64_t
+zigzag(
+    std::int64_t x) noexcept
+{
+  return (static_cast<std::uint64_t>(x) << 1) ^ static_cast<std::uint64_t>(x >> 63);
+}
+
+inline std::int64_t
+unzigzag(
+    std::uint64_t x) noexcept
+{
+  return static_cast<std::int64_t>(x >> 1) ^ -static_cast<std::int64_t>(x & 1);
+}
+
+inline std::size_t
+varint_size(
+    std::uint64_t x) noexcept
+{
+  std::size_t n = 1;
+
+  for (; x >= 0x80; x >>= 7)
+    ++n;
+
+  return n;
+}
+
+inline std::uint8_t*
+put_varint(
+    std::uint8_t* p,
+    std::uint64_t x) noexcept
+{
+  for (; x >= 0x80; x >>= 7)
+    *p++ = static_cast<std::uint8_t>(x | 0x80);
+
+  *p++ = static_cast<std::uint8_t>(x);
+
+  return p;
+}
+
+// Fixed width little endian, independent of the host byte order
+inline std::uint8_t*
+put_fixed(
+    std::uint8_t* p,
+    std::uint64_t x,
+    std::size_t   n) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i, x >>= 8)
+    *p++ = static_cast<std::uint8_t>(x);
+
+  return p;
+}
+
+inline std::uint64_t
+get_fixed(
+    const std::uint8_t* p,
+    std::size_t         n) noexcept
+{
+  std::uint64_t x = 0;
+
+  for (std::size_t i = n; i > 0; --i)
+    x = (x << 8) | p[i - 1];
+
+  return x;
+}
+
+inline std::uint64_t
+bits_of(
+    double d) noexcept
+{
+  std::uint64_t x;
+  std::memcpy(&x, &d, sizeof(x));
+  return x;
+}
+
+inline double
+double_of(
+    std::uint64_t x) noexcept
+{
+  double d;
+  std::memcpy(&d, &x, sizeof(d));
+  return d;
+}
+
+// Array elements, little endian. A copy on little endian hosts
+inline std::uint8_t*
+put_elements(
+    std::uint8_t* p,
+    const void*   data,
+    std::size_t   n,
+    std::size_t   width) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::memcpy(p, data, n * width);
+  return p + n * width;
+#else
+  const std::uint8_t* q = static_cast<const std::uint8_t*>(data);
+
+  for (std::size_t i = 0; i < n; ++i, q += width)
+  {
+    std::uint64_t x = 0;
+
+    if (width == 4)
+    {
+      std::uint32_t y;
+      std::memcpy(&y, q, 4);
+      x = y;
+    }
+    else
+      std::memcpy(&x, q, width);
+
+    p = put_fixed(p, x, width);
+  }
+
+  return p;
+#endif
+}
+
+inline void
+get_elements(
+    const std::uint8_t* p,
+    void*               data,
+    std::size_t         n,
+    std::size_t         width) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::memcpy(data, p, n * width);
+#else
+  std::uint8_t* q = static_cast<std::uint8_t*>(data);
+
+  for (std::size_t i = 0; i < n; ++i, p += width, q += width)
+  {
+    const std::uint64_t x = get_fixed(p, width);
+
+    if (width == 4)
+    {
+      const std::uint32_t y = static_cast<std::uint32_t>(x);
+      std::memcpy(q, &y, 4);
+    }
+    else
+      std::memcpy(q, &x, width);
+  }
+#endif
+}
+
+// Narrow integers must decode into their own range
+inline bool
+fits_signed(
+    content      t,
+    std::int64_t x) noexcept
+{
+  switch (t)
+  {
+    case content::is_int8:   return x >= INT8_MIN && x <= INT8_MAX;
+    case content::is_int16:  return x >= INT16_MIN && x <= INT16_MAX;
+    case content::is_int32:  return x >= INT32_MIN && x <= INT32_MAX;
+    default:                 return true;
+  }
+}
+
+inline bool
+fits_unsigned(
+    content       t,
+    std::uint64_t x) noexcept
+{
+  switch (t)
+  {
+    case content::is_uint8:  return x <= UINT8_MAX;
+    case content::is_uint16: return x <= UINT16_MAX;
+    case content::is_uint32: return x <= UINT32_MAX;
+    default:                 return true;
+  }
+}
+
+// Long double goes as a 64 bit mantissa, a 32 bit exponent and the flags
+// below: exact for x87 and double, rounded for wider formats
+const std::uint8_t _cs_negative = 1;
+const std::uint8_t _cs_infinity = 2;
+const std::uint8_t _cs_nan = 4;
+
+const std::size_t _cs_long_double = 13;
+
+inline std::uint8_t*
+put_long_double(
+    std::uint8_t* p,
+    long double   x) noexcept
+{
+  std::uint8_t flags = std::signbit(x) ? _cs_negative : 0;
+  std::uint64_t mantissa = 0;
+  int exponent = 0;
+
+  if (std::isnan(x))
+    flags |= _cs_nan;
+  else if (std::isinf(x))
+    flags |= _cs_infinity;
+  else
+    mantissa = static_cast<std::uint64_t>(std::ldexp(std::frexp(std::fabs(x), &exponent), 64));
+
+  p = put_fixed(p, mantissa, 8);
+  p = put_fixed(p, static_cast<std::uint32_t>(exponent), 4);
+  *p++ = flags;
+
+  return p;
+}
+
+inline long double
+get_long_double(
+    const std::uint8_t* p) noexcept
+{
+  const std::uint64_t mantissa = get_fixed(p, 8);
+  const int exponent = static_cast<std::int32_t>(get_fixed(p + 8, 4));
+  const std::uint8_t flags = p[12];
+
+  long double x;
+
+  if (flags & _cs_nan)
+    x = std::numeric_limits<long double>::quiet_NaN();
+  else if (flags & _cs_infinity)
+    x = std::numeric_limits<long double>::infinity();
+  else
+    x = std::ldexp(static_cast<long double>(mantissa), exponent - 64);
+
+  return (flags & _cs_negative) ? -x : x;
+}
+
+std::size_t
+payload_size(
+    const variable& v) noexcept
+{
+  switch (v.type())
+  {
+    case content::is_empty:
+      return 0;
+
+    case content::is_bool:
+      return 1;
+
+    case content::is_int8:
+    case content::is_int16:
+    case content::is_int32:
+    case content::is_int64:
+      return varint_size(zigzag(variable_access::signed_value(v)));
+
+    case content::is_uint8:
+    case content::is_uint16:
+    case content::is_uint32:
+    case content::is_uint64:
+      return varint_size(variable_access::unsigned_value(v));
+
+    case content::is_float:
+      return 4;
+
+    case content::is_double:
+      return 8;
+
+    case content::is_long_double:
+      return _cs_long_double;
+
+    case content::is_string:
+    {
+      const std::size_t n = v.as_string().size();
+      return varint_size(n) + n;
+    }
+
+    case content::is_string_list:
+    {
+      const variable::stringlist& l = v.as_string_list();
+      std::size_t n = varint_size(l.size());
+
+      for (const std::string& s : l)
+        n += varint_size(s.size()) + s.size();
+
+      return n;
+    }
+
+    case content::is_string_rope:
+    {
+      const variable::string_rope& r = v.as_string_rope();
+      std::size_t n = varint_size(r.size());
+
+      r.each([&n](const std::string& s) { n += varint_size(s.size()) + s.size(); });
+
+      return n;
+    }
+
+    case content::is_compact_string_list:
+    {
+      const variable::compact_string_list& c = v.as_compact_string_list();
+      std::size_t n = varint_size(c.size());
+
+      c.each([&n](const std::string& s) { n += varint_size(s.size()) + s.size(); });
+
+      return n;
+    }
+
+    case content::is_int32_array:
+    case content::is_int64_array:
+    case content::is_uint64_array:
+    case content::is_double_array:
+    case content::is_blob:
+    {
+      const std::size_t n = variable_access::array_size(v);
+      return varint_size(n) + n * variable_access::element_size(v.type());
+    }
+
+    case content::is_list:
+    {
+      const variable::list& l = v.as_list();
+      std::size_t n = varint_size(l.size());
+
+      for (const variable& e : l)
+        n += 1 + payload_size(e);
+
+      return n;
+    }
+
+    case content::is_map:
+    {
+      const variable::map& m = v.as_map();
+      std::size_t n = varint_size(m.size());
+
+      for (const variable::map::value_type& e : m)
+        n += 2 + payload_size(e.first) + payload_size(e.second);
+
+      return n;
+    }
+
+    default:
+      return 0;
+  }
+}
+
+// The buffer is known to be large enough
+std::uint8_t*
+put(
+    const variable& v,
+    std::uint8_t*   p) noexcept
+{
+  const content t = v.type();
+  *p++ = static_cast<std::uint8_t>(t);
+
+  switch (t)
+  {
+    case content::is_empty:
+      return p;
+
+    case content::is_bool:
+      *p++ = v.as_bool() ? 1 : 0;
+      return p;
+
+    case content::is_int8:
+    case content::is_int16:
+    case content::is_int32:
+    case content::is_int64:
+      return put_varint(p, zigzag(variable_access::signed_value(v)));
+
+    case content::is_uint8:
+    case content::is_uint16:
+    case content::is_uint32:
+    case content::is_uint64:
+      return put_varint(p, variable_access::unsigned_value(v));
+
+    case content::is_float:
+    {
+      const float f = v.as_float();
+      std::uint32_t x;
+      std::memcpy(&x, &f, sizeof(x));
+      return put_fixed(p, x, 4);
+    }
+
+    case content::is_double:
+      return put_fixed(p, bits_of(v.as_double()), 8);
+
+    case content::is_long_double:
+      return put_long_double(p, v.as_long_double());
+
+    case content::is_string:
+    {
+      const std::string& s = v.as_string();
+      p = put_varint(p, s.size());
+      std::memcpy(p, s.data(), s.size());
+      return p + s.size();
+    }
+
+    case content::is_string_list:
+    {
+      const variable::stringlist& l = v.as_string_list();
+      p = put_varint(p, l.size());
+
+      for (const std::string& s : l)
+      {
+        p = put_varint(p, s.size());
+        std::memcpy(p, s.data(), s.size());
+        p += s.size();
+      }
+
+      return p;
+    }
+
+    case content::is_string_rope:
+    {
+      const variable::string_rope& r = v.as_string_rope();
+      p = put_varint(p, r.size());
+
+      r.each([&p](const std::string& s) {
+        p = put_varint(p, s.size());
+        std::memcpy(p, s.data(), s.size());
+        p += s.size();
+      });
+
+      return p;
+    }
+
+    case content::is_compact_string_list:
+    {
+      const variable::compact_string_list& c = v.as_compact_string_list();
+      p = put_varint(p, c.size());
+
+      c.each([&p](const std::string& s) {
+        p = put_varint(p, s.size());
+        std::memcpy(p, s.data(), s.size());
+        p += s.size();
+      });
+
+      return p;
+    }
+
+    case content::is_int32_array:
+    case content::is_int64_array:
+    case content::is_uint64_array:
+    case content::is_double_array:
+    case content::is_blob:
+    {
+      const std::size_t n = variable_access::array_size(v);
+      p = put_varint(p, n);
+
+      return put_elements(p, variable_access::array_data(v), n, variable_access::element_size(t));
+    }
+
+    case content::is_list:
+    {
+      const variable::list& l = v.as_list();
+      p = put_varint(p, l.size());
+
+      for (const variable& e : l)
+        p = put(e, p);
+
+      return p;
+    }
+
+    case content::is_map:
+    {
+      const variable::map& m = v.as_map();
+      p = put_varint(p, m.size());
+
+      for (const variable::map::value_type& e : m)
+        p = put(e.second, put(e.first, p));
+
+      return p;
+    }
+
+    default:
+      return p;
+  }
+}
+
+} // End of anonymous namespace
+
+// Encode
+std::size_t
+encoded_size(
+    const variable& value) noexcept
+{
+  return 1 + payload_size(value);
+}
+
+std::size_t
+encode(
+    const variable& value,
+    std::uint8_t*   buffer,
+    std::size_t     capacity) noexcept
+{
+  // Scalars need at most a tag and a varint, skip the sizing pass for them
+  if (capacity < 1 + _cs_varint || !variable_access::is_inline(value.type()))
+  {
+    const std::size_t n = encoded_size(value);
+
+    if (n > capacity)
+      return 0;
+  }
+
+  return static_cast<std::size_t>(put(value, buffer) - buffer);
+}
+
+std::size_t
+encode(
+    const variable&            value,
+    std::vector<std::uint8_t>& buffer)
+{
+  const std::size_t offset = buffer.size();
+  const std::size_t n = encoded_size(value);
+
+  buffer.resize(offset + n);
+  put(value, buffer.data() + offset);
+
+  return n;
+}
+
+// Decode
+std::size_t
+decode(
+    const std::uint8_t* data,
+    std::size_t         size,
+    variable&           out)
+{
+  variable_view v;
+  const std::size_t n = decode(data, size, v);
+
+  if (n != 0)
+    out = v.materialize();
+
+  return n;
+}
+
+std::size_t
+decode(
+    const std::uint8_t* data,
+    std::size_t         size,
+    variable_view&      out) noexcept
+{
+  return variable_view::parse(data, size, out, _cs_depth);
+}
+
+// View
+std::size_t
+variable_view::parse(
+    const std::uint8_t* data,
+    std::size_t         size,
+    variable_view&      out,
+    unsigned            depth) noexcept
+{
+  if (size == 0 || data[0] >= static_cast<std::uint8_t>(content::last))
+    return 0;
+
+  const content t = static_cast<content>(data[0]);
+  const std::uint8_t* p = data + 1;
+  const std::uint8_t* end = data + size;
+
+  variable_view v;
+  v._type = t;
+
+  switch (t)
+  {
+    case content::is_empty:
+      break;
+
+    case content::is_bool:
+      if (p == end || *p > 1)
+        return 0;
+
+      v._uint64 = *p++;
+      break;
+
+    case content::is_int8:
+    case content::is_int16:
+    case content::is_int32:
+    case content::is_int64:
+    {
+      std::uint64_t x;
+      const std::size_t n = variable_view::varint(p, end, x);
+
+      v._int64 = unzigzag(x);
+
+      if (n == 0 || !fits_signed(t, v._int64))
+        return 0;
+
+      p += n;
+      break;
+    }
+
+    case content::is_uint8:
+    case content::is_uint16:
+    case content::is_uint32:
+    case content::is_uint64:
+    {
+      const std::size_t n = variable_view::varint(p, end, v._uint64);
+
+      if (n == 0 || !fits_unsigned(t, v._uint64))
+        return 0;
+
+      p += n;
+      break;
+    }
+
+    case content::is_float:
+    {
+      if (end - p < 4)
+        return 0;
+
+      const std::uint32_t x = static_cast<std::uint32_t>(get_fixed(p, 4));
+      float f;
+      std::memcpy(&f, &x, sizeof(f));
+
+      v._double = f;
+      p += 4;
+      break;
+    }
+
+    case content::is_double:
+      if (end - p < 8)
+        return 0;
+
+      v._double = double_of(get_fixed(p, 8));
+      p += 8;
+      break;
+
+    case content::is_long_double:
+      if (end - p < static_cast<std::ptrdiff_t>(_cs_long_double) || p[12] > 7)
+        return 0;
+
+      v._long_double = get_long_double(p);
+      p += _cs_long_double;
+      break;
+
+    case content::is_string:
+    {
+      std::uint64_t length;
+      const std::size_t n = variable_view::varint(p, end, length);
+
+      if (n == 0 || length > static_cast<std::uint64_t>(end - p - n))
+        return 0;
+
+      v._data = p + n;
+      v._size = static_cast<std::size_t>(length);
+      p += n + length;
+      break;
+    }
+
+    case content::is_string_list:
+    case content::is_string_rope:
+    case content::is_compact_string_list:
+    {
+      std::uint64_t count;
+      std::size_t n = variable_view::varint(p, end, count);
+
+      // Every element takes at least a byte
+      if (n == 0 || count > static_cast<std::uint64_t>(end - p - n))
+        return 0;
+
+      p += n;
+      v._data = p;
+      v._size = static_cast<std::size_t>(count);
+
+      for (std::uint64_t i = 0; i < count; ++i)
+      {
+        std::uint64_t length;
+        n = variable_view::varint(p, end, length);
+
+        if (n == 0 || length > static_cast<std::uint64_t>(end - p - n))
+          return 0;
+
+        p += n + length;
+      }
+
+      v._bytes = static_cast<std::size_t>(p - v._data);
+      break;
+    }
+
+    case content::is_int32_array:
+    case content::is_int64_array:
+    case content::is_uint64_array:
+    case content::is_double_array:
+    case content::is_blob:
+    {
+      std::uint64_t count;
+      const std::size_t n = variable_view::varint(p, end, count);
+      const std::size_t width = variable_access::element_size(t);
+
+      if (n == 0 || count > static_cast<std::uint64_t>(end - p - n) / width)
+        return 0;
+
+      v._data = p + n;
+      v._size = static_cast<std::size_t>(count);
+      v._bytes = v._size * width;
+      p += n + v._bytes;
+      break;
+    }
+
+    case content::is_list:
+    case content::is_map:
+    {
+      std::uint64_t count;
+      const std::size_t n = variable_view::varint(p, end, count);
+      const std::uint64_t values = t == content::is_map ? 2 : 1;
+
+      // Every value takes at least its tag
+      if (n == 0 || depth == 0 || count > static_cast<std::uint64_t>(end - p - n) / values)
+        return 0;
+
+      p += n;
+      v._data = p;
+      v._size = static_cast<std::size_t>(count);
+
+      for (std::uint64_t i = 0; i < count * values; ++i)
+      {
+        variable_view child;
+        const std::size_t m = parse(p, static_cast<std::size_t>(end - p), child, depth - 1);
+
+        if (m == 0)
+          return 0;
+
+        p += m;
+      }
+
+      v._bytes = static_cast<std::size_t>(p - v._data);
+      break;
+    }
+
+    default:
+      return 0;
+  }
+
+  out = v;
+
+  return static_cast<std::size_t>(p - data);
+}
+
+variable_view::variable_view() noexcept
+  : _type(content::is_empty),
+    _long_double(0),
+    _data(nullptr),
+    _size(0),
+    _bytes(0)
+{}
+
+std::size_t
+variable_view::varint(
+    const std::uint8_t* p,
+    const std::uint8_t* end,
+    std::uint64_t&      x) noexcept
+{
+  x = 0;
+
+  for (std::size_t i = 0; i < _cs_varint && p + i < end; ++i)
+  {
+    const std::uint64_t b = p[i];
+
+    // The tenth byte carries the top bit only
+    if (i == _cs_varint - 1 && b > 1)
+      return 0;
+
+    x |= (b & 0x7f) << (7 * i);
+
+    if ((b & 0x80) == 0)
+      return i + 1;
+  }
+
+  return 0;
+}
+
+void
+variable_view::throw_if_not(
+    bool        ok,
+    const char* expected) const
+{
+  if (!ok)
+  {
+    std::ostringstream str;
+    str << "variable_view: " << expected << " expected, got " << _type;
+
+    throw std::invalid_argument(str.str());
+  }
+}
+
+bool
+variable_view::as_bool() const
+{
+  throw_if_not(_type == content::is_bool, "bool");
+  return _uint64 != 0;
+}
+
+std::int64_t
+variable_view::as_int64() const
+{
+  throw_if_not(variable_access::is_signed(_type), "signed integer");
+  return _int64;
+}
+
+std::uint64_t
+variable_view::as_uint64() const
+{
+  throw_if_not(variable_access::is_unsigned(_type) && _type != content::is_bool, "unsigned integer");
+  return _uint64;
+}
+
+double
+variable_view::as_double() const
+{
+  throw_if_not(_type == content::is_float || _type == content::is_double, "float or double");
+  return _double;
+}
+
+long double
+variable_view::as_long_double() const
+{
+  if (_type == content::is_long_double)
+    return _long_double;
+
+  throw_if_not(_type == content::is_float || _type == content::is_double, "floating point");
+  return _double;
+}
+
+const char*
+variable_view::data() const
+{
+  throw_if_not(_type == content::is_string || _type == content::is_blob, "string or blob");
+  return reinterpret_cast<const char*>(_data);
+}
+
+variable_view::size_type
+variable_view::size() const
+{
+  throw_if_not(_type == content::is_string || _type == content::is_blob, "string or blob");
+  return _size;
+}
+
+std::string
+variable_view::as_string() const
+{
+  return std::string(data(), size());
+}
+
+variable_view::size_type
+variable_view::count() const
+{
+  throw_if_not(_type == content::is_string_list || _type == content::is_string_rope ||
+               _type == content::is_compact_string_list ||
+               _type == content::is_list || _type == content::is_map ||
+               variable_access::is_array(_type), "list, map or array");
+  return _size;
+}
+
+variable
+variable_view::materialize() const
+{
+  switch (_type)
+  {
+    case content::is_bool:        return variable(_uint64 != 0);
+    case content::is_int8:        return variable(static_cast<std::int8_t>(_int64));
+    case content::is_uint8:       return variable(static_cast<std::uint8_t>(_uint64));
+    case content::is_int16:       return variable(static_cast<std::int16_t>(_int64));
+    case content::is_uint16:      return variable(static_cast<std::uint16_t>(_uint64));
+    case content::is_int32:       return variable(static_cast<std::int32_t>(_int64));
+    case content::is_uint32:      return variable(static_cast<std::uint32_t>(_uint64));
+    case content::is_int64:       return variable(_int64);
+    case content::is_uint64:      return variable(_uint64);
+    case content::is_float:       return variable(static_cast<float>(_double));
+    case content::is_double:      return variable(_double);
+    case content::is_long_double: return variable(_long_double);
+    case content::is_string:      return variable(as_string());
+
+    case content::is_string_list:
+    {
+      variable::stringlist l;
+      l.reserve(_size);
+
+      each([&l](const char* s, size_type n) { l.emplace_back(s, n); });
+
+      return variable(l);
+    }
+
+    case content::is_string_rope:
+    {
+      variable::string_rope r;
+
+      each([&r](const char* s, size_type n) { r.push_back(std::string(s, n)); });
+
+      return variable(std::move(r));
+    }
+
+    case content::is_compact_string_list:
+    {
+      variable::compact_string_list c;
+
+      each([&c](const char* s, size_type n) { c.push_back(std::string(s, n)); });
+      c.shrink_to_fit();
+
+      return variable(std::move(c));
+    }
+
+    case content::is_int32_array:
+    case content::is_int64_array:
+    case content::is_uint64_array:
+    case content::is_double_array:
+    case content::is_blob:
+    {
+      variable result;
+      get_elements(_data, variable_access::make_array(result, _type, _size), _size,
+                   variable_access::element_size(_type));
+      variable_access::rehash(result);
+
+      return result;
+    }
+
+    case content::is_list:
+    {
+      variable::list l;
+      l.reserve(_size);
+
+      const std::uint8_t* p = _data;
+      const std::uint8_t* end = _data + _bytes;
+
+      for (size_type i = 0; i < _size; ++i)
+      {
+        variable_view child;
+        p += parse(p, static_cast<std::size_t>(end - p), child, _cs_depth);
+        l.push_back(child.materialize());
+      }
+
+      return variable(std::move(l));
+    }
+
+    case content::is_map:
+    {
+      std::vector<variable::map::value_type> entries;
+      entries.reserve(_size);
+
+      const std::uint8_t* p = _data;
+      const std::uint8_t* end = _data + _bytes;
+
+      for (size_type i = 0; i < _size; ++i)
+      {
+        variable_view key, value;
+        p += parse(p, static_cast<std::size_t>(end - p), key, _cs_depth);
+        p += parse(p, static_cast<std::size_t>(end - p), value, _cs_depth);
+        entries.emplace_back(key.materialize(), value.materialize());
+      }
+
+      return variable(variable::map(std::move(entries)));
+    }
+
+    default:
+      return variable();
+  }
+}
+
+} // End of egg namespace
+
+/* End of file */
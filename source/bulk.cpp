@@ -0,0 +1,184 @@
+/*!
+ *	\file		bulk.cpp
+ *	\brief		Implements bulk hash, compare and dedup operations over variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <algorithm>
+
+#include <egg/bulk.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+namespace
+{
+
+typedef variable::content content;
+
+const std::size_t _cs_block = 256;
+
+// Slot marker of the dedup table
+const std::size_t _cs_free = static_cast<std::size_t>(-1);
+
+inline std::size_t
+mix(
+    std::uint32_t h) noexcept
+{
+  // Spread the hash bits, std::hash of integers is identity
+  std::uint64_t x = h;
+  x *= 0x9e3779b97f4a7c15ull;
+
+  return static_cast<std::size_t>(x ^ (x >> 29));
+}
+
+} // End of anonymous namespace
+
+// Hash
+void
+hash_all(
+    const variable* v,
+    std::size_t     n,
+    std::uint64_t*  out) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = variable_access::hash(v[i]);
+}
+
+void
+hash_all(
+    const variable_vector& vv,
+    std::uint64_t*         out) noexcept
+{
+  const std::uint32_t* hashes = vv.hashes();
+  const std::size_t n = vv.size();
+
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = hashes[i];
+}
+
+// Compare
+std::size_t
+equal_all(
+    const variable* lhs,
+    const variable* rhs,
+    std::size_t     n,
+    bool*           out) noexcept
+{
+  std::size_t result = 0;
+  unsigned char header[_cs_block], deep[_cs_block];
+
+  for (std::size_t offset = 0; offset < n; offset += _cs_block)
+  {
+    const std::size_t m = std::min(n - offset, _cs_block);
+    const variable* a = lhs + offset;
+    const variable* b = rhs + offset;
+
+    // Pass 1: type, hash and inline payload, no branches
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      const content t = variable_access::type(a[i]);
+      const bool same = (t == variable_access::type(b[i])) &
+                        (variable_access::hash(a[i]) == variable_access::hash(b[i]));
+      const bool scalar = variable_access::is_inline(t) | (t == content::is_empty);
+      const bool payload = variable_access::data(a[i])._uint64 ==
+                           variable_access::data(b[i])._uint64;
+
+      header[i] = same & (!scalar | payload);
+      deep[i] = same & !scalar;
+    }
+
+    // Pass 2: deep comparison of the boxed candidates
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      bool equal = header[i];
+
+      if (deep[i])
+        equal = (a[i] == b[i]);
+
+      out[offset + i] = equal;
+      result += equal;
+    }
+  }
+
+  return result;
+}
+
+// Distinct
+std::vector<std::size_t>
+distinct(
+    const variable* v,
+    std::size_t     n)
+{
+  std::vector<std::size_t> result;
+
+  if (n == 0)
+    return result;
+
+  // Open addressing table of positions, load factor <= 0.5
+  std::size_t capacity = 16;
+  while (capacity < n * 2)
+    capacity <<= 1;
+
+  const std::size_t mask = capacity - 1;
+  std::vector<std::size_t> table(capacity, _cs_free);
+  std::vector<std::uint32_t> hashes(capacity);
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const std::uint32_t h = variable_access::hash(v[i]);
+    std::size_t slot = mix(h) & mask;
+    bool found = false;
+
+    while (table[slot] != _cs_free)
+    {
+      if (hashes[slot] == h && v[table[slot]] == v[i])
+      {
+        found = true;
+        break;
+      }
+
+      slot = (slot + 1) & mask;
+    }
+
+    if (!found)
+    {
+      table[slot] = i;
+      hashes[slot] = h;
+      result.push_back(i);
+    }
+  }
+
+  return result;
+}
+
+// Dedup
+std::size_t
+dedup(
+    std::vector<variable>& values)
+{
+  const std::vector<std::size_t> keep = distinct(values.data(), values.size());
+  const std::size_t removed = values.size() - keep.size();
+
+  if (removed == 0)
+    return 0;
+
+  // Positions are ascending, so moving down in place is safe
+  for (std::size_t i = 0; i < keep.size(); ++i)
+    if (keep[i] != i)
+      values[i] = std::move(values[keep[i]]);
+
+  values.erase(values.begin() + keep.size(), values.end());
+
+  return removed;
+}
+
+} // End of egg namespace
+
+/* End of file */
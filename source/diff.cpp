@@ -0,0 +1,300 @@
+/*!
+ *	\file		diff.cpp
+ *	\brief		Implements change sets between maps and trees of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <egg/diff.hpp>
+
+
+namespace egg
+{
+
+namespace
+{
+
+typedef diff::change::kind kind;
+
+inline std::uint64_t
+mix(
+    std::uint64_t x) noexcept
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+
+  return x;
+}
+
+// Digest of every node, by node index. Children are summed, so the order of
+// the siblings doesn't matter
+void
+digests(
+    const tree&                 t,
+    std::vector<std::uint64_t>& out)
+{
+  // Breadth-first, a parent comes before its children
+  std::vector<tree::const_node> order(1, t.root());
+  tree::index_type last = 0;
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    const tree::const_node parent = order[i];
+
+    for (const tree::const_node c : parent)
+    {
+      order.push_back(c);
+      last = std::max(last, c.index());
+    }
+  }
+
+  out.assign(last + 1, 0);
+
+  for (auto n = order.rbegin(); n != order.rend(); ++n)
+  {
+    std::uint64_t children = 0;
+
+    for (const tree::const_node c : *n)
+      children += out[c.index()];
+
+    const std::uint64_t own = (static_cast<std::uint64_t>(n->key().hash()) << 32) | n->value().hash();
+
+    out[n->index()] = mix(own + mix(children + 0x9e3779b97f4a7c15ull));
+  }
+}
+
+// Node at the first segments of the path. Handles assign values, so the
+// walk recurses instead of reassigning one
+tree::node
+descend(
+    tree::node      n,
+    const path&     p,
+    path::size_type i,
+    path::size_type end,
+    bool            create)
+{
+  if (i == end || !n)
+    return n;
+
+  return descend(create ? n[p[i]] : n.find(p[i]), p, i + 1, end, create);
+}
+
+bool
+equal(
+    const tree::const_node& a,
+    const tree::const_node& b)
+{
+  if (a.value() != b.value() || a.size() != b.size())
+    return false;
+
+  for (const tree::const_node c : b)
+  {
+    const tree::const_node o = a.find(c.key());
+
+    if (!o || !equal(o, c))
+      return false;
+  }
+
+  return true;
+}
+
+// Walks the subtrees that differ
+struct walker
+{
+	std::vector<diff::change>&	_changes;
+	std::vector<std::uint64_t>	_from;
+	std::vector<std::uint64_t>	_to;
+	std::vector<variable>		_path;
+	bool				_verify;
+
+	void
+	push(
+	    kind            k,
+	    const variable& value)
+	{
+	  _changes.push_back(diff::change { k, path(_path), value });
+	}
+
+	void
+	added(
+	    const tree::const_node& n)
+	{
+	  push(kind::added, n.value());
+
+	  for (const tree::const_node c : n)
+	  {
+	    _path.push_back(c.key());
+	    added(c);
+	    _path.pop_back();
+	  }
+	}
+
+	void
+	walk(
+	    const tree::const_node& a,
+	    const tree::const_node& b)
+	{
+	  tree::size_type matched = 0;
+
+	  for (const tree::const_node c : b)
+	  {
+	    const tree::const_node o = a.find(c.key());
+
+	    _path.push_back(c.key());
+
+	    if (!o)
+	      added(c);
+	    else
+	    {
+	      ++matched;
+
+	      if (_from[o.index()] != _to[c.index()] || (_verify && !equal(o, c)))
+	      {
+	        if (o.value() != c.value())
+	          push(kind::modified, c.value());
+
+	        walk(o, c);
+	      }
+	    }
+
+	    _path.pop_back();
+	  }
+
+	  // Every child of a is in b
+	  if (matched == a.size())
+	    return;
+
+	  for (const tree::const_node c : a)
+	    if (!b.find(c.key()))
+	    {
+	      _path.push_back(c.key());
+	      push(kind::removed, variable());
+	      _path.pop_back();
+	    }
+	}
+};
+
+} // End of anonymous namespace
+
+// Construct/destruct
+diff::diff() noexcept
+{}
+
+diff::~diff() noexcept
+{}
+
+// Copy
+diff::diff(
+    const diff& other)
+  : _changes(other._changes)
+{}
+
+diff&
+diff::operator=(
+    const diff& other)
+{
+  if (this != &other)
+    _changes = other._changes;
+
+  return *this;
+}
+
+// Move
+diff::diff(
+    diff&& other) noexcept
+  : _changes(std::move(other._changes))
+{}
+
+diff&
+diff::operator=(
+    diff&& other) noexcept
+{
+  if (this != &other)
+    _changes = std::move(other._changes);
+
+  return *this;
+}
+
+// Compare
+diff
+diff::compare(
+    const tree& from,
+    const tree& to,
+    bool        verify)
+{
+  diff result;
+  walker w { result._changes, {}, {}, {}, verify };
+
+  digests(from, w._from);
+  digests(to, w._to);
+
+  if (w._from[0] != w._to[0] || verify)
+    w.walk(from.root(), to.root());
+
+  return result;
+}
+
+void
+diff::add(
+    change::kind    k,
+    const variable& key,
+    const variable& value)
+{
+  _changes.push_back(change { k, path({ key }), value });
+}
+
+// Apply
+void
+diff::apply(
+    tree& t) const
+{
+  for (const change& c : _changes)
+  {
+    const path::size_type n = c._path.size();
+
+    if (n == 0)
+      continue;
+
+    if (c._kind != change::kind::removed)
+      descend(t.root(), c._path, 0, n, true) = c._value;
+    else
+    {
+      tree::node parent = descend(t.root(), c._path, 0, n - 1, false);
+
+      if (parent)
+        parent.erase(c._path[n - 1]);
+    }
+  }
+}
+
+void
+diff::check(
+    const change& c)
+{
+  if (c._path.size() != 1)
+    throw std::invalid_argument("diff::apply(): " + c._path.to_string() + " is not a map key");
+}
+
+diff::size_type
+diff::count(
+    change::kind k) const noexcept
+{
+  size_type result = 0;
+
+  for (const change& c : _changes)
+    result += c._kind == k;
+
+  return result;
+}
+
+} // End of egg namespace
+
+/* End of file */
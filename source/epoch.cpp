@@ -0,0 +1,289 @@
+/*!
+ *	\file		epoch.cpp
+ *	\brief		Implements epoch-based memory reclamation
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+
+#include <egg/epoch.hpp>
+
+
+namespace egg
+{
+
+// Per thread announcement. Records are never freed while the domain lives,
+// a thread that exits hands its record over to the next one
+struct epoch_domain::record
+{
+	std::atomic<std::uint64_t>	_epoch;		// (epoch << 1) | 1 when pinned, 0 otherwise
+	std::atomic<bool>		_used;
+	std::size_t			_nesting;	// owner thread only
+	record*				_next;
+};
+
+struct epoch_domain::retired
+{
+	void*		_pointer;
+	deleter		_deleter;
+	std::uint64_t	_epoch;
+	retired*	_next;
+};
+
+namespace
+{
+
+// Collect after that many retirements
+const std::size_t _cs_collect_every = 64;
+
+// Domains alive, so an exiting thread knows whose records it may touch
+std::mutex& domains_lock()
+{
+  static std::mutex m;
+  return m;
+}
+
+std::unordered_set<std::uint64_t>& domains()
+{
+  static std::unordered_set<std::uint64_t> d;
+  return d;
+}
+
+std::atomic<std::uint64_t> _ids(0);
+
+// Records the calling thread holds, released when it exits
+struct thread_records
+{
+  std::vector<std::pair<std::uint64_t, std::atomic<bool>*>> _held;
+  std::vector<std::pair<std::uint64_t, void*>> _cache;
+
+  ~thread_records()
+  {
+    std::lock_guard<std::mutex> lock(domains_lock());
+
+    for (const auto& h : _held)
+      if (domains().count(h.first))
+        h.second->store(false, std::memory_order_release);
+  }
+};
+
+thread_local thread_records _tl_records;
+
+} // End of anonymous namespace
+
+// Construct/destruct
+epoch_domain::epoch_domain()
+  : _epoch(1),
+    _records(nullptr),
+    _retired(nullptr),
+    _pending(0),
+    _id(_ids.fetch_add(1, std::memory_order_relaxed) + 1)
+{
+  _collecting.clear();
+
+  std::lock_guard<std::mutex> lock(domains_lock());
+  domains().insert(_id);
+}
+
+epoch_domain::~epoch_domain() noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(domains_lock());
+    domains().erase(_id);
+  }
+
+  // Nobody reads any more
+  for (retired* r = _retired.load(std::memory_order_acquire); r != nullptr; )
+  {
+    retired* next = r->_next;
+    r->_deleter(r->_pointer);
+    delete r;
+    r = next;
+  }
+
+  for (record* r = _records.load(std::memory_order_acquire); r != nullptr; )
+  {
+    record* next = r->_next;
+    delete r;
+    r = next;
+  }
+}
+
+epoch_domain&
+epoch_domain::global()
+{
+  // Never destroyed, threads may outlive static destruction
+  static epoch_domain* d = new epoch_domain();
+  return *d;
+}
+
+// Guard
+epoch_domain::guard::guard(
+    epoch_domain& d)
+  : _record(d.acquire())
+{
+  if (_record->_nesting++ == 0)
+  {
+    const std::uint64_t e = d._epoch.load(std::memory_order_relaxed);
+
+    // Full barrier: later loads of shared pointers must not pass the
+    // announcement (an exchange is cheaper than a store and a fence)
+    _record->_epoch.exchange((e << 1) | 1, std::memory_order_seq_cst);
+  }
+}
+
+epoch_domain::guard::~guard() noexcept
+{
+  if (_record != nullptr && --_record->_nesting == 0)
+    _record->_epoch.store(0, std::memory_order_release);
+}
+
+// Records
+epoch_domain::record*
+epoch_domain::acquire()
+{
+  thread_records& tl = _tl_records;
+
+  for (const auto& c : tl._cache)
+    if (c.first == _id)
+      return static_cast<record*>(c.second);
+
+  // Reuse a record of an exited thread
+  record* r = _records.load(std::memory_order_acquire);
+
+  for (; r != nullptr; r = r->_next)
+  {
+    bool expected = false;
+
+    if (!r->_used.load(std::memory_order_relaxed) &&
+        r->_used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+      break;
+  }
+
+  if (r == nullptr)
+  {
+    r = new record();
+    r->_epoch.store(0, std::memory_order_relaxed);
+    r->_used.store(true, std::memory_order_relaxed);
+    r->_next = _records.load(std::memory_order_relaxed);
+
+    while (!_records.compare_exchange_weak(r->_next, r, std::memory_order_release, std::memory_order_relaxed))
+      ;
+  }
+
+  r->_nesting = 0;
+
+  tl._cache.push_back(std::make_pair(_id, static_cast<void*>(r)));
+  tl._held.push_back(std::make_pair(_id, &r->_used));
+
+  return r;
+}
+
+// Reclamation
+void
+epoch_domain::retire(
+    void*   pointer,
+    deleter d)
+{
+  retired* r = new retired { pointer, d, _epoch.load(std::memory_order_seq_cst), nullptr };
+
+  r->_next = _retired.load(std::memory_order_relaxed);
+
+  while (!_retired.compare_exchange_weak(r->_next, r, std::memory_order_release, std::memory_order_relaxed))
+    ;
+
+  if (_pending.fetch_add(1, std::memory_order_relaxed) % _cs_collect_every == _cs_collect_every - 1)
+    collect();
+}
+
+bool
+epoch_domain::advance() noexcept
+{
+  std::uint64_t e = _epoch.load(std::memory_order_seq_cst);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  for (record* r = _records.load(std::memory_order_acquire); r != nullptr; r = r->_next)
+  {
+    const std::uint64_t v = r->_epoch.load(std::memory_order_acquire);
+
+    if ((v & 1) && (v >> 1) != e)
+      return false;
+  }
+
+  return _epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+}
+
+epoch_domain::size_type
+epoch_domain::collect() noexcept
+{
+  if (_collecting.test_and_set(std::memory_order_acquire))
+    return 0;
+
+  advance();
+
+  const std::uint64_t e = _epoch.load(std::memory_order_seq_cst);
+
+  retired* list = _retired.exchange(nullptr, std::memory_order_acquire);
+  retired* keep = nullptr;
+  retired* tail = nullptr;
+  size_type freed = 0;
+
+  while (list != nullptr)
+  {
+    retired* next = list->_next;
+
+    if (list->_epoch + 2 <= e)
+    {
+      list->_deleter(list->_pointer);
+      delete list;
+      ++freed;
+    }
+    else
+    {
+      list->_next = keep;
+      keep = list;
+
+      if (tail == nullptr)
+        tail = list;
+    }
+
+    list = next;
+  }
+
+  // Put back what is still reachable
+  if (keep != nullptr)
+  {
+    tail->_next = _retired.load(std::memory_order_relaxed);
+
+    while (!_retired.compare_exchange_weak(tail->_next, keep, std::memory_order_release, std::memory_order_relaxed))
+      ;
+  }
+
+  _pending.fetch_sub(freed, std::memory_order_relaxed);
+  _collecting.clear(std::memory_order_release);
+
+  return freed;
+}
+
+epoch_domain::size_type
+epoch_domain::pending() const noexcept
+{
+  return _pending.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+epoch_domain::epoch() const noexcept
+{
+  return _epoch.load(std::memory_order_relaxed);
+}
+
+} // End of egg namespace
+
+/* End of file */
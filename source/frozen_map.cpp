@@ -0,0 +1,391 @@
+/*!
+ *	\file		frozen_map.cpp
+ *	\brief		Implements immutable perfect-hash map of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <egg/frozen_map.hpp>
+
+
+namespace egg
+{
+
+namespace
+{
+
+// Give up on a bucket after that many displacements
+const std::uint32_t _cs_attempts = 1u << 24;
+
+inline std::uint32_t
+mix(
+    std::uint32_t h,
+    std::uint32_t seed) noexcept
+{
+  std::uint64_t x = (static_cast<std::uint64_t>(seed) << 32) | h;
+
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+
+  return static_cast<std::uint32_t>(x);
+}
+
+// Map a 32 bit value onto [0, n) without division
+inline std::size_t
+reduce(
+    std::uint32_t x,
+    std::size_t   n) noexcept
+{
+  return static_cast<std::size_t>((static_cast<std::uint64_t>(x) * n) >> 32);
+}
+
+// Bucket seed is a different stream than the displacement seeds
+const std::uint32_t _cs_bucket_seed = 0x9e3779b9u;
+
+} // End of anonymous namespace
+
+const frozen_map::size_type frozen_map::npos;
+
+// Construct/destruct
+frozen_map::frozen_map() noexcept
+  : _root(npos)
+{}
+
+frozen_map::~frozen_map() noexcept
+{}
+
+// Copy
+frozen_map::frozen_map(
+    const frozen_map& other)
+  : _levels(other._levels),
+    _seeds(other._seeds),
+    _entries(other._entries),
+    _root(other._root)
+{}
+
+frozen_map&
+frozen_map::operator=(
+    const frozen_map& other)
+{
+  if (this != &other)
+  {
+    frozen_map copy(other);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+// Move
+frozen_map::frozen_map(
+    frozen_map&& other) noexcept
+  : _levels(std::move(other._levels)),
+    _seeds(std::move(other._seeds)),
+    _entries(std::move(other._entries)),
+    _root(other._root)
+{
+  other._root = npos;
+}
+
+frozen_map&
+frozen_map::operator=(
+    frozen_map&& other) noexcept
+{
+  if (this != &other)
+  {
+    _levels = std::move(other._levels);
+    _seeds = std::move(other._seeds);
+    _entries = std::move(other._entries);
+    _root = other._root;
+
+    other._root = npos;
+  }
+
+  return *this;
+}
+
+// Size
+frozen_map::size_type
+frozen_map::size() const noexcept
+{
+  return _root == npos ? 0 : _levels[_root]._size;
+}
+
+bool
+frozen_map::empty() const noexcept
+{
+  return size() == 0;
+}
+
+// Lookup
+const variable*
+frozen_map::find(
+    const variable& key) const noexcept
+{
+  if (_root == npos)
+    return nullptr;
+
+  const size_type e = lookup(_root, key);
+
+  return e == npos ? nullptr : &_entries[e]._value;
+}
+
+const variable&
+frozen_map::at(
+    const variable& key) const
+{
+  const variable* v = find(key);
+
+  if (v == nullptr)
+    throw std::out_of_range("frozen_map::at(): key " +
+                            key.to_string() + " not found");
+
+  return *v;
+}
+
+frozen_map::size_type
+frozen_map::lookup(
+    size_type       l,
+    const variable& key) const noexcept
+{
+  const level& lv = _levels[l];
+
+  if (lv._size == 0)
+    return npos;
+
+  const std::uint32_t h = key.hash();
+  const std::uint32_t seed = _seeds[lv._seeds + reduce(mix(h, _cs_bucket_seed), lv._buckets)];
+  size_type e = lv._offset + reduce(mix(h, seed), lv._size);
+
+  if (_entries[e]._hash != h)
+    return npos;
+
+  for (; e != npos; e = _entries[e]._next)
+    if (_entries[e]._key == key)
+      return e;
+
+  return npos;
+}
+
+// Build
+frozen_map::size_type
+frozen_map::place(
+    std::vector<variable>&  keys,
+    std::vector<variable>&  values,
+    std::vector<size_type>& children)
+{
+  const size_type n = keys.size();
+  const size_type buckets = n / 2 + 1;
+
+  // Keys with the same hash can't be told apart by any displacement. Only
+  // the first of them is placed, the others are chained behind it
+  std::vector<size_type> head(n, npos);
+  {
+    std::vector<std::pair<std::uint32_t, size_type>> hashes(n);
+
+    for (size_type i = 0; i < n; ++i)
+      hashes[i] = std::make_pair(keys[i].hash(), i);
+
+    std::sort(hashes.begin(), hashes.end());
+
+    for (size_type i = 1, first = 0; i < n; ++i)
+      if (hashes[i].first == hashes[first].first)
+        head[hashes[i].second] = hashes[first].second;
+      else
+        first = i;
+  }
+
+  level lv;
+  lv._offset = _entries.size();
+  lv._size = n;
+  lv._seeds = _seeds.size();
+  lv._buckets = buckets;
+
+  // Group the keys by bucket
+  std::vector<std::vector<size_type>> groups(buckets);
+
+  for (size_type i = 0; i < n; ++i)
+    if (head[i] == npos)
+      groups[reduce(mix(keys[i].hash(), _cs_bucket_seed), buckets)].push_back(i);
+
+  // Largest buckets first, they are the hardest to place
+  std::vector<size_type> order(buckets);
+  for (size_type b = 0; b < buckets; ++b)
+    order[b] = b;
+
+  std::sort(order.begin(), order.end(),
+    [&groups](size_type a, size_type b) { return groups[a].size() > groups[b].size(); });
+
+  std::vector<std::uint32_t> seeds(buckets, 0);
+  std::vector<size_type> slot_of(n, npos);
+  std::vector<bool> taken(n, false);
+  std::vector<size_type> slots;
+
+  for (size_type b : order)
+  {
+    const std::vector<size_type>& g = groups[b];
+
+    if (g.empty())
+      break;
+
+    std::uint32_t seed = 0;
+
+    for (; seed < _cs_attempts; ++seed)
+    {
+      slots.clear();
+
+      for (size_type i : g)
+      {
+        const size_type s = reduce(mix(keys[i].hash(), seed), n);
+
+        if (taken[s] || std::find(slots.begin(), slots.end(), s) != slots.end())
+          break;
+
+        slots.push_back(s);
+      }
+
+      if (slots.size() == g.size())
+        break;
+    }
+
+    if (seed == _cs_attempts)
+      throw std::runtime_error("frozen_map::freeze(): no perfect hash found");
+
+    seeds[b] = seed;
+
+    for (size_type k = 0; k < g.size(); ++k)
+    {
+      taken[slots[k]] = true;
+      slot_of[g[k]] = slots[k];
+    }
+  }
+
+  // Chained keys take the slots left free, one per chained key
+  std::vector<size_type> next(n, npos), tail(n, npos);
+  size_type free_slot = 0;
+
+  for (size_type i = 0; i < n; ++i)
+  {
+    if (head[i] == npos)
+      continue;
+
+    while (taken[free_slot])
+      ++free_slot;
+
+    taken[free_slot] = true;
+    slot_of[i] = free_slot;
+
+    const size_type t = tail[head[i]] == npos ? slot_of[head[i]] : tail[head[i]];
+    next[t] = free_slot;
+    tail[head[i]] = free_slot;
+  }
+
+  // Lay out the entries in slot order
+  _entries.resize(lv._offset + n);
+
+  for (size_type i = 0; i < n; ++i)
+  {
+    const size_type s = slot_of[i];
+    entry& e = _entries[lv._offset + s];
+
+    e._hash = keys[i].hash();
+    e._child = children[i];
+    e._next = next[s] == npos ? npos : lv._offset + next[s];
+    e._key = std::move(keys[i]);
+    e._value = std::move(values[i]);
+  }
+
+  _seeds.insert(_seeds.end(), seeds.begin(), seeds.end());
+  _levels.push_back(lv);
+
+  return _levels.size() - 1;
+}
+
+frozen_map
+frozen_map::freeze(
+    const tree& t)
+{
+  frozen_map result;
+  result._root = result.build(t.root());
+
+  return result;
+}
+
+frozen_map::size_type
+frozen_map::build(
+    const tree::const_node& n)
+{
+  std::vector<variable> keys, values;
+  std::vector<size_type> children;
+
+  keys.reserve(n.size());
+  values.reserve(n.size());
+  children.reserve(n.size());
+
+  for (const tree::const_node c : n)
+  {
+    keys.push_back(c.key());
+    values.push_back(c.value());
+    children.push_back(c.empty() ? npos : build(c));
+  }
+
+  return place(keys, values, children);
+}
+
+// Node
+const variable*
+frozen_map::node::key() const noexcept
+{
+  return (_map == nullptr || _entry == npos) ? nullptr : &_map->_entries[_entry]._key;
+}
+
+const variable*
+frozen_map::node::value() const noexcept
+{
+  return (_map == nullptr || _entry == npos) ? nullptr : &_map->_entries[_entry]._value;
+}
+
+frozen_map::node
+frozen_map::node::operator[] (
+    const variable& key) const noexcept
+{
+  if (_map == nullptr || _level == npos)
+    return node();
+
+  const size_type e = _map->lookup(_level, key);
+
+  if (e == npos)
+    return node();
+
+  return node(_map, e, _map->_entries[e]._child);
+}
+
+frozen_map::size_type
+frozen_map::node::size() const noexcept
+{
+  return (_map == nullptr || _level == npos) ? 0 : _map->_levels[_level]._size;
+}
+
+frozen_map::node
+frozen_map::node::child(
+    size_type i) const noexcept
+{
+  if (i >= size())
+    return node();
+
+  const size_type e = _map->_levels[_level]._offset + i;
+
+  return node(_map, e, _map->_entries[e]._child);
+}
+
+} // End of egg namespace
+
+/* End of file */
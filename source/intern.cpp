@@ -0,0 +1,380 @@
+/*!
+ *	\file		intern.cpp
+ *	\brief		Implements hash-consing table of immutable variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <egg/intern.hpp>
+
+
+namespace egg
+{
+
+namespace
+{
+
+const variable _cs_empty;
+
+// Heap a copy of the value allocates
+inline std::size_t
+payload(
+    const variable& v) noexcept
+{
+  return v.memory_usage() - sizeof(variable);
+}
+
+} // End of anonymous namespace
+
+// The table holds one reference while the value is listed
+struct interned::node
+{
+  template <typename V>
+  node(V&& value)
+    : _refs(1),
+      _listed(true),
+      _next(nullptr),
+      _value(std::forward<V>(value))
+  {}
+
+  std::atomic<size_type>	_refs;
+  std::atomic<bool>		_listed;
+  node*				_next;
+  const variable		_value;
+};
+
+// Chained buckets, a power of two at most one value per bucket on average.
+// Padded, so the lock of a shard and the buckets of its neighbour never
+// share a cache line
+struct intern_table::shard
+{
+  shard()
+    : _buckets(16, nullptr),
+      _count(0),
+      _requests(0),
+      _hits(0)
+  {}
+
+  mutable std::mutex			_lock;
+  std::vector<interned::node*>		_buckets;
+  size_type				_count;
+  size_type				_requests;
+  size_type				_hits;
+  char					_pad[64];
+};
+
+// interned
+interned::interned() noexcept
+  : _node(nullptr)
+{}
+
+interned::interned(
+    node* n) noexcept
+  : _node(n)
+{}
+
+interned::~interned() noexcept
+{
+  release();
+}
+
+interned::interned(
+    const interned& other) noexcept
+  : _node(other._node)
+{
+  if (_node != nullptr)
+    _node->_refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+interned&
+interned::operator=(
+    const interned& other) noexcept
+{
+  if (_node != other._node)
+  {
+    release();
+    _node = other._node;
+
+    if (_node != nullptr)
+      _node->_refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return *this;
+}
+
+interned::interned(
+    interned&& other) noexcept
+  : _node(other._node)
+{
+  other._node = nullptr;
+}
+
+interned&
+interned::operator=(
+    interned&& other) noexcept
+{
+  if (this != &other)
+  {
+    release();
+    _node = other._node;
+    other._node = nullptr;
+  }
+
+  return *this;
+}
+
+const variable*
+interned::get() const noexcept
+{
+  return _node == nullptr ? &_cs_empty : &_node->_value;
+}
+
+interned::size_type
+interned::use_count() const noexcept
+{
+  if (_node == nullptr)
+    return 0;
+
+  return _node->_refs.load(std::memory_order_acquire) -
+         (_node->_listed.load(std::memory_order_acquire) ? 1 : 0);
+}
+
+void
+interned::release() noexcept
+{
+  if (_node != nullptr &&
+      _node->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    delete _node;
+
+  _node = nullptr;
+}
+
+// intern_table
+intern_table::intern_table(
+    size_type n)
+  : _mask(0)
+{
+  if (n == 0)
+    n = 4 * std::max<size_type>(std::thread::hardware_concurrency(), 4);
+
+  size_type count = 1;
+  while (count < n)
+    count *= 2;
+
+  _shards.reset(new shard[count]);
+  _mask = count - 1;
+}
+
+intern_table::~intern_table() noexcept
+{
+  for (size_type i = 0; i <= _mask; ++i)
+    for (interned::node* head : _shards[i]._buckets)
+      while (head != nullptr)
+      {
+        interned::node* next = head->_next;
+
+        // Handles that are left keep their value alive
+        head->_listed.store(false, std::memory_order_release);
+
+        if (head->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          delete head;
+
+        head = next;
+      }
+}
+
+intern_table::shard&
+intern_table::select(
+    std::uint32_t hash) const noexcept
+{
+  // Top bits of a multiplicative hash, the buckets use the low ones
+  const std::uint32_t h = hash * 0x9e3779b9u;
+
+  return _shards[(h >> 16) & _mask];
+}
+
+template <typename V>
+interned
+intern_table::insert(
+    V&& value)
+{
+  const std::uint32_t h = value.hash();
+  shard& s = select(h);
+  std::lock_guard<std::mutex> lock(s._lock);
+
+  ++s._requests;
+
+  interned::node*& head = s._buckets[h & (s._buckets.size() - 1)];
+
+  for (interned::node* n = head; n != nullptr; n = n->_next)
+    if (n->_value.hash() == h && n->_value == value)
+    {
+      ++s._hits;
+      n->_refs.fetch_add(1, std::memory_order_relaxed);
+
+      return interned(n);
+    }
+
+  interned::node* n = new interned::node(std::forward<V>(value));
+  n->_refs.fetch_add(1, std::memory_order_relaxed);
+  n->_next = head;
+  head = n;
+
+  if (++s._count > s._buckets.size())
+  {
+    // Grow twice and relink the chains
+    std::vector<interned::node*> buckets(s._buckets.size() * 2, nullptr);
+    const std::size_t mask = buckets.size() - 1;
+
+    for (interned::node* b : s._buckets)
+      while (b != nullptr)
+      {
+        interned::node* next = b->_next;
+        interned::node*& to = buckets[b->_value.hash() & mask];
+
+        b->_next = to;
+        to = b;
+        b = next;
+      }
+
+    s._buckets.swap(buckets);
+  }
+
+  return interned(n);
+}
+
+interned
+intern_table::intern(
+    const variable& value)
+{
+  return insert(value);
+}
+
+interned
+intern_table::intern(
+    variable&& value)
+{
+  return insert(std::move(value));
+}
+
+interned
+intern_table::find(
+    const variable& value) const
+{
+  const std::uint32_t h = value.hash();
+  shard& s = select(h);
+  std::lock_guard<std::mutex> lock(s._lock);
+
+  for (interned::node* n = s._buckets[h & (s._buckets.size() - 1)]; n != nullptr; n = n->_next)
+    if (n->_value.hash() == h && n->_value == value)
+    {
+      n->_refs.fetch_add(1, std::memory_order_relaxed);
+      return interned(n);
+    }
+
+  return interned();
+}
+
+intern_table::size_type
+intern_table::purge()
+{
+  size_type dropped = 0;
+
+  for (size_type i = 0; i <= _mask; ++i)
+  {
+    shard& s = _shards[i];
+    std::lock_guard<std::mutex> lock(s._lock);
+
+    for (interned::node*& head : s._buckets)
+    {
+      interned::node** link = &head;
+
+      // New handles are only made under the lock, so a value that only
+      // the table refers to stays that way
+      while (*link != nullptr)
+      {
+        interned::node* n = *link;
+
+        if (n->_refs.load(std::memory_order_acquire) == 1)
+        {
+          *link = n->_next;
+          delete n;
+
+          --s._count;
+          ++dropped;
+        }
+        else
+          link = &n->_next;
+      }
+    }
+  }
+
+  return dropped;
+}
+
+intern_table::size_type
+intern_table::size() const
+{
+  size_type count = 0;
+
+  for (size_type i = 0; i <= _mask; ++i)
+  {
+    std::lock_guard<std::mutex> lock(_shards[i]._lock);
+    count += _shards[i]._count;
+  }
+
+  return count;
+}
+
+intern_table::statistics
+intern_table::stats() const
+{
+  statistics result = {0, 0, 0, 0, 0, 0};
+  size_type copies = 0;
+
+  for (size_type i = 0; i <= _mask; ++i)
+  {
+    const shard& s = _shards[i];
+    std::lock_guard<std::mutex> lock(s._lock);
+
+    result._requests += s._requests;
+    result._hits += s._hits;
+    result._values += s._count;
+    result._bytes += s._buckets.capacity() * sizeof(interned::node*);
+
+    for (const interned::node* head : s._buckets)
+      for (const interned::node* n = head; n != nullptr; n = n->_next)
+      {
+        const size_type handles = n->_refs.load(std::memory_order_relaxed) - 1;
+        const size_type bytes = payload(n->_value);
+
+        result._handles += handles;
+        result._bytes += sizeof(interned::node) + bytes;
+        copies += handles * bytes;
+      }
+  }
+
+  result._saved = copies > result._bytes ? copies - result._bytes : 0;
+
+  return result;
+}
+
+intern_table&
+intern_table::global()
+{
+  static intern_table table;
+
+  return table;
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,1324 @@
+/*!
+ *	\file		json.cpp
+ *	\brief		Implements streaming JSON reader and writer of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <egg/json.hpp>
+
+#include "string_index.hpp"
+#include "text_helpers.hpp"
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+namespace
+{
+
+typedef variable::content content;
+typedef json::size_type size_type;
+
+// Longest number taken by the fast integer path and the stack copy for strtod
+const std::size_t _cs_number = 64;
+
+[[noreturn]] void
+fail(
+    const char*       what,
+    const char*       begin,
+    const char*       at)
+{
+  throw std::invalid_argument(std::string("json: ") + what + " at offset " +
+                              std::to_string(at - begin));
+}
+
+inline bool
+is_space(
+    char c) noexcept
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool
+is_digit(
+    char c) noexcept
+{
+  return c >= '0' && c <= '9';
+}
+
+// First non whitespace character. Indentation is scanned 16 bytes at once
+const char*
+skip_space(
+    const char* p,
+    const char* end) noexcept
+{
+  if (p == end || !is_space(*p))
+    return p;
+
+#if defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  const __m128i tab = _mm_set1_epi8('\t');
+
+  for (; end - p >= 16; p += 16)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i s = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, newline)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(x, carriage), _mm_cmpeq_epi8(x, tab)));
+    const unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(s)) & 0xffffu;
+
+    if (other != 0)
+      return p + first_bit(other);
+  }
+#endif
+
+  while (p != end && is_space(*p))
+    ++p;
+
+  return p;
+}
+
+// First quote, backslash or control character, the end if there is none.
+// Shared by the reader (end of a string) and the writer (escapes)
+const char*
+scan_string(
+    const char* p,
+    const char* end) noexcept
+{
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1f);
+
+  for (; end - p >= 16; p += 16)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+    // Unsigned x <= 0x1f is max(x, 0x1f) == 0x1f
+    const __m128i s = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+                                   _mm_cmpeq_epi8(_mm_max_epu8(x, control), control));
+    const unsigned special = static_cast<unsigned>(_mm_movemask_epi8(s));
+
+    if (special != 0)
+      return p + first_bit(special);
+  }
+#endif
+
+  for (; p != end; ++p)
+  {
+    const unsigned char c = static_cast<unsigned char>(*p);
+
+    if (c == '"' || c == '\\' || c < 0x20)
+      return p;
+  }
+
+  return end;
+}
+
+variable
+make_list(
+    variable::stringlist&& list)
+{
+  variable v;
+
+  variable_access::data(v)._pointer = new string_list_payload(std::move(list));
+  variable_access::type(v) = content::is_string_list;
+  variable_access::rehash(v);
+
+  return v;
+}
+
+// Move the payload out of a string variable
+std::string
+take_string(
+    variable& v)
+{
+  return std::move(*reinterpret_cast<std::string *>(variable_access::data(v)._pointer));
+}
+
+variable
+make_integer(
+    std::int64_t x,
+    bool         narrow) noexcept
+{
+  if (narrow)
+  {
+    if (x >= INT8_MIN && x <= INT8_MAX)
+      return variable(static_cast<std::int8_t>(x));
+
+    if (x >= INT16_MIN && x <= INT16_MAX)
+      return variable(static_cast<std::int16_t>(x));
+
+    if (x >= INT32_MIN && x <= INT32_MAX)
+      return variable(static_cast<std::int32_t>(x));
+  }
+
+  return variable(x);
+}
+
+void
+put_utf8(
+    std::string&  out,
+    std::uint32_t c)
+{
+  if (c < 0x80)
+    out += static_cast<char>(c);
+  else if (c < 0x800)
+  {
+    out += static_cast<char>(0xc0 | (c >> 6));
+    out += static_cast<char>(0x80 | (c & 0x3f));
+  }
+  else if (c < 0x10000)
+  {
+    out += static_cast<char>(0xe0 | (c >> 12));
+    out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (c & 0x3f));
+  }
+  else
+  {
+    out += static_cast<char>(0xf0 | (c >> 18));
+    out += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (c & 0x3f));
+  }
+}
+
+// Recursive descent without recursion: the open containers are on a stack
+struct reader
+{
+  reader(
+      const char*    data,
+      size_type      size,
+      json::handler& h,
+      bool           narrow)
+    : _begin(data), _p(data), _end(data + size), _handler(h), _narrow(narrow)
+  {}
+
+  void parse();
+
+  // Returns the string, _p is after the closing quote
+  void string(const char*& /*data*/, size_type& /*size*/);
+  std::uint32_t hex4();
+
+  variable number();
+  void literal(const char* /*word*/, size_type /*size*/);
+
+  const char*		_begin;
+  const char*		_p;
+  const char*		_end;
+  json::handler&	_handler;
+  bool			_narrow;
+
+  std::string		_scratch;
+  std::vector<char>	_open;
+};
+
+void
+reader::parse()
+{
+  enum class expect { value, key, next };
+
+  expect state = expect::value;
+
+  for (;;)
+  {
+    _p = skip_space(_p, _end);
+
+    if (state == expect::next)
+    {
+      if (_open.empty())
+      {
+        if (_p != _end)
+          fail("trailing characters", _begin, _p);
+
+        return;
+      }
+
+      if (_p == _end)
+        fail("unexpected end", _begin, _p);
+
+      const char c = *_p++;
+
+      if (c == ',')
+        state = _open.back() == '{' ? expect::key : expect::value;
+      else if (c == '}' && _open.back() == '{')
+      {
+        _open.pop_back();
+        _handler.end_object();
+      }
+      else if (c == ']' && _open.back() == '[')
+      {
+        _open.pop_back();
+        _handler.end_array();
+      }
+      else
+        fail("expected a comma or a closing bracket", _begin, _p - 1);
+
+      continue;
+    }
+
+    if (_p == _end)
+      fail("unexpected end", _begin, _p);
+
+    if (state == expect::key)
+    {
+      if (*_p != '"')
+        fail("expected a key", _begin, _p);
+
+      ++_p;
+
+      const char* data;
+      size_type size;
+      string(data, size);
+
+      _handler.key(data, size);
+
+      _p = skip_space(_p, _end);
+
+      if (_p == _end || *_p != ':')
+        fail("expected a colon", _begin, _p);
+
+      ++_p;
+      state = expect::value;
+      continue;
+    }
+
+    // Value
+    switch (*_p)
+    {
+      case '{':
+        ++_p;
+        _handler.begin_object();
+        _p = skip_space(_p, _end);
+
+        if (_p != _end && *_p == '}')
+        {
+          ++_p;
+          _handler.end_object();
+          break;
+        }
+
+        _open.push_back('{');
+        state = expect::key;
+        continue;
+
+      case '[':
+        ++_p;
+        _handler.begin_array();
+        _p = skip_space(_p, _end);
+
+        if (_p != _end && *_p == ']')
+        {
+          ++_p;
+          _handler.end_array();
+          break;
+        }
+
+        _open.push_back('[');
+        continue;
+
+      case '"':
+      {
+        ++_p;
+
+        const char* data;
+        size_type size;
+        string(data, size);
+
+        _handler.value(make_string(data, size));
+        break;
+      }
+
+      case 't':
+        literal("true", 4);
+        _handler.value(variable(true));
+        break;
+
+      case 'f':
+        literal("false", 5);
+        _handler.value(variable(false));
+        break;
+
+      case 'n':
+        literal("null", 4);
+        _handler.value(variable());
+        break;
+
+      default:
+        _handler.value(number());
+    }
+
+    state = expect::next;
+  }
+}
+
+void
+reader::string(
+    const char*& data,
+    size_type&   size)
+{
+  const char* start = _p;
+  const char* q = scan_string(_p, _end);
+
+  if (q == _end)
+    fail("unterminated string", _begin, start - 1);
+
+  // Nothing to unescape, point into the input
+  if (*q == '"')
+  {
+    _p = q + 1;
+    data = start;
+    size = static_cast<size_type>(q - start);
+    return;
+  }
+
+  _scratch.assign(start, q);
+  _p = q;
+
+  for (;;)
+  {
+    const unsigned char c = static_cast<unsigned char>(*_p);
+
+    if (c == '"')
+    {
+      ++_p;
+      break;
+    }
+
+    if (c < 0x20)
+      fail("control character in a string", _begin, _p);
+
+    // Backslash
+    if (++_p == _end)
+      fail("unterminated string", _begin, start - 1);
+
+    switch (*_p++)
+    {
+      case '"':  _scratch += '"';  break;
+      case '\\': _scratch += '\\'; break;
+      case '/':  _scratch += '/';  break;
+      case 'b':  _scratch += '\b'; break;
+      case 'f':  _scratch += '\f'; break;
+      case 'n':  _scratch += '\n'; break;
+      case 'r':  _scratch += '\r'; break;
+      case 't':  _scratch += '\t'; break;
+
+      case 'u':
+      {
+        std::uint32_t u = hex4();
+
+        if (u >= 0xdc00 && u <= 0xdfff)
+          fail("unpaired surrogate", _begin, _p - 6);
+
+        if (u >= 0xd800 && u <= 0xdbff)
+        {
+          if (_end - _p < 6 || _p[0] != '\\' || _p[1] != 'u')
+            fail("unpaired surrogate", _begin, _p - 6);
+
+          _p += 2;
+          const std::uint32_t low = hex4();
+
+          if (low < 0xdc00 || low > 0xdfff)
+            fail("unpaired surrogate", _begin, _p - 6);
+
+          u = 0x10000 + ((u - 0xd800) << 10) + (low - 0xdc00);
+        }
+
+        put_utf8(_scratch, u);
+        break;
+      }
+
+      default:
+        fail("bad escape", _begin, _p - 1);
+    }
+
+    q = scan_string(_p, _end);
+
+    if (q == _end)
+      fail("unterminated string", _begin, start - 1);
+
+    _scratch.append(_p, q);
+    _p = q;
+  }
+
+  data = _scratch.data();
+  size = _scratch.size();
+}
+
+std::uint32_t
+reader::hex4()
+{
+  if (_end - _p < 4)
+    fail("short unicode escape", _begin, _p);
+
+  std::uint32_t u = 0;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    const char c = *_p++;
+
+    u <<= 4;
+
+    if (c >= '0' && c <= '9')
+      u |= static_cast<std::uint32_t>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      u |= static_cast<std::uint32_t>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      u |= static_cast<std::uint32_t>(c - 'A' + 10);
+    else
+      fail("bad unicode escape", _begin, _p - 1);
+  }
+
+  return u;
+}
+
+void
+reader::literal(
+    const char* word,
+    size_type   size)
+{
+  if (static_cast<size_type>(_end - _p) < size || std::memcmp(_p, word, size) != 0)
+    fail("unexpected character", _begin, _p);
+
+  _p += size;
+}
+
+variable
+reader::number()
+{
+  const char* start = _p;
+  const bool negative = *_p == '-';
+
+  if (negative)
+    ++_p;
+
+  if (_p == _end || !is_digit(*_p))
+    fail("unexpected character", _begin, start);
+
+  // Integer part, exact while it fits
+  std::uint64_t x = 0;
+  bool overflow = false;
+
+  if (*_p == '0')
+    ++_p;
+  else
+    for (; _p != _end && is_digit(*_p); ++_p)
+    {
+      const unsigned d = static_cast<unsigned>(*_p - '0');
+
+      if (x > (std::numeric_limits<std::uint64_t>::max() - d) / 10)
+        overflow = true;
+      else
+        x = x * 10 + d;
+    }
+
+  bool real = overflow;
+
+  if (_p != _end && *_p == '.')
+  {
+    real = true;
+
+    if (++_p == _end || !is_digit(*_p))
+      fail("digit expected", _begin, _p);
+
+    while (_p != _end && is_digit(*_p))
+      ++_p;
+  }
+
+  if (_p != _end && (*_p == 'e' || *_p == 'E'))
+  {
+    real = true;
+
+    if (++_p != _end && (*_p == '+' || *_p == '-'))
+      ++_p;
+
+    if (_p == _end || !is_digit(*_p))
+      fail("digit expected", _begin, _p);
+
+    while (_p != _end && is_digit(*_p))
+      ++_p;
+  }
+
+  const std::uint64_t limit = std::uint64_t(std::numeric_limits<std::int64_t>::max());
+
+  if (!real)
+  {
+    if (!negative)
+      return x <= limit ? make_integer(static_cast<std::int64_t>(x), _narrow) : variable(x);
+
+    if (x <= limit + 1)
+      return make_integer(x == limit + 1 ? std::numeric_limits<std::int64_t>::min() :
+                                           -static_cast<std::int64_t>(x), _narrow);
+  }
+
+  // The input isn't terminated, strtod needs a copy
+  const size_type n = static_cast<size_type>(_p - start);
+
+  if (n < _cs_number)
+  {
+    char buffer[_cs_number];
+    std::memcpy(buffer, start, n);
+    buffer[n] = 0;
+
+    return variable(std::strtod(buffer, nullptr));
+  }
+
+  return variable(std::strtod(std::string(start, n).c_str(), nullptr));
+}
+
+// Builds a tree from the events
+struct tree_builder : json::handler
+{
+  explicit tree_builder(
+      tree& t)
+    : _tree(t)
+  {}
+
+  struct frame
+  {
+    tree::node			_node;
+    bool			_array;
+    bool			_strings;	// array of strings so far
+    std::uint32_t		_index;
+    variable::stringlist	_pending;
+  };
+
+  // Node that receives the next value
+  tree::node target()
+  {
+    if (_stack.empty())
+      return _tree.root();
+
+    frame& f = _stack.back();
+
+    if (!f._array)
+      return f._node[_key];
+
+    unstring(f);
+
+    return f._node[variable(f._index++)];
+  }
+
+  // Not a string list after all, the strings become children
+  void unstring(frame& f)
+  {
+    if (!f._strings)
+      return;
+
+    f._strings = false;
+
+    for (std::string& s : f._pending)
+      f._node[variable(f._index++)] = make_string(s.data(), s.size());
+
+    f._pending.clear();
+  }
+
+  void begin_object() override
+  {
+    const tree::node n = target();
+    _stack.push_back(frame { n, false, false, 0, variable::stringlist() });
+  }
+
+  void end_object() override
+  {
+    _stack.pop_back();
+  }
+
+  void begin_array() override
+  {
+    const tree::node n = target();
+    _stack.push_back(frame { n, true, true, 0, variable::stringlist() });
+  }
+
+  void end_array() override
+  {
+    frame& f = _stack.back();
+
+    if (f._strings)
+      f._node = make_list(std::move(f._pending));
+
+    _stack.pop_back();
+  }
+
+  void key(const char* data, size_type size) override
+  {
+    _key = make_string(data, size);
+  }
+
+  void value(variable&& v) override
+  {
+    if (!_stack.empty())
+    {
+      frame& f = _stack.back();
+
+      if (f._array && f._strings && v.type() == content::is_string)
+      {
+        f._pending.push_back(take_string(v));
+        return;
+      }
+    }
+
+    tree::node n = target();
+    n = std::move(v);
+  }
+
+  tree&			_tree;
+  std::vector<frame>	_stack;
+  variable		_key;
+};
+
+// A scalar or one array of strings
+struct value_builder : json::handler
+{
+  void reject()
+  {
+    throw std::invalid_argument("json::read_value(): only scalars and arrays of strings, use read_tree()");
+  }
+
+  void begin_object() override		{ reject();	}
+  void end_object() override		{}
+  void key(const char*, size_type) override {}
+
+  void begin_array() override
+  {
+    if (_array)
+      reject();
+
+    _array = true;
+  }
+
+  void end_array() override
+  {
+    _value = make_list(std::move(_list));
+  }
+
+  void value(variable&& v) override
+  {
+    if (!_array)
+      _value = std::move(v);
+    else if (v.type() == content::is_string)
+      _list.push_back(take_string(v));
+    else
+      reject();
+  }
+
+  bool			_array = false;
+  variable::stringlist	_list;
+  variable		_value;
+};
+
+bool
+is_array(
+    const tree::const_node& n) noexcept
+{
+  std::uint32_t i = 0;
+
+  for (const tree::const_node c : n)
+  {
+    const variable& k = c.key();
+
+    if (k.type() != content::is_uint32 || variable_access::data(k)._uint32 != i++)
+      return false;
+  }
+
+  return true;
+}
+
+void
+write_node(
+    json::writer&           w,
+    const tree::const_node& n)
+{
+  if (n.empty())
+  {
+    w.value(n.value());
+    return;
+  }
+
+  if (is_array(n))
+  {
+    w.begin_array();
+
+    for (const tree::const_node c : n)
+      write_node(w, c);
+
+    w.end_array();
+    return;
+  }
+
+  w.begin_object();
+
+  for (const tree::const_node c : n)
+  {
+    w.key(c.key());
+    write_node(w, c);
+  }
+
+  w.end_object();
+}
+
+// Decimal digits, right aligned in the buffer. Returns the first one
+char*
+format(
+    std::uint64_t x,
+    char*         end) noexcept
+{
+  char* p = end;
+
+  do
+  {
+    *--p = static_cast<char>('0' + x % 10);
+    x /= 10;
+  }
+  while (x != 0);
+
+  return p;
+}
+
+// Make sure the number reads back as a floating point one
+size_type
+real_suffix(
+    char*     buffer,
+    size_type n) noexcept
+{
+  for (size_type i = 0; i < n; ++i)
+    if (buffer[i] == '.' || buffer[i] == 'e')
+      return n;
+
+  buffer[n++] = '.';
+  buffer[n++] = '0';
+
+  return n;
+}
+
+} // End of anonymous namespace
+
+// Handler
+json::handler::~handler() noexcept
+{}
+
+// Reader
+void
+json::parse(
+    const char* data,
+    size_type   size,
+    handler&    h,
+    bool        narrow)
+{
+  reader(data, size, h, narrow).parse();
+}
+
+variable
+json::read_value(
+    const std::string& text,
+    bool               narrow)
+{
+  value_builder b;
+  parse(text.data(), text.size(), b, narrow);
+
+  return std::move(b._value);
+}
+
+tree
+json::read_tree(
+    const char* data,
+    size_type   size,
+    bool        narrow)
+{
+  tree t;
+  tree_builder b(t);
+
+  parse(data, size, b, narrow);
+
+  return t;
+}
+
+// Writer
+json::writer::writer(
+    std::ostream& out)
+  : _out(out),
+    _after_key(false),
+    _used(0)
+{}
+
+json::writer::~writer() noexcept
+{
+  try
+  {
+    drain();
+  }
+  catch (...)
+  {}
+}
+
+void
+json::writer::separate()
+{
+  if (_after_key)
+  {
+    _after_key = false;
+    return;
+  }
+
+  if (!_first.empty())
+  {
+    if (_first.back())
+      _first.back() = false;
+    else
+      put(',');
+  }
+}
+
+void
+json::writer::begin_object()
+{
+  separate();
+  put('{');
+  _first.push_back(true);
+}
+
+void
+json::writer::end_object()
+{
+  _first.pop_back();
+  put('}');
+}
+
+void
+json::writer::begin_array()
+{
+  separate();
+  put('[');
+  _first.push_back(true);
+}
+
+void
+json::writer::end_array()
+{
+  _first.pop_back();
+  put(']');
+}
+
+void
+json::writer::key(
+    const char* data,
+    size_type   size)
+{
+  separate();
+  string(data, size);
+  put(':');
+  _after_key = true;
+}
+
+void
+json::writer::key(
+    const variable& k)
+{
+  if (k.type() == content::is_string)
+  {
+    const std::string& s = k.as_string();
+    key(s.data(), s.size());
+  }
+  else
+  {
+    const std::string s = k.to_string();
+    key(s.data(), s.size());
+  }
+}
+
+void
+json::writer::value(
+    const variable& v)
+{
+  const content t = v.type();
+
+  // Nested values open their own container
+  if (t == content::is_list)
+  {
+    begin_array();
+
+    for (const variable& e : v.as_list())
+      value(e);
+
+    end_array();
+    return;
+  }
+
+  if (t == content::is_map)
+  {
+    begin_object();
+
+    for (const variable::map::value_type& e : v.as_map())
+    {
+      key(e.first);
+      value(e.second);
+    }
+
+    end_object();
+    return;
+  }
+
+  separate();
+
+  switch (t)
+  {
+    case content::is_empty:
+      raw("null", 4);
+      break;
+
+    case content::is_bool:
+      if (v.as_bool())
+        raw("true", 4);
+      else
+        raw("false", 5);
+      break;
+
+    case content::is_int8:
+    case content::is_int16:
+    case content::is_int32:
+    case content::is_int64:
+      number(variable_access::signed_value(v));
+      break;
+
+    case content::is_uint8:
+    case content::is_uint16:
+    case content::is_uint32:
+    case content::is_uint64:
+      number(variable_access::unsigned_value(v));
+      break;
+
+    case content::is_float:
+      number(v.as_float(), t);
+      break;
+
+    case content::is_double:
+      number(v.as_double(), t);
+      break;
+
+    case content::is_long_double:
+      number(v.as_long_double(), t);
+      break;
+
+    case content::is_string:
+    {
+      const std::string& s = v.as_string();
+      string(s.data(), s.size());
+      break;
+    }
+
+    case content::is_string_list:
+    {
+      put('[');
+
+      bool first = true;
+
+      for (const std::string& s : v.as_string_list())
+      {
+        if (!first)
+          put(',');
+
+        first = false;
+        string(s.data(), s.size());
+      }
+
+      put(']');
+      break;
+    }
+
+    case content::is_string_rope:
+    {
+      put('[');
+
+      bool first = true;
+
+      v.as_string_rope().each([this, &first](const std::string& s) {
+        if (!first)
+          put(',');
+
+        first = false;
+        string(s.data(), s.size());
+      });
+
+      put(']');
+      break;
+    }
+
+    case content::is_compact_string_list:
+    {
+      put('[');
+
+      bool first = true;
+
+      v.as_compact_string_list().each([this, &first](const std::string& s) {
+        if (!first)
+          put(',');
+
+        first = false;
+        string(s.data(), s.size());
+      });
+
+      put(']');
+      break;
+    }
+
+    case content::is_int32_array:
+      elements(v.as_int32_array(), [this](std::int64_t x) { number(x); });
+      break;
+
+    case content::is_int64_array:
+      elements(v.as_int64_array(), [this](std::int64_t x) { number(x); });
+      break;
+
+    case content::is_uint64_array:
+      elements(v.as_uint64_array(), [this](std::uint64_t x) { number(x); });
+      break;
+
+    case content::is_double_array:
+      elements(v.as_double_array(), [this](double x) { number(x, content::is_double); });
+      break;
+
+    case content::is_blob:
+    {
+      const std::string hex = v.to_string();
+      string(hex.data(), hex.size());
+      break;
+    }
+
+    default:
+      raw("null", 4);
+  }
+}
+
+void
+json::writer::number(
+    std::int64_t x)
+{
+  char buffer[24];
+  char* const end = buffer + sizeof(buffer);
+  char* p = format(x < 0 ? 0 - static_cast<std::uint64_t>(x) : static_cast<std::uint64_t>(x), end);
+
+  if (x < 0)
+    *--p = '-';
+
+  raw(p, static_cast<size_type>(end - p));
+}
+
+void
+json::writer::number(
+    std::uint64_t x)
+{
+  char buffer[24];
+  char* const end = buffer + sizeof(buffer);
+  const char* p = format(x, end);
+
+  raw(p, static_cast<size_type>(end - p));
+}
+
+void
+json::writer::number(
+    long double x,
+    content     t)
+{
+  char buffer[48];
+
+  if (!std::isfinite(x))
+  {
+    raw("null", 4);
+    return;
+  }
+
+  // Shortest precision that reads back the same value
+  int n = 0;
+
+  if (t == content::is_float)
+  {
+    const float f = static_cast<float>(x);
+
+    for (int digits = 6; digits <= 9; ++digits)
+      if ((n = std::snprintf(buffer, sizeof(buffer) - 2, "%.*g", digits, static_cast<double>(f))) > 0 &&
+          std::strtof(buffer, nullptr) == f)
+        break;
+  }
+  else if (t == content::is_double)
+  {
+    const double d = static_cast<double>(x);
+
+    for (int digits = 15; digits <= 17; ++digits)
+      if ((n = std::snprintf(buffer, sizeof(buffer) - 2, "%.*g", digits, d)) > 0 &&
+          std::strtod(buffer, nullptr) == d)
+        break;
+  }
+  else
+    for (int digits = 18; digits <= 21; ++digits)
+      if ((n = std::snprintf(buffer, sizeof(buffer) - 2, "%.*Lg", digits, x)) > 0 &&
+          std::strtold(buffer, nullptr) == x)
+        break;
+
+  raw(buffer, real_suffix(buffer, static_cast<size_type>(n)));
+}
+
+template <typename T, typename F>
+void
+json::writer::elements(
+    const variable::array_view<T>& a,
+    F                              f)
+{
+  put('[');
+
+  for (size_type i = 0; i < a.size(); ++i)
+  {
+    if (i != 0)
+      put(',');
+
+    f(a[i]);
+  }
+
+  put(']');
+}
+
+void
+json::writer::string(
+    const char* data,
+    size_type   size)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  const char* p = data;
+  const char* end = data + size;
+
+  put('"');
+
+  for (;;)
+  {
+    const char* q = scan_string(p, end);
+    raw(p, static_cast<size_type>(q - p));
+
+    if (q == end)
+      break;
+
+    const unsigned char c = static_cast<unsigned char>(*q);
+
+    put('\\');
+
+    switch (c)
+    {
+      case '"':  put('"');  break;
+      case '\\': put('\\'); break;
+      case '\b': put('b');  break;
+      case '\f': put('f');  break;
+      case '\n': put('n');  break;
+      case '\r': put('r');  break;
+      case '\t': put('t');  break;
+
+      default:
+        put('u');
+        put('0');
+        put('0');
+        put(hex[c >> 4]);
+        put(hex[c & 15]);
+    }
+
+    p = q + 1;
+  }
+
+  put('"');
+}
+
+void
+json::writer::raw(
+    const char* data,
+    size_type   size)
+{
+  if (size > sizeof(_buffer) - _used)
+  {
+    drain();
+
+    if (size >= sizeof(_buffer))
+    {
+      _out.write(data, static_cast<std::streamsize>(size));
+      return;
+    }
+  }
+
+  std::memcpy(_buffer + _used, data, size);
+  _used += size;
+}
+
+void
+json::writer::drain()
+{
+  if (_used != 0)
+    _out.write(_buffer, static_cast<std::streamsize>(_used));
+
+  _used = 0;
+}
+
+void
+json::writer::flush()
+{
+  drain();
+  _out.flush();
+}
+
+void
+json::write(
+    const variable& value,
+    std::ostream&   out)
+{
+  writer w(out);
+
+  w.value(value);
+  w.flush();
+}
+
+void
+json::write(
+    const tree&   t,
+    std::ostream& out)
+{
+  writer w(out);
+
+  write_node(w, t.root());
+  w.flush();
+}
+
+std::string
+json::to_string(
+    const variable& value)
+{
+  std::ostringstream out;
+  write(value, out);
+
+  return out.str();
+}
+
+std::string
+json::to_string(
+    const tree& t)
+{
+  std::ostringstream out;
+  write(t, out);
+
+  return out.str();
+}
+
+} // End of egg namespace
+
+/* End of file */
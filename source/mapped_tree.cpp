@@ -0,0 +1,603 @@
+/*!
+ *	\file		mapped_tree.cpp
+ *	\brief		Implements memory-mapped read-only snapshot of a tree
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <egg/mapped_tree.hpp>
+#include <egg/variable_hash_map.hpp>
+
+
+namespace egg
+{
+
+struct mapped_tree::header
+{
+	char		_magic[8];
+	std::uint32_t	_version;
+	std::uint32_t	_order;		// byte order probe
+	std::uint64_t	_size;		// whole file
+
+	std::uint32_t	_nodes;		// with the root
+	std::uint32_t	_keys;
+	std::uint32_t	_slots;		// index slots, a power of two
+	std::uint32_t	_reserved;
+
+	std::uint64_t	_key_offset;
+	std::uint64_t	_node_offset;
+	std::uint64_t	_index_offset;
+	std::uint64_t	_data_offset;
+	std::uint64_t	_data_size;
+
+	std::uint64_t	_checksum;	// of everything after the header
+};
+
+namespace
+{
+
+const char _cs_magic[8] = { 'E', 'G', 'G', 'T', 'R', 'E', 'E', 0 };
+const std::uint32_t _cs_version = 1;
+const std::uint32_t _cs_order = 0x01020304u;
+
+// Smallest index
+const std::size_t _cs_slots = 16;
+
+// Keys up to that size are encoded on the stack for a lookup
+const std::size_t _cs_key_buffer = 256;
+
+inline std::uint64_t
+align(
+    std::uint64_t x) noexcept
+{
+  return (x + 7) & ~std::uint64_t(7);
+}
+
+// FNV-1a over the key encoding, stable across builds
+inline std::uint32_t
+key_hash(
+    const std::uint8_t* p,
+    std::size_t         n) noexcept
+{
+  std::uint64_t h = 0xcbf29ce484222325ull;
+
+  for (std::size_t i = 0; i < n; ++i)
+    h = (h ^ p[i]) * 0x100000001b3ull;
+
+  return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+inline std::size_t
+slot_hash(
+    mapped_tree::index_type parent,
+    std::uint32_t           key) noexcept
+{
+  std::uint64_t x = (static_cast<std::uint64_t>(parent) << 32) | key;
+
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+
+  return static_cast<std::size_t>(x);
+}
+
+// Word at a time, the checksum guards against damage, not against tampering
+std::uint64_t
+checksum(
+    const std::uint8_t* p,
+    std::size_t         n) noexcept
+{
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  std::size_t i = 0;
+
+  for (; i + 8 <= n; i += 8)
+  {
+    std::uint64_t w;
+    std::memcpy(&w, p + i, sizeof(w));
+
+    h = (h ^ w) * 0x100000001b3ull;
+    h ^= h >> 29;
+  }
+
+  for (; i < n; ++i)
+    h = (h ^ p[i]) * 0x100000001b3ull;
+
+  return h;
+}
+
+void
+invalid(
+    const std::string& what)
+{
+  throw std::runtime_error("mapped_tree::open(): " + what);
+}
+
+} // End of anonymous namespace
+
+const mapped_tree::index_type mapped_tree::npos;
+
+// Construct/destruct
+mapped_tree::mapped_tree() noexcept
+  : _base(nullptr),
+    _size(0),
+    _keys(nullptr),
+    _nodes(nullptr),
+    _index(nullptr),
+    _data(nullptr),
+    _key_count(0),
+    _node_count(0),
+    _slots(0),
+    _data_size(0)
+{}
+
+mapped_tree::~mapped_tree() noexcept
+{
+  close();
+}
+
+// Move
+mapped_tree::mapped_tree(
+    mapped_tree&& other) noexcept
+  : mapped_tree()
+{
+  *this = std::move(other);
+}
+
+mapped_tree&
+mapped_tree::operator=(
+    mapped_tree&& other) noexcept
+{
+  if (this != &other)
+  {
+    close();
+
+    _base = other._base;
+    _size = other._size;
+    _keys = other._keys;
+    _nodes = other._nodes;
+    _index = other._index;
+    _data = other._data;
+    _key_count = other._key_count;
+    _node_count = other._node_count;
+    _slots = other._slots;
+    _data_size = other._data_size;
+
+    other._base = nullptr;
+    other.close();
+  }
+
+  return *this;
+}
+
+void
+mapped_tree::close() noexcept
+{
+  if (_base != nullptr)
+    ::munmap(const_cast<std::uint8_t*>(_base), _size);
+
+  _base = nullptr;
+  _size = 0;
+  _keys = nullptr;
+  _nodes = nullptr;
+  _index = nullptr;
+  _data = nullptr;
+  _key_count = 0;
+  _node_count = 0;
+  _slots = 0;
+  _data_size = 0;
+}
+
+// Size
+mapped_tree::size_type
+mapped_tree::size() const noexcept
+{
+  return _node_count == 0 ? 0 : _node_count - 1;
+}
+
+mapped_tree::size_type
+mapped_tree::keys() const noexcept
+{
+  return _key_count == 0 ? 0 : _key_count - 1;
+}
+
+// Write
+void
+mapped_tree::write(
+    const tree&        t,
+    const std::string& file)
+{
+  const std::size_t count = t.size() + 1;
+
+  if (count >= npos)
+    throw std::length_error("mapped_tree::write(): too many nodes");
+
+  std::vector<node_record> nodes;
+  std::vector<key_record> keys;
+  std::vector<std::uint8_t> data;
+  variable_hash_map<index_type> key_ids;
+
+  nodes.reserve(count);
+
+  // Breadth-first, so the children of a node are contiguous
+  std::vector<tree::const_node> order;
+  order.reserve(count);
+  order.push_back(t.root());
+
+  nodes.push_back(node_record { 0, npos, 0, 0, 0 });
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    const tree::const_node n = order[i];
+    node_record& r = nodes[i];
+
+    const auto k = key_ids.emplace(n.key(), static_cast<index_type>(keys.size()));
+
+    if (k.second)
+    {
+      const std::size_t offset = data.size();
+      const std::size_t size = encode(n.key(), data);
+
+      keys.push_back(key_record { offset, static_cast<std::uint32_t>(size),
+                                  key_hash(data.data() + offset, size) });
+    }
+
+    r._key = k.first->second;
+    r._value = data.size();
+    encode(n.value(), data);
+
+    r._first = static_cast<index_type>(order.size());
+    r._children = static_cast<index_type>(n.size());
+
+    for (const tree::const_node c : n)
+    {
+      order.push_back(c);
+      nodes.push_back(node_record { 0, static_cast<index_type>(i), 0, 0, 0 });
+    }
+  }
+
+  // Index of everything but the root, at most half full
+  std::size_t slots = _cs_slots;
+  while (slots < count * 2)
+    slots *= 2;
+
+  std::vector<index_type> index(slots, npos);
+  const std::size_t mask = slots - 1;
+
+  for (std::size_t i = 1; i < count; ++i)
+  {
+    std::size_t s = slot_hash(nodes[i]._parent, keys[nodes[i]._key]._hash) & mask;
+
+    while (index[s] != npos)
+      s = (s + 1) & mask;
+
+    index[s] = static_cast<index_type>(i);
+  }
+
+  // Lay out the file
+  header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h._magic, _cs_magic, sizeof(h._magic));
+
+  h._version = _cs_version;
+  h._order = _cs_order;
+  h._nodes = static_cast<std::uint32_t>(count);
+  h._keys = static_cast<std::uint32_t>(keys.size());
+  h._slots = static_cast<std::uint32_t>(slots);
+
+  h._key_offset = align(sizeof(header));
+  h._node_offset = align(h._key_offset + keys.size() * sizeof(key_record));
+  h._index_offset = align(h._node_offset + nodes.size() * sizeof(node_record));
+  h._data_offset = align(h._index_offset + index.size() * sizeof(index_type));
+  h._data_size = data.size();
+  h._size = h._data_offset + data.size();
+
+  std::vector<std::uint8_t> image(h._size, 0);
+
+  std::memcpy(image.data() + h._key_offset, keys.data(), keys.size() * sizeof(key_record));
+  std::memcpy(image.data() + h._node_offset, nodes.data(), nodes.size() * sizeof(node_record));
+  std::memcpy(image.data() + h._index_offset, index.data(), index.size() * sizeof(index_type));
+  std::memcpy(image.data() + h._data_offset, data.data(), data.size());
+
+  h._checksum = checksum(image.data() + sizeof(header), image.size() - sizeof(header));
+  std::memcpy(image.data(), &h, sizeof(h));
+
+  // Readers see either the old or the new file
+  const std::string aside = file + ".tmp";
+
+  {
+    std::ofstream out(aside, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(image.data()), image.size());
+    out.close();
+
+    if (!out)
+    {
+      std::remove(aside.c_str());
+      throw std::runtime_error("mapped_tree::write(): can't write " + aside);
+    }
+  }
+
+  if (std::rename(aside.c_str(), file.c_str()) != 0)
+  {
+    std::remove(aside.c_str());
+    throw std::runtime_error("mapped_tree::write(): can't rename " + aside + " to " + file);
+  }
+}
+
+// Open
+mapped_tree
+mapped_tree::open(
+    const std::string& file,
+    bool               verify)
+{
+  const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+    invalid("can't open " + file);
+
+  struct stat st;
+
+  if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(header)))
+  {
+    ::close(fd);
+    invalid(file + " is too short");
+  }
+
+  void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+    invalid("can't map " + file);
+
+  // Unmapped by the destructor if the validation throws
+  mapped_tree result;
+  result._base = static_cast<const std::uint8_t*>(p);
+  result._size = static_cast<std::size_t>(st.st_size);
+
+  result.validate(verify);
+
+  return result;
+}
+
+void
+mapped_tree::validate(
+    bool verify) const
+{
+  const header& h = *reinterpret_cast<const header*>(_base);
+
+  if (std::memcmp(h._magic, _cs_magic, sizeof(h._magic)) != 0)
+    invalid("not a snapshot");
+
+  if (h._version != _cs_version)
+    invalid("unsupported version " + std::to_string(h._version));
+
+  if (h._order != _cs_order)
+    invalid("written with another byte order");
+
+  if (h._size != _size)
+    invalid("size mismatch, the file is truncated");
+
+  // Sections in order, aligned and within the file. Counts are 32 bit, so
+  // the products can't overflow
+  if (h._nodes == 0 || h._keys == 0 ||
+      h._slots < _cs_slots || (h._slots & (h._slots - 1)) != 0 || h._slots <= h._nodes ||
+      h._key_offset < sizeof(header) ||
+      (h._key_offset | h._node_offset | h._index_offset | h._data_offset) % 8 != 0 ||
+      h._key_offset + std::uint64_t(h._keys) * sizeof(key_record) > h._node_offset ||
+      h._node_offset + std::uint64_t(h._nodes) * sizeof(node_record) > h._index_offset ||
+      h._index_offset + std::uint64_t(h._slots) * sizeof(index_type) > h._data_offset ||
+      h._data_offset > _size || h._data_size != _size - h._data_offset)
+    invalid("bad section layout");
+
+  mapped_tree& self = const_cast<mapped_tree&>(*this);
+
+  self._keys = reinterpret_cast<const key_record*>(_base + h._key_offset);
+  self._nodes = reinterpret_cast<const node_record*>(_base + h._node_offset);
+  self._index = reinterpret_cast<const index_type*>(_base + h._index_offset);
+  self._data = _base + h._data_offset;
+  self._key_count = h._keys;
+  self._node_count = h._nodes;
+  self._slots = h._slots;
+  self._data_size = h._data_size;
+
+  if (!verify)
+    return;
+
+  if (checksum(_base + sizeof(header), _size - sizeof(header)) != h._checksum)
+    invalid("checksum mismatch");
+
+  variable_view v;
+
+  for (std::size_t i = 0; i < _key_count; ++i)
+  {
+    const key_record& k = _keys[i];
+
+    if (k._offset > _data_size || k._size > _data_size - k._offset ||
+        decode(_data + k._offset, k._size, v) != k._size ||
+        key_hash(_data + k._offset, k._size) != k._hash)
+      invalid("bad key " + std::to_string(i));
+  }
+
+  for (std::size_t i = 0; i < _node_count; ++i)
+  {
+    const node_record& n = _nodes[i];
+
+    if (n._key >= _key_count ||
+        (i == 0 ? n._parent != npos : n._parent >= i) ||
+        n._first > _node_count || n._children > _node_count - n._first ||
+        n._value >= _data_size ||
+        decode(_data + n._value, _data_size - n._value, v) == 0)
+      invalid("bad node " + std::to_string(i));
+
+    for (index_type c = n._first; c < n._first + n._children; ++c)
+      if (_nodes[c]._parent != i)
+        invalid("bad children of node " + std::to_string(i));
+  }
+
+  std::size_t used = 0;
+
+  for (std::size_t s = 0; s < _slots; ++s)
+    if (_index[s] != npos)
+    {
+      if (_index[s] == 0 || _index[s] >= _node_count)
+        invalid("bad index slot " + std::to_string(s));
+
+      ++used;
+    }
+
+  // Every node is reachable through the index, so the probing terminates
+  if (used != _node_count - 1)
+    invalid("index size mismatch");
+
+  for (std::size_t i = 1; i < _node_count; ++i)
+  {
+    const key_record& k = _keys[_nodes[i]._key];
+
+    if (lookup(_nodes[i]._parent, _data + k._offset, k._size) != i)
+      invalid("node " + std::to_string(i) + " is missing in the index");
+  }
+}
+
+// Lookup
+mapped_tree::index_type
+mapped_tree::lookup(
+    index_type          parent,
+    const std::uint8_t* key,
+    std::size_t         size) const noexcept
+{
+  const std::uint32_t h = key_hash(key, size);
+  const std::size_t mask = _slots - 1;
+
+  for (std::size_t s = slot_hash(parent, h) & mask; ; s = (s + 1) & mask)
+  {
+    const index_type i = _index[s];
+
+    if (i == npos)
+      return npos;
+
+    const node_record& n = _nodes[i];
+
+    if (n._parent == parent)
+    {
+      const key_record& k = _keys[n._key];
+
+      if (k._hash == h && k._size == size && std::memcmp(_data + k._offset, key, size) == 0)
+        return i;
+    }
+  }
+}
+
+// Load
+tree
+mapped_tree::load() const
+{
+  tree t;
+
+  if (is_open())
+  {
+    t.reserve(size());
+    copy(root(), t.root());
+  }
+
+  return t;
+}
+
+void
+mapped_tree::copy(
+    node       from,
+    tree::node to) const
+{
+  for (size_type i = 0; i < from.size(); ++i)
+  {
+    const node c = from.child(i);
+    tree::node n = to[c.key().materialize()];
+
+    n = c.value().materialize();
+    copy(c, n);
+  }
+}
+
+// Node
+variable_view
+mapped_tree::node::key() const noexcept
+{
+  variable_view v;
+
+  if (_index != npos)
+  {
+    const key_record& k = _tree->_keys[_tree->_nodes[_index]._key];
+    decode(_tree->_data + k._offset, k._size, v);
+  }
+
+  return v;
+}
+
+variable_view
+mapped_tree::node::value() const noexcept
+{
+  variable_view v;
+
+  if (_index != npos)
+  {
+    const std::uint64_t offset = _tree->_nodes[_index]._value;
+    decode(_tree->_data + offset, _tree->_data_size - offset, v);
+  }
+
+  return v;
+}
+
+mapped_tree::size_type
+mapped_tree::node::size() const noexcept
+{
+  return _index == npos ? 0 : _tree->_nodes[_index]._children;
+}
+
+mapped_tree::node
+mapped_tree::node::find(
+    const variable& k) const
+{
+  if (_index == npos)
+    return node();
+
+  std::uint8_t buffer[_cs_key_buffer];
+  const std::size_t n = encode(k, buffer, sizeof(buffer));
+
+  if (n != 0)
+    return node(_tree, _tree->lookup(_index, buffer, n));
+
+  std::vector<std::uint8_t> large;
+  encode(k, large);
+
+  return node(_tree, _tree->lookup(_index, large.data(), large.size()));
+}
+
+mapped_tree::node
+mapped_tree::node::child(
+    size_type i) const noexcept
+{
+  if (i >= size())
+    return node();
+
+  return node(_tree, static_cast<index_type>(_tree->_nodes[_index]._first + i));
+}
+
+mapped_tree::node
+mapped_tree::node::parent() const noexcept
+{
+  return node(_tree, _index == npos ? npos : _tree->_nodes[_index]._parent);
+}
+
+} // End of egg namespace
+
+/* End of file */
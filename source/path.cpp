@@ -0,0 +1,220 @@
+/*!
+ *	\file		path.cpp
+ *	\brief		Implements precompiled path lookups in a tree
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <stdexcept>
+
+#include <egg/path.hpp>
+
+
+namespace egg
+{
+
+// Construct/destruct
+path::path() noexcept
+  : _generation(0),
+    _node(tree::npos)
+{}
+
+path::~path() noexcept
+{}
+
+path::path(
+    const std::string&  dotted,
+    const char          separator)
+  : _generation(0),
+    _node(tree::npos)
+{
+  if (dotted.empty())
+    return;
+
+  std::string::size_type start = 0;
+
+  for (;;)
+  {
+    const std::string::size_type end = dotted.find(separator, start);
+    const std::string::size_type length = (end == std::string::npos ? dotted.size() : end) - start;
+
+    if (length == 0)
+      throw std::invalid_argument("path: empty segment in \"" + dotted + "\"");
+
+    _segments.push_back(dotted.substr(start, length));
+
+    if (end == std::string::npos)
+      break;
+
+    start = end + 1;
+  }
+}
+
+path::path(
+    std::initializer_list<variable> segments)
+  : _segments(segments),
+    _generation(0),
+    _node(tree::npos)
+{}
+
+path::path(
+    std::vector<variable> segments) noexcept
+  : _segments(std::move(segments)),
+    _generation(0),
+    _node(tree::npos)
+{}
+
+// Copy
+path::path(
+    const path& other)
+  : _segments(other._segments),
+    _generation(other._generation),
+    _node(other._node)
+{}
+
+path&
+path::operator=(
+    const path& other)
+{
+  if (this != &other)
+  {
+    _segments = other._segments;
+    _generation = other._generation;
+    _node = other._node;
+  }
+
+  return *this;
+}
+
+// Move
+path::path(
+    path&& other) noexcept
+  : _segments(std::move(other._segments)),
+    _generation(other._generation),
+    _node(other._node)
+{
+  other._generation = 0;
+}
+
+path&
+path::operator=(
+    path&& other) noexcept
+{
+  if (this != &other)
+  {
+    _segments = std::move(other._segments);
+    _generation = other._generation;
+    _node = other._node;
+
+    other._generation = 0;
+  }
+
+  return *this;
+}
+
+// Lookup
+tree::index_type
+path::walk(
+    const tree& t) const noexcept
+{
+  tree::index_type n = 0;
+
+  for (const variable& s : _segments)
+  {
+    const tree::index_type id = t.key_id(s);
+
+    if (id == tree::npos)
+      return tree::npos;
+
+    n = t.child(n, id);
+
+    if (n == tree::npos)
+      return tree::npos;
+  }
+
+  return n;
+}
+
+tree::index_type
+path::lookup(
+    const tree& t) const noexcept
+{
+  // Generation 0 is never stamped, so it means "nothing cached"
+  if (_generation != t._generation)
+  {
+    _node = walk(t);
+    _generation = t._generation;
+  }
+
+  return _node;
+}
+
+tree::const_node
+path::find(
+    const tree& t) const noexcept
+{
+  return t.handle(lookup(t));
+}
+
+tree::node
+path::find(
+    tree& t) const noexcept
+{
+  return t.handle(lookup(t));
+}
+
+tree::const_node
+path::resolve(
+    const tree& t) const noexcept
+{
+  return t.handle(walk(t));
+}
+
+tree::node
+path::make(
+    tree& t) const
+{
+  tree::index_type n = lookup(t);
+
+  if (n != tree::npos)
+    return t.handle(n);
+
+  n = 0;
+
+  for (const variable& s : _segments)
+  {
+    const tree::index_type id = t.intern(s);
+    const tree::index_type c = t.child(n, id);
+
+    n = c != tree::npos ? c : t.add(n, id);
+  }
+
+  return t.handle(n);
+}
+
+std::string
+path::to_string(
+    const char separator) const
+{
+  std::string result;
+  bool first = true;
+
+  // Empty keys still take a separator
+  for (const variable& s : _segments)
+  {
+    if (!first)
+      result += separator;
+
+    first = false;
+
+    result += s.to_string();
+  }
+
+  return result;
+}
+
+} // End of egg namespace
+
+/* End of file */
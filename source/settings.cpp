@@ -0,0 +1,685 @@
+/*!
+ *	\file		settings.cpp
+ *	\brief		Implements bulk loader of environment and key-value files
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <egg/settings.hpp>
+
+#include "text_helpers.hpp"
+#include "variable_access.hpp"
+
+extern char** environ;
+
+
+namespace egg
+{
+
+namespace
+{
+
+typedef variable::content content;
+
+// Smallest key table
+const std::size_t _cs_slots = 16;
+
+// Longer values are never numbers
+const std::size_t _cs_number = 64;
+
+// First a or b, the end if there is none. Scanned 16 bytes at once
+const char*
+find_either(
+    const char* p,
+    const char* end,
+    const char  a,
+    const char  b) noexcept
+{
+#if defined(__SSE2__)
+  const __m128i va = _mm_set1_epi8(a);
+  const __m128i vb = _mm_set1_epi8(b);
+
+  for (; end - p >= 16; p += 16)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const unsigned found = static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(x, vb))));
+
+    if (found != 0)
+      return p + first_bit(found);
+  }
+#endif
+
+  for (; p != end; ++p)
+    if (*p == a || *p == b)
+      return p;
+
+  return end;
+}
+
+inline bool
+is_blank(
+    const char c) noexcept
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char*
+skip_blank(
+    const char* p,
+    const char* end) noexcept
+{
+  while (p != end && is_blank(*p))
+    ++p;
+
+  return p;
+}
+
+inline const char*
+trim_blank(
+    const char* p,
+    const char* end) noexcept
+{
+  while (end != p && is_blank(end[-1]))
+    --end;
+
+  return end;
+}
+
+// FNV-1a, continued over the parts of a key
+inline std::uint64_t
+fnv(
+    std::uint64_t h,
+    const char*   p,
+    std::size_t   n) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i)
+    h = (h ^ static_cast<unsigned char>(p[i])) * 0x100000001b3ull;
+
+  return h;
+}
+
+const std::uint64_t _cs_fnv_basis = 0xcbf29ce484222325ull;
+
+inline std::uint32_t
+fold(
+    std::uint64_t h) noexcept
+{
+  return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+inline bool
+is_word(
+    const char* p,
+    std::size_t n,
+    const char* word) noexcept
+{
+  return std::strlen(word) == n && strncasecmp(p, word, n) == 0;
+}
+
+variable
+typed(
+    const char* p,
+    std::size_t n)
+{
+  if (n != 0 && n <= 5)
+  {
+    if (is_word(p, n, "true") || is_word(p, n, "yes") || is_word(p, n, "on"))
+      return variable(true);
+
+    if (is_word(p, n, "false") || is_word(p, n, "no") || is_word(p, n, "off"))
+      return variable(false);
+  }
+
+  // Slices aren't terminated, numbers are parsed from a stack copy
+  if (n != 0 && n < _cs_number && std::strchr("+-.0123456789", *p) != nullptr)
+  {
+    char text[_cs_number];
+    char* end = nullptr;
+
+    std::memcpy(text, p, n);
+    text[n] = 0;
+
+    errno = 0;
+    const long long i = std::strtoll(text, &end, 10);
+
+    if (*end == 0 && errno == 0)
+      return variable(static_cast<std::int64_t>(i));
+
+    if (*end == 0 && text[0] != '-')
+    {
+      errno = 0;
+      const unsigned long long u = std::strtoull(text, &end, 10);
+
+      if (*end == 0 && errno == 0)
+        return variable(static_cast<std::uint64_t>(u));
+    }
+
+    // Plain decimal reals only, "inf" or "0x10" stay strings
+    if (std::strspn(text, "0123456789+-.eE") == n && std::strpbrk(text, "0123456789") != nullptr)
+    {
+      const double d = std::strtod(text, &end);
+
+      if (*end == 0)
+        return variable(d);
+    }
+  }
+
+  return make_string(p, n);
+}
+
+} // End of anonymous namespace
+
+const settings::index_type settings::npos;
+
+// Construct/destruct
+settings::settings()
+  : _slots(_cs_slots, npos),
+    _count(0)
+{}
+
+settings::~settings() noexcept
+{
+  release();
+}
+
+// Move
+settings::settings(
+    settings&& other) noexcept
+  : _blocks(std::move(other._blocks)),
+    _entries(std::move(other._entries)),
+    _slots(std::move(other._slots)),
+    _count(other._count)
+{
+  other._blocks.clear();
+  other._entries.clear();
+  other._slots.assign(_cs_slots, npos);
+  other._count = 0;
+}
+
+settings&
+settings::operator=(
+    settings&& other) noexcept
+{
+  if (this != &other)
+  {
+    release();
+
+    _blocks = std::move(other._blocks);
+    _entries = std::move(other._entries);
+    _slots = std::move(other._slots);
+    _count = other._count;
+
+    other._blocks.clear();
+    other._entries.clear();
+    other._slots.assign(_cs_slots, npos);
+    other._count = 0;
+  }
+
+  return *this;
+}
+
+void
+settings::release() noexcept
+{
+  for (const block& b : _blocks)
+    if (b._mapped)
+      ::munmap(const_cast<char*>(b._data), b._size);
+    else
+      delete[] b._data;
+
+  _blocks.clear();
+}
+
+// Load
+void
+settings::load_file(
+    const std::string& file)
+{
+  const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+    throw std::runtime_error("settings::load_file(): can't open " + file);
+
+  struct stat st;
+
+  if (::fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    throw std::runtime_error("settings::load_file(): can't stat " + file);
+  }
+
+  // Nothing to map
+  if (st.st_size == 0)
+  {
+    ::close(fd);
+    return;
+  }
+
+  void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+    throw std::runtime_error("settings::load_file(): can't map " + file);
+
+  ::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+
+  add(block { static_cast<const char*>(p), static_cast<size_type>(st.st_size), true }, format::text, file);
+}
+
+void
+settings::load_text(
+    const std::string& text)
+{
+  if (text.empty())
+    return;
+
+  char* copy = new char[text.size()];
+  std::memcpy(copy, text.data(), text.size());
+
+  add(block { copy, text.size(), false }, format::text, "text");
+}
+
+void
+settings::load_environment()
+{
+  load_environment(environ);
+}
+
+void
+settings::load_environment(
+    const char* const* environment)
+{
+  size_type size = 0;
+
+  for (const char* const* e = environment; e != nullptr && *e != nullptr; ++e)
+    size += std::strlen(*e) + 1;
+
+  if (size == 0)
+    return;
+
+  // One copy, the strings stay separated by their NULs
+  char* copy = new char[size];
+  char* p = copy;
+
+  for (const char* const* e = environment; *e != nullptr; ++e)
+  {
+    const size_type n = std::strlen(*e) + 1;
+
+    std::memcpy(p, *e, n);
+    p += n;
+  }
+
+  add(block { copy, size, false }, format::environment, "environment");
+}
+
+void
+settings::add(
+    const block&       b,
+    format             f,
+    const std::string& source)
+{
+  const size_type first = _entries.size();
+
+  // The block is owned from here on, released again if it's malformed
+  _blocks.push_back(b);
+
+  try
+  {
+    split(b, f, source, _entries);
+  }
+  catch (...)
+  {
+    _entries.resize(first);
+
+    if (b._mapped)
+      ::munmap(const_cast<char*>(b._data), b._size);
+    else
+      delete[] b._data;
+
+    _blocks.pop_back();
+    throw;
+  }
+
+  // Room for all of them at once
+  size_type slots = _slots.size();
+
+  while ((_count + _entries.size() - first) * 2 > slots)
+    slots *= 2;
+
+  if (slots != _slots.size())
+    rehash(slots);
+
+  for (size_type i = first; i < _entries.size(); ++i)
+    insert(static_cast<index_type>(i));
+}
+
+void
+settings::split(
+    const block&        b,
+    format              f,
+    const std::string&  source,
+    std::vector<entry>& out)
+{
+  const char* p = b._data;
+  const char* const end = p + b._size;
+
+  if (f == format::environment)
+  {
+    while (p < end)
+    {
+      const char* eq = find_either(p, end, '=', '\0');
+      const char* eor = eq;
+
+      if (eq != end && *eq == '=')
+        eor = find_either(eq + 1, end, '\0', '\0');
+
+      // Entries without a name or a value are skipped, as the shell does
+      if (eq != end && *eq == '=' && eq != p)
+        out.push_back(entry { p, p, eq + 1, 0, static_cast<std::uint32_t>(eq - p),
+                              static_cast<std::uint32_t>(eor - eq - 1), 0, false, false, variable() });
+
+      p = eor + 1;
+    }
+
+    return;
+  }
+
+  const char* section = p;
+  std::uint32_t section_size = 0;
+
+  while (p < end)
+  {
+    const char* s = skip_blank(p, end);
+
+    if (s == end)
+      break;
+
+    if (*s == '\n')
+    {
+      p = s + 1;
+      continue;
+    }
+
+    const char* eol = find_either(s, end, '\n', '\n');
+
+    if (*s == '#' || *s == ';')
+    {
+      p = eol + 1;
+      continue;
+    }
+
+    const char* eq = nullptr;
+
+    if (*s == '[')
+    {
+      const char* close = static_cast<const char*>(std::memchr(s, ']', eol - s));
+
+      if (close != nullptr && skip_blank(close + 1, eol) == eol)
+      {
+        section = skip_blank(s + 1, close);
+        section_size = static_cast<std::uint32_t>(trim_blank(section, close) - section);
+        p = eol + 1;
+        continue;
+      }
+    }
+    else
+    {
+      if (eol - s > 7 && std::memcmp(s, "export ", 7) == 0)
+        s = skip_blank(s + 7, eol);
+
+      eq = find_either(s, eol, '=', '=');
+    }
+
+    const char* name_end = eq == nullptr ? s : trim_blank(s, eq);
+
+    if (eq == nullptr || eq == eol || name_end == s)
+    {
+      size_type line = 1;
+
+      for (const char* c = b._data; c != s; ++c)
+        line += *c == '\n';
+
+      throw std::invalid_argument("settings: " + source + ":" + std::to_string(line) +
+                                  ": expected key = value, [section] or a comment");
+    }
+
+    const char* value = skip_blank(eq + 1, eol);
+    const char* value_end = trim_blank(value, eol);
+    const bool quoted = value_end - value >= 2 && (*value == '"' || *value == '\'') && value_end[-1] == *value;
+
+    if (quoted)
+    {
+      ++value;
+      --value_end;
+    }
+
+    out.push_back(entry { section, s, value, section_size,
+                          static_cast<std::uint32_t>(name_end - s),
+                          static_cast<std::uint32_t>(value_end - value), 0, false, quoted, variable() });
+
+    p = eol + 1;
+  }
+}
+
+void
+settings::insert(
+    index_type x)
+{
+  entry& e = _entries[x];
+  std::uint64_t h = _cs_fnv_basis;
+
+  if (e._section_size != 0)
+    h = fnv(fnv(h, e._section, e._section_size), ".", 1);
+
+  e._hash = fold(fnv(h, e._name, e._name_size));
+
+  const size_type size = e._section_size == 0 ? e._name_size : e._section_size + 1 + e._name_size;
+  const std::size_t mask = _slots.size() - 1;
+  std::string key;
+
+  for (std::size_t i = e._hash & mask; ; i = (i + 1) & mask)
+  {
+    if (_slots[i] == npos)
+    {
+      _slots[i] = x;
+      ++_count;
+      return;
+    }
+
+    const entry& o = _entries[_slots[i]];
+    const size_type osize = o._section_size == 0 ? o._name_size : o._section_size + 1 + o._name_size;
+
+    if (o._hash != e._hash || osize != size)
+      continue;
+
+    // Same hash, compare the whole keys. Only overrides get here
+    if (key.empty())
+    {
+      if (e._section_size != 0)
+        key.assign(e._section, e._section_size).append(1, '.');
+
+      key.append(e._name, e._name_size);
+    }
+
+    if (lookup(key.data(), key.size(), e._hash) == i)
+    {
+      _slots[i] = x;
+      return;
+    }
+  }
+}
+
+void
+settings::rehash(
+    size_type slots)
+{
+  std::vector<index_type> old(slots, npos);
+  old.swap(_slots);
+
+  const std::size_t mask = slots - 1;
+
+  for (const index_type x : old)
+    if (x != npos)
+    {
+      std::size_t i = _entries[x]._hash & mask;
+
+      while (_slots[i] != npos)
+        i = (i + 1) & mask;
+
+      _slots[i] = x;
+    }
+}
+
+// Lookup
+settings::size_type
+settings::lookup(
+    const char*   key,
+    size_type     size,
+    std::uint32_t hash) const noexcept
+{
+  const std::size_t mask = _slots.size() - 1;
+
+  for (std::size_t i = hash & mask; ; i = (i + 1) & mask)
+  {
+    const index_type x = _slots[i];
+
+    if (x == npos)
+      return i;
+
+    const entry& e = _entries[x];
+
+    if (e._hash != hash)
+      continue;
+
+    if (e._section_size == 0)
+    {
+      if (e._name_size == size && std::memcmp(e._name, key, size) == 0)
+        return i;
+    }
+    else if (e._section_size + 1 + e._name_size == size &&
+             std::memcmp(e._section, key, e._section_size) == 0 &&
+             key[e._section_size] == '.' &&
+             std::memcmp(e._name, key + e._section_size + 1, e._name_size) == 0)
+      return i;
+  }
+}
+
+const variable&
+settings::value(
+    const entry& e) const
+{
+  if (!e._typed)
+  {
+    e._variable = e._quoted ? make_string(e._value, e._value_size) : typed(e._value, e._value_size);
+    e._typed = true;
+  }
+
+  return e._variable;
+}
+
+const variable*
+settings::find(
+    const char* key,
+    size_type   size) const
+{
+  const index_type x = _slots[lookup(key, size, fold(fnv(_cs_fnv_basis, key, size)))];
+
+  return x == npos ? nullptr : &value(_entries[x]);
+}
+
+const variable*
+settings::find(
+    const std::string& key) const
+{
+  return find(key.data(), key.size());
+}
+
+const variable&
+settings::operator[] (
+    const std::string& key) const
+{
+  const variable* v = find(key);
+
+  if (v == nullptr)
+    throw std::out_of_range("settings: key " + key + " not found");
+
+  return *v;
+}
+
+bool
+settings::contains(
+    const std::string& key) const noexcept
+{
+  return _slots[lookup(key.data(), key.size(), fold(fnv(_cs_fnv_basis, key.data(), key.size())))] != npos;
+}
+
+settings::slice
+settings::raw(
+    const std::string& key) const noexcept
+{
+  const index_type x = _slots[lookup(key.data(), key.size(), fold(fnv(_cs_fnv_basis, key.data(), key.size())))];
+
+  return x == npos ? slice() : slice(_entries[x]._value, _entries[x]._value_size);
+}
+
+void
+settings::resolve() const
+{
+  for (const index_type x : _slots)
+    if (x != npos)
+      value(_entries[x]);
+}
+
+settings::size_type
+settings::bytes() const noexcept
+{
+  size_type result = 0;
+
+  for (const block& b : _blocks)
+    result += b._size;
+
+  return result;
+}
+
+std::map<variable, variable>
+settings::to_map() const
+{
+  std::map<variable, variable> result;
+
+  for (const index_type x : _slots)
+    if (x != npos)
+    {
+      const entry& e = _entries[x];
+      std::string key;
+
+      if (e._section_size != 0)
+        key.assign(e._section, e._section_size).append(1, '.');
+
+      key.append(e._name, e._name_size);
+      result[variable(key)] = value(e);
+    }
+
+  return result;
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,656 @@
+/*!
+ *	\file		shared_store.cpp
+ *	\brief		Implements variable store in POSIX shared memory
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <egg/shared_store.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+// The segment is shared by processes, the atomics must not hide a lock
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared_store needs lock-free 32 bit atomics");
+
+struct shared_store::header
+{
+	char				_magic[8];
+	std::atomic<std::uint32_t>	_ready;		// set last by the creator
+	std::uint32_t			_version;
+	std::uint64_t			_capacity;
+	std::uint64_t			_key_bytes;
+	std::uint64_t			_value_bytes;
+	std::uint64_t			_stride;	// bytes per slot
+	std::atomic<std::uint32_t>	_size;
+};
+
+struct shared_store::slot
+{
+	std::atomic<std::uint32_t>	_sequence;	// odd while a writer holds it
+	std::atomic<std::uint32_t>	_state;
+	std::uint32_t			_hash;
+	std::uint32_t			_key_size;
+	std::uint32_t			_value_size;
+	std::uint32_t			_reserved;
+
+	// Key, then value bytes follow
+
+	std::uint8_t* key() noexcept		{ return reinterpret_cast<std::uint8_t*>(this + 1);	}
+	const std::uint8_t* key() const noexcept { return reinterpret_cast<const std::uint8_t*>(this + 1); }
+};
+
+namespace
+{
+
+const char _cs_magic[8] = { 'E', 'G', 'G', 'S', 'H', 'M', 0, 0 };
+const std::uint32_t _cs_version = 1;
+const std::uint32_t _cs_ready = 0x52454459u;
+
+// Slot states
+const std::uint32_t _cs_empty = 0;
+const std::uint32_t _cs_claimed = 1;	// key being written
+const std::uint32_t _cs_used = 2;
+
+// Slots start on their own cache line
+const std::size_t _cs_line = 64;
+
+// Largest slot limits, the sizes are 32 bit
+const std::size_t _cs_limit = std::size_t(1) << 30;
+
+// Encoding of the empty variable
+const std::uint8_t _cs_empty_value = 0;
+
+// Opening side waits that long for the creator to finish
+const int _cs_attach_tries = 10000;
+
+// FNV-1a over the key encoding, the same in every process
+inline std::uint32_t
+key_hash(
+    const std::uint8_t* p,
+    std::size_t         n) noexcept
+{
+  std::uint64_t h = 0xcbf29ce484222325ull;
+
+  for (std::size_t i = 0; i < n; ++i)
+    h = (h ^ p[i]) * 0x100000001b3ull;
+
+  return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+// Encoding buffer, on the stack for the usual slot limits
+struct scratch
+{
+  explicit scratch(
+      std::size_t size)
+    : _data(_small)
+  {
+    if (size > sizeof(_small))
+    {
+      _large.resize(size);
+      _data = _large.data();
+    }
+  }
+
+  std::uint8_t*			_data;
+  std::uint8_t			_small[256];
+  std::vector<std::uint8_t>	_large;
+};
+
+std::string
+shm_name(
+    const std::string& name)
+{
+  return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+void
+system_error(
+    const std::string& what)
+{
+  throw std::runtime_error("shared_store: " + what + ": " + std::strerror(errno));
+}
+
+} // End of anonymous namespace
+
+// Construct/destruct
+shared_store::shared_store() noexcept
+  : _base(nullptr),
+    _size(0),
+    _header(nullptr)
+{}
+
+shared_store::~shared_store() noexcept
+{
+  close();
+}
+
+// Move
+shared_store::shared_store(
+    shared_store&& other) noexcept
+  : shared_store()
+{
+  *this = std::move(other);
+}
+
+shared_store&
+shared_store::operator=(
+    shared_store&& other) noexcept
+{
+  if (this != &other)
+  {
+    close();
+
+    _base = other._base;
+    _size = other._size;
+    _header = other._header;
+
+    other._base = nullptr;
+    other._size = 0;
+    other._header = nullptr;
+  }
+
+  return *this;
+}
+
+void
+shared_store::close() noexcept
+{
+  if (_base != nullptr)
+    ::munmap(_base, _size);
+
+  _base = nullptr;
+  _size = 0;
+  _header = nullptr;
+}
+
+// Segment
+shared_store
+shared_store::create(
+    const std::string& name,
+    const options&     geometry)
+{
+  return attach(name, &geometry);
+}
+
+shared_store
+shared_store::open(
+    const std::string& name)
+{
+  return attach(name, nullptr);
+}
+
+bool
+shared_store::remove(
+    const std::string& name) noexcept
+{
+  return ::shm_unlink(shm_name(name).c_str()) == 0;
+}
+
+shared_store
+shared_store::attach(
+    const std::string& name,
+    const options*     geometry)
+{
+  const std::string n = shm_name(name);
+
+  std::size_t capacity = 0, key_bytes = 0, value_bytes = 0, stride = 0;
+
+  if (geometry != nullptr)
+  {
+    if (geometry->_key_bytes == 0 || geometry->_key_bytes > _cs_limit ||
+        geometry->_value_bytes == 0 || geometry->_value_bytes > _cs_limit ||
+        geometry->_capacity == 0 || geometry->_capacity > _cs_limit)
+      throw std::invalid_argument("shared_store::create(): bad geometry");
+
+    capacity = 1;
+    while (capacity < geometry->_capacity)
+      capacity *= 2;
+
+    key_bytes = geometry->_key_bytes;
+    value_bytes = geometry->_value_bytes;
+    stride = (sizeof(slot) + key_bytes + value_bytes + _cs_line - 1) / _cs_line * _cs_line;
+  }
+
+  // The one who creates the name lays the segment out
+  bool creator = false;
+  int fd = -1;
+
+  if (geometry != nullptr)
+  {
+    fd = ::shm_open(n.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    creator = fd >= 0;
+
+    if (fd < 0 && errno != EEXIST)
+      system_error("can't create " + n);
+  }
+
+  if (fd < 0)
+    fd = ::shm_open(n.c_str(), O_RDWR, 0);
+
+  if (fd < 0)
+    system_error("can't open " + n);
+
+  const std::size_t head = (sizeof(header) + _cs_line - 1) / _cs_line * _cs_line;
+  std::size_t size = 0;
+
+  if (creator)
+  {
+    size = head + capacity * stride;
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+      ::close(fd);
+      ::shm_unlink(n.c_str());
+      system_error("can't size " + n);
+    }
+  }
+  else
+  {
+    // Wait until the creator has sized the segment
+    struct stat st;
+
+    for (int i = 0; ; ++i)
+    {
+      if (::fstat(fd, &st) != 0)
+      {
+        ::close(fd);
+        system_error("can't stat " + n);
+      }
+
+      if (st.st_size >= static_cast<off_t>(head) || i == _cs_attach_tries)
+        break;
+
+      std::this_thread::yield();
+    }
+
+    size = static_cast<std::size_t>(st.st_size);
+
+    if (size < head)
+    {
+      ::close(fd);
+      throw std::runtime_error("shared_store: " + n + " is not initialized");
+    }
+  }
+
+  void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+    system_error("can't map " + n);
+
+  shared_store result;
+  result._base = static_cast<std::uint8_t*>(p);
+  result._size = size;
+  result._header = static_cast<header*>(p);
+
+  header& h = *result._header;
+
+  if (creator)
+  {
+    // Fresh pages are zero: every slot is empty, every sequence even
+    std::memcpy(h._magic, _cs_magic, sizeof(h._magic));
+    h._version = _cs_version;
+    h._capacity = capacity;
+    h._key_bytes = key_bytes;
+    h._value_bytes = value_bytes;
+    h._stride = stride;
+    h._size.store(0, std::memory_order_relaxed);
+    h._ready.store(_cs_ready, std::memory_order_release);
+
+    return result;
+  }
+
+  for (int i = 0; h._ready.load(std::memory_order_acquire) != _cs_ready; ++i)
+  {
+    if (i == _cs_attach_tries)
+      throw std::runtime_error("shared_store: " + n + " is not initialized");
+
+    std::this_thread::yield();
+  }
+
+  if (std::memcmp(h._magic, _cs_magic, sizeof(h._magic)) != 0 || h._version != _cs_version ||
+      h._capacity == 0 || (h._capacity & (h._capacity - 1)) != 0 ||
+      h._stride < sizeof(slot) + h._key_bytes + h._value_bytes ||
+      size < head + h._capacity * h._stride)
+    throw std::runtime_error("shared_store: " + n + " is not a store");
+
+  if (geometry != nullptr &&
+      (h._capacity != capacity || h._key_bytes != key_bytes || h._value_bytes != value_bytes))
+    throw std::runtime_error("shared_store: " + n + " exists with another geometry");
+
+  return result;
+}
+
+// Size
+shared_store::size_type
+shared_store::size() const noexcept
+{
+  return _header == nullptr ? 0 : _header->_size.load(std::memory_order_relaxed);
+}
+
+shared_store::size_type
+shared_store::capacity() const noexcept
+{
+  return _header == nullptr ? 0 : _header->_capacity;
+}
+
+shared_store::size_type
+shared_store::key_bytes() const noexcept
+{
+  return _header == nullptr ? 0 : _header->_key_bytes;
+}
+
+shared_store::size_type
+shared_store::value_bytes() const noexcept
+{
+  return _header == nullptr ? 0 : _header->_value_bytes;
+}
+
+// Slots
+shared_store::slot*
+shared_store::at(
+    size_type i) const noexcept
+{
+  const std::size_t head = (sizeof(header) + _cs_line - 1) / _cs_line * _cs_line;
+
+  return reinterpret_cast<slot*>(_base + head + i * _header->_stride);
+}
+
+shared_store::size_type
+shared_store::key(
+    const variable& k,
+    std::uint8_t*   buffer) const
+{
+  if (_header == nullptr)
+    throw std::runtime_error("shared_store: not open");
+
+  const size_type n = encode(k, buffer, _header->_key_bytes);
+
+  if (n == 0)
+    throw std::length_error("shared_store: key " + k.to_string() + " is too large");
+
+  return n;
+}
+
+shared_store::slot*
+shared_store::find(
+    const std::uint8_t* k,
+    size_type           size) const noexcept
+{
+  const std::uint32_t h = key_hash(k, size);
+  const size_type mask = _header->_capacity - 1;
+
+  for (size_type probe = 0, i = h & mask; probe <= mask; ++probe, i = (i + 1) & mask)
+  {
+    slot* s = at(i);
+    std::uint32_t state = s->_state.load(std::memory_order_acquire);
+
+    if (state == _cs_empty)
+      return nullptr;
+
+    // Another process is writing a key here, it may be this one
+    while (state == _cs_claimed)
+    {
+      std::this_thread::yield();
+      state = s->_state.load(std::memory_order_acquire);
+    }
+
+    // Keys never change once the slot is used
+    if (s->_hash == h && s->_key_size == size && std::memcmp(s->key(), k, size) == 0)
+      return s;
+  }
+
+  return nullptr;
+}
+
+shared_store::slot*
+shared_store::insert(
+    const std::uint8_t* k,
+    size_type           size)
+{
+  const std::uint32_t h = key_hash(k, size);
+  const size_type mask = _header->_capacity - 1;
+
+  for (size_type probe = 0, i = h & mask; probe <= mask; ++probe, i = (i + 1) & mask)
+  {
+    slot* s = at(i);
+    std::uint32_t state = s->_state.load(std::memory_order_acquire);
+
+    if (state == _cs_empty &&
+        s->_state.compare_exchange_strong(state, _cs_claimed, std::memory_order_acquire))
+    {
+      s->_hash = h;
+      s->_key_size = static_cast<std::uint32_t>(size);
+      std::memcpy(s->key(), k, size);
+
+      s->_value_size = 1;
+      s->key()[_header->_key_bytes] = _cs_empty_value;
+
+      s->_state.store(_cs_used, std::memory_order_release);
+      _header->_size.fetch_add(1, std::memory_order_relaxed);
+
+      return s;
+    }
+
+    // Lost the race or the slot is taken, wait for the key
+    while (state == _cs_claimed)
+    {
+      std::this_thread::yield();
+      state = s->_state.load(std::memory_order_acquire);
+    }
+
+    if (s->_hash == h && s->_key_size == size && std::memcmp(s->key(), k, size) == 0)
+      return s;
+  }
+
+  throw std::length_error("shared_store: full");
+}
+
+// Sequence lock
+std::uint32_t
+shared_store::lock(
+    slot& s) noexcept
+{
+  for (;;)
+  {
+    std::uint32_t sequence = s._sequence.load(std::memory_order_relaxed);
+
+    if ((sequence & 1) == 0 &&
+        s._sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire))
+    {
+      // Readers that see the new value also see the odd sequence
+      std::atomic_thread_fence(std::memory_order_release);
+      return sequence + 1;
+    }
+
+    std::this_thread::yield();
+  }
+}
+
+void
+shared_store::unlock(
+    slot&         s,
+    std::uint32_t sequence) noexcept
+{
+  s._sequence.store(sequence + 1, std::memory_order_release);
+}
+
+shared_store::size_type
+shared_store::fetch(
+    const slot&   s,
+    std::uint8_t* buffer) const noexcept
+{
+  const std::uint8_t* value = s.key() + _header->_key_bytes;
+  const size_type limit = _header->_value_bytes;
+
+  for (;;)
+  {
+    const std::uint32_t before = s._sequence.load(std::memory_order_acquire);
+
+    if (before & 1)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    // A torn size is caught by the sequence check, it just must not overrun
+    size_type n = s._value_size;
+    if (n > limit)
+      n = limit;
+
+    std::memcpy(buffer, value, n);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (s._sequence.load(std::memory_order_relaxed) == before)
+      return n;
+  }
+}
+
+shared_store::size_type
+shared_store::fetch(
+    const variable& k,
+    std::uint8_t*   buffer) const
+{
+  scratch encoded(key_bytes());
+  const size_type n = key(k, encoded._data);
+  const slot* s = find(encoded._data, n);
+
+  return s == nullptr ? 0 : fetch(*s, buffer);
+}
+
+// Access
+void
+shared_store::set(
+    const variable& k,
+    const variable& value)
+{
+  scratch encoded(key_bytes());
+  const size_type n = key(k, encoded._data);
+  const size_type m = encoded_size(value);
+
+  if (m > _header->_value_bytes)
+    throw std::length_error("shared_store: value of " + k.to_string() + " is too large");
+
+  slot& s = *insert(encoded._data, n);
+  const std::uint32_t sequence = lock(s);
+
+  encode(value, s.key() + _header->_key_bytes, m);
+  s._value_size = static_cast<std::uint32_t>(m);
+
+  unlock(s, sequence);
+}
+
+std::int64_t
+shared_store::add(
+    const variable& k,
+    std::int64_t    delta)
+{
+  scratch encoded(key_bytes());
+  const size_type n = key(k, encoded._data);
+
+  slot& s = *insert(encoded._data, n);
+  std::uint8_t* value = s.key() + _header->_key_bytes;
+
+  const std::uint32_t sequence = lock(s);
+
+  // The writer owns the slot, the value can be read in place
+  variable_view current;
+  std::int64_t x = 0;
+
+  if (decode(value, s._value_size, current) == 0 ||
+      !(current.is_empty() || variable_access::is_signed(current.type())))
+  {
+    unlock(s, sequence);
+    throw std::invalid_argument("shared_store::add(): value of " + k.to_string() + " is not a signed integer");
+  }
+
+  if (!current.is_empty())
+    x = current.as_int64();
+
+  if (delta > 0 ? x > std::numeric_limits<std::int64_t>::max() - delta
+                : x < std::numeric_limits<std::int64_t>::min() - delta)
+  {
+    unlock(s, sequence);
+    throw std::overflow_error("shared_store::add(): value of " + k.to_string() + " overflows int64");
+  }
+
+  x += delta;
+
+  const size_type m = encode(variable(x), value, _header->_value_bytes);
+
+  if (m == 0)
+  {
+    unlock(s, sequence);
+    throw std::length_error("shared_store::add(): value of " + k.to_string() + " is too large");
+  }
+
+  s._value_size = static_cast<std::uint32_t>(m);
+
+  unlock(s, sequence);
+
+  return x;
+}
+
+bool
+shared_store::erase(
+    const variable& k)
+{
+  scratch encoded(key_bytes());
+  const size_type n = key(k, encoded._data);
+  slot* s = find(encoded._data, n);
+
+  if (s == nullptr)
+    return false;
+
+  const std::uint32_t sequence = lock(*s);
+
+  s->key()[_header->_key_bytes] = _cs_empty_value;
+  s->_value_size = 1;
+
+  unlock(*s, sequence);
+
+  return true;
+}
+
+bool
+shared_store::get(
+    const variable& k,
+    variable&       value) const
+{
+  scratch buffer(value_bytes());
+  const size_type n = fetch(k, buffer._data);
+
+  return n != 0 && decode(buffer._data, n, value) != 0;
+}
+
+variable
+shared_store::get(
+    const variable& k) const
+{
+  variable v;
+  get(k, v);
+
+  return v;
+}
+
+} // End of egg namespace
+
+/* End of file */
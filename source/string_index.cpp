@@ -0,0 +1,233 @@
+/*!
+ *	\file		string_index.cpp
+ *	\brief		Implements the membership index of string lists
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <string>
+#include <functional>
+
+#include "string_index.hpp"
+
+
+namespace egg
+{
+
+namespace
+{
+
+// std::hash is 32 bit on some targets, spread it over 64
+inline std::uint64_t
+mix(
+    const std::string& s) noexcept
+{
+  std::uint64_t h = std::hash<std::string>()(s);
+
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+
+  return h;
+}
+
+// Two bits of one word per entry
+inline std::uint64_t
+bloom_bits(
+    const std::uint64_t h) noexcept
+{
+  return (std::uint64_t(1) << ((h >> 52) & 63)) | (std::uint64_t(1) << (h >> 58));
+}
+
+inline std::size_t
+power_of_two(
+    const std::size_t n) noexcept
+{
+  std::size_t p = 1;
+
+  while (p < n)
+    p <<= 1;
+
+  return p;
+}
+
+} // End of anonymous namespace
+
+// Index
+const std::size_t string_index::scan_limit;
+const std::size_t string_index::bloom_limit;
+
+string_index::string_index(
+    const variable::stringlist& entries)
+  : _refs(1),
+    _slots(power_of_two(entries.size() * 2 + 1), 0),
+    _mask(_slots.size() - 1),
+    _bloom_mask(0)
+{
+  if (entries.size() >= bloom_limit)
+  {
+    _bloom.assign(power_of_two(entries.size() / 8), 0);
+    _bloom_mask = _bloom.size() - 1;
+  }
+
+  for (std::size_t p = 0; p < entries.size(); ++p)
+  {
+    const std::uint64_t h = mix(entries[p]);
+    const std::uint64_t tag = h & 0xffffffff00000000ull;
+
+    if (!_bloom.empty())
+      _bloom[(h >> 12) & _bloom_mask] |= bloom_bits(h);
+
+    // Duplicates keep the first position
+    std::size_t i = h & _mask;
+
+    for (; _slots[i] != 0; i = (i + 1) & _mask)
+      if ((_slots[i] & 0xffffffff00000000ull) == tag &&
+          entries[(_slots[i] & 0xffffffff) - 1] == entries[p])
+        break;
+
+    if (_slots[i] == 0)
+      _slots[i] = tag | (p + 1);
+  }
+}
+
+std::size_t
+string_index::find(
+    const variable::stringlist& entries,
+    const std::string&          value) const noexcept
+{
+  const std::uint64_t h = mix(value);
+
+  if (!_bloom.empty())
+  {
+    const std::uint64_t bits = bloom_bits(h);
+
+    if ((_bloom[(h >> 12) & _bloom_mask] & bits) != bits)
+      return variable::npos;
+  }
+
+  const std::uint64_t tag = h & 0xffffffff00000000ull;
+
+  for (std::size_t i = h & _mask; _slots[i] != 0; i = (i + 1) & _mask)
+    if ((_slots[i] & 0xffffffff00000000ull) == tag)
+    {
+      const std::size_t p = (_slots[i] & 0xffffffff) - 1;
+
+      if (entries[p] == value)
+        return p;
+    }
+
+  return variable::npos;
+}
+
+std::size_t
+string_index::bytes() const noexcept
+{
+  return sizeof(string_index) + (_slots.capacity() + _bloom.capacity()) * sizeof(std::uint64_t);
+}
+
+void
+string_index::acquire() const noexcept
+{
+  _refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+string_index::release() const noexcept
+{
+  if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    delete this;
+}
+
+// Payload
+string_list_payload::string_list_payload(
+    const variable::stringlist& entries)
+  : _entries(entries),
+    _index(nullptr)
+{}
+
+string_list_payload::string_list_payload(
+    variable::stringlist&& entries) noexcept
+  : _entries(std::move(entries)),
+    _index(nullptr)
+{}
+
+string_list_payload::string_list_payload(
+    const string_list_payload& other)
+  : _entries(other._entries),
+    _index(other._index.load(std::memory_order_acquire))
+{
+  if (const string_index* i = _index.load(std::memory_order_relaxed))
+    i->acquire();
+}
+
+string_list_payload&
+string_list_payload::operator=(
+    const string_list_payload& other)
+{
+  if (this != &other)
+  {
+    // Drop the index first, it must not outlive the entries if the copy throws
+    if (const string_index* old = _index.exchange(nullptr, std::memory_order_acq_rel))
+      old->release();
+
+    _entries = other._entries;
+
+    const string_index* i = other._index.load(std::memory_order_acquire);
+
+    if (i != nullptr)
+      i->acquire();
+
+    _index.store(i, std::memory_order_release);
+  }
+
+  return *this;
+}
+
+string_list_payload::~string_list_payload() noexcept
+{
+  if (const string_index* i = _index.load(std::memory_order_acquire))
+    i->release();
+}
+
+const string_index&
+string_list_payload::index() const
+{
+  const string_index* i = _index.load(std::memory_order_acquire);
+
+  if (i == nullptr)
+  {
+    const string_index* built = new string_index(_entries);
+
+    if (_index.compare_exchange_strong(i, built, std::memory_order_acq_rel))
+      i = built;
+    else
+      built->release();
+  }
+
+  return *i;
+}
+
+std::size_t
+string_list_payload::find(
+    const std::string& value) const
+{
+  if (_entries.size() < string_index::scan_limit)
+  {
+    for (std::size_t p = 0; p < _entries.size(); ++p)
+      if (_entries[p] == value)
+        return p;
+
+    return variable::npos;
+  }
+
+  return index().find(_entries, value);
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,85 @@
+/*!
+ *	\file		string_index.hpp
+ *	\brief		Declares the membership index of string lists (library only)
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_STRING_INDEX
+#define EGG_STRING_INDEX
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+// Not installed. Open addressing table of the positions of the entries of a
+// string list. A slot keeps 32 bits of the hash of the entry next to its
+// position, so a probe compares strings only when those bits match. Large
+// lists also get a blocked Bloom filter, one word per probe, small enough to
+// stay in cache and reject most misses before the table is touched.
+// Immutable once built; shared by reference count.
+struct EGG_PRIVATE string_index
+{
+	// Lists shorter than this are scanned, the index would not pay off
+	static const std::size_t scan_limit = 8;
+
+	// Lists at least this long get the Bloom filter
+	static const std::size_t bloom_limit = 4096;
+
+	explicit string_index(const variable::stringlist& /*entries*/);
+
+	string_index(const string_index&) = delete;
+	string_index& operator=(const string_index&) = delete;
+
+	// Position of the first entry equal to value, variable::npos if none
+	std::size_t find(const variable::stringlist& /*entries*/, const std::string& /*value*/) const noexcept;
+
+	// Heap of the index
+	std::size_t bytes() const noexcept;
+
+	void acquire() const noexcept;
+	void release() const noexcept;
+
+private:
+
+	mutable std::atomic<std::size_t>	_refs;
+	std::vector<std::uint64_t>		_slots;		// hash bits << 32 | position + 1, 0 is free
+	std::size_t				_mask;
+	std::vector<std::uint64_t>		_bloom;		// empty below bloom_limit
+	std::size_t				_bloom_mask;
+};
+
+// Payload of is_string_list: the entries, then the index built by the first
+// query. Copies share the index, assigning other entries drops it
+struct EGG_PRIVATE string_list_payload
+{
+	explicit string_list_payload(const variable::stringlist& /*entries*/);
+	explicit string_list_payload(variable::stringlist&& /*entries*/) noexcept;
+
+	string_list_payload(const string_list_payload& /*other*/);
+	string_list_payload& operator=(const string_list_payload& /*other*/);
+
+	~string_list_payload() noexcept;
+
+	// Built on first use, safe to race: one of the builds is kept
+	const string_index& index() const;
+
+	std::size_t find(const std::string& /*value*/) const;
+
+	variable::stringlist			_entries;
+	mutable std::atomic<const string_index*> _index;
+};
+
+} // End of egg namespace
+
+#endif  // EGG_STRING_INDEX
+
+/* End of file */
@@ -0,0 +1,70 @@
+/*!
+ *	\file		text_helpers.hpp
+ *	\brief		Declares helpers shared by the text readers (library only)
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_TEXT_HELPERS
+#define EGG_TEXT_HELPERS
+
+#include <string>
+#include <cstddef>
+
+#include <egg/variable.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+// Not installed. Used by the JSON and settings readers.
+
+// Position of the lowest set bit of a non zero mask
+#if defined(__GNUC__)
+inline unsigned
+first_bit(
+    unsigned mask) noexcept
+{
+  return static_cast<unsigned>(__builtin_ctz(mask));
+}
+#else
+inline unsigned
+first_bit(
+    unsigned mask) noexcept
+{
+  unsigned i = 0;
+
+  while ((mask & 1) == 0)
+  {
+    mask >>= 1;
+    ++i;
+  }
+
+  return i;
+}
+#endif
+
+// String variable built in place, one allocation
+inline variable
+make_string(
+    const char*  data,
+    std::size_t  size)
+{
+  variable v;
+
+  variable_access::data(v)._pointer = new std::string(data, size);
+  variable_access::type(v) = variable::content::is_string;
+  variable_access::rehash(v);
+
+  return v;
+}
+
+} // End of egg namespace
+
+#endif  // EGG_TEXT_HELPERS
+
+/* End of file */
@@ -0,0 +1,458 @@
+/*!
+ *	\file		tree.cpp
+ *	\brief		Implements arena-backed hierarchical tree of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include <egg/tree.hpp>
+
+
+namespace egg
+{
+
+namespace
+{
+
+// Link slot states, stored in place of the node index
+const tree::index_type _cs_empty = tree::npos;
+const tree::index_type _cs_deleted = tree::npos - 1;
+
+// Smallest link table
+const std::size_t _cs_links = 16;
+
+// Key id of the root, the empty variable
+const tree::index_type _cs_root_key = 0;
+
+// Source of the generation stamps
+std::atomic<std::uint64_t> _generations(0);
+
+inline std::uint64_t
+stamp() noexcept
+{
+  return _generations.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // End of anonymous namespace
+
+const tree::index_type tree::npos;
+
+// Construct/destruct
+tree::tree()
+  : _link_count(0),
+    _link_deleted(0),
+    _size(0),
+    _generation(0)
+{
+  clear();
+}
+
+tree::~tree() noexcept
+{}
+
+// Copy
+tree::tree(
+    const tree& other)
+  : _nodes(other._nodes),
+    _keys(other._keys),
+    _key_ids(other._key_ids),
+    _links(other._links),
+    _link_count(other._link_count),
+    _link_deleted(other._link_deleted),
+    _size(other._size),
+    _generation(other._generation)
+{}
+
+tree&
+tree::operator=(
+    const tree& other)
+{
+  if (this != &other)
+  {
+    tree copy(other);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+// Move
+tree::tree(
+    tree&& other) noexcept
+  : _nodes(std::move(other._nodes)),
+    _keys(std::move(other._keys)),
+    _key_ids(std::move(other._key_ids)),
+    _links(std::move(other._links)),
+    _link_count(other._link_count),
+    _link_deleted(other._link_deleted),
+    _size(other._size),
+    _generation(other._generation)
+{}
+
+tree&
+tree::operator=(
+    tree&& other) noexcept
+{
+  if (this != &other)
+  {
+    _nodes = std::move(other._nodes);
+    _keys = std::move(other._keys);
+    _key_ids = std::move(other._key_ids);
+    _links = std::move(other._links);
+    _link_count = other._link_count;
+    _link_deleted = other._link_deleted;
+    _size = other._size;
+    _generation = other._generation;
+  }
+
+  return *this;
+}
+
+// Size
+tree::size_type
+tree::size() const noexcept
+{
+  return _size;
+}
+
+bool
+tree::empty() const noexcept
+{
+  return _size == 0;
+}
+
+tree::size_type
+tree::keys() const noexcept
+{
+  return _keys.size() - 1;
+}
+
+void
+tree::reserve(
+    size_type n)
+{
+  _nodes.reserve(n + 1);
+
+  if ((n + _link_deleted) * 4 > _links.size() * 3)
+    link_rehash(std::max(n, _link_count));
+}
+
+void
+tree::clear()
+{
+  _nodes.clear();
+  _keys.clear();
+  _key_ids.clear();
+  _links.assign(_cs_links, link { npos, npos, _cs_empty });
+  _link_count = 0;
+  _link_deleted = 0;
+  _size = 0;
+  _generation = stamp();
+
+  // Root has the empty key and no parent
+  _keys.push_back(variable());
+  _key_ids[variable()] = _cs_root_key;
+  _nodes.push_back(node_data { _cs_root_key, npos, npos, npos, npos, 0, variable() });
+}
+
+void
+tree::compact()
+{
+  std::vector<node_data> nodes;
+  nodes.reserve(_size + 1);
+
+  // Depth-first copy. Each pending entry is (old index, new parent)
+  std::vector<std::pair<index_type, index_type>> pending;
+  pending.push_back(std::make_pair(index_type(0), npos));
+
+  std::vector<index_type> children;
+
+  while (!pending.empty())
+  {
+    const index_type old = pending.back().first;
+    const index_type parent = pending.back().second;
+    pending.pop_back();
+
+    node_data& from = _nodes[old];
+    const index_type self = static_cast<index_type>(nodes.size());
+
+    nodes.push_back(node_data { from._key, parent, npos, npos, npos, 0, std::move(from._value) });
+
+    if (parent != npos)
+    {
+      node_data& p = nodes[parent];
+
+      if (p._last == npos)
+        p._first = self;
+      else
+        nodes[p._last]._next = self;
+
+      p._last = self;
+      ++p._children;
+    }
+
+    // Push children in reverse, so the first one is copied first
+    children.clear();
+    for (index_type c = from._first; c != npos; c = _nodes[c]._next)
+      children.push_back(c);
+
+    for (auto c = children.rbegin(); c != children.rend(); ++c)
+      pending.push_back(std::make_pair(*c, self));
+  }
+
+  _nodes.swap(nodes);
+  _generation = stamp();
+
+  // Indices changed, so do the links
+  _links.assign(_links.size(), link { npos, npos, _cs_empty });
+  _link_count = 0;
+  _link_deleted = 0;
+
+  for (index_type i = 1; i < _nodes.size(); ++i)
+    link_insert(_nodes[i]._parent, _nodes[i]._key, i);
+}
+
+// Keys
+tree::index_type
+tree::key_id(
+    const variable& key) const noexcept
+{
+  const auto i = _key_ids.find(key);
+
+  return i == _key_ids.end() ? npos : i->second;
+}
+
+tree::index_type
+tree::intern(
+    const variable& key)
+{
+  const auto r = _key_ids.emplace(key, static_cast<index_type>(_keys.size()));
+
+  if (r.second)
+  {
+    if (_keys.size() >= _cs_deleted)
+    {
+      _key_ids.erase(key);
+      throw std::length_error("tree: too many keys");
+    }
+
+    _keys.push_back(key);
+  }
+
+  return r.first->second;
+}
+
+// Nodes
+tree::index_type
+tree::child(
+    index_type parent,
+    index_type key) const noexcept
+{
+  const std::size_t mask = _links.size() - 1;
+
+  for (std::size_t i = link_hash(parent, key) & mask; ; i = (i + 1) & mask)
+  {
+    const link& l = _links[i];
+
+    if (l._node == _cs_empty)
+      return npos;
+
+    if (l._parent == parent && l._key == key && l._node != _cs_deleted)
+      return l._node;
+  }
+}
+
+tree::index_type
+tree::add(
+    index_type parent,
+    index_type key)
+{
+  if (_nodes.size() >= _cs_deleted)
+    throw std::length_error("tree: too many nodes");
+
+  const index_type self = static_cast<index_type>(_nodes.size());
+
+  // The node exists before a link can point at it
+  _nodes.push_back(node_data { key, parent, npos, npos, npos, 0, variable() });
+
+  try
+  {
+    link_insert(parent, key, self);
+  }
+  catch (...)
+  {
+    _nodes.pop_back();
+    throw;
+  }
+
+  node_data& p = _nodes[parent];
+
+  if (p._last == npos)
+    p._first = self;
+  else
+    _nodes[p._last]._next = self;
+
+  p._last = self;
+  ++p._children;
+  ++_size;
+  _generation = stamp();
+
+  return self;
+}
+
+tree::size_type
+tree::remove(
+    index_type parent,
+    index_type key) noexcept
+{
+  const index_type victim = child(parent, key);
+
+  if (victim == npos)
+    return 0;
+
+  // Unlink from the siblings
+  node_data& p = _nodes[parent];
+  index_type previous = npos;
+
+  for (index_type c = p._first; c != victim; c = _nodes[c]._next)
+    previous = c;
+
+  if (previous == npos)
+    p._first = _nodes[victim]._next;
+  else
+    _nodes[previous]._next = _nodes[victim]._next;
+
+  if (p._last == victim)
+    p._last = previous;
+
+  --p._children;
+
+  // Drop the subtree in preorder, climbing back through the parents.
+  // The arena slots stay until compact()
+  size_type removed = 0;
+  index_type i = victim;
+
+  for (;;)
+  {
+    node_data& n = _nodes[i];
+
+    link_erase(n._parent, n._key);
+    n._value = variable();
+    ++removed;
+
+    if (n._first != npos)
+    {
+      i = n._first;
+      continue;
+    }
+
+    while (i != victim && _nodes[i]._next == npos)
+      i = _nodes[i]._parent;
+
+    if (i == victim)
+      break;
+
+    i = _nodes[i]._next;
+  }
+
+  _size -= removed;
+  _generation = stamp();
+
+  return removed;
+}
+
+// Links
+std::size_t
+tree::link_hash(
+    index_type parent,
+    index_type key) noexcept
+{
+  std::uint64_t x = (static_cast<std::uint64_t>(parent) << 32) | key;
+
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+
+  return static_cast<std::size_t>(x);
+}
+
+void
+tree::link_insert(
+    index_type parent,
+    index_type key,
+    index_type node)
+{
+  if ((_link_count + _link_deleted + 1) * 4 > _links.size() * 3)
+    link_rehash(_link_count + 1);
+
+  const std::size_t mask = _links.size() - 1;
+  std::size_t i = link_hash(parent, key) & mask;
+
+  while (_links[i]._node != _cs_empty && _links[i]._node != _cs_deleted)
+    i = (i + 1) & mask;
+
+  if (_links[i]._node == _cs_deleted)
+    --_link_deleted;
+
+  _links[i] = link { parent, key, node };
+  ++_link_count;
+}
+
+void
+tree::link_erase(
+    index_type parent,
+    index_type key) noexcept
+{
+  const std::size_t mask = _links.size() - 1;
+
+  for (std::size_t i = link_hash(parent, key) & mask; _links[i]._node != _cs_empty; i = (i + 1) & mask)
+  {
+    link& l = _links[i];
+
+    if (l._parent == parent && l._key == key && l._node != _cs_deleted)
+    {
+      l._node = _cs_deleted;
+      --_link_count;
+      ++_link_deleted;
+      return;
+    }
+  }
+}
+
+void
+tree::link_rehash(
+    size_type count)
+{
+  // Keep the load at or below a half after the rehash
+  size_type capacity = _cs_links;
+  while (capacity < count * 2)
+    capacity *= 2;
+
+  std::vector<link> old(capacity, link { npos, npos, _cs_empty });
+  old.swap(_links);
+
+  const std::size_t mask = capacity - 1;
+
+  for (const link& l : old)
+    if (l._node != _cs_empty && l._node != _cs_deleted)
+    {
+      std::size_t i = link_hash(l._parent, l._key) & mask;
+
+      while (_links[i]._node != _cs_empty)
+        i = (i + 1) & mask;
+
+      _links[i] = l;
+    }
+
+  _link_deleted = 0;
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,1069 @@
+/*!
+ *	\file		usage.cpp
+ *	\brief		Implements DocOpt-style command line parser
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cerrno>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <strings.h>
+
+#include <egg/usage.hpp>
+
+
+namespace egg
+{
+
+namespace
+{
+
+// Position of the word in the text, ignoring the case
+std::string::size_type
+find_word(
+    const std::string& text,
+    const char*        word,
+    std::string::size_type from = 0)
+{
+  const std::size_t n = std::strlen(word);
+
+  for (std::string::size_type i = from; i + n <= text.size(); ++i)
+  {
+    std::size_t k = 0;
+
+    while (k < n && std::tolower(static_cast<unsigned char>(text[i + k])) == word[k])
+      ++k;
+
+    if (k == n)
+      return i;
+  }
+
+  return std::string::npos;
+}
+
+bool
+is_blank(
+    const char* b,
+    const char* e) noexcept
+{
+  for (; b < e; ++b)
+    if (!std::isspace(static_cast<unsigned char>(*b)))
+      return false;
+
+  return true;
+}
+
+std::vector<std::string>
+split(
+    const std::string& text)
+{
+  std::vector<std::string> words;
+  std::string word;
+
+  for (const char c : text)
+    if (std::isspace(static_cast<unsigned char>(c)))
+    {
+      if (!word.empty())
+        words.push_back(word);
+
+      word.clear();
+    }
+    else
+      word += c;
+
+  if (!word.empty())
+    words.push_back(word);
+
+  return words;
+}
+
+// Words of the patterns, brackets, bars and ellipses are words of their own
+std::vector<std::string>
+pattern_words(
+    const char* p,
+    const char* end)
+{
+  std::vector<std::string> words;
+  const char* word = nullptr;
+
+  for (; p < end; ++p)
+  {
+    const char c = *p;
+    const bool ellipsis = c == '.' && end - p >= 3 && p[1] == '.' && p[2] == '.';
+    const bool single = c == '[' || c == ']' || c == '(' || c == ')' || c == '|';
+
+    if (word != nullptr && (ellipsis || single || std::isspace(static_cast<unsigned char>(c))))
+    {
+      words.emplace_back(word, p);
+      word = nullptr;
+    }
+
+    if (ellipsis)
+    {
+      words.emplace_back("...");
+      p += 2;
+    }
+    else if (single)
+      words.emplace_back(1, c);
+    else if (word == nullptr && !std::isspace(static_cast<unsigned char>(c)))
+      word = p;
+  }
+
+  if (word != nullptr)
+    words.emplace_back(word, end);
+
+  return words;
+}
+
+// <name> or NAME
+bool
+is_argument(
+    const std::string& word)
+{
+  if (word.size() > 2 && word.front() == '<' && word.back() == '>')
+    return true;
+
+  bool upper = false;
+
+  for (const char c : word)
+  {
+    if (std::islower(static_cast<unsigned char>(c)))
+      return false;
+
+    upper = upper || std::isupper(static_cast<unsigned char>(c));
+  }
+
+  return upper;
+}
+
+void
+malformed(
+    const std::string& what)
+{
+  throw std::invalid_argument("usage: " + what);
+}
+
+void
+mismatch(
+    const std::string& what,
+    const std::string& text)
+{
+  throw std::invalid_argument("usage::parse(): " + what + "\n" + text);
+}
+
+} // End of anonymous namespace
+
+const usage::index_type usage::npos;
+
+// Matching consumes tokens and logs them, so backtracking is a truncation
+// of the log rather than a copy of the state
+struct usage::state
+{
+	typedef std::pair<index_type, index_type> taken;	// name, token
+
+	const std::vector<token>*	_tokens;
+	std::vector<char>		_used;
+	std::vector<taken>		_collected;
+
+	size_type left() const noexcept { return _used.size() - _collected.size(); }
+
+	void take(index_type n, index_type t)
+	{
+	  _used[t] = 1;
+	  _collected.push_back(taken(n, t));
+	}
+
+	void undo(size_type mark) noexcept
+	{
+	  while (_collected.size() > mark)
+	  {
+	    _used[_collected.back().second] = 0;
+	    _collected.pop_back();
+	  }
+	}
+};
+
+// Construct/destruct
+usage::usage(
+    const std::string& doc,
+    bool               typed)
+  : _typed(typed),
+    _root(npos)
+{
+  // The usage section runs from "usage:" to the first blank line
+  const std::string::size_type start = find_word(doc, "usage:");
+
+  if (start == std::string::npos)
+    malformed("no \"usage:\" section");
+
+  std::string::size_type end = doc.find('\n', start);
+
+  while (end != std::string::npos)
+  {
+    const std::string::size_type next = doc.find('\n', end + 1);
+
+    if (is_blank(doc.data() + end + 1, doc.data() + (next == std::string::npos ? doc.size() : next)))
+      break;
+
+    end = next;
+  }
+
+  _text = doc.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+  parse_options(doc);
+
+  const std::vector<std::string> words = pattern_words(_text.data() + 6, _text.data() + _text.size());
+
+  if (words.empty())
+    malformed("empty usage section");
+
+  // Every occurrence of the program name starts a pattern
+  std::vector<index_type> lines;
+  std::vector<std::string> line;
+
+  for (size_type i = 1; i <= words.size(); ++i)
+  {
+    if (i < words.size() && words[i] != words[0])
+    {
+      line.push_back(words[i]);
+      continue;
+    }
+
+    size_type at = 0;
+    const index_type pattern = expression(line, at);
+
+    if (at != line.size())
+      malformed("unbalanced \"" + line[at] + "\"");
+
+    lines.push_back(pattern);
+    line.clear();
+  }
+
+  _root = add(kind::either, npos, lines);
+
+  // One leaf per option sorted by name, shared by all [options]
+  std::vector<index_type> sorted;
+
+  for (const option& o : _options)
+    sorted.push_back(add(kind::option, o._name, {}));
+
+  std::sort(sorted.begin(), sorted.end(),
+    [this](index_type a, index_type b) { return _nodes[a]._name < _nodes[b]._name; });
+
+  const index_type leaves = static_cast<index_type>(_children.size());
+  _children.insert(_children.end(), sorted.begin(), sorted.end());
+
+  // A name is repeated if a pattern can take it more than once
+  for (const index_type l : lines)
+  {
+    std::vector<int> seen(_names.size(), 0);
+    count(l, seen, 1);
+
+    for (size_type n = 0; n < seen.size(); ++n)
+      if (seen[n] > 1)
+        _names[n]._repeated = true;
+
+    shortcuts(l, seen, leaves);
+  }
+}
+
+usage::~usage() noexcept
+{}
+
+// Compile
+void
+usage::parse_options(
+    const std::string& doc)
+{
+  // Walk the lines in place, only the spellings and defaults are copied
+  const char* p = doc.data();
+  const char* const end = p + doc.size();
+
+  while (p < end)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+
+    if (eol == nullptr)
+      eol = end;
+
+    const char* b = p;
+    p = eol + 1;
+
+    while (b < eol && (*b == ' ' || *b == '\t'))
+      ++b;
+
+    if (b == eol || *b != '-')
+      continue;
+
+    // Spellings end at two spaces or a tab, the description follows
+    const char* gap = b;
+
+    while (gap < eol && *gap != '\t' && !(gap[0] == ' ' && gap + 1 < eol && gap[1] == ' '))
+      ++gap;
+
+    option o { std::string(), std::string(), false, false, std::string(), npos };
+
+    for (const char* w = b; w < gap; )
+    {
+      if (*w == ' ' || *w == ',' || *w == '=')
+      {
+        ++w;
+        continue;
+      }
+
+      const char* e = w;
+
+      while (e < gap && *e != ' ' && *e != ',' && *e != '=')
+        ++e;
+
+      if (e - w > 2 && w[0] == '-' && w[1] == '-')
+        o._long.assign(w, e);
+      else if (e - w == 2 && w[0] == '-')
+        o._short.assign(w, e);
+      else
+        o._argument = true;
+
+      w = e;
+    }
+
+    if (o._short.empty() && o._long.empty())
+      malformed("bad option line \"" + std::string(b, eol) + "\"");
+
+    for (const char* d = gap; d + 9 <= eol; ++d)
+      if (*d == '[' && strncasecmp(d, "[default:", 9) == 0)
+      {
+        const char* v = d + 9;
+        const char* close = static_cast<const char*>(std::memchr(v, ']', eol - v));
+
+        if (close == nullptr)
+          close = eol;
+
+        while (v < close && *v == ' ')
+          ++v;
+
+        while (close > v && close[-1] == ' ')
+          --close;
+
+        o._has_default = true;
+        o._default.assign(v, close);
+        break;
+      }
+
+    const index_type id = static_cast<index_type>(_options.size());
+
+    o._name = name_of(o._long.empty() ? o._short : o._long, kind::option, id);
+
+    for (const std::string* s : { &o._short, &o._long })
+      if (!s->empty())
+        _spellings.push_back(std::make_pair(*s, id));
+
+    _options.push_back(std::move(o));
+  }
+
+  std::sort(_spellings.begin(), _spellings.end());
+
+  for (size_type i = 1; i < _spellings.size(); ++i)
+    if (_spellings[i].first == _spellings[i - 1].first)
+      malformed("option " + _spellings[i].first + " is described twice");
+}
+
+usage::index_type
+usage::option_of(
+    const std::string& text,
+    bool               long_name,
+    bool               argument)
+{
+  const auto i = std::lower_bound(_spellings.begin(), _spellings.end(), std::make_pair(text, index_type(0)));
+
+  if (i != _spellings.end() && i->first == text)
+  {
+    option& o = _options[i->second];
+    o._argument = o._argument || argument;
+    return i->second;
+  }
+
+  // Used in a pattern, but not described
+  const index_type id = static_cast<index_type>(_options.size());
+
+  option o { long_name ? std::string() : text, long_name ? text : std::string(), argument, false, std::string(), npos };
+  o._name = name_of(text, kind::option, id);
+
+  _options.push_back(o);
+  _spellings.insert(i, std::make_pair(text, id));
+
+  return id;
+}
+
+usage::index_type
+usage::name_of(
+    const std::string& text,
+    kind               k,
+    index_type         o)
+{
+  const auto r = _name_ids.emplace(variable(text), static_cast<index_type>(_names.size()));
+
+  if (r.second)
+    _names.push_back(name { text, k, false, o });
+  else if (_names[r.first->second]._kind != k)
+    malformed("\"" + text + "\" is used as an option and as an argument");
+
+  return r.first->second;
+}
+
+usage::index_type
+usage::add(
+    kind                           k,
+    index_type                     n,
+    const std::vector<index_type>& children)
+{
+  const index_type id = static_cast<index_type>(_nodes.size());
+
+  _nodes.push_back(node { k, n, static_cast<index_type>(_children.size()), static_cast<index_type>(children.size()) });
+  _children.insert(_children.end(), children.begin(), children.end());
+
+  return id;
+}
+
+usage::index_type
+usage::expression(
+    const std::vector<std::string>& words,
+    size_type&                      at)
+{
+  std::vector<index_type> alternatives { sequence(words, at) };
+
+  while (at < words.size() && words[at] == "|")
+  {
+    ++at;
+    alternatives.push_back(sequence(words, at));
+  }
+
+  return alternatives.size() == 1 ? alternatives[0] : add(kind::either, npos, alternatives);
+}
+
+usage::index_type
+usage::sequence(
+    const std::vector<std::string>& words,
+    size_type&                      at)
+{
+  std::vector<index_type> items;
+
+  while (at < words.size() && words[at] != "|" && words[at] != ")" && words[at] != "]")
+  {
+    const size_type before = items.size();
+
+    atom(words, at, items);
+
+    if (at < words.size() && words[at] == "...")
+    {
+      ++at;
+
+      // Short option clusters repeat as a whole
+      const std::vector<index_type> repeated(items.begin() + before, items.end());
+      items.resize(before);
+      items.push_back(add(kind::one_or_more, npos, { add(kind::required, npos, repeated) }));
+    }
+  }
+
+  return add(kind::required, npos, items);
+}
+
+void
+usage::atom(
+    const std::vector<std::string>& words,
+    size_type&                      at,
+    std::vector<index_type>&        out)
+{
+  const std::string& w = words[at++];
+
+  if (w == "(" || w == "[")
+  {
+    const char* close = w == "(" ? ")" : "]";
+
+    if (w == "[" && at + 1 < words.size() && words[at] == "options" && words[at + 1] == "]")
+    {
+      at += 2;
+
+      // Filled by shortcuts() once the whole pattern is known
+      out.push_back(add(kind::options, npos, {}));
+      return;
+    }
+
+    const index_type inner = expression(words, at);
+
+    if (at == words.size() || words[at] != close)
+      malformed(std::string("missing \"") + close + "\"");
+
+    ++at;
+    out.push_back(add(w == "(" ? kind::required : kind::optional, npos, { inner }));
+    return;
+  }
+
+  if (w == "..." || w == "|" || w == ")" || w == "]")
+    malformed("unexpected \"" + w + "\"");
+
+  if (w.compare(0, 2, "--") == 0 && w.size() > 2)
+  {
+    const std::string::size_type eq = w.find('=');
+    const index_type o = option_of(w.substr(0, eq), true, eq != std::string::npos);
+
+    // --port <n>
+    if (eq == std::string::npos && _options[o]._argument && at < words.size() && is_argument(words[at]))
+      ++at;
+
+    out.push_back(add(kind::option, _options[o]._name, {}));
+    return;
+  }
+
+  if (w[0] == '-' && w.size() > 1)
+  {
+    for (std::string::size_type i = 1; i < w.size(); ++i)
+    {
+      const index_type o = option_of(std::string { '-', w[i] }, false, false);
+
+      out.push_back(add(kind::option, _options[o]._name, {}));
+
+      // -p<n> or -p <n>
+      if (_options[o]._argument)
+      {
+        if (i + 1 == w.size() && at < words.size() && is_argument(words[at]))
+          ++at;
+
+        break;
+      }
+    }
+
+    return;
+  }
+
+  if (is_argument(w))
+    out.push_back(add(kind::argument, name_of(w, kind::argument, npos), {}));
+  else
+    out.push_back(add(kind::command, name_of(w, kind::command, npos), {}));
+}
+
+void
+usage::count(
+    index_type        n,
+    std::vector<int>& seen,
+    int               weight) const
+{
+  const node& x = _nodes[n];
+
+  switch (x._kind)
+  {
+    case kind::argument:
+    case kind::command:
+    case kind::option:
+      seen[x._name] += weight;
+      break;
+
+    // Options named in the pattern as well are not repeated by that
+    case kind::options:
+      break;
+
+    // Only one of the alternatives is taken
+    case kind::either:
+    {
+      const std::vector<int> before = seen;
+
+      for (index_type i = 0; i < x._count; ++i)
+      {
+        std::vector<int> alternative = before;
+        count(_children[x._first + i], alternative, weight);
+
+        for (size_type n = 0; n < seen.size(); ++n)
+          seen[n] = std::max(seen[n], alternative[n]);
+      }
+
+      break;
+    }
+
+    default:
+      for (index_type i = 0; i < x._count; ++i)
+        count(_children[x._first + i], seen, x._kind == kind::one_or_more ? 2 : weight);
+  }
+}
+
+void
+usage::shortcuts(
+    index_type              n,
+    const std::vector<int>& seen,
+    index_type              leaves)
+{
+  const kind k = _nodes[n]._kind;
+
+  if (k == kind::options)
+  {
+    // Every option the pattern doesn't name by itself. Usually that are
+    // all of them, so the shared leaves are used as they are
+    const index_type count = static_cast<index_type>(_options.size());
+    bool all = true;
+
+    for (const option& o : _options)
+      all = all && seen[o._name] == 0;
+
+    if (all)
+    {
+      _nodes[n]._first = leaves;
+      _nodes[n]._count = count;
+      return;
+    }
+
+    const index_type first = static_cast<index_type>(_children.size());
+
+    for (index_type i = leaves; i < leaves + count; ++i)
+    {
+      const index_type leaf = _children[i];
+
+      if (seen[_nodes[leaf]._name] == 0)
+        _children.push_back(leaf);
+    }
+
+    _nodes[n]._first = first;
+    _nodes[n]._count = static_cast<index_type>(_children.size()) - first;
+    return;
+  }
+
+  if (k != kind::argument && k != kind::command && k != kind::option)
+    for (index_type i = 0; i < _nodes[n]._count; ++i)
+      shortcuts(_children[_nodes[n]._first + i], seen, leaves);
+}
+
+// Parse
+usage::index_type
+usage::find_option(
+    const char* text,
+    size_type   size,
+    bool        long_name) const
+{
+  const auto less = [](const std::pair<std::string, index_type>& s, const std::pair<const char*, size_type>& t) {
+    return s.first.compare(0, std::string::npos, t.first, t.second) < 0;
+  };
+
+  auto i = std::lower_bound(_spellings.begin(), _spellings.end(), std::make_pair(text, size), less);
+
+  if (i != _spellings.end() && i->first.size() == size && i->first.compare(0, size, text, size) == 0)
+    return i->second;
+
+  // Unique prefix of a long option
+  if (!long_name)
+    return npos;
+
+  index_type found = npos;
+
+  for (; i != _spellings.end() && i->first.compare(0, size, text, size) == 0; ++i)
+  {
+    if (found != npos && found != i->second)
+      mismatch("option " + std::string(text, size) + " is ambiguous", _text);
+
+    found = i->second;
+  }
+
+  return found;
+}
+
+void
+usage::tokenize(
+    int                argc,
+    const char* const  argv[],
+    std::vector<token>& out) const
+{
+  bool positional = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* a = argv[i];
+
+    // Negative numbers are positional, unless there are such options
+    if (positional || a[0] != '-' || a[1] == 0 ||
+        (std::isdigit(static_cast<unsigned char>(a[1])) && find_option(a, 2, false) == npos))
+    {
+      out.push_back(token { npos, a });
+      continue;
+    }
+
+    if (a[1] == '-')
+    {
+      // "--" ends the options
+      if (a[2] == 0)
+      {
+        positional = true;
+        continue;
+      }
+
+      const char* eq = std::strchr(a, '=');
+      const size_type n = eq == nullptr ? std::strlen(a) : static_cast<size_type>(eq - a);
+      const index_type o = find_option(a, n, true);
+
+      if (o == npos)
+        mismatch("unknown option " + std::string(a, n), _text);
+
+      const char* value = nullptr;
+
+      if (_options[o]._argument)
+      {
+        if (eq != nullptr)
+          value = eq + 1;
+        else if (i + 1 < argc)
+          value = argv[++i];
+        else
+          mismatch("option " + _options[o]._long + " requires an argument", _text);
+      }
+      else if (eq != nullptr)
+        mismatch("option " + _options[o]._long + " takes no argument", _text);
+
+      out.push_back(token { o, value });
+      continue;
+    }
+
+    // Cluster of short options, the last one may take the rest as argument
+    for (const char* p = a + 1; *p != 0; ++p)
+    {
+      const char spelling[2] = { '-', *p };
+      const index_type o = find_option(spelling, 2, false);
+
+      if (o == npos)
+        mismatch("unknown option " + std::string(spelling, 2), _text);
+
+      if (!_options[o]._argument)
+      {
+        out.push_back(token { o, nullptr });
+        continue;
+      }
+
+      if (p[1] != 0)
+        out.push_back(token { o, p + 1 });
+      else if (i + 1 < argc)
+        out.push_back(token { o, argv[++i] });
+      else
+        mismatch("option " + std::string(spelling, 2) + " requires an argument", _text);
+
+      break;
+    }
+  }
+}
+
+bool
+usage::match(
+    index_type n,
+    state&     s) const
+{
+  const node& x = _nodes[n];
+  const std::vector<token>& tokens = *s._tokens;
+
+  switch (x._kind)
+  {
+    case kind::option:
+      for (index_type i = 0; i < tokens.size(); ++i)
+        if (!s._used[i] && tokens[i]._option != npos && _options[tokens[i]._option]._name == x._name)
+        {
+          s.take(x._name, i);
+          return true;
+        }
+
+      return false;
+
+    case kind::argument:
+    case kind::command:
+      // The first positional, options in between don't matter
+      for (index_type i = 0; i < tokens.size(); ++i)
+      {
+        if (s._used[i] || tokens[i]._option != npos)
+          continue;
+
+        if (x._kind == kind::command && _names[x._name]._text != tokens[i]._text)
+          return false;
+
+        s.take(x._name, i);
+        return true;
+      }
+
+      return false;
+
+    case kind::options:
+    {
+      // Walk the tokens instead of the (many) options, leaves are sorted
+      // by name and each takes one token
+      const index_type* first = _children.data() + x._first;
+      const index_type* last = first + x._count;
+      const size_type mark = s._collected.size();
+
+      for (index_type i = 0; i < tokens.size(); ++i)
+      {
+        if (s._used[i] || tokens[i]._option == npos)
+          continue;
+
+        const index_type name = _options[tokens[i]._option]._name;
+        const index_type* c = std::lower_bound(first, last, name,
+          [this](index_type leaf, index_type v) { return _nodes[leaf]._name < v; });
+
+        if (c == last || _nodes[*c]._name != name)
+          continue;
+
+        bool taken = false;
+
+        for (size_type k = mark; k < s._collected.size() && !taken; ++k)
+          taken = s._collected[k].first == name;
+
+        if (!taken)
+          s.take(name, i);
+      }
+
+      return true;
+    }
+
+    case kind::required:
+    {
+      const size_type mark = s._collected.size();
+
+      for (index_type i = 0; i < x._count; ++i)
+        if (!match(_children[x._first + i], s))
+        {
+          s.undo(mark);
+          return false;
+        }
+
+      return true;
+    }
+
+    case kind::optional:
+      for (index_type i = 0; i < x._count; ++i)
+        match(_children[x._first + i], s);
+
+      return true;
+
+    case kind::either:
+    {
+      // The alternative that leaves the least unmatched
+      const size_type mark = s._collected.size();
+      std::vector<state::taken> best;
+      size_type best_left = 0;
+      bool found = false;
+
+      for (index_type i = 0; i < x._count; ++i)
+      {
+        if (match(_children[x._first + i], s) && (!found || s.left() < best_left))
+        {
+          best.assign(s._collected.begin() + mark, s._collected.end());
+          best_left = s.left();
+          found = true;
+        }
+
+        s.undo(mark);
+      }
+
+      for (const state::taken& t : best)
+        s.take(t.first, t.second);
+
+      return found;
+    }
+
+    case kind::one_or_more:
+    {
+      size_type times = 0;
+
+      for (;;)
+      {
+        const size_type before = s._collected.size();
+
+        if (!match(_children[x._first], s))
+          break;
+
+        ++times;
+
+        if (s._collected.size() == before || s.left() == 0)
+          break;
+      }
+
+      return times != 0;
+    }
+  }
+
+  return false;
+}
+
+variable
+usage::typed(
+    const char* text) const
+{
+  if (_typed && *text != 0)
+  {
+    char* end = nullptr;
+
+    errno = 0;
+    const long long i = std::strtoll(text, &end, 10);
+
+    if (*end == 0 && errno == 0)
+      return variable(static_cast<std::int64_t>(i));
+
+    // Plain decimal reals only, "inf" or "0x10" stay strings
+    if (std::strspn(text, "0123456789+-.eE") == std::strlen(text) &&
+        std::strpbrk(text, "0123456789") != nullptr)
+    {
+      const double d = std::strtod(text, &end);
+
+      if (*end == 0)
+        return variable(d);
+    }
+  }
+
+  return variable(text);
+}
+
+usage::arguments
+usage::parse(
+    int               argc,
+    const char* const argv[]) const
+{
+  std::vector<token> tokens;
+  tokenize(argc, argv, tokens);
+
+  state s;
+  s._tokens = &tokens;
+  s._used.assign(tokens.size(), 0);
+
+  if (!match(_root, s) || s.left() != 0)
+  {
+    for (index_type i = 0; i < tokens.size(); ++i)
+      if (!s._used[i] && tokens[i]._option == npos)
+        mismatch(std::string("unexpected argument ") + tokens[i]._text, _text);
+
+    mismatch("arguments don't match the usage", _text);
+  }
+
+  // In the order of argv
+  std::sort(s._collected.begin(), s._collected.end(),
+    [](const std::pair<index_type, index_type>& a, const std::pair<index_type, index_type>& b) { return a.second < b.second; });
+
+  arguments result;
+  result._usage = this;
+  result._values.resize(_names.size());
+
+  std::vector<index_type> counts(_names.size(), 0);
+
+  // Texts of repeated names, each list becomes a variable once
+  std::vector<variable::stringlist> lists(_names.size());
+
+  for (const auto& c : s._collected)
+  {
+    const name& n = _names[c.first];
+    const char* text = tokens[c.second]._text;
+
+    ++counts[c.first];
+
+    if (text == nullptr || n._kind == kind::command)
+      continue;
+
+    result._raw.push_back(std::make_pair(c.first, text));
+
+    if (!n._repeated)
+      result._values[c.first] = typed(text);
+    else
+      lists[c.first].push_back(text);
+  }
+
+  for (index_type i = 0; i < _names.size(); ++i)
+    if (!lists[i].empty())
+      result._values[i] = variable(lists[i]);
+
+  // Flags, counts and defaults
+  for (index_type i = 0; i < _names.size(); ++i)
+  {
+    const name& n = _names[i];
+    variable& v = result._values[i];
+    const bool has_argument = n._kind == kind::argument ||
+                              (n._kind == kind::option && _options[n._option]._argument);
+
+    if (!has_argument)
+    {
+      v = n._repeated ? variable(static_cast<std::int64_t>(counts[i])) : variable(counts[i] != 0);
+      continue;
+    }
+
+    if (counts[i] != 0)
+      continue;
+
+    const option* o = n._kind == kind::option ? &_options[n._option] : nullptr;
+
+    if (n._repeated)
+    {
+      variable::stringlist l;
+
+      if (o != nullptr && o->_has_default)
+        for (const std::string& w : split(o->_default))
+          l.push_back(w);
+
+      v = variable(l);
+    }
+    else if (o != nullptr && o->_has_default)
+      v = typed(o->_default.c_str());
+  }
+
+  return result;
+}
+
+usage::arguments
+usage::parse(
+    const std::vector<const char*>& argv) const
+{
+  return parse(static_cast<int>(argv.size()), argv.data());
+}
+
+// Arguments
+const variable*
+usage::arguments::find(
+    const std::string& n) const noexcept
+{
+  const auto i = _usage->_name_ids.find(variable(n));
+
+  return i == _usage->_name_ids.end() ? nullptr : &_values[i->second];
+}
+
+const variable&
+usage::arguments::operator[] (
+    const std::string& n) const
+{
+  const variable* v = find(n);
+
+  if (v == nullptr)
+    throw std::out_of_range("usage::arguments: " + n + " is not in the usage");
+
+  return *v;
+}
+
+std::vector<const char*>
+usage::arguments::raw(
+    const std::string& n) const
+{
+  std::vector<const char*> result;
+  const auto i = _usage->_name_ids.find(variable(n));
+
+  if (i != _usage->_name_ids.end())
+    for (const auto& r : _raw)
+      if (r.first == i->second)
+        result.push_back(r.second);
+
+  return result;
+}
+
+std::map<variable, variable>
+usage::arguments::to_map() const
+{
+  std::map<variable, variable> result;
+
+  for (size_type i = 0; i < _values.size(); ++i)
+    result[variable(_usage->_names[i]._text)] = _values[i];
+
+  return result;
+}
+
+} // End of egg namespace
+
+/* End of file */
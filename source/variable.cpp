@@ -8,16 +8,72 @@
  */
 
 #include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 #include <functional>
 
 #include <egg/variable.hpp>
 
+#include "variable_access.hpp"
+#include "string_index.hpp"
+
 
 namespace egg
 {
 
 static const std::uint32_t _cs_hash = std::hash<void *>()(nullptr);
 
+// Copy of an array block, header included
+static void*
+copy_array(
+    const variable& v)
+{
+  const std::size_t bytes = variable_access::array_header +
+    variable_access::array_size(v) * variable_access::element_size(v.type());
+  const void* from = static_cast<const char*>(variable_access::array_data(v)) -
+    variable_access::array_header;
+  void* to = ::operator new(bytes);
+
+  std::memcpy(to, from, bytes);
+
+  return to;
+}
+
+// Byte hash of the arrays, 8 bytes a step
+static std::uint32_t
+hash_bytes(
+    const void*   data,
+    std::size_t   size,
+    std::uint64_t h) noexcept
+{
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+
+  for (; size >= 8; size -= 8, p += 8)
+  {
+    std::uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+
+    h = (h ^ x) * 0x9e3779b97f4a7c15ull;
+    h ^= h >> 29;
+  }
+
+  for (; size > 0; --size, ++p)
+    h = (h ^ *p) * 0x100000001b3ull;
+
+  h ^= h >> 32;
+
+  return static_cast<std::uint32_t>(h);
+}
+
+// Heap of a string beyond its inline buffer
+static inline std::size_t
+heap(
+    const std::string& s) noexcept
+{
+  return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+}
+
 static const std::string _cs_type_to_string[] =
 {
   "empty",
@@ -33,6 +89,14 @@ static const std::string _cs_type_to_string[] =
 
   "string", "string list",
 
+  "int32 array", "int64 array", "uint64 array", "double array", "blob",
+
+  "list", "map",
+
+  "string rope",
+
+  "compact string list",
+
   "unknown"
 };
 
@@ -44,6 +108,8 @@ variable::variant::variant() noexcept
 variable::variant::~variant() noexcept
 {}
 
+const std::size_t variable::npos;
+
 // Construct/destruct
 variable::variable() noexcept
   : _type(content::is_empty),
@@ -99,8 +165,27 @@ variable::variable(
               *reinterpret_cast<std::string *>(other._data._pointer));
 
           else if (_type == content::is_string_list)
-            _data._pointer = new stringlist(
-              *reinterpret_cast<stringlist *>(other._data._pointer));
+            _data._pointer = new string_list_payload(
+              *reinterpret_cast<string_list_payload *>(other._data._pointer));
+
+          else if (variable_access::is_array(_type))
+            _data._pointer = copy_array(other);
+
+          else if (_type == content::is_list)
+            _data._pointer = new list(
+              *reinterpret_cast<list *>(other._data._pointer));
+
+          else if (_type == content::is_map)
+            _data._pointer = new map(
+              *reinterpret_cast<map *>(other._data._pointer));
+
+          else if (_type == content::is_string_rope)
+            _data._pointer = new string_rope(
+              *reinterpret_cast<string_rope *>(other._data._pointer));
+
+          else if (_type == content::is_compact_string_list)
+            _data._pointer = new compact_string_list(
+              *reinterpret_cast<compact_string_list *>(other._data._pointer));
         }
         else
           throw std::runtime_error(
@@ -158,8 +243,27 @@ variable::operator=(
                 *reinterpret_cast<std::string *>(other._data._pointer));
 
             else if (_type == content::is_string_list)
-              _data._pointer = new stringlist(
-                *reinterpret_cast<stringlist *>(other._data._pointer));
+              _data._pointer = new string_list_payload(
+                *reinterpret_cast<string_list_payload *>(other._data._pointer));
+
+            else if (variable_access::is_array(_type))
+              _data._pointer = copy_array(other);
+
+            else if (_type == content::is_list)
+              _data._pointer = new list(
+                *reinterpret_cast<list *>(other._data._pointer));
+
+            else if (_type == content::is_map)
+              _data._pointer = new map(
+                *reinterpret_cast<map *>(other._data._pointer));
+
+            else if (_type == content::is_string_rope)
+              _data._pointer = new string_rope(
+                *reinterpret_cast<string_rope *>(other._data._pointer));
+
+            else if (_type == content::is_compact_string_list)
+              _data._pointer = new compact_string_list(
+                *reinterpret_cast<compact_string_list *>(other._data._pointer));
           }
           else
             throw std::runtime_error(
@@ -326,16 +430,169 @@ variable::variable(
   : _type(content::is_string_list),
     _hash(_cs_hash)
 {
-  _data._pointer = new stringlist(v);
+  _data._pointer = new string_list_payload(v);
   __rehash();
 }
 
+variable::variable(
+    const std::vector<std::int32_t>& v)
+  : variable(array(v.data(), v.size()))
+{}
+
+variable::variable(
+    const std::vector<std::int64_t>& v)
+  : variable(array(v.data(), v.size()))
+{}
+
+variable::variable(
+    const std::vector<std::uint64_t>& v)
+  : variable(array(v.data(), v.size()))
+{}
+
+variable::variable(
+    const std::vector<double>& v)
+  : variable(array(v.data(), v.size()))
+{}
+
+variable::variable(
+    const std::vector<std::uint8_t>& v)
+  : variable(blob(v.data(), v.size()))
+{}
+
+variable::variable(
+    const list& v)
+  : _type(content::is_list),
+    _hash(_cs_hash)
+{
+  _data._pointer = new list(v);
+  __rehash();
+}
+
+variable::variable(
+    list&& v)
+  : _type(content::is_list),
+    _hash(_cs_hash)
+{
+  _data._pointer = new list(std::move(v));
+  __rehash();
+}
+
+variable::variable(
+    const map& v)
+  : _type(content::is_map),
+    _hash(_cs_hash)
+{
+  _data._pointer = new map(v);
+  __rehash();
+}
+
+variable::variable(
+    map&& v)
+  : _type(content::is_map),
+    _hash(_cs_hash)
+{
+  _data._pointer = new map(std::move(v));
+  __rehash();
+}
+
+variable::variable(
+    const string_rope& v)
+  : _type(content::is_string_rope),
+    _hash(v.hash())
+{
+  _data._pointer = new string_rope(v);
+}
+
+variable::variable(
+    string_rope&& v)
+  : _type(content::is_string_rope),
+    _hash(v.hash())
+{
+  _data._pointer = new string_rope(std::move(v));
+}
+
+variable::variable(
+    const compact_string_list& v)
+  : _type(content::is_compact_string_list),
+    _hash(v.hash())
+{
+  _data._pointer = new compact_string_list(v);
+}
+
+variable::variable(
+    compact_string_list&& v)
+  : _type(content::is_compact_string_list),
+    _hash(v.hash())
+{
+  _data._pointer = new compact_string_list(std::move(v));
+}
+
+// Arrays from raw memory
+template <typename T>
+static variable
+make_array(
+    variable::content t,
+    const T*          data,
+    std::size_t       size)
+{
+  variable result;
+
+  if (size != 0)
+    std::memcpy(variable_access::make_array(result, t, size), data, size * sizeof(T));
+  else
+    variable_access::make_array(result, t, 0);
+
+  variable_access::rehash(result);
+
+  return result;
+}
+
+variable
+variable::array(
+    const std::int32_t* data,
+    std::size_t         size)
+{
+  return make_array(content::is_int32_array, data, size);
+}
+
+variable
+variable::array(
+    const std::int64_t* data,
+    std::size_t         size)
+{
+  return make_array(content::is_int64_array, data, size);
+}
+
+variable
+variable::array(
+    const std::uint64_t* data,
+    std::size_t          size)
+{
+  return make_array(content::is_uint64_array, data, size);
+}
+
+variable
+variable::array(
+    const double* data,
+    std::size_t   size)
+{
+  return make_array(content::is_double_array, data, size);
+}
+
+variable
+variable::blob(
+    const void* data,
+    std::size_t size)
+{
+  return make_array(content::is_blob, static_cast<const std::uint8_t*>(data), size);
+}
+
 // Compare
 bool
 variable::operator == (
-    const variable& other) noexcept
+    const variable& other) const noexcept
 {
-  if (_type != other._type)
+  if (_type != other._type || _hash != other._hash)
     return false;
 
   if (_type == content::is_empty)
@@ -392,14 +649,65 @@ variable::operator == (
           *reinterpret_cast<std::string *>(other._data._pointer);
 
     else if (_type == content::is_string_list)
-      return *reinterpret_cast<stringlist *>(_data._pointer) ==
-          *reinterpret_cast<stringlist *>(other._data._pointer);
+      return reinterpret_cast<string_list_payload *>(_data._pointer)->_entries ==
+          reinterpret_cast<string_list_payload *>(other._data._pointer)->_entries;
+
+    else if (_type == content::is_double_array)
+    {
+      const array_view<double> a = as_double_array(), b = other.as_double_array();
+
+      // Element by element, as the scalars: 0.0 equals -0.0, NaN nothing
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    else if (variable_access::is_array(_type))
+    {
+      const std::size_t n = variable_access::array_size(*this);
+
+      return n == variable_access::array_size(other) &&
+        std::memcmp(variable_access::array_data(*this), variable_access::array_data(other),
+                    n * variable_access::element_size(_type)) == 0;
+    }
+
+    else if (_type == content::is_list)
+      return *reinterpret_cast<list *>(_data._pointer) ==
+          *reinterpret_cast<list *>(other._data._pointer);
+
+    else if (_type == content::is_map)
+      return *reinterpret_cast<map *>(_data._pointer) ==
+          *reinterpret_cast<map *>(other._data._pointer);
+
+    else if (_type == content::is_string_rope)
+      return *reinterpret_cast<string_rope *>(_data._pointer) ==
+          *reinterpret_cast<string_rope *>(other._data._pointer);
+
+    else if (_type == content::is_compact_string_list)
+      return *reinterpret_cast<compact_string_list *>(_data._pointer) ==
+          *reinterpret_cast<compact_string_list *>(other._data._pointer);
   }
 
   return false;
 }
 
 // Stringify
+template <typename T>
+static std::string
+join(
+    const variable::array_view<T>& a)
+{
+  std::string result;
+
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    if (i != 0)
+      result += ',';
+
+    result += std::to_string(a[i]);
+  }
+
+  return result;
+}
+
 std::string
 variable::to_string() const
 {
@@ -446,7 +754,7 @@ variable::to_string() const
 
     else if (_type == content::is_string_list)
     {
-      stringlist* slp = reinterpret_cast<stringlist *>(_data._pointer);
+      const stringlist* slp = &reinterpret_cast<string_list_payload *>(_data._pointer)->_entries;
       std::string result;
 
       if (slp->size())
@@ -458,11 +766,200 @@ variable::to_string() const
 
       return result;
     }
+
+    else if (_type == content::is_int32_array)
+      return join(as_int32_array());
+
+    else if (_type == content::is_int64_array)
+      return join(as_int64_array());
+
+    else if (_type == content::is_uint64_array)
+      return join(as_uint64_array());
+
+    else if (_type == content::is_double_array)
+      return join(as_double_array());
+
+    else if (_type == content::is_blob)
+    {
+      static const char hex[] = "0123456789abcdef";
+
+      const array_view<std::uint8_t> b = as_blob();
+      std::string result(2 * b.size(), '0');
+
+      for (std::size_t i = 0; i < b.size(); ++i)
+      {
+        result[2 * i] = hex[b[i] >> 4];
+        result[2 * i + 1] = hex[b[i] & 0x0f];
+      }
+
+      return result;
+    }
+
+    else if (_type == content::is_list)
+    {
+      std::string result = "[";
+      bool first = true;
+
+      for (const variable& v : as_list())
+      {
+        if (!first)
+          result += ',';
+
+        first = false;
+        result += v.to_string();
+      }
+
+      return result + ']';
+    }
+
+    else if (_type == content::is_map)
+    {
+      std::string result = "{";
+      bool first = true;
+
+      for (const map::value_type& e : as_map())
+      {
+        if (!first)
+          result += ',';
+
+        first = false;
+        result += e.first.to_string() + ':' + e.second.to_string();
+      }
+
+      return result + '}';
+    }
+
+    else if (_type == content::is_string_rope ||
+             _type == content::is_compact_string_list)
+    {
+      std::string result;
+      bool first = true;
+
+      const auto join = [&result, &first](const std::string& s) {
+        if (!first)
+          result += ',';
+
+        first = false;
+        result += s;
+      };
+
+      if (_type == content::is_string_rope)
+        as_string_rope().each(join);
+      else
+        as_compact_string_list().each(join);
+
+      return result;
+    }
   }
 
   return "<empty>";
 }
 
+void
+variable::write(
+    std::ostream& out) const
+{
+  bool first = true;
+
+  const auto put = [&out, &first](const std::string& s) {
+    if (!first)
+      out << ',';
+
+    first = false;
+    out << s;
+  };
+
+  if (_type == content::is_string_rope)
+    as_string_rope().each(put);
+  else if (_type == content::is_compact_string_list)
+    as_compact_string_list().each(put);
+  else
+    out << to_string();
+}
+
+std::size_t
+variable::memory_usage() const noexcept
+{
+  std::size_t bytes = sizeof(variable);
+
+  switch (_type)
+  {
+    case content::is_float:
+      return bytes + sizeof(float);
+
+    case content::is_double:
+      return bytes + sizeof(double);
+
+    case content::is_long_double:
+      return bytes + sizeof(long double);
+
+    case content::is_string:
+      return bytes + sizeof(std::string) + heap(as_string());
+
+    case content::is_string_list:
+    {
+      const string_list_payload* l = reinterpret_cast<string_list_payload *>(_data._pointer);
+      bytes += sizeof(string_list_payload) + l->_entries.capacity() * sizeof(std::string);
+
+      for (const std::string& s : l->_entries)
+        bytes += heap(s);
+
+      if (const string_index* i = l->_index.load(std::memory_order_acquire))
+        bytes += i->bytes();
+
+      return bytes;
+    }
+
+    case content::is_int32_array:
+    case content::is_int64_array:
+    case content::is_uint64_array:
+    case content::is_double_array:
+    case content::is_blob:
+      return bytes + variable_access::array_header +
+        variable_access::array_size(*this) * variable_access::element_size(_type);
+
+    case content::is_list:
+    {
+      const list& l = as_list();
+      bytes += sizeof(list) + (l.capacity() - l.size()) * sizeof(variable);
+
+      for (const variable& e : l)
+        bytes += e.memory_usage();
+
+      return bytes;
+    }
+
+    case content::is_map:
+    {
+      const map& m = as_map();
+      bytes += sizeof(map);
+
+      for (const map::value_type& e : m)
+        bytes += e.first.memory_usage() + e.second.memory_usage();
+
+      return bytes;
+    }
+
+    case content::is_string_rope:
+    {
+      const string_rope& r = as_string_rope();
+      bytes += sizeof(string_rope) +
+        r.chunks() * (sizeof(std::shared_ptr<stringlist>) + sizeof(stringlist) +
+                      string_rope::chunk_size * sizeof(std::string));
+
+      r.each([&bytes](const std::string& s) { bytes += heap(s); });
+
+      return bytes;
+    }
+
+    case content::is_compact_string_list:
+      return bytes + as_compact_string_list().bytes();
+
+    default:
+      return bytes;
+  }
+}
+
 // Value getters
 bool
 variable::as_bool() const
@@ -760,7 +1257,113 @@ variable::as_string_list() const
 
   throw_if_not_type(content::is_string_list);
 
-  return (_data._pointer == nullptr ? _default : *reinterpret_cast<stringlist *>(_data._pointer));
+  return (_data._pointer == nullptr ? _default : reinterpret_cast<string_list_payload *>(_data._pointer)->_entries);
+}
+
+const variable::list&
+variable::as_list() const
+{
+  throw_if_not_type(content::is_list);
+
+  return *reinterpret_cast<list *>(_data._pointer);
+}
+
+const variable::map&
+variable::as_map() const
+{
+  throw_if_not_type(content::is_map);
+
+  return *reinterpret_cast<map *>(_data._pointer);
+}
+
+const variable::string_rope&
+variable::as_string_rope() const
+{
+  throw_if_not_type(content::is_string_rope);
+
+  return *reinterpret_cast<string_rope *>(_data._pointer);
+}
+
+const variable::compact_string_list&
+variable::as_compact_string_list() const
+{
+  throw_if_not_type(content::is_compact_string_list);
+
+  return *reinterpret_cast<compact_string_list *>(_data._pointer);
+}
+
+void
+variable::append(
+    const std::string& v)
+{
+  if (_type == content::is_empty)
+  {
+    _data._pointer = new string_rope();
+    _type = content::is_string_rope;
+  }
+
+  throw_if_not_type(content::is_string_rope);
+
+  string_rope* r = reinterpret_cast<string_rope *>(_data._pointer);
+  r->push_back(v);
+  _hash = r->hash();
+}
+
+bool
+variable::contains(
+    const std::string& v) const
+{
+  return find(v) != npos;
+}
+
+std::size_t
+variable::find(
+    const std::string& v) const
+{
+  throw_if_not_type(content::is_string_list);
+
+  return (_data._pointer == nullptr ? npos : reinterpret_cast<string_list_payload *>(_data._pointer)->find(v));
+}
+
+template <typename T>
+variable::array_view<T>
+variable::view(
+    content expected) const
+{
+  throw_if_not_type(expected);
+
+  return array_view<T>(static_cast<const T*>(variable_access::array_data(*this)),
+                       variable_access::array_size(*this));
+}
+
+variable::array_view<std::int32_t>
+variable::as_int32_array() const
+{
+  return view<std::int32_t>(content::is_int32_array);
+}
+
+variable::array_view<std::int64_t>
+variable::as_int64_array() const
+{
+  return view<std::int64_t>(content::is_int64_array);
+}
+
+variable::array_view<std::uint64_t>
+variable::as_uint64_array() const
+{
+  return view<std::uint64_t>(content::is_uint64_array);
+}
+
+variable::array_view<double>
+variable::as_double_array() const
+{
+  return view<double>(content::is_double_array);
+}
+
+variable::array_view<std::uint8_t>
+variable::as_blob() const
+{
+  return view<std::uint8_t>(content::is_blob);
 }
 
 std::uint32_t
@@ -769,6 +1372,13 @@ variable::hash() const noexcept
   return _hash;
 }
 
+std::uint32_t
+variable::hash_of(
+    const std::string& v) noexcept
+{
+  return std::hash<std::string>()(v);
+}
+
 // Internals
 const std::string&
 variable::type_as_string(
@@ -841,12 +1451,11 @@ variable::__rehash()
             *reinterpret_cast<long double *>(_data._pointer));
       break;
     case content::is_string:
-      _hash = std::hash<std::string>()(
-            *reinterpret_cast<std::string *>(_data._pointer));
+      _hash = hash_of(*reinterpret_cast<std::string *>(_data._pointer));
       break;
     case content::is_string_list:
       {
-        stringlist* slp = reinterpret_cast<stringlist *>(_data._pointer);
+        const stringlist* slp = &reinterpret_cast<string_list_payload *>(_data._pointer)->_entries;
         _hash = std::hash<std::uint32_t>()(slp->size());
         std::hash<std::string> hasher;
 
@@ -854,6 +1463,72 @@ variable::__rehash()
           _hash ^= hasher(s) + 0x9e3779b9 + (_hash << 6) + (_hash >> 2);
       }
       break;
+    case content::is_double_array:
+      {
+        // Zeros of either sign are equal, so they must hash the same
+        const array_view<double> a = as_double_array();
+        std::uint64_t h = 0xcbf29ce484222325ull ^ a.size();
+
+        for (const double d : a)
+        {
+          std::uint64_t x = 0;
+
+          if (d != 0.0)
+            std::memcpy(&x, &d, sizeof(x));
+
+          h = (h ^ x) * 0x9e3779b97f4a7c15ull;
+          h ^= h >> 29;
+        }
+
+        _hash = static_cast<std::uint32_t>(h ^ (h >> 32));
+      }
+      break;
+    case content::is_list:
+      {
+        const list& l = as_list();
+        _hash = std::hash<std::uint32_t>()(l.size()) ^ 0x5bd1e995;
+
+        for (const variable& v : l)
+          _hash ^= v._hash + 0x9e3779b9 + (_hash << 6) + (_hash >> 2);
+      }
+      break;
+    case content::is_map:
+      {
+        // Sum of the entries, so the order of the keys doesn't matter
+        const map& m = as_map();
+        std::uint64_t h = m.size();
+
+        for (const map::value_type& e : m)
+        {
+          std::uint64_t x = (static_cast<std::uint64_t>(e.first._hash) << 32) | e.second._hash;
+
+          x ^= x >> 33;
+          x *= 0xff51afd7ed558ccdull;
+          x ^= x >> 33;
+          h += x;
+        }
+
+        _hash = static_cast<std::uint32_t>(h ^ (h >> 32));
+      }
+      break;
+    case content::is_string_rope:
+      _hash = as_string_rope().hash();
+      break;
+    case content::is_compact_string_list:
+      _hash = as_compact_string_list().hash();
+      break;
+    case content::is_int32_array:
+    case content::is_int64_array:
+    case content::is_uint64_array:
+    case content::is_blob:
+      {
+        const std::size_t n = variable_access::array_size(*this);
+
+        _hash = hash_bytes(variable_access::array_data(*this),
+                           n * variable_access::element_size(_type),
+                           0xcbf29ce484222325ull ^ n);
+      }
+      break;
     default:
       _hash = _cs_hash;
   }
@@ -873,7 +1548,17 @@ variable::reset() noexcept
     else if (_type == content::is_string)
       delete reinterpret_cast<std::string *>(_data._pointer);
     else if (_type == content::is_string_list)
-      delete reinterpret_cast<stringlist *>(_data._pointer);
+      delete reinterpret_cast<string_list_payload *>(_data._pointer);
+    else if (variable_access::is_array(_type))
+      variable_access::free_array(_data._pointer);
+    else if (_type == content::is_list)
+      delete reinterpret_cast<list *>(_data._pointer);
+    else if (_type == content::is_map)
+      delete reinterpret_cast<map *>(_data._pointer);
+    else if (_type == content::is_string_rope)
+      delete reinterpret_cast<string_rope *>(_data._pointer);
+    else if (_type == content::is_compact_string_list)
+      delete reinterpret_cast<compact_string_list *>(_data._pointer);
 
     _type = content::is_empty;
     _data._pointer = nullptr;
@@ -881,6 +1566,361 @@ variable::reset() noexcept
   }
 }
 
+// Map
+variable::map::map() noexcept
+{}
+
+variable::map::map(
+    std::initializer_list<value_type> entries)
+  : map(std::vector<value_type>(entries))
+{}
+
+variable::map::map(
+    std::vector<value_type> entries)
+  : _entries(std::move(entries))
+{
+  // Stable, so the last of equal keys is the last of its hash run
+  std::stable_sort(_entries.begin(), _entries.end(),
+    [](const value_type& a, const value_type& b) { return a.first.hash() < b.first.hash(); });
+
+  std::size_t out = 0;
+
+  for (std::size_t i = 0; i < _entries.size(); ++i)
+  {
+    std::size_t j = out;
+
+    // Same key earlier in the run of its hash
+    while (j > 0 && _entries[j - 1].first.hash() == _entries[i].first.hash() &&
+           _entries[j - 1].first != _entries[i].first)
+      --j;
+
+    if (j > 0 && _entries[j - 1].first.hash() == _entries[i].first.hash())
+      _entries[j - 1].second = std::move(_entries[i].second);
+    else
+    {
+      if (out != i)
+        _entries[out] = std::move(_entries[i]);
+
+      ++out;
+    }
+  }
+
+  _entries.resize(out);
+}
+
+variable::map::size_type
+variable::map::position(
+    const variable& key,
+    bool&           found) const noexcept
+{
+  const std::uint32_t h = key.hash();
+
+  size_type i = static_cast<size_type>(std::lower_bound(_entries.begin(), _entries.end(), h,
+    [](const value_type& e, std::uint32_t x) { return e.first.hash() < x; }) - _entries.begin());
+
+  for (; i < _entries.size() && _entries[i].first.hash() == h; ++i)
+    if (_entries[i].first == key)
+    {
+      found = true;
+      return i;
+    }
+
+  found = false;
+  return i;
+}
+
+variable&
+variable::map::operator[] (
+    const variable& key)
+{
+  bool found;
+  const size_type i = position(key, found);
+
+  if (!found)
+    _entries.emplace(_entries.begin() + i, key, variable());
+
+  return _entries[i].second;
+}
+
+bool
+variable::map::insert_or_assign(
+    const variable& key,
+    variable        value)
+{
+  bool found;
+  const size_type i = position(key, found);
+
+  if (found)
+    _entries[i].second = std::move(value);
+  else
+    _entries.emplace(_entries.begin() + i, key, std::move(value));
+
+  return !found;
+}
+
+variable::map::size_type
+variable::map::erase(
+    const variable& key)
+{
+  bool found;
+  const size_type i = position(key, found);
+
+  if (!found)
+    return 0;
+
+  _entries.erase(_entries.begin() + i);
+  return 1;
+}
+
+const variable*
+variable::map::find(
+    const variable& key) const noexcept
+{
+  bool found;
+  const size_type i = position(key, found);
+
+  return found ? &_entries[i].second : nullptr;
+}
+
+const variable&
+variable::map::at(
+    const variable& key) const
+{
+  const variable* v = find(key);
+
+  if (v == nullptr)
+    throw std::out_of_range("variable::map::at(): no key " + key.to_string());
+
+  return *v;
+}
+
+bool
+variable::map::operator == (
+    const map& other) const noexcept
+{
+  if (_entries.size() != other._entries.size())
+    return false;
+
+  for (size_type i = 0; i < _entries.size(); ++i)
+  {
+    const value_type& e = _entries[i];
+
+    // Same position, unless keys share a hash
+    if (e.first == other._entries[i].first)
+    {
+      if (e.second != other._entries[i].second)
+        return false;
+    }
+    else
+    {
+      const variable* v = other.find(e.first);
+
+      if (v == nullptr || *v != e.second)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+// String rope
+const variable::string_rope::size_type variable::string_rope::chunk_size;
+
+// Hash of an empty rope, before the size is mixed in
+static const std::uint32_t _cs_rope_seed = 0x811c9dc5u;
+
+// Fold one more entry into the hash of a rope or compact list
+static inline std::uint32_t
+fold(
+    const std::uint32_t state,
+    const std::string&  v) noexcept
+{
+  return state ^ (std::hash<std::string>()(v) + 0x9e3779b9 + (state << 6) + (state >> 2));
+}
+
+variable::string_rope::string_rope() noexcept
+  : _size(0),
+    _state(_cs_rope_seed)
+{}
+
+variable::string_rope::string_rope(
+    const stringlist& entries)
+  : string_rope()
+{
+  _chunks.reserve((entries.size() + chunk_size - 1) / chunk_size);
+
+  for (const std::string& s : entries)
+    push_back(s);
+}
+
+void
+variable::string_rope::push_back(
+    const std::string& v)
+{
+  if (_chunks.empty() || _chunks.back()->size() == chunk_size)
+  {
+    _chunks.push_back(std::make_shared<stringlist>());
+    _chunks.back()->reserve(chunk_size);
+  }
+  else if (_chunks.back().use_count() > 1)
+  {
+    // Shared with a copy, which must not see the new entry
+    std::shared_ptr<stringlist> own = std::make_shared<stringlist>();
+    own->reserve(chunk_size);
+    own->assign(_chunks.back()->begin(), _chunks.back()->end());
+    _chunks.back() = std::move(own);
+  }
+
+  _chunks.back()->push_back(v);
+  ++_size;
+
+  _state = fold(_state, v);
+}
+
+variable::stringlist
+variable::string_rope::to_string_list() const
+{
+  stringlist result;
+  result.reserve(_size);
+
+  each([&result](const std::string& s) { result.push_back(s); });
+
+  return result;
+}
+
+std::uint32_t
+variable::string_rope::hash() const noexcept
+{
+  return _state ^ (static_cast<std::uint32_t>(_size) * 0x9e3779b9u);
+}
+
+bool
+variable::string_rope::operator == (
+    const string_rope& other) const noexcept
+{
+  if (_size != other._size || _state != other._state)
+    return false;
+
+  // Equal sizes split into the same chunks
+  for (size_type i = 0; i < _chunks.size(); ++i)
+    if (_chunks[i] != other._chunks[i] && *_chunks[i] != *other._chunks[i])
+      return false;
+
+  return true;
+}
+
+// Compact string list
+const variable::compact_string_list::size_type variable::compact_string_list::block_size;
+
+static inline void
+put_varint(
+    std::vector<char>&  out,
+    std::size_t         v)
+{
+  for (; v >= 0x80; v >>= 7)
+    out.push_back(static_cast<char>(v | 0x80));
+
+  out.push_back(static_cast<char>(v));
+}
+
+variable::compact_string_list::compact_string_list() noexcept
+  : _size(0),
+    _state(_cs_rope_seed)
+{}
+
+variable::compact_string_list::compact_string_list(
+    const stringlist& entries)
+  : compact_string_list()
+{
+  _blocks.reserve((entries.size() + block_size - 1) / block_size);
+
+  for (const std::string& s : entries)
+    push_back(s);
+
+  shrink_to_fit();
+}
+
+void
+variable::compact_string_list::push_back(
+    const std::string& v)
+{
+  if (_size % block_size == 0)
+  {
+    _blocks.push_back(_bytes.size());
+    put_varint(_bytes, v.size());
+    _bytes.insert(_bytes.end(), v.begin(), v.end());
+  }
+  else
+  {
+    const std::size_t limit = std::min(_last.size(), v.size());
+    std::size_t shared = 0;
+
+    while (shared < limit && _last[shared] == v[shared])
+      ++shared;
+
+    put_varint(_bytes, shared);
+    put_varint(_bytes, v.size() - shared);
+    _bytes.insert(_bytes.end(), v.begin() + shared, v.end());
+  }
+
+  _last = v;
+  ++_size;
+
+  _state = fold(_state, v);
+}
+
+void
+variable::compact_string_list::shrink_to_fit()
+{
+  _bytes.shrink_to_fit();
+  _blocks.shrink_to_fit();
+  _last.shrink_to_fit();
+}
+
+std::string
+variable::compact_string_list::operator[] (
+    size_type i) const
+{
+  std::string s;
+  const char* p = _bytes.data() + _blocks[i / block_size];
+
+  for (size_type k = 0; k <= i % block_size; ++k)
+    p = decode(p, s, k == 0);
+
+  return s;
+}
+
+variable::stringlist
+variable::compact_string_list::to_string_list() const
+{
+  stringlist result;
+  result.reserve(_size);
+
+  each([&result](const std::string& s) { result.push_back(s); });
+
+  return result;
+}
+
+variable::compact_string_list::size_type
+variable::compact_string_list::bytes() const noexcept
+{
+  return sizeof(compact_string_list) + _bytes.capacity() +
+    _blocks.capacity() * sizeof(size_type) + heap(_last);
+}
+
+std::uint32_t
+variable::compact_string_list::hash() const noexcept
+{
+  return _state ^ (static_cast<std::uint32_t>(_size) * 0x9e3779b9u);
+}
+
+bool
+variable::compact_string_list::operator == (
+    const compact_string_list& other) const noexcept
+{
+  return _size == other._size && _state == other._state && _bytes == other._bytes;
+}
+
 } // End of egg namespace
 
 namespace std
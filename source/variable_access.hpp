@@ -0,0 +1,175 @@
+/*!
+ *	\file		variable_access.hpp
+ *	\brief		Declares raw access to the variable internals (library only)
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_VARIABLE_ACCESS
+#define EGG_VARIABLE_ACCESS
+
+#include <new>
+
+#include <egg/variable.hpp>
+
+
+namespace egg
+{
+
+// Not installed. Gives the library containers and kernels direct access to the
+// type tag, the payload union and the cached hash of a variable.
+struct EGG_PRIVATE variable_access
+{
+  typedef variable::content content;
+  typedef variable::variant variant;
+
+  static content type(const variable& v) noexcept      { return v._type; }
+  static content& type(variable& v) noexcept           { return v._type; }
+
+  static const variant& data(const variable& v) noexcept { return v._data; }
+  static variant& data(variable& v) noexcept           { return v._data; }
+
+  static std::uint32_t hash(const variable& v) noexcept { return v._hash; }
+  static std::uint32_t& hash(variable& v) noexcept     { return v._hash; }
+
+  static void rehash(variable& v) noexcept             { v.__rehash(); }
+
+  // Payload lives in the union itself (no heap allocation)
+  static bool is_inline(content t) noexcept
+  {
+    return t >= content::is_bool && t <= content::is_uint64;
+  }
+
+  // Arrays are one block: the element count, padding to 16 bytes, then the
+  // elements. The pointer of an array variable is never null
+  static const std::size_t array_header = 16;
+
+  static bool is_array(content t) noexcept
+  {
+    return t >= content::is_int32_array && t <= content::is_blob;
+  }
+
+  static std::size_t element_size(content t) noexcept
+  {
+    return t == content::is_int32_array ? 4 : t == content::is_blob ? 1 : 8;
+  }
+
+  static std::size_t array_size(const variable& v) noexcept
+  {
+    return *static_cast<const std::size_t*>(v._data._pointer);
+  }
+
+  static const void* array_data(const variable& v) noexcept
+  {
+    return static_cast<const char*>(v._data._pointer) + array_header;
+  }
+
+  static void* array_data(variable& v) noexcept
+  {
+    return static_cast<char*>(v._data._pointer) + array_header;
+  }
+
+  // Make v an array of n elements, left uninitialized. Fill them, then rehash
+  static void* make_array(variable& v, content t, std::size_t n)
+  {
+    void* block = ::operator new(array_header + n * element_size(t));
+    *static_cast<std::size_t*>(block) = n;
+
+    v.reset();
+    v._type = t;
+    v._data._pointer = block;
+
+    return static_cast<char*>(block) + array_header;
+  }
+
+  static void free_array(void* block) noexcept
+  {
+    ::operator delete(block);
+  }
+
+  static bool is_signed(content t) noexcept
+  {
+    return t == content::is_int8  || t == content::is_int16 ||
+           t == content::is_int32 || t == content::is_int64;
+  }
+
+  static bool is_unsigned(content t) noexcept
+  {
+    return t == content::is_bool   || t == content::is_uint8  ||
+           t == content::is_uint16 || t == content::is_uint32 ||
+           t == content::is_uint64;
+  }
+
+  // Widen inline payload to 64 bit
+  static std::int64_t signed_value(const variable& v) noexcept
+  {
+    switch (v._type)
+    {
+      case content::is_int8:   return v._data._int8;
+      case content::is_int16:  return v._data._int16;
+      case content::is_int32:  return v._data._int32;
+      case content::is_int64:  return v._data._int64;
+      default:                 return 0;
+    }
+  }
+
+  static std::uint64_t unsigned_value(const variable& v) noexcept
+  {
+    switch (v._type)
+    {
+      case content::is_bool:   return v._data._bool ? 1 : 0;
+      case content::is_uint8:  return v._data._uint8;
+      case content::is_uint16: return v._data._uint16;
+      case content::is_uint32: return v._data._uint32;
+      case content::is_uint64: return v._data._uint64;
+      default:                 return 0;
+    }
+  }
+
+  // Narrow 64 bit payload back into a variable of the given inline type.
+  // The hash is recomputed unless the caller knows it.
+  static void assign_signed(
+      variable&     v,
+      content       t,
+      std::int64_t  x) noexcept
+  {
+    v.reset();
+    v._type = t;
+    v._data._d = 0;
+
+    switch (t)
+    {
+      case content::is_int8:   v._data._int8  = static_cast<std::int8_t>(x);  break;
+      case content::is_int16:  v._data._int16 = static_cast<std::int16_t>(x); break;
+      case content::is_int32:  v._data._int32 = static_cast<std::int32_t>(x); break;
+      default:                 v._data._int64 = x;
+    }
+  }
+
+  static void assign_unsigned(
+      variable&     v,
+      content       t,
+      std::uint64_t x) noexcept
+  {
+    v.reset();
+    v._type = t;
+    v._data._d = 0;
+
+    switch (t)
+    {
+      case content::is_bool:   v._data._bool   = x != 0;                          break;
+      case content::is_uint8:  v._data._uint8  = static_cast<std::uint8_t>(x);   break;
+      case content::is_uint16: v._data._uint16 = static_cast<std::uint16_t>(x);  break;
+      case content::is_uint32: v._data._uint32 = static_cast<std::uint32_t>(x);  break;
+      default:                 v._data._uint64 = x;
+    }
+  }
+};
+
+} // End of egg namespace
+
+#endif  // EGG_VARIABLE_ACCESS
+
+/* End of file */
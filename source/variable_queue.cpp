@@ -0,0 +1,64 @@
+/*!
+ *	\file		variable_queue.cpp
+ *	\brief		Implements bounded lock-free queues of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <egg/variable_queue.hpp>
+
+
+namespace egg
+{
+
+// SPSC
+spsc_variable_queue::spsc_variable_queue(
+    size_type capacity)
+  : _mask(queue_detail::round_up(capacity) - 1),
+    _tail(0),
+    _head_cache(0),
+    _head(0),
+    _tail_cache(0)
+{
+  _slots.reset(new variable[_mask + 1]);
+}
+
+spsc_variable_queue::~spsc_variable_queue() noexcept
+{}
+
+spsc_variable_queue::size_type
+spsc_variable_queue::size() const noexcept
+{
+  return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+}
+
+// MPSC
+mpsc_variable_queue::mpsc_variable_queue(
+    size_type capacity)
+  : _mask(queue_detail::round_up(capacity) - 1),
+    _tail(0),
+    _head(0)
+{
+  _slots.reset(new slot[_mask + 1]);
+
+  for (size_type i = 0; i <= _mask; ++i)
+    _slots[i]._sequence.store(i, std::memory_order_relaxed);
+}
+
+mpsc_variable_queue::~mpsc_variable_queue() noexcept
+{}
+
+mpsc_variable_queue::size_type
+mpsc_variable_queue::size() const noexcept
+{
+  const size_type head = _head.load(std::memory_order_acquire);
+  const size_type tail = _tail.load(std::memory_order_acquire);
+
+  return tail > head ? tail - head : 0;
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,287 @@
+/*!
+ *	\file		variable_vector.cpp
+ *	\brief		Implements columnar (structure-of-arrays) vector of variables
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <stdexcept>
+
+#include <egg/variable_vector.hpp>
+
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+// Construct/destruct
+variable_vector::variable_vector() noexcept
+{}
+
+variable_vector::~variable_vector() noexcept
+{}
+
+// Copy
+variable_vector::variable_vector(
+    const variable_vector& other)
+  : _types(other._types),
+    _payloads(other._payloads),
+    _hashes(other._hashes),
+    _heap(other._heap),
+    _free(other._free)
+{}
+
+variable_vector&
+variable_vector::operator=(
+    const variable_vector& other)
+{
+  if (this != &other)
+  {
+    _types = other._types;
+    _payloads = other._payloads;
+    _hashes = other._hashes;
+    _heap = other._heap;
+    _free = other._free;
+  }
+
+  return *this;
+}
+
+// Move
+variable_vector::variable_vector(
+    variable_vector&& other) noexcept
+  : _types(std::move(other._types)),
+    _payloads(std::move(other._payloads)),
+    _hashes(std::move(other._hashes)),
+    _heap(std::move(other._heap)),
+    _free(std::move(other._free))
+{}
+
+variable_vector&
+variable_vector::operator=(
+    variable_vector&& other) noexcept
+{
+  if (this != &other)
+  {
+    _types = std::move(other._types);
+    _payloads = std::move(other._payloads);
+    _hashes = std::move(other._hashes);
+    _heap = std::move(other._heap);
+    _free = std::move(other._free);
+  }
+
+  return *this;
+}
+
+variable_vector::variable_vector(
+    const std::vector<variable>& values)
+{
+  reserve(values.size());
+
+  for (const auto& v : values)
+    push_back(v);
+}
+
+// Size
+void
+variable_vector::reserve(
+    size_type capacity)
+{
+  _types.reserve(capacity);
+  _payloads.reserve(capacity);
+  _hashes.reserve(capacity);
+}
+
+void
+variable_vector::clear() noexcept
+{
+  _types.clear();
+  _payloads.clear();
+  _hashes.clear();
+  _heap.clear();
+  _free.clear();
+}
+
+// Modifiers
+void
+variable_vector::push_back(
+    const variable& v)
+{
+  _types.push_back(content::is_empty);
+  _payloads.push_back(scalar());
+  _hashes.push_back(0);
+
+  try
+  {
+    store(_types.size() - 1, v);
+  }
+  catch (...)
+  {
+    pop_back();
+    throw;
+  }
+}
+
+void
+variable_vector::pop_back() noexcept
+{
+  if (_types.empty())
+    return;
+
+  release(_types.back(), _payloads.back());
+
+  _types.pop_back();
+  _payloads.pop_back();
+  _hashes.pop_back();
+}
+
+void
+variable_vector::set(
+    size_type       i,
+    const variable& v)
+{
+  if (i >= _types.size())
+    throw std::out_of_range("variable_vector::set(): position " +
+                            std::to_string(i) + " is out of range");
+
+  // store() only overwrites the position once the new value is in place
+  const content t = _types[i];
+  const scalar p = _payloads[i];
+
+  store(i, v);
+  release(t, p);
+}
+
+// Materialize
+variable
+variable_vector::at(
+    size_type i) const
+{
+  if (i >= _types.size())
+    throw std::out_of_range("variable_vector::at(): position " +
+                            std::to_string(i) + " is out of range");
+
+  const content t = _types[i];
+  const scalar& p = _payloads[i];
+  variable result;
+
+  if (variable_access::is_signed(t))
+    variable_access::assign_signed(result, t, p._int64);
+
+  else if (variable_access::is_unsigned(t))
+    variable_access::assign_unsigned(result, t, p._uint64);
+
+  else if (t == content::is_float)
+    return variable(static_cast<float>(p._double));
+
+  else if (t == content::is_double)
+    return variable(p._double);
+
+  else if (t != content::is_empty)
+    return _heap[p._uint64];
+
+  variable_access::hash(result) = _hashes[i];
+
+  return result;
+}
+
+std::vector<variable>
+variable_vector::to_vector() const
+{
+  std::vector<variable> result;
+  result.reserve(_types.size());
+
+  for (size_type i = 0; i < _types.size(); ++i)
+    result.push_back(at(i));
+
+  return result;
+}
+
+// Scans
+variable_vector::size_type
+variable_vector::count(
+    content t) const noexcept
+{
+  const content* types = _types.data();
+  const size_type n = _types.size();
+  size_type result = 0;
+
+  // Branch-free so the compiler can vectorize it
+  for (size_type i = 0; i < n; ++i)
+    result += (types[i] == t);
+
+  return result;
+}
+
+// Internals
+void
+variable_vector::store(
+    size_type       i,
+    const variable& v)
+{
+  const content t = v.type();
+  scalar p;
+  p._uint64 = 0;
+
+  if (variable_access::is_signed(t))
+    p._int64 = variable_access::signed_value(v);
+
+  else if (variable_access::is_unsigned(t))
+    p._uint64 = variable_access::unsigned_value(v);
+
+  else if (t == content::is_float)
+    p._double = v.as_float();
+
+  else if (t == content::is_double)
+    p._double = v.as_double();
+
+  else if (t != content::is_empty)
+  {
+    if (_free.empty())
+    {
+      p._uint64 = _heap.size();
+      _heap.push_back(v);
+    }
+    else
+    {
+      p._uint64 = _free.back();
+      _heap[p._uint64] = v;
+      _free.pop_back();
+    }
+  }
+
+  _types[i] = t;
+  _payloads[i] = p;
+  _hashes[i] = v.hash();
+}
+
+void
+variable_vector::release(
+    const content t,
+    const scalar& p) noexcept
+{
+  if (t != content::is_empty &&
+      t != content::is_float &&
+      t != content::is_double &&
+      !variable_access::is_inline(t))
+  {
+    const size_type slot = p._uint64;
+
+    if (slot + 1 == _heap.size())
+      _heap.pop_back();
+    else
+    {
+      _heap[slot].reset();
+
+      // The slot stays unused if the free list can't grow
+      try { _free.push_back(slot); } catch (...) {}
+    }
+  }
+}
+
+} // End of egg namespace
+
+/* End of file */
@@ -0,0 +1,480 @@
+/*!
+ *	\file		watchable_store.cpp
+ *	\brief		Implements variable store with batched change notifications
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#include <cstring>
+#include <exception>
+#include <algorithm>
+
+#include <egg/watchable_store.hpp>
+
+#include "string_index.hpp"
+#include "variable_access.hpp"
+
+
+namespace egg
+{
+
+struct watchable_store::subscriber
+{
+	subscription			_id;
+	callback			_callback;
+	variable			_key;
+	std::string			_prefix;
+	bool				_prefixed;
+	std::vector<std::uint32_t>	_selected;
+	watchable_store*		_store;
+};
+
+namespace
+{
+
+typedef variable_access access;
+typedef variable::content content;
+
+// Copy reusing the storage the target already has, so refreshing the
+// buffers of a flush doesn't allocate once they grew big enough. The copy
+// may still allocate and throw
+template <typename T>
+inline bool
+assign_boxed(
+    variable&       to,
+    const variable& from,
+    content         t)
+{
+  if (access::type(to) != t || access::type(from) != t ||
+      access::data(to)._pointer == nullptr || access::data(from)._pointer == nullptr)
+    return false;
+
+  *static_cast<T*>(access::data(to)._pointer) = *static_cast<const T*>(access::data(from)._pointer);
+  access::hash(to) = access::hash(from);
+
+  return true;
+}
+
+// Arrays of the same type and length are copied over
+inline bool
+assign_array(
+    variable&       to,
+    const variable& from) noexcept
+{
+  const content t = access::type(from);
+
+  if (!access::is_array(t) || access::type(to) != t ||
+      access::array_size(to) != access::array_size(from))
+    return false;
+
+  std::memcpy(access::array_data(to), access::array_data(from),
+              access::array_size(from) * access::element_size(t));
+  access::hash(to) = access::hash(from);
+
+  return true;
+}
+
+inline void
+assign(
+    variable&       to,
+    const variable& from)
+{
+  if (!assign_array(to, from) &&
+      !assign_boxed<std::string>(to, from, content::is_string) &&
+      !assign_boxed<string_list_payload>(to, from, content::is_string_list) &&
+      !assign_boxed<double>(to, from, content::is_double) &&
+      !assign_boxed<float>(to, from, content::is_float) &&
+      !assign_boxed<long double>(to, from, content::is_long_double))
+    to = from;
+}
+
+inline bool
+starts_with(
+    const variable&     key,
+    const std::string&  prefix) noexcept
+{
+  if (key.type() != content::is_string)
+    return false;
+
+  const std::string& s = key.as_string();
+
+  return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+struct direct_executor : watchable_store::executor
+{
+  void execute(void (*fn)(void*), void* argument) override
+  {
+    fn(argument);
+  }
+};
+
+} // End of anonymous namespace
+
+// Executor
+watchable_store::executor::~executor() noexcept
+{}
+
+watchable_store::executor&
+watchable_store::inline_executor() noexcept
+{
+  static direct_executor e;
+  return e;
+}
+
+// Construct/destruct
+watchable_store::watchable_store(
+    executor& e)
+  : _executor(&e),
+    _suppressed(0),
+    _next_id(1),
+    _outstanding(0)
+{}
+
+watchable_store::~watchable_store() noexcept
+{}
+
+// Values
+void
+watchable_store::mark(
+    std::uint32_t i)
+{
+  slot& s = _slots[i];
+
+  if (!s._dirty)
+  {
+    s._dirty = true;
+    _dirty.push_back(i);
+  }
+}
+
+bool
+watchable_store::set(
+    const variable& key,
+    const variable& value)
+{
+  std::lock_guard<std::mutex> lock(_lock);
+
+  const auto i = _index.find(key);
+
+  if (i != _index.end())
+  {
+    slot& s = _slots[i->second];
+
+    // Different cached hashes reject the deep comparison right away
+    if (s._alive && s._value == value)
+    {
+      ++_suppressed;
+      return false;
+    }
+
+    assign(s._value, value);
+    s._alive = true;
+    mark(i->second);
+
+    return true;
+  }
+
+  std::uint32_t n;
+
+  if (_free.empty())
+  {
+    n = static_cast<std::uint32_t>(_slots.size());
+    _slots.push_back(slot { key, value, true, false });
+  }
+  else
+  {
+    n = _free.back();
+    _free.pop_back();
+
+    slot& s = _slots[n];
+    assign(s._key, key);
+    assign(s._value, value);
+    s._alive = true;
+  }
+
+  _index.emplace(key, n);
+  mark(n);
+
+  return true;
+}
+
+bool
+watchable_store::erase(
+    const variable& key)
+{
+  std::lock_guard<std::mutex> lock(_lock);
+
+  const auto i = _index.find(key);
+
+  if (i == _index.end() || !_slots[i->second]._alive)
+    return false;
+
+  slot& s = _slots[i->second];
+  s._alive = false;
+  s._value.reset();
+  mark(i->second);
+
+  return true;
+}
+
+bool
+watchable_store::get(
+    const variable& key,
+    variable&       out) const
+{
+  std::lock_guard<std::mutex> lock(_lock);
+
+  const auto i = _index.find(key);
+
+  if (i == _index.end() || !_slots[i->second]._alive)
+    return false;
+
+  out = _slots[i->second]._value;
+  return true;
+}
+
+watchable_store::size_type
+watchable_store::size() const
+{
+  std::lock_guard<std::mutex> lock(_lock);
+
+  size_type result = 0;
+  for (const slot& s : _slots)
+    result += s._alive;
+
+  return result;
+}
+
+watchable_store::size_type
+watchable_store::pending() const
+{
+  std::lock_guard<std::mutex> lock(_lock);
+  return _dirty.size();
+}
+
+watchable_store::size_type
+watchable_store::suppressed() const
+{
+  std::lock_guard<std::mutex> lock(_lock);
+  return _suppressed;
+}
+
+// Subscriptions
+watchable_store::subscription
+watchable_store::subscribe(
+    const variable& key,
+    callback        f)
+{
+  std::lock_guard<std::mutex> lock(_flush_lock);
+
+  std::unique_ptr<subscriber> s(new subscriber { _next_id++, std::move(f), key, std::string(), false, {}, this });
+
+  _exact[key].push_back(s.get());
+  _subscribers.push_back(std::move(s));
+
+  return _subscribers.back()->_id;
+}
+
+watchable_store::subscription
+watchable_store::subscribe_prefix(
+    const std::string& prefix,
+    callback           f)
+{
+  std::lock_guard<std::mutex> lock(_flush_lock);
+
+  std::unique_ptr<subscriber> s(new subscriber { _next_id++, std::move(f), variable(), prefix, true, {}, this });
+
+  _prefixed.push_back(s.get());
+  _subscribers.push_back(std::move(s));
+
+  return _subscribers.back()->_id;
+}
+
+bool
+watchable_store::unsubscribe(
+    subscription id)
+{
+  // Waits for a flush in progress, with its callbacks
+  std::lock_guard<std::mutex> lock(_flush_lock);
+
+  const auto i = std::find_if(_subscribers.begin(), _subscribers.end(),
+    [id](const std::unique_ptr<subscriber>& s) { return s->_id == id; });
+
+  if (i == _subscribers.end())
+    return false;
+
+  subscriber* s = i->get();
+
+  if (s->_prefixed)
+    _prefixed.erase(std::find(_prefixed.begin(), _prefixed.end(), s));
+  else
+  {
+    const auto e = _exact.find(s->_key);
+    std::vector<subscriber*>& list = e->second;
+
+    list.erase(std::find(list.begin(), list.end(), s));
+
+    if (list.empty())
+      _exact.erase(e);
+  }
+
+  _subscribers.erase(i);
+
+  return true;
+}
+
+// Delivery
+void
+watchable_store::deliver(
+    void* argument)
+{
+  subscriber* s = static_cast<subscriber*>(argument);
+  std::exception_ptr failure;
+
+  // A throwing callback must not keep flush() waiting forever
+  try
+  {
+    s->_callback(batch(s->_store->_changes.data(), s->_selected.data(), s->_selected.size()));
+  }
+  catch (...)
+  {
+    failure = std::current_exception();
+  }
+
+  s->_store->finished(failure);
+}
+
+void
+watchable_store::finished(
+    const std::exception_ptr& failure)
+{
+  std::lock_guard<std::mutex> lock(_delivery_lock);
+
+  // flush() rethrows the first one
+  if (failure && !_failure)
+    _failure = failure;
+
+  if (--_outstanding == 0)
+    _delivered.notify_all();
+}
+
+watchable_store::size_type
+watchable_store::flush()
+{
+  std::lock_guard<std::mutex> flush_lock(_flush_lock);
+
+  // Take the changed keys, writers go on with an empty list
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _flushing.swap(_dirty);
+    _dirty.clear();
+
+    if (_changes.size() < _flushing.size())
+      _changes.resize(_flushing.size());
+
+    for (size_type n = 0; n < _flushing.size(); ++n)
+    {
+      const std::uint32_t i = _flushing[n];
+      slot& s = _slots[i];
+      change& c = _changes[n];
+
+      assign(c._key, s._key);
+
+      if (s._alive)
+        assign(c._value, s._value);
+      else
+      {
+        c._value.reset();
+
+        // Erased for good, the slot can be reused
+        _index.erase(s._key);
+        _free.push_back(i);
+      }
+
+      s._dirty = false;
+    }
+  }
+
+  const size_type count = _flushing.size();
+
+  if (count == 0)
+    return 0;
+
+  // Pick the changes of every subscriber
+  for (const auto& s : _subscribers)
+    s->_selected.clear();
+
+  for (size_type n = 0; n < count; ++n)
+  {
+    const variable& key = _changes[n]._key;
+    const auto e = _exact.find(key);
+
+    if (e != _exact.end())
+      for (subscriber* s : e->second)
+        s->_selected.push_back(static_cast<std::uint32_t>(n));
+
+    for (subscriber* s : _prefixed)
+      if (starts_with(key, s->_prefix))
+        s->_selected.push_back(static_cast<std::uint32_t>(n));
+  }
+
+  size_type batches = 0;
+
+  for (const auto& s : _subscribers)
+    batches += !s->_selected.empty();
+
+  if (batches == 0)
+    return count;
+
+  {
+    std::lock_guard<std::mutex> lock(_delivery_lock);
+    _outstanding = batches;
+  }
+
+  // Deliveries already dispatched read the buffers, so a failing executor
+  // can't end the flush early: the batches it didn't take run here
+  std::exception_ptr failure;
+
+  for (const auto& s : _subscribers)
+    if (!s->_selected.empty())
+    {
+      if (!failure)
+      {
+        try
+        {
+          _executor->execute(&watchable_store::deliver, s.get());
+          continue;
+        }
+        catch (...)
+        {
+          failure = std::current_exception();
+        }
+      }
+
+      deliver(s.get());
+    }
+
+  // The buffers are reused by the next flush
+  {
+    std::unique_lock<std::mutex> lock(_delivery_lock);
+    _delivered.wait(lock, [this] { return _outstanding == 0; });
+
+    if (!failure)
+      failure = _failure;
+
+    _failure = nullptr;
+  }
+
+  if (failure)
+    std::rethrow_exception(failure);
+
+  return count;
+}
+
+} // End of egg namespace
+
+/* End of file */
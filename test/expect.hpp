@@ -0,0 +1,28 @@
+/*!
+ *	\file		expect.hpp
+ *	\brief		Check helper shared by the tests
+ *	\author		Vladislav "Tanuki" Mikhailikov \<vmikhailikov\@gmail.com\>
+ *	\copyright	GNU GPL v3
+ *	\date		18/10/2026
+ *	\version	1.0
+ */
+
+#ifndef EGG_TEST_EXPECT
+#define EGG_TEST_EXPECT
+
+#include <string>
+#include <stdexcept>
+
+// Fails the test with the name of the check
+inline void
+expect(
+  const bool          condition,
+  const std::string&  what)
+{
+  if (!condition)
+    throw std::runtime_error("Check failed: " + what);
+}
+
+#endif  // EGG_TEST_EXPECT
+
+/* End of file */
@@ -0,0 +1,138 @@
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable_vector.hpp"
+#include "expect.hpp"
+
+void
+round_trip()
+{
+  using egg::variable;
+  using egg::variable_vector;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking variable_vector round trip" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable::stringlist sl = { "one", "two", "three" };
+  std::vector<variable> values;
+
+  values.push_back(variable());
+  values.push_back(true);
+  values.push_back(std::numeric_limits<std::int8_t>::min());
+  values.push_back(std::numeric_limits<std::uint8_t>::max());
+  values.push_back(std::numeric_limits<std::int16_t>::min());
+  values.push_back(std::numeric_limits<std::uint16_t>::max());
+  values.push_back(std::numeric_limits<std::int32_t>::min());
+  values.push_back(std::numeric_limits<std::uint32_t>::max());
+  values.push_back(std::numeric_limits<std::int64_t>::min());
+  values.push_back(std::numeric_limits<std::uint64_t>::max());
+  values.push_back(3.25f);
+  values.push_back(2.5);
+  values.push_back(1.125L);
+  values.push_back("string");
+  values.push_back(sl);
+
+  variable_vector vv(values);
+  expect(vv.size() == values.size(), "size");
+
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    variable v = vv.at(i);
+
+    cout  << "vv[" << i << "] = " << v
+          << " (" << vv.type(i) << ")" << endl;
+
+    expect(v.type() == values[i].type(), "type of " + std::to_string(i));
+    expect(v == values[i], "value of " + std::to_string(i));
+    expect(v.hash() == values[i].hash(), "hash of " + std::to_string(i));
+  }
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+columns()
+{
+  using egg::variable;
+  using egg::variable_vector;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking variable_vector columns" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable_vector vv;
+
+  for (std::int64_t i = 0; i < 100; ++i)
+  {
+    vv.push_back(i);
+    vv.push_back(static_cast<double>(i) / 2);
+  }
+
+  vv.push_back("tail");
+
+  expect(vv.count(variable::content::is_int64) == 100, "int64 count");
+  expect(vv.count(variable::content::is_double) == 100, "double count");
+  expect(vv.count(variable::content::is_string) == 1, "string count");
+
+  std::int64_t isum = 0;
+  double dsum = 0;
+
+  for (std::size_t i = 0; i < vv.size(); ++i)
+  {
+    if (vv.types()[i] == variable::content::is_int64)
+      isum += vv.payloads()[i]._int64;
+    else if (vv.types()[i] == variable::content::is_double)
+      dsum += vv.payloads()[i]._double;
+  }
+
+  cout << "Sum of int64: " << isum << ", sum of double: " << dsum << endl;
+
+  expect(isum == 4950, "int64 sum");
+  expect(dsum == 2475.0, "double sum");
+  expect(vv.heap(vv.payload(vv.size() - 1)).as_string() == "tail", "heap");
+
+  // Replace the heap value with a scalar and back
+  vv.set(vv.size() - 1, 42);
+  expect(vv.at(vv.size() - 1).as_int32() == 42, "set scalar");
+
+  vv.set(0, "head");
+  expect(vv.at(0).as_string() == "head", "set string");
+
+  // The new string is stored before the old one is freed
+  vv.set(0, "new head");
+  vv.set(1, "second");
+  expect(vv.at(0).as_string() == "new head" && vv.at(1).as_string() == "second", "set string over string");
+
+  vv.pop_back();
+  expect(vv.size() == 200, "pop_back");
+
+  variable_vector copy(vv);
+  expect(copy.at(0).as_string() == "new head", "copy");
+
+  variable_vector moved(std::move(copy));
+  expect(moved.size() == 200 && copy.empty(), "move");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Conversion to columns and back
+  round_trip();
+
+  // Column access, set and pop
+  columns();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,138 @@
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/aggregate.hpp"
+#include "expect.hpp"
+
+static std::vector<egg::variable>
+sample()
+{
+  using egg::variable;
+
+  std::vector<variable> values;
+
+  // Runs of each numeric kind, interleaved with non-numeric values
+  for (int i = 1; i <= 300; ++i)
+    values.push_back(static_cast<std::int8_t>(i % 100));
+
+  values.push_back("not a number");
+  values.push_back(true);
+
+  for (int i = 1; i <= 300; ++i)
+    values.push_back(static_cast<std::uint16_t>(i));
+
+  for (int i = 1; i <= 10; ++i)
+  {
+    values.push_back(static_cast<std::int32_t>(-i));
+    values.push_back(static_cast<float>(i) / 4);
+  }
+
+  values.push_back(std::numeric_limits<std::int64_t>::max());
+  values.push_back(std::numeric_limits<std::int64_t>::max());
+  values.push_back(std::numeric_limits<std::uint64_t>::max());
+  values.push_back(0.5);
+  values.push_back(0.25L);
+  values.push_back(variable());
+
+  return values;
+}
+
+static long double
+naive_sum(
+  const std::vector<egg::variable>& values,
+  std::size_t& count)
+{
+  using egg::variable;
+
+  long double sum = 0;
+  count = 0;
+
+  for (const auto& v : values)
+  {
+    switch (v.type())
+    {
+      case variable::content::is_int8:        sum += v.as_int8();        break;
+      case variable::content::is_uint8:       sum += v.as_uint8();       break;
+      case variable::content::is_int16:       sum += v.as_int16();       break;
+      case variable::content::is_uint16:      sum += v.as_uint16();      break;
+      case variable::content::is_int32:       sum += v.as_int32();       break;
+      case variable::content::is_uint32:      sum += v.as_uint32();      break;
+      case variable::content::is_int64:       sum += v.as_int64();       break;
+      case variable::content::is_uint64:      sum += v.as_uint64();      break;
+      case variable::content::is_float:       sum += v.as_float();       break;
+      case variable::content::is_double:      sum += v.as_double();      break;
+      case variable::content::is_long_double: sum += v.as_long_double(); break;
+      default: continue;
+    }
+
+    ++count;
+  }
+
+  return sum;
+}
+
+void
+check(
+  const std::string&      name,
+  const egg::statistics&  s,
+  const long double       sum,
+  const std::size_t       count)
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout  << name << ": count = " << s.count
+        << ", sum = " << s.sum
+        << ", min = " << s.min
+        << ", max = " << s.max
+        << ", mean = " << s.mean() << endl;
+
+  expect(s.count == count, name + " count");
+  expect(std::abs(s.sum - sum) <= std::abs(sum) * 1e-15L, name + " sum");
+  expect(s.min == -10, name + " min");
+  expect(s.max == std::numeric_limits<std::uint64_t>::max(), name + " max");
+  expect(s.count_of(variable::content::is_int8) == 300, name + " int8 count");
+  expect(s.count_of(variable::content::is_string) == 1, name + " string count");
+  expect(s.count_of(variable::content::is_bool) == 1, name + " bool count");
+  expect(s.count_of(variable::content::is_empty) == 1, name + " empty count");
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking aggregate kernels" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::vector<egg::variable> values = sample();
+  std::size_t count = 0;
+  const long double sum = naive_sum(values, count);
+
+  cout << "Naive: count = " << count << ", sum = " << sum << endl;
+
+  // Array of variables
+  check("Array", egg::aggregate(values), sum, count);
+
+  // Columnar vector
+  check("Columns", egg::aggregate(egg::variable_vector(values)), sum, count);
+
+  // Merge of two halves
+  const std::size_t half = values.size() / 2;
+  egg::statistics s = egg::aggregate(values.data(), half);
+  s += egg::aggregate(values.data() + half, values.size() - half);
+  check("Merged", s, sum, count);
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/bulk.hpp"
+#include "expect.hpp"
+
+void
+compare()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking const equality and equal_all()" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable a("string"), b("string"), c("other");
+  const variable d(1.5), e(1.5), f(2.5);
+
+  expect(a == b && a != c, "const string equality");
+  expect(d == e && d != f, "const double equality");
+  expect(variable(1) != variable(1u), "different types");
+  expect(variable() == variable(), "empty");
+
+  std::vector<variable> lhs, rhs;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    lhs.push_back(i);
+    rhs.push_back(i % 3 ? variable(i) : variable(i + 1));
+
+    lhs.push_back(std::to_string(i));
+    rhs.push_back(std::to_string(i % 5 ? i : -i));
+
+    lhs.push_back(static_cast<double>(i));
+    rhs.push_back(static_cast<double>(i));
+  }
+
+  std::vector<char> out(lhs.size());
+  const std::size_t equal = egg::equal_all(
+    lhs.data(), rhs.data(), lhs.size(), reinterpret_cast<bool *>(out.data()));
+
+  std::size_t expected = 0;
+
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+  {
+    const bool same = (lhs[i] == rhs[i]);
+
+    expect(static_cast<bool>(out[i]) == same, "equal_all at " + std::to_string(i));
+    expected += same;
+  }
+
+  cout << "equal_all(): " << equal << " of " << lhs.size() << " equal" << endl;
+  expect(equal == expected, "equal_all count");
+
+  std::vector<std::uint64_t> hashes(lhs.size());
+  egg::hash_all(lhs, hashes.data());
+
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+    expect(hashes[i] == lhs[i].hash(), "hash_all at " + std::to_string(i));
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+dedup()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking dedup()" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable::stringlist sl = { "one", "two" };
+  std::vector<variable> values = {
+    variable(1), variable("one"), variable(1), variable(sl),
+    variable(2.5), variable("one"), variable(sl), variable(1u),
+    variable(), variable(2.5), variable()
+  };
+
+  const std::size_t removed = egg::dedup(values);
+
+  for (const auto& v : values)
+    cout << v << " (" << v.type() << ")" << endl;
+
+  expect(removed == 5, "removed count");
+  expect(values.size() == 6, "size");
+  expect(values[0] == variable(1), "order 0");
+  expect(values[1] == variable("one"), "order 1");
+  expect(values[2] == variable(sl), "order 2");
+  expect(values[3] == variable(2.5), "order 3");
+  expect(values[4] == variable(1u), "order 4");
+  expect(values[5].is_empty(), "order 5");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Equality, hashing
+  compare();
+
+  // Deduplication
+  dedup();
+
+  return 0;
+}
+
+/* End of file */
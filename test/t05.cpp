@@ -0,0 +1,136 @@
+#include <map>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable_hash_map.hpp"
+#include "expect.hpp"
+
+void
+basics()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking variable_hash_map basics" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  egg::variable_hash_map<variable> vm;
+  const variable::stringlist key1 = {"one", "two", "three" };
+
+  vm["one"] = "two";
+  vm[2] = "three";
+  vm[3.14] = 87634;
+  vm[key1] = false;
+  vm[true] = key1;
+
+  for (const auto& i : vm)
+    cout << "vm[" << i.first << "] = " << i.second << endl;
+
+  expect(vm.size() == 5, "size");
+  expect(vm.at("one").as_string() == "two", "string key");
+  expect(vm.find(std::string("one")) != vm.end(), "string lookup");
+  expect(vm.find("one") != vm.end(), "char* lookup");
+  expect(vm.find(std::string("none")) == vm.end(), "missing string lookup");
+  expect(vm.at(2).as_string() == "three", "int key");
+  expect(vm.at(3.14).as_int32() == 87634, "double key");
+  expect(vm.at(key1).as_bool() == false, "list key");
+  expect(vm.count(2u) == 0, "type is part of the key");
+
+  vm[key1] = vm[true];
+  expect(vm.at(key1).as_string_list() == key1, "assign");
+
+  expect(vm.erase(2) == 1 && vm.erase(2) == 0, "erase");
+  expect(vm.size() == 4 && !vm.contains(2), "size after erase");
+
+  bool thrown = false;
+  try { vm.at(42); } catch (const std::out_of_range&) { thrown = true; }
+  expect(thrown, "at() throws");
+
+  egg::variable_hash_map<variable> copy(vm);
+  expect(copy.size() == vm.size() && copy.at("one") == vm.at("one"), "copy");
+
+  egg::variable_hash_map<variable> moved(std::move(copy));
+  expect(moved.size() == vm.size() && copy.empty(), "move");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+stress()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking variable_hash_map against std::map" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  egg::variable_hash_map<std::int64_t> hm;
+  std::map<std::int64_t, std::int64_t> reference;
+  std::uint64_t seed = 12345;
+
+  for (int i = 0; i < 200000; ++i)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    const std::int64_t k = static_cast<std::int64_t>((seed >> 33) % 5000);
+    const variable key = (k % 2 ? variable(k) : variable("key-" + std::to_string(k)));
+
+    switch ((seed >> 20) % 3)
+    {
+      case 0:
+        hm[key] = i;
+        reference[k] = i;
+        break;
+      case 1:
+        expect(hm.erase(key) == reference.erase(k), "erase " + std::to_string(k));
+        break;
+      default:
+      {
+        auto found = hm.find(key);
+        auto expected = reference.find(k);
+
+        expect((found == hm.end()) == (expected == reference.end()),
+               "presence of " + std::to_string(k));
+
+        if (found != hm.end())
+          expect(found->second == expected->second, "value of " + std::to_string(k));
+      }
+    }
+  }
+
+  std::size_t visited = 0;
+  for (const auto& e : hm)
+  {
+    (void)e;
+    ++visited;
+  }
+
+  cout << "Size: " << hm.size() << ", capacity: " << hm.capacity() << endl;
+
+  expect(hm.size() == reference.size(), "final size");
+  expect(visited == reference.size(), "iteration");
+
+  hm.clear();
+  expect(hm.empty() && hm.begin() == hm.end(), "clear");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Same usage as std::map<variable, variable>
+  basics();
+
+  // Random operations against std::map
+  stress();
+
+  return 0;
+}
+
+/* End of file */
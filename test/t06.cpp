@@ -0,0 +1,192 @@
+#include <map>
+#include <thread>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/frozen_map.hpp"
+#include "../include/egg/variable_hash_map.hpp"
+#include "expect.hpp"
+
+typedef std::map<egg::variable, egg::variable> variable_map;
+
+void
+flat()
+{
+  using egg::variable;
+  using egg::frozen_map;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking frozen_map of variable_map" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable_map vm;
+  const variable::stringlist key1 = {"one", "two", "three" };
+
+  vm["one"] = "two";
+  vm[2] = "three";
+  vm[3.14] = 87634;
+  vm[key1] = false;
+  vm[true] = key1;
+
+  for (int i = 0; i < 1000; ++i)
+    vm["key-" + std::to_string(i)] = i;
+
+  const frozen_map fm = frozen_map::freeze(vm);
+
+  expect(fm.size() == vm.size(), "size");
+
+  for (const auto& i : vm)
+  {
+    const variable* v = fm.find(i.first);
+
+    expect(v != nullptr && *v == i.second, "value of " + i.first.to_string());
+  }
+
+  cout << "fm[one] = " << fm.at("one") << endl
+       << "fm[2] = " << fm.at(2) << endl
+       << "fm[3.14] = " << fm.at(3.14) << endl
+       << "fm[true] = " << fm.at(true) << endl;
+
+  expect(fm.find("missing") == nullptr, "missing key");
+  expect(fm.find(2u) == nullptr, "type is part of the key");
+
+  bool thrown = false;
+  try { fm.at("missing"); } catch (const std::out_of_range&) { thrown = true; }
+  expect(thrown, "at() throws");
+
+  // Shared between threads without locks
+  std::size_t found[4] = { 0, 0, 0, 0 };
+  std::vector<std::thread> readers;
+
+  for (int t = 0; t < 4; ++t)
+    readers.emplace_back([&fm, &found, t] {
+      for (int i = 0; i < 1000; ++i)
+        found[t] += fm.find("key-" + std::to_string(i)) != nullptr;
+    });
+
+  for (auto& r : readers)
+    r.join();
+
+  for (int t = 0; t < 4; ++t)
+    expect(found[t] == 1000, "concurrent readers");
+
+  const frozen_map empty = frozen_map::freeze(variable_map());
+  expect(empty.empty() && empty.find(1) == nullptr, "empty");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+nested()
+{
+  using egg::variable;
+  using egg::frozen_map;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking frozen_map of nested maps" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  std::map<variable, std::map<variable, variable>> repository;
+
+  repository["cmd"]["configuration"] = "/etc/phoenix/test.xml";
+  repository["cmd"]["level"] = 9;
+  repository["log"]["file"] = "/var/log/test.log";
+  repository["empty"];
+
+  const frozen_map fm = frozen_map::freeze(repository);
+
+  expect(fm.size() == 3, "top level size");
+  expect(fm["cmd"].size() == 2, "nested size");
+  expect(fm["cmd"]["level"].value()->as_int32() == 9, "nested value");
+  expect(fm["log"]["file"].value()->as_string() == "/var/log/test.log", "nested string");
+  expect(!fm["cmd"]["missing"], "missing nested key");
+  expect(!fm["missing"]["level"], "missing parent key");
+  expect(fm["empty"] && fm["empty"].size() == 0, "empty child");
+
+  for (std::size_t i = 0; i < fm.root().size(); ++i)
+  {
+    const frozen_map::node n = fm.root().child(i);
+    cout << "fm[" << *n.key() << "]: " << n.size() << " children" << endl;
+
+    for (std::size_t j = 0; j < n.size(); ++j)
+      cout << "  fm[" << *n.key() << "][" << *n.child(j).key() << "] = "
+           << *n.child(j).value() << endl;
+  }
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+collisions()
+{
+  using egg::variable;
+  using egg::frozen_map;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking frozen_map of keys sharing a hash" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  // Integer hashes are the value, so these keys differ only by type
+  egg::variable_hash_map<variable> vm;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    vm[variable(static_cast<std::int32_t>(i))] = "int32";
+    vm[variable(static_cast<std::uint32_t>(i))] = "uint32";
+    vm[variable(static_cast<std::int64_t>(i))] = "int64";
+  }
+
+  vm[variable(true)] = "bool";
+  vm[variable(static_cast<std::uint8_t>(1))] = "uint8";
+
+  expect(vm.size() == 3002 && variable(true).hash() == variable(static_cast<std::int32_t>(1)).hash(), "shared hashes");
+
+  const frozen_map fm = frozen_map::freeze(vm);
+
+  expect(fm.size() == vm.size(), "size");
+
+  for (const auto& i : vm)
+  {
+    const variable* v = fm.find(i.first);
+
+    expect(v != nullptr && *v == i.second, "value of " + i.first.to_type_string() + " " + i.first.to_string());
+  }
+
+  expect(fm.at(true) == variable("bool") && fm.at(static_cast<std::int32_t>(1)) == variable("int32"), "bool and int32");
+  expect(fm.find(static_cast<std::int16_t>(1)) == nullptr, "missing type of a shared hash");
+  expect(fm.find(static_cast<std::int32_t>(5000)) == nullptr, "missing key");
+
+  // Every entry is reached once by a walk
+  std::size_t walked = 0;
+  for (std::size_t i = 0; i < fm.root().size(); ++i)
+    walked += fm.root().child(i).key() != nullptr;
+
+  expect(walked == vm.size(), "walk");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Flat map
+  flat();
+
+  // Map of maps
+  nested();
+
+  // Keys sharing a hash
+  collisions();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/tree.hpp"
+#include "../include/egg/frozen_map.hpp"
+#include "expect.hpp"
+
+void
+recursive_dump(
+    const egg::tree::const_node n,
+    int level)
+{
+  using std::cout;
+  using std::endl;
+
+  for (const auto c : n)
+  {
+    for (auto l = 0; l < level; ++l)
+      cout << "  ";
+
+    cout << "d[" << c.key() << "] = " << c.value() << endl;
+
+    recursive_dump(c, level + 1);
+  }
+}
+
+void
+build()
+{
+  using egg::variable;
+  using egg::tree;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking tree build and lookup" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree d;
+
+  d["cmd"]["configuration"] = "/etc/phoenix/test.xml";
+  d["cmd"]["log"]["level"] = 9;
+  d["cmd"]["log"]["file"] = "/var/log/test.log";
+  d["log"]["level"] = 3;
+  d[2][3.14] = true;
+
+  recursive_dump(d.root(), 0);
+
+  expect(d.size() == 9, "size");
+  expect(d.keys() == 7, "keys are interned once");
+  expect(d["cmd"].size() == 2, "children");
+  expect(d["cmd"]["log"]["level"].value() == variable(9), "deep value");
+  expect(d["log"]["level"].value() == variable(3), "same key, other parent");
+  expect(d[2][3.14].value() == variable(true), "non-string keys");
+
+  // Lookups on a const tree never create nodes
+  const tree& c = d;
+
+  expect(!c["cmd"]["missing"], "missing key");
+  expect(!c["missing"]["level"], "missing parent");
+  expect(!c["cmd"]["level"], "key known, but not under the parent");
+  expect(d.size() == 9, "const lookup doesn't grow");
+
+  // Insertion order is kept
+  const char* order[] = { "cmd", "log" };
+  std::size_t i = 0;
+
+  for (const auto n : c.root())
+    if (n.key().type() == variable::content::is_string)
+      expect(n.key() == variable(order[i++]), "order");
+
+  expect(c["cmd"]["log"].parent().key() == variable("cmd"), "parent");
+
+  // Values can be replaced in place
+  d["cmd"]["log"]["level"] = "debug";
+  expect(c["cmd"]["log"]["level"].value() == variable("debug"), "replace");
+
+  d["log"]["level"] = d["cmd"]["log"]["level"];
+  expect(c["log"]["level"].value() == variable("debug"), "assign node to node");
+
+  // Assigning iterators rebinds them, the values stay
+  tree t;
+  t["a"] = 1;
+  t["b"] = 2;
+
+  tree::node::iterator it = t.root().begin(), it2 = ++t.root().begin();
+  it = it2;
+  expect(t["a"].value() == variable(1) && it->key() == variable("b"), "iterator assignment");
+
+  tree::node::iterator e;
+  e = t.root().begin();
+  expect(e->key() == variable("a") && e != t.root().end(), "assign to a default iterator");
+
+  tree::const_node::iterator ce;
+  ce = c.root().begin();
+  expect(ce->key() == variable("cmd"), "assign a const iterator");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+erase()
+{
+  using egg::variable;
+  using egg::tree;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking tree erase, copy and compact" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree d;
+
+  for (int i = 0; i < 100; ++i)
+    for (int j = 0; j < 10; ++j)
+      d["section-" + std::to_string(i)]["key-" + std::to_string(j)] = i * j;
+
+  expect(d.size() == 1100, "size");
+
+  // Middle, first and last children
+  expect(d.root().erase("section-50") == 11, "erase subtree");
+  expect(d.root().erase("section-0") == 11, "erase first");
+  expect(d["section-99"].erase("key-9") == 1, "erase last");
+  expect(d.root().erase("section-50") == 0, "erase missing");
+
+  expect(d.size() == 1077, "size after erase");
+  expect(d.root().size() == 98, "children after erase");
+  expect(!static_cast<const tree&>(d)["section-50"], "erased node is gone");
+
+  std::size_t visited = 0;
+  for (const auto s : static_cast<const tree&>(d).root())
+    for (const auto k : s)
+      visited += k.valid();
+
+  expect(visited == 979, "traversal after erase");
+
+  // Re-adding goes to the end
+  d["section-50"]["key-0"] = 1;
+  expect(d["section-99"].next().key() == variable("section-50"), "append");
+
+  const tree copy(d);
+  d.compact();
+
+  expect(d.size() == copy.size(), "compact keeps size");
+
+  for (int i = 1; i < 100; ++i)
+    for (int j = 0; j < 10; ++j)
+    {
+      const std::string s = "section-" + std::to_string(i);
+      const std::string k = "key-" + std::to_string(j);
+      const tree::const_node a = copy[s][k];
+      const tree::const_node b = static_cast<const tree&>(d)[s][k];
+
+      expect(a.valid() == b.valid(), "compact keeps nodes");
+      expect(!a || a.value() == b.value(), "compact keeps values");
+    }
+
+  d.clear();
+  expect(d.empty() && d.root().empty(), "clear");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+freeze()
+{
+  using egg::variable;
+  using egg::tree;
+  using egg::frozen_map;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking frozen_map of tree" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree d;
+
+  d["cmd"] = "command";
+  d["cmd"]["log"]["level"] = 9;
+  d["log"]["file"] = "/var/log/test.log";
+
+  const frozen_map fm = frozen_map::freeze(d);
+
+  expect(fm.size() == 2, "top level size");
+  expect(*fm["cmd"].value() == variable("command"), "inner node value");
+  expect(fm["cmd"]["log"]["level"].value()->as_int32() == 9, "deep value");
+  expect(fm["log"]["file"].value()->as_string() == "/var/log/test.log", "string value");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Build and look up
+  build();
+
+  // Erase, copy, compact
+  erase();
+
+  // Freeze
+  freeze();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/path.hpp"
+#include "expect.hpp"
+
+void
+parse()
+{
+  using egg::variable;
+  using egg::path;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking path parsing" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const path p("cmd.log.level");
+
+  expect(p.size() == 3, "segments");
+  expect(p[0] == variable("cmd") && p[2] == variable("level"), "segment keys");
+  expect(p.to_string() == "cmd.log.level", "to_string");
+  expect(path("a/b", '/').size() == 2, "separator");
+  expect(path("").empty(), "empty path");
+
+  const path q { "section", 2, 3.14 };
+  expect(q.size() == 3 && q[1] == variable(2), "typed keys");
+
+  // Empty keys can't be parsed, but built paths print them
+  expect(path { variable(""), "a" }.to_string() == ".a", "leading empty key");
+  expect(path { "a", variable(""), "b" }.to_string() == "a..b", "inner empty key");
+
+  for (const char* bad : { ".a", "a.", "a..b" })
+  {
+    bool thrown = false;
+    try { path r(bad); } catch (const std::invalid_argument&) { thrown = true; }
+    expect(thrown, std::string("empty segment in ") + bad);
+  }
+
+  cout << p.to_string() << ", " << q.to_string('/') << endl;
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+lookup()
+{
+  using egg::variable;
+  using egg::path;
+  using egg::tree;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking path lookup and cache" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree d;
+  const tree& c = d;
+
+  d["cmd"]["log"]["level"] = 9;
+  d["section"][2][3.14] = true;
+
+  const path level("cmd.log.level");
+  const path typed { "section", 2, 3.14 };
+  const path missing("cmd.log.file");
+
+  expect(level.find(c).value() == variable(9), "find");
+  expect(level.resolve(c).value() == variable(9), "resolve");
+  expect(typed.find(c).value() == variable(true), "typed find");
+  expect(!missing.find(c), "missing");
+  expect(path().find(c).index() == c.root().index(), "empty path is the root");
+
+  // Value changes are seen through the cache
+  d["cmd"]["log"]["level"] = 3;
+  expect(level.find(c).value() == variable(3), "cached node, live value");
+
+  // Structural changes invalidate the cache
+  const std::uint64_t g = c.generation();
+
+  missing.make(d) = "/var/log/test.log";
+  expect(c.generation() != g, "generation changed");
+  expect(missing.find(c).value() == variable("/var/log/test.log"), "make");
+
+  d["cmd"].erase("log");
+  expect(!level.find(c) && !missing.find(c), "erased");
+
+  level.make(d) = 7;
+  expect(level.find(c).value() == variable(7), "recreated");
+
+  d.compact();
+  expect(level.find(c).value() == variable(7), "after compact");
+
+  // Another tree with the same keys
+  tree other;
+  other["cmd"]["log"]["level"] = 1;
+
+  expect(level.find(other).value() == variable(1), "other tree");
+  expect(level.find(c).value() == variable(7), "back to the first tree");
+
+  // A copy shares the structure
+  tree copy(d);
+  copy["cmd"]["log"]["level"] = 5;
+  expect(level.find(copy).value() == variable(5), "copy");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Parse
+  parse();
+
+  // Look up
+  lookup();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,185 @@
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/atomic_variable.hpp"
+#include "expect.hpp"
+
+void
+single()
+{
+  using egg::variable;
+  using egg::atomic_variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking atomic_variable values" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable::stringlist list = { "one", "two", "three" };
+  const std::vector<variable> values = {
+    variable(), variable(true), variable(false),
+    variable(std::int8_t(-5)), variable(std::uint8_t(200)),
+    variable(std::int16_t(-30000)), variable(std::uint16_t(60000)),
+    variable(std::int32_t(-2000000000)), variable(std::uint32_t(4000000000u)),
+    variable(std::int64_t(-(std::int64_t(1) << 55))), variable(std::int64_t((std::int64_t(1) << 55) - 1)),
+    variable(std::int64_t(1) << 60), variable(-(std::int64_t(1) << 60)),
+    variable(std::uint64_t(1) << 55), variable(~std::uint64_t(0)),
+    variable(3.14f), variable(2.718281828), variable(1.5L),
+    variable("string"), variable(list) };
+
+  atomic_variable a;
+  expect(a.load().is_empty(), "empty by default");
+
+  for (const variable& v : values)
+  {
+    a.store(v);
+
+    const variable l = a.load();
+    cout << v.to_type_string() << ": " << l
+         << (atomic_variable::is_inline(v) ? " (inline)" : " (boxed)") << endl;
+
+    expect(l == v && l.type() == v.type(), "round trip of " + v.to_string());
+    expect(l.hash() == v.hash(), "hash of " + v.to_string());
+    expect(a.type() == v.type(), "type of " + v.to_string());
+  }
+
+  expect(atomic_variable::is_inline(std::int64_t(1) << 54), "small int64 is inline");
+  expect(!atomic_variable::is_inline(std::int64_t(1) << 60), "large int64 is boxed");
+  expect(!atomic_variable::is_inline("string"), "string is boxed");
+
+  // Exchange and compare-exchange
+  a = variable("first");
+  expect(a.exchange(42).as_string() == "first", "exchange returns the old value");
+
+  variable expected = 41;
+  expect(!a.compare_exchange(expected, 43), "compare_exchange fails");
+  expect(expected == variable(42), "compare_exchange loads the current value");
+  expect(a.compare_exchange(expected, "forty three"), "compare_exchange succeeds");
+
+  expected = variable("forty three");
+  expect(a.compare_exchange(expected, list), "compare_exchange of heap values");
+  expect(a.load() == variable(list), "after compare_exchange");
+
+  std::size_t size = 0;
+  a.read([&size](const variable& v) { size = v.as_string_list().size(); });
+  expect(size == 3, "read");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+concurrent()
+{
+  using egg::variable;
+  using egg::atomic_variable;
+  using egg::epoch_domain;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking atomic_variable under contention" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  epoch_domain domain;
+
+  // Readers must always see a whole value, never a freed one
+  {
+    atomic_variable shared(variable("value-0"), domain);
+    std::atomic<bool> stop(false);
+    std::atomic<std::size_t> torn(0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+      threads.emplace_back([&] {
+        while (!stop.load())
+        {
+          const variable v = shared.load();
+
+          if (v.type() == variable::content::is_string)
+          {
+            const std::string& s = v.as_string();
+            if (s.compare(0, 6, "value-") != 0 || variable(s).hash() != v.hash())
+              ++torn;
+          }
+          else if (v.type() != variable::content::is_int32)
+            ++torn;
+        }
+      });
+
+    for (int t = 0; t < 2; ++t)
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < 20000; ++i)
+          if (i % 3 == 0)
+            shared.store(i);
+          else
+            shared.store("value-" + std::to_string(t) + "-" + std::to_string(i));
+      });
+
+    for (std::size_t t = 4; t < threads.size(); ++t)
+      threads[t].join();
+
+    stop = true;
+
+    for (std::size_t t = 0; t < 4; ++t)
+      threads[t].join();
+
+    expect(torn == 0, "readers see whole values");
+  }
+
+  // Increments through compare_exchange, inline and boxed
+  {
+    atomic_variable small(std::int64_t(0), domain);
+    atomic_variable large(std::int64_t(1) << 60, domain);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+      threads.emplace_back([&] {
+        for (int i = 0; i < 5000; ++i)
+        {
+          variable e = small.load();
+          while (!small.compare_exchange(e, e.as_int64() + 1))
+            ;
+
+          e = large.load();
+          while (!large.compare_exchange(e, e.as_int64() + 1))
+            ;
+        }
+      });
+
+    for (auto& t : threads)
+      t.join();
+
+    expect(small.load().as_int64() == 20000, "inline increments");
+    expect(large.load().as_int64() == (std::int64_t(1) << 60) + 20000, "boxed increments");
+  }
+
+  // Nobody reads any more, everything retired can go
+  domain.collect();
+  domain.collect();
+  domain.collect();
+
+  cout << "pending after collect: " << domain.pending() << endl;
+  expect(domain.pending() == 0, "reclaimed");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Single thread semantics
+  single();
+
+  // Readers and writers
+  concurrent();
+
+  return 0;
+}
+
+/* End of file */
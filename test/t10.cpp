@@ -0,0 +1,152 @@
+#include <map>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/snapshot.hpp"
+#include "expect.hpp"
+
+typedef std::map<egg::variable, egg::variable> variable_map;
+
+// Counts live copies, to see versions reclaimed
+struct counted
+{
+  counted() noexcept { ++alive; }
+  counted(const counted& o) noexcept : value(o.value) { ++alive; }
+  ~counted() noexcept { --alive; }
+
+  int value = 0;
+
+  static std::atomic<int> alive;
+};
+
+std::atomic<int> counted::alive(0);
+
+void
+versions()
+{
+  using egg::variable;
+  using egg::epoch_domain;
+  using egg::snapshot_registry;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking snapshot versions" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  epoch_domain domain;
+  snapshot_registry<variable_map> registry(variable_map { { "level", 1 } }, domain);
+
+  expect(registry.version() == 1, "first version");
+
+  {
+    const auto old = registry.acquire();
+
+    variable_map next(*old);
+    next["level"] = 2;
+    next["file"] = "/var/log/test.log";
+
+    expect(registry.publish(next) == 2, "publish");
+
+    // The held snapshot doesn't change
+    expect(old->at("level") == variable(1) && old->size() == 1, "old snapshot");
+    expect(old.version() == 1, "old version");
+
+    const auto now = registry.acquire();
+    expect(now->at("level") == variable(2) && now.version() == 2, "new snapshot");
+  }
+
+  expect(registry.update([](variable_map& m) { m["level"] = 3; }) == 3, "update");
+  expect(registry.read([](const variable_map& m) { return m.at("level").as_int32(); }) == 3, "read");
+
+  cout << "version " << registry.version() << ", level = "
+       << registry.acquire()->at("level") << endl;
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+concurrent()
+{
+  using egg::epoch_domain;
+  using egg::snapshot_registry;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking snapshot reclamation under reloads" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  {
+    epoch_domain domain;
+
+    {
+      snapshot_registry<counted> registry(counted(), domain);
+      std::atomic<bool> stop(false);
+      std::atomic<std::size_t> backwards(0);
+      std::vector<std::thread> threads;
+
+      for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] {
+          std::uint64_t last = 0;
+          while (!stop.load())
+          {
+            const auto s = registry.acquire();
+            if (s.version() < last || s->value != static_cast<int>(s.version()) - 1)
+              ++backwards;
+            last = s.version();
+          }
+        });
+
+      // Two writers, every update must land exactly once
+      std::vector<std::thread> writers;
+      for (int t = 0; t < 2; ++t)
+        writers.emplace_back([&] {
+          for (int i = 0; i < 5000; ++i)
+            registry.update([](counted& c) { ++c.value; });
+        });
+
+      for (auto& w : writers)
+        w.join();
+
+      stop = true;
+
+      for (auto& t : threads)
+        t.join();
+
+      expect(backwards == 0, "readers see consistent, monotonic versions");
+      expect(registry.version() == 10001, "no lost updates");
+      expect(registry.acquire()->value == 10000, "all updates applied");
+
+      domain.collect();
+      domain.collect();
+      domain.collect();
+
+      cout << "alive after collect: " << counted::alive << endl;
+      expect(counted::alive == 1, "old versions reclaimed");
+    }
+  }
+
+  expect(counted::alive == 0, "registry and domain release everything");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Versions
+  versions();
+
+  // Readers during reloads
+  concurrent();
+
+  return 0;
+}
+
+/* End of file */
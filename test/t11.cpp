@@ -0,0 +1,129 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/concurrent_map.hpp"
+#include "expect.hpp"
+
+void
+single()
+{
+  using egg::variable;
+  using egg::concurrent_map;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking concurrent_map operations" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  concurrent_map<> m;
+  variable v;
+
+  expect(m.shards() >= 16 && (m.shards() & (m.shards() - 1)) == 0, "shards");
+  expect(m.empty() && !m.get("one", v), "empty");
+
+  expect(m.put("one", 1), "put inserts");
+  expect(!m.put("one", "two"), "put replaces");
+  expect(m.get("one", v) && v == variable("two"), "get");
+
+  expect(!m.insert("one", 3), "insert keeps the value");
+  expect(m.insert(2, 3.14), "insert");
+  expect(m.contains(2) && m.size() == 2, "contains");
+
+  int made = 0;
+  expect(m.compute_if_absent(2, [&made] { ++made; return variable(); }) == variable(3.14), "existing");
+  expect(m.compute_if_absent(3, [&made] { ++made; return variable("three"); }) == variable("three"), "made");
+  expect(made == 1, "make called once");
+
+  expect(m.update("one", [](variable& x) { x = x.as_string() + "!"; }), "update");
+  expect(!m.update("missing", [](variable& x) { x = 0; }), "update missing");
+
+  std::string seen;
+  expect(m.visit("one", [&seen](const variable& x) { seen = x.as_string(); }) && seen == "two!", "visit");
+
+  std::size_t n = 0;
+  m.for_each([&n](const variable& k, const variable& x) {
+    std::cout << "m[" << k << "] = " << x << std::endl;
+    ++n;
+  });
+  expect(n == 3, "for_each");
+
+  expect(m.erase("one") == 1 && m.erase("one") == 0, "erase");
+  expect(m.size() == 2, "size after erase");
+
+  m.clear();
+  expect(m.empty(), "clear");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+concurrent()
+{
+  using egg::variable;
+  using egg::concurrent_map;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking concurrent_map from many threads" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  concurrent_map<std::int64_t> m(8);
+  std::vector<std::thread> threads;
+  std::atomic<int> made(0);
+
+  const int threads_count = 8;
+  const int keys = 2000;
+
+  for (int t = 0; t < threads_count; ++t)
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < keys; ++i)
+      {
+        // Own keys
+        m.put("own-" + std::to_string(t) + "-" + std::to_string(i), i);
+
+        // Shared keys, built by exactly one thread
+        m.compute_if_absent("shared-" + std::to_string(i), [&made, i] { ++made; return std::int64_t(i); });
+
+        // Shared counters
+        m.insert("counter", 0);
+        m.update("counter", [](std::int64_t& c) { ++c; });
+
+        if (i % 2)
+          m.erase("own-" + std::to_string(t) + "-" + std::to_string(i - 1));
+      }
+    });
+
+  for (auto& t : threads)
+    t.join();
+
+  std::int64_t counter = 0;
+
+  expect(made == keys, "compute_if_absent builds once per key");
+  expect(m.get("counter", counter) && counter == threads_count * keys, "updates are atomic");
+  expect(m.size() == std::size_t(threads_count * keys / 2 + keys + 1), "size");
+
+  cout << "size: " << m.size() << ", counter: " << counter << endl;
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Single thread semantics
+  single();
+
+  // Many threads
+  concurrent();
+
+  return 0;
+}
+
+/* End of file */
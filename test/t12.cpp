@@ -0,0 +1,275 @@
+#include <new>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/watchable_store.hpp"
+#include "expect.hpp"
+
+// Count allocations to check the steady state
+static std::atomic<std::size_t> allocations(0);
+
+void*
+operator new(
+  std::size_t size)
+{
+  ++allocations;
+
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(
+  void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(
+  void*       p,
+  std::size_t) noexcept
+{
+  std::free(p);
+}
+
+// Runs every delivery on its own thread, joined by the next flush
+struct thread_executor : egg::watchable_store::executor
+{
+  void execute(void (*fn)(void*), void* argument) override
+  {
+    _threads.emplace_back(fn, argument);
+  }
+
+  void join()
+  {
+    for (auto& t : _threads)
+      t.join();
+    _threads.clear();
+  }
+
+  std::vector<std::thread> _threads;
+};
+
+// Takes one delivery, then fails
+struct failing_executor : thread_executor
+{
+  void execute(void (*fn)(void*), void* argument) override
+  {
+    if (!_threads.empty())
+      throw std::runtime_error("executor is full");
+
+    thread_executor::execute(fn, argument);
+  }
+};
+
+void
+notify()
+{
+  using egg::variable;
+  using egg::watchable_store;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking watchable_store notifications" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  watchable_store store;
+
+  std::vector<std::string> level, log;
+  std::size_t level_batches = 0, log_batches = 0;
+
+  const auto a = store.subscribe("log.level", [&](const watchable_store::batch& b) {
+    ++level_batches;
+    for (std::size_t i = 0; i < b.size(); ++i)
+      level.push_back(b[i].value().to_string());
+  });
+
+  store.subscribe_prefix("log.", [&](const watchable_store::batch& b) {
+    ++log_batches;
+    for (std::size_t i = 0; i < b.size(); ++i)
+    {
+      cout << "  " << b[i].key() << " = " << b[i].value() << endl;
+      log.push_back(b[i].key().to_string());
+    }
+  });
+
+  expect(store.set("log.level", 1), "set");
+  expect(store.set("log.level", 2), "set again");
+  expect(store.set("log.file", "/var/log/test.log"), "set other");
+  expect(store.set("cmd.level", 9), "set unwatched");
+  expect(store.pending() == 3, "coalesced");
+
+  expect(store.flush() == 3, "flush");
+  expect(level_batches == 1 && level.size() == 1 && level[0] == "2", "last value only");
+  expect(log_batches == 1 && log.size() == 2, "prefix batch");
+
+  // Same value: nothing to say
+  expect(!store.set("log.level", 2), "unchanged write");
+  expect(store.suppressed() == 1 && store.pending() == 0, "suppressed");
+  expect(store.flush() == 0 && level_batches == 1, "no empty batches");
+
+  // Same hash, different type
+  expect(store.set("log.level", std::int64_t(2)), "type change");
+
+  // Erase reports an empty value
+  expect(store.erase("log.file") && !store.erase("missing"), "erase");
+  store.flush();
+
+  expect(level.back() == "2" && level_batches == 2, "type change delivered");
+  expect(log.back() == "log.file" && log_batches == 2, "erase delivered");
+
+  variable v;
+  expect(!store.get("log.file", v) && store.get("cmd.level", v) && v == variable(9), "get");
+  expect(store.size() == 2, "size");
+
+  expect(store.unsubscribe(a) && !store.unsubscribe(a), "unsubscribe");
+  store.set("log.level", 3);
+  store.flush();
+  expect(level_batches == 2 && log_batches == 3, "unsubscribed");
+
+  // A throwing callback doesn't stop the others, flush() rethrows
+  const auto c = store.subscribe("cmd.level", [](const watchable_store::batch&) {
+    throw std::logic_error("callback failed");
+  });
+
+  store.subscribe("cmd.level", [&](const watchable_store::batch&) { ++level_batches; });
+  store.set("cmd.level", 10);
+
+  bool thrown = false;
+
+  try
+  {
+    store.flush();
+  }
+  catch (const std::logic_error&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown && level_batches == 3, "callback exception");
+
+  store.unsubscribe(c);
+  store.set("cmd.level", 11);
+  expect(store.flush() == 1 && level_batches == 4, "exception cleared");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+steady()
+{
+  using egg::variable;
+  using egg::watchable_store;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking watchable_store steady state" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  watchable_store store;
+  std::size_t seen = 0;
+
+  store.subscribe_prefix("module.", [&seen](const watchable_store::batch& b) { seen += b.size(); });
+  store.subscribe("module.key-7", [&seen](const watchable_store::batch& b) { seen += b.size(); });
+
+  std::vector<variable> keys, values[2];
+
+  for (int i = 0; i < 100; ++i)
+  {
+    keys.push_back("module.key-" + std::to_string(i));
+    values[0].push_back(i % 2 ? variable(i) : variable("a string value that allocates " + std::to_string(i)));
+    values[1].push_back(i % 2 ? variable(-i) : variable("another string value, allocates " + std::to_string(i)));
+  }
+
+  // Warm up: slots, buffers and selections grow to size
+  for (int round = 0; round < 2; ++round)
+  {
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      store.set(keys[i], values[round][i]);
+    store.flush();
+  }
+
+  const std::size_t before = allocations;
+
+  for (int round = 0; round < 10; ++round)
+  {
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      store.set(keys[i], values[round % 2][i]);
+    store.flush();
+  }
+
+  const std::size_t during = allocations - before;
+
+  cout << "allocations in 10 rounds of 100 writes: " << during << endl;
+  expect(during == 0, "no allocations in steady state");
+  expect(seen == 12 * 101, "deliveries");
+
+  // Deliveries on other threads
+  thread_executor executor;
+  watchable_store async(executor);
+  std::atomic<std::size_t> changes(0);
+
+  for (int s = 0; s < 4; ++s)
+    async.subscribe_prefix("module.", [&changes](const watchable_store::batch& b) { changes += b.size(); });
+
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    async.set(keys[i], values[0][i]);
+
+  async.flush();
+  executor.join();
+
+  expect(changes == 4 * keys.size(), "async deliveries");
+
+  // The batches a failing executor didn't take run on the flushing thread
+  failing_executor failing;
+  watchable_store partial(failing);
+  changes = 0;
+
+  for (int s = 0; s < 3; ++s)
+    partial.subscribe_prefix("module.", [&changes](const watchable_store::batch& b) { changes += b.size(); });
+
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    partial.set(keys[i], values[0][i]);
+
+  bool thrown = false;
+
+  try
+  {
+    partial.flush();
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+
+  failing.join();
+
+  expect(thrown && changes == 3 * keys.size(), "failing executor");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Notifications
+  notify();
+
+  // Allocation-free steady state
+  steady();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,166 @@
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable_queue.hpp"
+#include "expect.hpp"
+
+template <typename Q>
+void
+single(
+  const std::string& name)
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking " << name << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  Q q(3);
+  variable out;
+
+  expect(q.capacity() == 4, "capacity is a power of two");
+  expect(q.empty() && !q.try_pop(out), "empty");
+
+  variable s("a string long enough to live on the heap");
+  const std::string* payload = &s.as_string();
+
+  expect(q.try_push(std::move(s)) && s.is_empty(), "moved in");
+  expect(q.try_push(variable(2)) && q.try_push(variable(3.14)) && q.try_push(variable(true)), "push");
+
+  variable extra(5);
+  expect(!q.try_push(std::move(extra)) && extra == variable(5), "full keeps the value");
+  expect(q.size() == 4, "size");
+
+  expect(q.try_pop(out) && &out.as_string() == payload, "moved out, not copied");
+  expect(q.try_pop(out) && out == variable(2), "order");
+  expect(q.try_push(std::move(extra)), "push after pop wraps around");
+  expect(q.try_pop(out) && out == variable(3.14), "order after wrap");
+  expect(q.try_pop(out) && out == variable(true), "order after wrap");
+  expect(q.try_pop(out) && out == variable(5), "wrapped element");
+  expect(!q.try_pop(out) && q.empty(), "drained");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+spsc_threads()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking spsc_variable_queue between threads" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  egg::spsc_variable_queue q(64);
+  const int count = 100000;
+
+  std::thread producer([&q] {
+    for (int i = 0; i < count; ++i)
+    {
+      variable v = i % 4 ? variable(i) : variable("message " + std::to_string(i));
+      while (!q.try_push(std::move(v)))
+        std::this_thread::yield();
+    }
+  });
+
+  int next = 0;
+  variable out;
+
+  while (next < count)
+  {
+    if (!q.try_pop(out))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const variable expected = next % 4 ? variable(next) : variable("message " + std::to_string(next));
+    expect(out == expected, "message " + std::to_string(next));
+    ++next;
+  }
+
+  producer.join();
+  expect(q.empty(), "drained");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+mpsc_threads()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking mpsc_variable_queue between threads" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  egg::mpsc_variable_queue q(64);
+  const int producers = 4;
+  const int count = 25000;
+  std::vector<std::thread> threads;
+
+  // Producer in the high bits, sequence in the low ones
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&q, p] {
+      for (int i = 0; i < count; ++i)
+      {
+        variable v(static_cast<std::int64_t>(p) << 32 | i);
+        while (!q.try_push(std::move(v)))
+          std::this_thread::yield();
+      }
+    });
+
+  std::vector<std::int64_t> next(producers, 0);
+  variable out;
+
+  for (int received = 0; received < producers * count; )
+  {
+    if (!q.try_pop(out))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const std::int64_t x = out.as_int64();
+    const int p = static_cast<int>(x >> 32);
+
+    expect((x & 0xffffffff) == next[p]++, "per producer order");
+    ++received;
+  }
+
+  for (auto& t : threads)
+    t.join();
+
+  for (int p = 0; p < producers; ++p)
+    expect(next[p] == count, "all messages of producer " + std::to_string(p));
+
+  expect(q.empty(), "drained");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Single thread semantics
+  single<egg::spsc_variable_queue>("spsc_variable_queue");
+  single<egg::mpsc_variable_queue>("mpsc_variable_queue");
+
+  // Between threads
+  spsc_threads();
+  mpsc_threads();
+
+  return 0;
+}
+
+/* End of file */
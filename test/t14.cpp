@@ -0,0 +1,231 @@
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/binary.hpp"
+#include "expect.hpp"
+
+static egg::variable
+round_trip(
+  const egg::variable& v)
+{
+  std::vector<std::uint8_t> buffer;
+
+  const std::size_t n = egg::encode(v, buffer);
+  expect(n == egg::encoded_size(v) && n == buffer.size(), "encoded size of " + v.to_string());
+
+  egg::variable r;
+  expect(egg::decode(buffer.data(), buffer.size(), r) == n, "decoded size of " + v.to_string());
+  expect(r.type() == v.type(), "type of " + v.to_string());
+
+  return r;
+}
+
+void
+scalars()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking binary round trip of scalars" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable values[] = {
+    variable(),
+    variable(true),
+    variable(false),
+    variable(std::int8_t(-128)),
+    variable(std::uint8_t(255)),
+    variable(std::int16_t(-32768)),
+    variable(std::uint16_t(65535)),
+    variable(std::int32_t(-1)),
+    variable(std::uint32_t(4000000000u)),
+    variable(std::numeric_limits<std::int64_t>::min()),
+    variable(std::numeric_limits<std::int64_t>::max()),
+    variable(std::numeric_limits<std::uint64_t>::max()),
+    variable(1.5f),
+    variable(1.0 / 3.0),
+    variable(std::numeric_limits<double>::infinity()),
+    variable(std::numeric_limits<double>::denorm_min()),
+    variable(1.0L / 3.0L),
+    variable(std::numeric_limits<long double>::max()),
+    variable(-std::numeric_limits<long double>::denorm_min()),
+    variable(-std::numeric_limits<long double>::infinity()) };
+
+  for (const variable& v : values)
+  {
+    cout << v.type() << endl;
+    expect(round_trip(v) == v, "value of " + v.to_string());
+  }
+
+  // Sign of zero and NaN survive, they compare unequal by value
+  expect(std::signbit(round_trip(variable(-0.0)).as_double()), "negative zero");
+  expect(std::isnan(round_trip(variable(std::nan(""))).as_double()), "nan");
+  expect(std::signbit(round_trip(variable(-0.0L)).as_long_double()), "negative long zero");
+  expect(std::isnan(round_trip(variable(std::nanl(""))).as_long_double()), "long nan");
+
+  // Small integers take two bytes whatever the width
+  expect(egg::encoded_size(variable(std::int64_t(-3))) == 2, "zig-zag");
+  expect(egg::encoded_size(variable(std::uint64_t(127))) == 2, "varint");
+  expect(egg::encoded_size(variable(std::numeric_limits<std::uint64_t>::max())) == 11, "longest varint");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+strings()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking binary round trip of strings and lists" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::string zero("a\0b", 3);
+
+  expect(round_trip(variable("")) == variable(""), "empty string");
+  expect(round_trip(variable("a,b,c")) == variable("a,b,c"), "string with commas");
+  expect(round_trip(variable(zero)).as_string() == zero, "string with zero");
+  expect(round_trip(variable(std::string(300, 'x'))).as_string().size() == 300, "long string");
+
+  const variable::stringlist lists[] = {
+    variable::stringlist(),
+    variable::stringlist { "" },
+    variable::stringlist { "a,b", "", "c" },
+    variable::stringlist { zero, std::string(200, 'y') } };
+
+  for (const variable::stringlist& l : lists)
+    expect(round_trip(variable(l)).as_string_list() == l, "list of " + std::to_string(l.size()));
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+views()
+{
+  using egg::variable;
+  using egg::variable_view;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking zero-copy views" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  std::vector<std::uint8_t> buffer;
+
+  egg::encode(variable("hello"), buffer);
+  egg::encode(variable(variable::stringlist { "x", "yz" }), buffer);
+  egg::encode(variable(std::int16_t(-300)), buffer);
+  egg::encode(variable(2.5), buffer);
+
+  const std::uint8_t* p = buffer.data();
+  const std::uint8_t* end = p + buffer.size();
+  variable_view v;
+
+  p += egg::decode(p, end - p, v);
+  expect(v.as_string() == "hello", "string view");
+  expect(reinterpret_cast<const std::uint8_t*>(v.data()) > buffer.data() &&
+         reinterpret_cast<const std::uint8_t*>(v.data()) < end, "view points into the buffer");
+
+  p += egg::decode(p, end - p, v);
+  std::string joined;
+  v.each([&joined](const char* s, std::size_t n) { joined.append(s, n).append("|"); });
+  expect(v.count() == 2 && joined == "x|yz|", "list view");
+
+  p += egg::decode(p, end - p, v);
+  expect(v.type() == variable::content::is_int16 && v.as_int64() == -300, "integer view");
+
+  p += egg::decode(p, end - p, v);
+  expect(v.as_double() == 2.5 && v.materialize() == variable(2.5), "double view");
+  expect(p == end, "whole buffer consumed");
+
+  bool thrown = false;
+  try { v.as_string(); } catch (const std::invalid_argument&) { thrown = true; }
+  expect(thrown, "type mismatch throws");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+malformed()
+{
+  using egg::variable;
+  using egg::variable_view;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking malformed input and small buffers" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable values[] = {
+    variable(std::numeric_limits<std::int64_t>::min()),
+    variable(1.0L / 3.0L),
+    variable("some string"),
+    variable(variable::stringlist { "a", "bc", "def" }) };
+
+  for (const variable& v : values)
+  {
+    std::vector<std::uint8_t> buffer;
+    egg::encode(v, buffer);
+
+    variable_view view;
+
+    // Every truncation is detected
+    for (std::size_t n = 0; n < buffer.size(); ++n)
+      expect(egg::decode(buffer.data(), n, view) == 0, "truncated " + v.to_string());
+
+    // Encoding never writes past the capacity
+    std::vector<std::uint8_t> small(buffer.size() + 1, 0xee);
+    expect(egg::encode(v, small.data(), buffer.size() - 1) == 0, "too small buffer");
+    expect(egg::encode(v, small.data(), buffer.size()) == buffer.size(), "exact buffer");
+    expect(small.back() == 0xee, "no overrun");
+  }
+
+  variable_view view;
+
+  const std::uint8_t bad_tag[] = { 0x7f };
+  expect(egg::decode(bad_tag, sizeof(bad_tag), view) == 0, "unknown tag");
+
+  const std::uint8_t bad_bool[] = { 1, 2 };
+  expect(egg::decode(bad_bool, sizeof(bad_bool), view) == 0, "bool out of range");
+
+  const std::uint8_t bad_uint8[] = { 3, 0x80, 0x02 };
+  expect(egg::decode(bad_uint8, sizeof(bad_uint8), view) == 0, "uint8 out of range");
+
+  const std::uint8_t long_varint[] = { 9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02 };
+  expect(egg::decode(long_varint, sizeof(long_varint), view) == 0, "varint overflow");
+
+  const std::uint8_t huge_list[] = { 14, 0xff, 0xff, 0xff, 0xff, 0x0f };
+  expect(egg::decode(huge_list, sizeof(huge_list), view) == 0, "list count beyond the data");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Scalars
+  scalars();
+
+  // Strings and string lists
+  strings();
+
+  // Zero-copy views
+  views();
+
+  // Malformed input
+  malformed();
+
+  return 0;
+}
+
+/* End of file */
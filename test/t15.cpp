@@ -0,0 +1,196 @@
+#include <map>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/mapped_tree.hpp"
+#include "expect.hpp"
+
+static const char* _file = "t15.snapshot";
+
+static bool
+rejected(
+  const std::string& file,
+  const bool         verify)
+{
+  try
+  {
+    egg::mapped_tree::open(file, verify);
+  }
+  catch (const std::runtime_error& e)
+  {
+    std::cout << e.what() << std::endl;
+    return true;
+  }
+
+  return false;
+}
+
+// Overwrite one byte of the file
+static void
+damage(
+  const std::size_t offset)
+{
+  std::fstream f(_file, std::ios::in | std::ios::out | std::ios::binary);
+  f.seekg(offset);
+
+  char c = 0;
+  f.get(c);
+  f.seekp(offset);
+  f.put(static_cast<char>(c ^ 0x5a));
+}
+
+void
+round_trip()
+{
+  using egg::variable;
+  using egg::tree;
+  using egg::mapped_tree;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking mapped tree write, open and lookup" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree t;
+
+  t["cmd"] = "command";
+  t["cmd"]["configuration"] = "/etc/phoenix/test.xml";
+  t["cmd"]["log"]["level"] = 9;
+  t["cmd"]["log"]["file"] = "/var/log/test.log";
+  t["log"]["level"] = 3;
+  t["log"]["tags"] = variable::stringlist { "a", "b,c" };
+  t[2][3.14] = 2.5L;
+
+  for (int i = 0; i < 1000; ++i)
+    t["many"]["key-" + std::to_string(i)] = i;
+
+  mapped_tree::write(t, _file);
+
+  const mapped_tree m = mapped_tree::open(_file);
+
+  cout << m.size() << " nodes, " << m.keys() << " keys, " << m.bytes() << " bytes" << endl;
+
+  expect(m.is_open(), "open");
+  expect(m.size() == t.size(), "size");
+  expect(m.keys() == t.keys(), "keys are interned once");
+
+  expect(m["cmd"].value().as_string() == "command", "inner node value");
+  expect(m["cmd"]["log"]["level"].value().as_int64() == 9, "deep value");
+  expect(m["log"]["level"].value().as_int64() == 3, "same key, other parent");
+  expect(m["log"]["tags"].value().materialize() == t["log"]["tags"].value(), "string list");
+  expect(m[2][3.14].value().as_long_double() == 2.5L, "non-string keys");
+  expect(m["many"]["key-777"].value().as_int64() == 777, "wide level");
+  expect(m["many"].size() == 1000, "children");
+
+  expect(!m["missing"], "missing key");
+  expect(!m["cmd"]["level"], "key known, but not under the parent");
+  expect(!m["missing"]["level"], "missing parent");
+  expect(!m[std::string(1000, 'x')], "long key");
+
+  // Children keep the order
+  const mapped_tree::node cmd = m["cmd"];
+  expect(cmd.child(0).key().as_string() == "configuration", "first child");
+  expect(cmd.child(1).key().as_string() == "log", "second child");
+  expect(!cmd.child(2), "past the children");
+  expect(cmd.child(1).parent().index() == cmd.index(), "parent");
+
+  // Back to a tree
+  const tree l = m.load();
+  expect(l.size() == t.size(), "load size");
+  expect(l["cmd"]["log"]["file"].value() == t["cmd"]["log"]["file"].value(), "load value");
+  expect(l["many"]["key-999"].value() == variable(999), "load wide level");
+
+  // Maps
+  std::map<variable, variable> flat { { "a", 1 }, { "b", "two" } };
+  mapped_tree::write_map(flat, _file);
+
+  mapped_tree f = mapped_tree::open(_file);
+  expect(f.size() == 2 && f["b"].value().as_string() == "two", "map");
+
+  // Still mapped after the file is replaced
+  expect(m["cmd"]["log"]["level"].value().as_int64() == 9, "old mapping");
+
+  mapped_tree moved(std::move(f));
+  expect(!f.is_open() && moved["a"].value().as_int64() == 1, "move");
+
+  std::remove(_file);
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+validation()
+{
+  using egg::tree;
+  using egg::mapped_tree;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking mapped tree validation" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree t;
+
+  for (int i = 0; i < 100; ++i)
+    t["section-" + std::to_string(i)]["key"] = "value-" + std::to_string(i);
+
+  expect(rejected("missing.snapshot", true), "missing file");
+
+  // Not a snapshot
+  {
+    std::ofstream out(_file, std::ios::binary | std::ios::trunc);
+    out << std::string(200, 'x');
+  }
+  expect(rejected(_file, false), "bad magic");
+
+  // Truncated
+  mapped_tree::write(t, _file);
+
+  std::size_t size = 0;
+  {
+    std::ifstream in(_file, std::ios::binary | std::ios::ate);
+    size = static_cast<std::size_t>(in.tellg());
+  }
+
+  {
+    std::string image(size, 0);
+    std::ifstream in(_file, std::ios::binary);
+    in.read(&image[0], size);
+    in.close();
+
+    std::ofstream out(_file, std::ios::binary | std::ios::trunc);
+    out.write(image.data(), size - 10);
+  }
+  expect(rejected(_file, false), "truncated file");
+
+  // A flipped byte in the values passes the cheap check only
+  mapped_tree::write(t, _file);
+  damage(size - 5);
+
+  expect(!rejected(_file, false), "unverified open trusts the content");
+  expect(rejected(_file, true), "checksum");
+
+  std::remove(_file);
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Write, open, look up
+  round_trip();
+
+  // Damaged files
+  validation();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,213 @@
+#include <limits>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/json.hpp"
+#include "expect.hpp"
+
+static bool
+rejected(
+  const std::string& text)
+{
+  try
+  {
+    egg::json::read_tree(text);
+  }
+  catch (const std::invalid_argument& e)
+  {
+    std::cout << text << ": " << e.what() << std::endl;
+    return true;
+  }
+
+  return false;
+}
+
+void
+values()
+{
+  using egg::variable;
+  using egg::json;
+  using std::cout;
+  using std::endl;
+
+  typedef variable::content content;
+
+  cout << "Checking JSON values and integer widths" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  expect(json::read_value("null").is_empty(), "null");
+  expect(json::read_value(" true ") == variable(true), "true");
+  expect(json::read_value("false") == variable(false), "false");
+
+  expect(json::read_value("5").type() == content::is_int8, "int8");
+  expect(json::read_value("-200").type() == content::is_int16, "int16");
+  expect(json::read_value("70000").type() == content::is_int32, "int32");
+  expect(json::read_value("5000000000").as_int64() == 5000000000ll, "int64");
+  expect(json::read_value("-9223372036854775808").as_int64() == std::numeric_limits<std::int64_t>::min(), "int64 min");
+  expect(json::read_value("18446744073709551615").as_uint64() == std::numeric_limits<std::uint64_t>::max(), "uint64 max");
+  expect(json::read_value("18446744073709551616").type() == content::is_double, "beyond uint64");
+  expect(json::read_value("5", false).type() == content::is_int64, "no narrowing");
+
+  expect(json::read_value("1.5").as_double() == 1.5, "fraction");
+  expect(json::read_value("-2.5e-3").as_double() == -2.5e-3, "exponent");
+  expect(json::read_value("1E3").type() == content::is_double, "integer with exponent");
+
+  expect(json::read_value("\"a\\n\\u00e9\\ud83d\\ude00\\/\"").as_string() == "a\n\xc3\xa9\xf0\x9f\x98\x80/", "escapes");
+  expect(json::read_value("[\"a\", \"b,c\", \"\"]").as_string_list() == variable::stringlist({ "a", "b,c", "" }), "string list");
+  expect(json::read_value("[]").as_string_list().empty(), "empty list");
+
+  // Long strings go through the 16 byte scanner, escapes on both sides of a block
+  const std::string long_text(100, 'x');
+  expect(json::read_value("\"" + long_text + "\\t" + long_text + "\"").as_string() == long_text + "\t" + long_text, "long string");
+
+  bool thrown = false;
+  try { json::read_value("{\"a\": 1}"); } catch (const std::invalid_argument&) { thrown = true; }
+  expect(thrown, "object is not a value");
+
+  thrown = false;
+  try { json::read_value("[1, 2]"); } catch (const std::invalid_argument&) { thrown = true; }
+  expect(thrown, "numbers are not a string list");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+errors()
+{
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking malformed JSON" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const char* bad[] = {
+    "", "{", "[1,]", "[1 2]", "01", "-", "1.", "1e", "\"abc", "\"\\ud800\"", "\"\\udc00\"",
+    "\"\\x\"", "\"a\nb\"", "tru", "nul", "1 2", "{\"a\" 1}", "{\"a\": 1,}", "{1: 2}", "[}", "{]" };
+
+  for (const char* text : bad)
+    expect(rejected(text), std::string("rejects ") + text);
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+trees()
+{
+  using egg::variable;
+  using egg::tree;
+  using egg::json;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking JSON trees" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::string text =
+    "{\n"
+    "  \"cmd\": { \"configuration\": \"/etc/phoenix/test.xml\",\n"
+    "           \"log\": { \"level\": 9, \"file\": \"/var/log/test.log\" } },\n"
+    "  \"tags\": [ \"a\", \"b\" ],\n"
+    "  \"mixed\": [ \"a\", 1, { \"deep\": null }, [ 2.5 ] ],\n"
+    "  \"empty\": [],\n"
+    "  \"ratio\": 0.1\n"
+    "}";
+
+  const tree t = json::read_tree(text);
+
+  expect(t["cmd"]["log"]["level"].value() == variable(std::int8_t(9)), "nested value");
+  expect(t["cmd"]["configuration"].value().as_string() == "/etc/phoenix/test.xml", "string value");
+  expect(t["tags"].value().as_string_list() == variable::stringlist({ "a", "b" }), "string list value");
+  expect(t["mixed"].size() == 4, "mixed array children");
+  expect(t["mixed"][std::uint32_t(0)].value() == variable("a"), "strings before a number become children");
+  expect(t["mixed"][std::uint32_t(2)]["deep"].valid(), "object in array");
+  expect(t["mixed"][std::uint32_t(3)][std::uint32_t(0)].value().as_double() == 2.5, "array in array");
+  expect(t["empty"].value().as_string_list().empty(), "empty array");
+  expect(t["ratio"].value().as_double() == 0.1, "double");
+
+  // Written back and read again gives the same document
+  const std::string once = json::to_string(t);
+  const std::string twice = json::to_string(json::read_tree(once));
+
+  cout << once << endl;
+  expect(once == twice, "round trip");
+
+  const tree scalar = json::read_tree("42");
+  expect(scalar.empty() && scalar.root().value() == variable(std::int8_t(42)), "top level scalar");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+writer()
+{
+  using egg::variable;
+  using egg::json;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking JSON writer" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  expect(json::to_string(variable()) == "null", "null");
+  expect(json::to_string(variable(std::numeric_limits<std::int64_t>::min())) == "-9223372036854775808", "int64 min");
+  expect(json::to_string(variable(std::numeric_limits<std::uint64_t>::max())) == "18446744073709551615", "uint64 max");
+  expect(json::to_string(variable(2.0)) == "2.0", "double stays a double");
+  expect(json::to_string(variable(0.1)) == "0.1", "shortest double");
+  expect(json::to_string(variable(0.1f)) == "0.1", "shortest float");
+  expect(json::to_string(variable(std::numeric_limits<double>::quiet_NaN())) == "null", "nan");
+  expect(json::to_string(variable("q\"b\\n\n\x01")) == "\"q\\\"b\\\\n\\n\\u0001\"", "escapes");
+  expect(json::to_string(variable(variable::stringlist { "a", "b" })) == "[\"a\",\"b\"]", "string list");
+
+  const double values[] = { 0.1, 1.0 / 3.0, 1e300, -4.9e-324 };
+  for (const double d : values)
+    expect(json::read_value(json::to_string(variable(d))).as_double() == d, "double round trip");
+
+  // Streaming
+  std::ostringstream out;
+  {
+    json::writer w(out);
+
+    w.begin_object();
+    w.key(variable("list"));
+    w.begin_array();
+    w.value(variable(1));
+    w.value(variable(true));
+    w.begin_object();
+    w.end_object();
+    w.end_array();
+    w.key(variable(7));
+    w.value(variable(std::string(5000, 'z')));
+    w.end_object();
+  }
+
+  expect(out.str() == "{\"list\":[1,true,{}],\"7\":\"" + std::string(5000, 'z') + "\"}", "streaming writer");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Scalars and string lists
+  values();
+
+  // Malformed input
+  errors();
+
+  // Trees
+  trees();
+
+  // Writer
+  writer();
+
+  return 0;
+}
+
+/* End of file */
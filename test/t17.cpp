@@ -0,0 +1,227 @@
+#include <string>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../include/egg/shared_store.hpp"
+#include "expect.hpp"
+
+static std::string
+name(
+  const char* suffix)
+{
+  return "/egg-t17-" + std::to_string(::getpid()) + "-" + suffix;
+}
+
+void
+basics()
+{
+  using egg::variable;
+  using egg::shared_store;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking shared store in one process" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::string n = name("basics");
+
+  shared_store::options geometry;
+  geometry._capacity = 100;
+  geometry._key_bytes = 32;
+  geometry._value_bytes = 64;
+
+  shared_store s = shared_store::create(n, geometry);
+
+  expect(s.capacity() == 128, "capacity is a power of two");
+  expect(s.get("missing").is_empty(), "missing key");
+
+  s.set("name", "phoenix");
+  s.set(42, 2.5);
+  s.set("list", variable::stringlist { "a", "b,c" });
+
+  expect(s.get("name") == variable("phoenix"), "string");
+  expect(s.get(42) == variable(2.5), "non-string key");
+  expect(s.get("list").as_string_list().size() == 2, "string list");
+  expect(s.size() == 3, "size");
+
+  // Zero-copy read of a consistent copy
+  std::string seen;
+  expect(s.read("name", [&seen](const egg::variable_view& v) { seen = v.as_string(); }), "read");
+  expect(seen == "phoenix", "read value");
+
+  s.set("name", "egg");
+  expect(s.get("name") == variable("egg"), "overwrite");
+  expect(s.size() == 3, "overwrite keeps the slot");
+
+  expect(s.add("hits", 5) == 5 && s.add("hits", -2) == 3, "counter");
+  expect(s.erase("hits") && s.get("hits").is_empty(), "erase");
+  expect(s.add("hits", 1) == 1, "counter after erase");
+
+  bool thrown = false;
+  try { s.add("name", 1); } catch (const std::invalid_argument&) { thrown = true; }
+  expect(thrown, "add to a string");
+
+  thrown = false;
+  s.set("top", std::numeric_limits<std::int64_t>::max() - 1);
+  expect(s.add("top", 1) == std::numeric_limits<std::int64_t>::max(), "counter at the limit");
+  try { s.add("top", 1); } catch (const std::overflow_error&) { thrown = true; }
+  expect(thrown && s.get("top") == variable(std::numeric_limits<std::int64_t>::max()), "overflow");
+  expect(s.add("top", -1) == std::numeric_limits<std::int64_t>::max() - 1, "slot unlocked after overflow");
+
+  thrown = false;
+  try { s.set("big", std::string(100, 'x')); } catch (const std::length_error&) { thrown = true; }
+  expect(thrown, "value too large");
+
+  thrown = false;
+  try { s.set(std::string(40, 'k'), 1); } catch (const std::length_error&) { thrown = true; }
+  expect(thrown, "key too large");
+
+  // Another mapping sees the same slots at another address
+  shared_store o = shared_store::open(n);
+  expect(o.get("name") == variable("egg") && o.get(42) == variable(2.5), "second mapping");
+
+  thrown = false;
+  geometry._value_bytes = 128;
+  try { shared_store::create(n, geometry); } catch (const std::runtime_error&) { thrown = true; }
+  expect(thrown, "geometry mismatch");
+
+  // Full
+  shared_store::options tiny;
+  tiny._capacity = 4;
+  shared_store f = shared_store::create(name("full"), tiny);
+
+  for (int i = 0; i < 4; ++i)
+    f.set(i, i);
+
+  thrown = false;
+  try { f.set(4, 4); } catch (const std::length_error&) { thrown = true; }
+  expect(thrown, "full");
+  expect(f.get(3) == variable(3), "full store still reads");
+
+  shared_store::remove(name("full"));
+  expect(shared_store::remove(n) && !shared_store::remove(n), "remove");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+// Writers store "<c> repeated <length>" values, readers check that every
+// value they see is whole
+static int
+worker(
+  const std::string& n,
+  const int          id,
+  const int          rounds)
+{
+  try
+  {
+    egg::shared_store s = egg::shared_store::open(n);
+
+    for (int r = 0; r < rounds; ++r)
+    {
+      const int key = r % 16;
+
+      if (id % 2 == 0)
+      {
+        const char c = static_cast<char>('a' + (id + r) % 26);
+        s.set(key, std::string(1 + (r * 7 + id) % 200, c));
+      }
+      else
+      {
+        bool whole = true;
+
+        s.read(key, [&whole](const egg::variable_view& v) {
+          if (v.type() != egg::variable::content::is_string)
+            return;
+
+          const char* p = v.data();
+          for (std::size_t i = 1; i < v.size(); ++i)
+            whole = whole && p[i] == p[0];
+        });
+
+        if (!whole)
+          return 1;
+      }
+
+      s.add("counter", 1);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
+
+void
+processes()
+{
+  using egg::variable;
+  using egg::shared_store;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking shared store across processes" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::string n = name("stress");
+  const int workers = 6;
+  const int rounds = 20000;
+
+  shared_store::options geometry;
+  geometry._capacity = 64;
+  geometry._value_bytes = 256;
+
+  shared_store s = shared_store::create(n, geometry);
+
+  pid_t children[workers];
+
+  for (int i = 0; i < workers; ++i)
+  {
+    children[i] = ::fork();
+    expect(children[i] >= 0, "fork");
+
+    if (children[i] == 0)
+      ::_exit(worker(n, i, rounds));
+  }
+
+  for (int i = 0; i < workers; ++i)
+  {
+    int status = 0;
+    ::waitpid(children[i], &status, 0);
+
+    expect(WIFEXITED(status) && WEXITSTATUS(status) == 0, "worker " + std::to_string(i));
+  }
+
+  cout << s.get("counter") << " increments" << endl;
+
+  expect(s.get("counter") == variable(std::int64_t(workers) * rounds), "no lost increments");
+  expect(s.size() == 17, "keys");
+
+  shared_store::remove(n);
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // One process
+  basics();
+
+  // Several processes
+  processes();
+
+  return 0;
+}
+
+/* End of file */
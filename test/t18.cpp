@@ -0,0 +1,208 @@
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/usage.hpp"
+#include "expect.hpp"
+
+static bool
+rejects(
+  const egg::usage&               u,
+  const std::vector<const char*>& argv)
+{
+  try
+  {
+    u.parse(argv);
+  }
+  catch (const std::invalid_argument&)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+static const char* _doc =
+  "Naval Fate.\n"
+  "\n"
+  "Usage:\n"
+  "  naval ship new <name>...\n"
+  "  naval ship <name> move <x> <y> [--speed=<kn>]\n"
+  "  naval mine (set | remove) <x> <y> [--moored | --drifting]\n"
+  "  naval [options] -I <dir>... <file>\n"
+  "  naval -h | --help\n"
+  "\n"
+  "Options:\n"
+  "  -h --help       Show this screen.\n"
+  "  --speed=<kn>    Speed in knots [default: 10].\n"
+  "  --moored        Moored (anchored) mine.\n"
+  "  --drifting      Drifting mine.\n"
+  "  -v --verbose    More output.\n"
+  "  -o FILE         Output file [default: a.out].\n"
+  "  -I <dir>        Include directory.\n";
+
+void
+patterns()
+{
+  using egg::variable;
+  using egg::usage;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking commands, arguments and defaults" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const usage u(_doc);
+
+  cout << u.text() << endl;
+
+  {
+    const usage::arguments a = u.parse({ "naval", "ship", "new", "Guardian", "Nautilus" });
+
+    expect(a["ship"] == variable(true) && a["new"] == variable(true), "commands");
+    expect(a["move"] == variable(false), "command not given");
+    expect(a["<name>"].type() == variable::content::is_string_list, "repeated argument");
+    expect(a["<name>"].as_string_list() == variable::stringlist({ "Guardian", "Nautilus" }), "argument order");
+  }
+
+  {
+    const usage::arguments a = u.parse({ "naval", "ship", "Guardian", "move", "10", "-2.5", "--speed=15" });
+
+    expect(a["<name>"].as_string_list() == variable::stringlist({ "Guardian" }), "single value of a repeated argument");
+    expect(a["<x>"] == variable(std::int64_t(10)), "typed integer");
+    expect(a["<y>"] == variable(-2.5), "typed real");
+    expect(a["--speed"] == variable(std::int64_t(15)), "option value");
+    expect(a["--moored"] == variable(false), "flag not given");
+  }
+
+  {
+    const usage::arguments a = u.parse({ "naval", "ship", "Guardian", "move", "1", "2" });
+
+    expect(a["--speed"] == variable(std::int64_t(10)), "typed default");
+    expect(a["-o"] == variable("a.out"), "string default");
+  }
+
+  {
+    const usage::arguments a = u.parse({ "naval", "mine", "remove", "3", "4", "--drifting" });
+
+    expect(a["remove"] == variable(true) && a["set"] == variable(false), "alternative commands");
+    expect(a["--drifting"] == variable(true), "flag");
+    expect(rejects(u, { "naval", "mine", "set", "3", "4", "--moored", "--drifting" }), "exclusive flags");
+  }
+
+  expect(u.parse({ "naval", "--help" })["--help"] == variable(true), "long flag");
+  expect(u.parse({ "naval", "-h" })["--help"] == variable(true), "short spelling");
+
+  const std::map<variable, variable> m = u.parse({ "naval", "-h" }).to_map();
+
+  expect(m.size() == u.names(), "map of every name");
+  expect(m.at(variable("<file>")).is_empty(), "argument not given");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+options()
+{
+  using egg::variable;
+  using egg::usage;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking option syntax, repetition and raw views" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const usage u(_doc);
+
+  // Clusters, attached and separate arguments, prefixes, "--"
+  const std::vector<const char*> argv { "naval", "-Iinclude", "--verb", "-I", "lib", "-o", "out.bin", "--", "-main.c" };
+  const usage::arguments a = u.parse(argv);
+
+  expect(a["--verbose"] == variable(true), "flag by a unique prefix");
+  expect(a["-I"].as_string_list() == variable::stringlist({ "include", "lib" }), "repeated option");
+  expect(a["-o"] == variable("out.bin"), "option with a separate argument");
+  expect(a["<file>"] == variable("-main.c"), "positional after --");
+
+  const std::vector<const char*> dirs = a.raw("-I");
+
+  expect(dirs.size() == 2, "raw occurrences");
+  expect(dirs[0] == argv[1] + 2, "raw view of an attached argument");
+  expect(dirs[1] == argv[4], "raw view of a separate argument");
+  expect(a.raw("<file>")[0] == argv[8], "raw view of a positional");
+  expect(a.raw("--verbose").empty(), "flags have no text");
+
+  // Counted flags and untyped values
+  const usage v("usage: tool [-v...] <n>", false);
+
+  expect(v.parse({ "tool", "-vvv", "5" })["-v"] == variable(std::int64_t(3)), "counted flag");
+  expect(v.parse({ "tool", "5" })["-v"] == variable(std::int64_t(0)), "counted flag not given");
+  expect(v.parse({ "tool", "5" })["<n>"] == variable("5"), "typing off");
+
+  // Errors
+  expect(rejects(u, { "naval", "--unknown" }), "unknown option");
+  expect(rejects(u, { "naval", "-I" }), "missing argument");
+  expect(rejects(u, { "naval", "--help=yes" }), "argument of a flag");
+  expect(rejects(u, { "naval", "ship" }), "incomplete pattern");
+  expect(rejects(u, { "naval", "-h", "extra" }), "extra argument");
+  expect(rejects(u, { "naval", "-vI", "a", "--verbose", "x" }), "flag given twice");
+  expect(rejects(usage("usage: x --alpha --alps"), { "x", "--al" }), "ambiguous prefix");
+
+  bool thrown = false;
+
+  try
+  {
+    usage("no section here");
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "missing usage section");
+
+  thrown = false;
+
+  try
+  {
+    usage("usage: x (a | b");
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "unbalanced pattern");
+
+  bool unknown = false;
+
+  try
+  {
+    a["--missing"];
+  }
+  catch (const std::out_of_range&)
+  {
+    unknown = true;
+  }
+
+  expect(unknown && a.find("--missing") == nullptr, "unknown name");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Patterns
+  patterns();
+
+  // Options
+  options();
+
+  return 0;
+}
+
+/* End of file */
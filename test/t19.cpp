@@ -0,0 +1,175 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "../include/egg/settings.hpp"
+#include "expect.hpp"
+
+template <typename E, typename F>
+static bool
+throws(
+  F f)
+{
+  try
+  {
+    f();
+  }
+  catch (const E&)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+void
+files()
+{
+  using egg::variable;
+  using egg::settings;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking files, sections and lazy typing" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::string file = "/tmp/egg-t19-" + std::to_string(::getpid()) + ".ini";
+
+  {
+    std::ofstream out(file);
+
+    out << "# daemon settings\n"
+        << "; another comment\n"
+        << "export PREFIX=/opt/daemon\n"
+        << "debug = yes\n"
+        << "\n"
+        << "[server]\r\n"
+        << "  port   = 8080  \r\n"
+        << "name = \"main node\"\n"
+        << "ratio=0.75\n"
+        << "big = 18446744073709551615\n"
+        << "offset = -12\n"
+        << "empty =\n"
+        << "url = http://localhost/?a=b\n"
+        << "[ client ]\n"
+        << "port = 9090";
+  }
+
+  settings s;
+  s.load_file(file);
+
+  expect(s.size() == 10, "entries");
+  expect(s["PREFIX"] == variable("/opt/daemon"), "export is skipped");
+  expect(s["debug"] == variable(true), "bool");
+  expect(s["server.port"] == variable(std::int64_t(8080)), "integer in a section");
+  expect(s["server.name"] == variable("main node"), "quotes are stripped");
+  expect(s["server.ratio"] == variable(0.75), "real");
+  expect(s["server.big"] == variable(std::uint64_t(18446744073709551615ull)), "unsigned");
+  expect(s["server.offset"] == variable(std::int64_t(-12)), "negative");
+  expect(s["server.empty"] == variable(""), "empty value");
+  expect(s["server.url"] == variable("http://localhost/?a=b"), "value with =");
+  expect(s["client.port"] == variable(std::int64_t(9090)), "last line without newline");
+
+  expect(s.raw("server.port").to_string() == "8080", "raw slice");
+  expect(s.raw("missing").data() == nullptr, "raw of a missing key");
+  expect(s.find("port") == nullptr && !s.contains("server"), "missing keys");
+  expect(throws<std::out_of_range>([&s] { s["missing"]; }), "operator[] of a missing key");
+
+  // Typed once, the same variable afterwards
+  expect(s.find("server.port") == s.find("server.port"), "typed on first access");
+
+  // Later sources override
+  s.load_text("[server]\nport = 8081\nextra = 1\n");
+
+  expect(s.size() == 11, "override keeps the size");
+  expect(s["server.port"] == variable(std::int64_t(8081)), "override");
+  expect(s["server.name"] == variable("main node"), "other keys stay");
+
+  const std::map<variable, variable> m = s.to_map();
+
+  expect(m.size() == 11 && m.at(variable("server.extra")) == variable(std::int64_t(1)), "to_map");
+
+  // Quotes force a string
+  egg::settings q;
+  q.load_text("zip = \"01234\"\nname = 'yes'\nratio = \"0.5\"\nbare = 01234\n");
+
+  expect(q["zip"] == variable("01234"), "quoted number");
+  expect(q["name"] == variable("yes"), "quoted bool");
+  expect(q["ratio"] == variable("0.5"), "quoted real");
+  expect(q["bare"] == variable(std::int64_t(1234)), "bare number");
+
+  std::remove(file.c_str());
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+environment()
+{
+  using egg::variable;
+  using egg::settings;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking environment and errors" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const char* env[] = { "HOME=/home/egg", "THREADS=8", "EMPTY=", "NOVALUE", "=broken",
+                        "MULTI=a\nb", "EQ=x=y", nullptr };
+
+  settings s;
+  s.load_environment(env);
+
+  expect(s.size() == 5, "environment entries");
+  expect(s["HOME"] == variable("/home/egg"), "string");
+  expect(s["THREADS"] == variable(std::int64_t(8)), "typed");
+  expect(s["MULTI"] == variable("a\nb"), "new lines in values");
+  expect(s["EQ"] == variable("x=y"), "first = splits");
+
+  // The process environment
+  ::setenv("EGG_T19", "42", 1);
+
+  settings p;
+  p.load_environment();
+
+  expect(p["EGG_T19"] == variable(std::int64_t(42)), "process environment");
+
+  // Malformed text is rejected as a whole
+  settings e;
+  e.load_text("a = 1\n");
+
+  expect(throws<std::invalid_argument>([&e] { e.load_text("b = 2\njust words\n"); }), "line without =");
+  expect(throws<std::invalid_argument>([&e] { e.load_text("= 2\n"); }), "line without a key");
+  expect(throws<std::invalid_argument>([&e] { e.load_text("[open\n"); }), "unclosed section");
+  expect(e.size() == 1 && !e.contains("b"), "nothing of a malformed text");
+  expect(throws<std::runtime_error>([&e] { e.load_file("/nonexistent/egg.ini"); }), "missing file");
+
+  // Moves
+  settings m(std::move(s));
+
+  expect(m.size() == 5 && s.empty(), "move");
+  expect(m.raw("HOME").to_string() == "/home/egg", "slices survive a move");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Files
+  files();
+
+  // Environment
+  environment();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,145 @@
+#include <map>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/diff.hpp"
+#include "../include/egg/variable_hash_map.hpp"
+#include "expect.hpp"
+
+void
+maps()
+{
+  using egg::variable;
+  using egg::diff;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking diff and patch of maps" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  std::map<variable, variable> from, to;
+
+  for (int i = 0; i < 100; ++i)
+    from[variable(i)] = variable("value-" + std::to_string(i));
+
+  to = from;
+  to[variable(5)] = variable("changed");
+  to[variable(7)] = variable(7.5);
+  to[variable("new")] = variable(true);
+  to.erase(variable(9));
+
+  const diff d = diff::compare(from, to);
+
+  for (const diff::change& c : d)
+    cout << static_cast<int>(c._kind) << " " << c._path.to_string() << " = " << c._value << endl;
+
+  expect(d.size() == 4, "changes");
+  expect(d.count(diff::change::kind::added) == 1, "added");
+  expect(d.count(diff::change::kind::removed) == 1, "removed");
+  expect(d.count(diff::change::kind::modified) == 2, "modified");
+  expect(diff::compare(from, from).empty(), "no changes");
+
+  // Patch a replica, any map type
+  std::map<variable, variable> replica = from;
+  d.apply(replica);
+  expect(replica == to, "patched map");
+
+  egg::variable_hash_map<variable> hashed;
+  for (const auto& e : from)
+    hashed[e.first] = e.second;
+
+  d.apply(hashed);
+  expect(hashed.size() == to.size() && hashed.at(variable(5)) == variable("changed") &&
+         hashed.find(variable(9)) == hashed.end(), "patched hash map");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+trees()
+{
+  using egg::variable;
+  using egg::tree;
+  using egg::diff;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking diff and patch of trees" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  tree from;
+
+  for (int s = 0; s < 20; ++s)
+    for (int k = 0; k < 20; ++k)
+      from["section-" + std::to_string(s)]["key-" + std::to_string(k)] = s * 100 + k;
+
+  tree to(from);
+
+  to["section-3"]["key-4"] = "modified";
+  to["section-5"] = "section value";
+  to["section-7"]["key-1"]["deep"] = 1;
+  to["added"]["a"]["b"] = 2;
+  to["section-9"].erase("key-0");
+  to.root().erase("section-11");
+
+  const diff d = diff::compare(from, to);
+
+  for (const diff::change& c : d)
+    cout << static_cast<int>(c._kind) << " " << c._path.to_string() << " = " << c._value << endl;
+
+  expect(d.count(diff::change::kind::modified) == 2, "modified values");
+  expect(d.count(diff::change::kind::added) == 4, "added nodes, parents first");
+  expect(d.count(diff::change::kind::removed) == 2, "removed subtrees");
+  expect(diff::compare(from, tree(from)).empty(), "copy has no changes");
+  expect(diff::compare(from, to, true).size() == d.size(), "verified");
+
+  // Sibling order doesn't matter
+  tree reordered;
+  for (int s = 19; s >= 0; --s)
+    for (int k = 19; k >= 0; --k)
+      reordered["section-" + std::to_string(s)]["key-" + std::to_string(k)] = s * 100 + k;
+
+  expect(diff::compare(from, reordered).empty(), "order of siblings");
+
+  // Patch a replica
+  tree replica(from);
+  d.apply(replica);
+
+  expect(diff::compare(replica, to, true).empty(), "patched tree");
+  expect(replica.size() == to.size(), "patched size");
+
+  // Maps only take one segment paths
+  std::map<variable, variable> m;
+  bool thrown = false;
+
+  try
+  {
+    d.apply(m);
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "tree change on a map");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Maps
+  maps();
+
+  // Trees
+  trees();
+
+  return 0;
+}
+
+/* End of file */
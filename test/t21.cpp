@@ -0,0 +1,162 @@
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "../include/egg/intern.hpp"
+#include "expect.hpp"
+
+void
+values()
+{
+  using egg::variable;
+  using egg::interned;
+  using egg::intern_table;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking canonical values" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  intern_table table(4);
+
+  const interned a = table.intern(variable("/usr/share/daemon/default-profile"));
+  const interned b = table.intern(variable(std::string("/usr/share/daemon/default-profile")));
+  const interned c = table.intern(variable("/usr/share/daemon/other-profile"));
+
+  expect(a == b && a.get() == b.get(), "equal values share the payload");
+  expect(a != c, "different values");
+  expect(*a == variable("/usr/share/daemon/default-profile"), "value");
+  expect(a->as_string() == "/usr/share/daemon/default-profile", "access");
+  expect(a.use_count() == 2 && c.use_count() == 1, "use count");
+  expect(table.size() == 2, "distinct values");
+
+  // Types are kept apart
+  const interned i32 = table.intern(variable(std::int32_t(1)));
+  const interned i64 = table.intern(variable(std::int64_t(1)));
+  expect(i32 != i64, "int32 and int64");
+
+  const variable::stringlist list = { "alpha", "beta", "gamma" };
+  const interned l1 = table.intern(variable(list));
+  variable moved(list);
+  const interned l2 = table.intern(std::move(moved));
+  expect(l1 == l2 && l1->as_string_list().size() == 3, "string lists");
+
+  // Default handle
+  const interned none;
+  expect(!none && none->is_empty() && none.use_count() == 0, "default handle");
+  expect(!table.find(variable("missing")), "find a missing value");
+  expect(table.find(variable(list)) == l1, "find a value");
+
+  std::unordered_set<interned> set = { a, b, c };
+  expect(set.size() == 2, "hashed handles");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+lifetime()
+{
+  using egg::variable;
+  using egg::interned;
+  using egg::intern_table;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking purge, statistics and lifetime" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  interned kept;
+
+  {
+    intern_table table(2);
+
+    std::vector<interned> handles;
+
+    for (int i = 0; i < 1000; ++i)
+      handles.push_back(table.intern(variable("/var/lib/daemon/shared/value-" + std::to_string(i % 10))));
+
+    const intern_table::statistics s = table.stats();
+
+    cout << "requests " << s._requests << ", hits " << s._hits << ", values " << s._values
+         << ", bytes " << s._bytes << ", saved " << s._saved << endl;
+
+    expect(s._requests == 1000 && s._hits == 990 && s._values == 10, "counters");
+    expect(s._handles == 1000, "handles");
+    expect(s._saved > 0, "memory saved");
+
+    kept = handles[3];
+    handles.resize(5);
+
+    expect(table.purge() == 5, "purged values without handles");
+    expect(table.size() == 5, "values left");
+
+    const interned again = table.intern(variable("/var/lib/daemon/shared/value-7"));
+    expect(again.use_count() == 1, "interned again after purge");
+  }
+
+  // The table is gone, the handle keeps its value
+  expect(kept->as_string() == "/var/lib/daemon/shared/value-3", "handle outlives its table");
+  expect(kept.use_count() == 1, "unlisted use count");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+threads()
+{
+  using egg::variable;
+  using egg::interned;
+  using egg::intern_table;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking concurrent interning" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  intern_table table;
+  std::vector<std::vector<interned>> results(4);
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < 4; ++t)
+    workers.emplace_back([&, t] {
+      for (int i = 0; i < 2000; ++i)
+        results[t].push_back(table.intern(variable("key-" + std::to_string(i % 500))));
+    });
+
+  for (std::thread& w : workers)
+    w.join();
+
+  expect(table.size() == 500, "distinct values");
+
+  for (int t = 1; t < 4; ++t)
+    for (int i = 0; i < 2000; ++i)
+      expect(results[t][i] == results[0][i], "same handles in every thread");
+
+  expect(table.stats()._hits == 4 * 2000 - 500, "hits");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Canonical values
+  values();
+
+  // Purge and lifetime
+  lifetime();
+
+  // Threads
+  threads();
+
+  return 0;
+}
+
+/* End of file */
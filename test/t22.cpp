@@ -0,0 +1,147 @@
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable.hpp"
+#include "../include/egg/binary.hpp"
+#include "../include/egg/json.hpp"
+#include "expect.hpp"
+
+void
+arrays()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking numeric arrays and blobs" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::vector<double> samples = { 0.5, 1.25, -3.0, 1e10 };
+  const variable d(samples);
+
+  expect(d.type() == variable::content::is_double_array, "double array type");
+  expect(d.as_double_array().size() == 4 && d.as_double_array()[1] == 1.25, "double view");
+  expect(reinterpret_cast<std::uintptr_t>(d.as_double_array().data()) % 16 == 0, "aligned elements");
+  expect(d.as_double_array().to_vector() == samples, "to_vector");
+  expect(d.to_type_string() == "double array", "type name");
+
+  // Copies are deep, equal and hash the same
+  variable copy(d);
+  expect(copy == d && copy.hash() == d.hash(), "copy");
+  expect(copy.as_double_array().data() != d.as_double_array().data(), "own payload");
+
+  copy = variable(std::vector<double>{ 0.5, 1.25, -3.0, 2.0 });
+  expect(copy != d, "different element");
+
+  // Zeros of either sign compare and hash equal, as the scalars do
+  const variable zero(std::vector<double>{ 0.0 }), negative(std::vector<double>{ -0.0 });
+  expect(zero == negative && zero.hash() == negative.hash(), "signed zeros");
+
+  const variable i32(std::vector<std::int32_t>{ 1, -2, 3 });
+  const variable i64(std::vector<std::int64_t>{ 1, -2, 3 });
+  const variable u64(std::vector<std::uint64_t>{ 1, 2, 3 });
+
+  expect(i32 != i64, "types are compared");
+  expect(i32.to_string() == "1,-2,3", "int32 to_string");
+  expect(u64.as_uint64_array()[2] == 3, "uint64 view");
+  expect(variable::array(i64.as_int64_array().data(), 3) == i64, "from raw memory");
+
+  const variable empty(std::vector<std::int64_t>{});
+  expect(empty.as_int64_array().empty() && empty.to_string().empty(), "empty array");
+
+  const unsigned char bytes[] = { 0x00, 0x7f, 0xff, 0x10 };
+  const variable blob = variable::blob(bytes, sizeof(bytes));
+  expect(blob.type() == variable::content::is_blob && blob.as_blob().size() == 4, "blob");
+  expect(blob.to_string() == "007fff10", "blob to_string");
+
+  bool thrown = false;
+
+  try
+  {
+    d.as_int64_array();
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "strict accessors");
+
+  // Move leaves the source empty
+  variable moved(std::move(copy));
+  expect(copy.is_empty() && moved.as_double_array().size() == 4, "move");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+encodings()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking binary and JSON of arrays" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const unsigned char raw[] = { 1, 2, 3 };
+  const std::vector<variable> values = {
+    variable(std::vector<std::int32_t>{ -1, 0, 2147483647 }),
+    variable(std::vector<std::int64_t>{ -9000000000, 5 }),
+    variable(std::vector<std::uint64_t>{ 18446744073709551615ull }),
+    variable(std::vector<double>{ 3.5, -0.25 }),
+    variable::blob(raw, sizeof(raw)),
+    variable(std::vector<double>{})
+  };
+
+  for (const variable& v : values)
+  {
+    std::vector<std::uint8_t> buffer;
+    const std::size_t n = egg::encode(v, buffer);
+
+    expect(n == egg::encoded_size(v), "encoded size");
+
+    variable back;
+    expect(egg::decode(buffer.data(), n, back) == n && back == v, "binary round trip");
+    expect(egg::decode(buffer.data(), n - 1, back) == 0, "truncated");
+
+    egg::variable_view view;
+    egg::decode(buffer.data(), n, view);
+
+    if (v.type() == variable::content::is_blob)
+      expect(view.size() == 3 && view.data()[2] == 3, "blob view");
+    else
+      expect(view.materialize() == v, "array view");
+  }
+
+  egg::variable_view view;
+  std::vector<std::uint8_t> buffer;
+  egg::encode(values[1], buffer);
+  egg::decode(buffer.data(), buffer.size(), view);
+  expect(view.count() == 2, "array view count");
+
+  expect(egg::json::to_string(values[0]) == "[-1,0,2147483647]", "int32 JSON");
+  expect(egg::json::to_string(values[3]) == "[3.5,-0.25]", "double JSON");
+  expect(egg::json::to_string(values[4]) == "\"010203\"", "blob JSON");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Arrays
+  arrays();
+
+  // Encodings
+  encodings();
+
+  return 0;
+}
+
+/* End of file */
@@ -0,0 +1,173 @@
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable.hpp"
+#include "../include/egg/binary.hpp"
+#include "../include/egg/json.hpp"
+#include "expect.hpp"
+
+void
+lists()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking nested lists" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable l(variable::list{ 1, "two", 3.5, variable::list{ true, variable() } });
+
+  cout << l << endl;
+
+  expect(l.type() == variable::content::is_list, "list type");
+  expect(l.as_list().size() == 4 && l.as_list()[1] == variable("two"), "elements");
+  expect(l.as_list()[3].as_list()[0].as_bool(), "nested list");
+  expect(l.to_string() == "[1,two,3.500000,[true,<empty>]]", "to_string");
+  expect(variable(variable::list{ "", "a" }).to_string() == "[,a]", "empty first element");
+  expect(variable(variable::list{ variable::list{}, "" }).to_string() == "[[],]", "empty last element");
+
+  variable copy(l);
+  expect(copy == l && copy.hash() == l.hash(), "copy");
+  expect(&copy.as_list()[0] != &l.as_list()[0], "deep copy");
+
+  const variable other(variable::list{ 1, "two", 3.5, variable::list{ false, variable() } });
+  expect(other != l, "nested difference");
+
+  const variable reversed(variable::list{ variable::list{ true, variable() }, 3.5, "two", 1 });
+  expect(reversed != l, "order matters");
+
+  variable moved(std::move(copy));
+  expect(copy.is_empty() && moved == l, "move");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+maps()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking nested maps" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable::map server = {
+    { "host", "localhost" },
+    { "port", 8080 },
+    { "tags", variable::list{ "a", "b" } }
+  };
+
+  server["port"] = 8081;
+  server.insert_or_assign("secure", true);
+
+  const variable config(variable::map{ { "server", server }, { "workers", 4 } });
+
+  expect(config.type() == variable::content::is_map, "map type");
+  expect(config.as_map().size() == 2, "size");
+  expect(config.as_map().at("server").as_map().at("port") == variable(8081), "nested lookup");
+  expect(config.as_map().find("missing") == nullptr, "missing key");
+  expect(!config.as_map().contains(4), "typed keys");
+
+  // Insertion order doesn't matter
+  const variable same(variable::map{ { "workers", 4 }, { "server", server } });
+  expect(same == config && same.hash() == config.hash(), "order of keys");
+
+  // Later duplicates win
+  const variable::map duplicates = { { "k", 1 }, { "k", 2 } };
+  expect(duplicates.size() == 1 && duplicates.at("k") == variable(2), "duplicate keys");
+
+  variable::map edited(server);
+  expect(edited.erase("tags") == 1 && edited.erase("tags") == 0, "erase");
+  expect(variable(edited) != variable(server), "erased value differs");
+
+  bool thrown = false;
+
+  try
+  {
+    config.as_map().at("missing");
+  }
+  catch (const std::out_of_range&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "at() of a missing key");
+
+  // Many keys, all found
+  std::vector<variable::map::value_type> entries;
+  for (int i = 0; i < 1000; ++i)
+    entries.emplace_back(variable("key-" + std::to_string(i)), variable(i));
+
+  const variable::map large(entries);
+  for (int i = 0; i < 1000; ++i)
+    expect(large.at(variable("key-" + std::to_string(i))) == variable(i), "large map");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+encodings()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking binary and JSON of nested values" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const variable v(variable::map{
+    { "name", "daemon" },
+    { "ports", variable::list{ 80, 443 } },
+    { "limits", variable::map{ { "memory", std::uint64_t(1) << 32 }, { "cpu", 1.5 } } },
+    { "samples", std::vector<double>{ 0.25, 0.5 } } });
+
+  std::vector<std::uint8_t> buffer;
+  const std::size_t n = egg::encode(v, buffer);
+
+  variable back;
+  expect(egg::decode(buffer.data(), n, back) == n && back == v, "binary round trip");
+  expect(egg::decode(buffer.data(), n - 1, back) == 0, "truncated");
+
+  egg::variable_view view;
+  egg::decode(buffer.data(), n, view);
+  expect(view.count() == 4, "view count");
+
+  // Nesting deeper than the decoder follows is rejected
+  variable deep(variable::list{});
+  for (int i = 0; i < 200; ++i)
+    deep = variable(variable::list{ deep });
+
+  buffer.clear();
+  egg::encode(deep, buffer);
+  expect(egg::decode(buffer.data(), buffer.size(), back) == 0, "depth limit");
+
+  const std::string text = egg::json::to_string(variable(variable::list{ 1, variable::map{ { "a", "b" } } }));
+  expect(text == "[1,{\"a\":\"b\"}]", "JSON");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Lists
+  lists();
+
+  // Maps
+  maps();
+
+  // Encodings
+  encodings();
+
+  return 0;
+}
+
+/* End of file */
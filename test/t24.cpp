@@ -0,0 +1,127 @@
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable.hpp"
+#include "../include/egg/binary.hpp"
+#include "../include/egg/json.hpp"
+#include "expect.hpp"
+
+void
+ropes()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking string ropes" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  const std::size_t n = 3 * variable::string_rope::chunk_size + 17;
+
+  variable v;
+  variable::stringlist expected;
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    v.append("host-" + std::to_string(i));
+    expected.push_back("host-" + std::to_string(i));
+  }
+
+  const variable::string_rope& r = v.as_string_rope();
+
+  expect(v.type() == variable::content::is_string_rope, "rope type");
+  expect(r.size() == n && r.chunks() == 4, "size and chunks");
+  expect(r[0] == "host-0" && r[n - 1] == "host-" + std::to_string(n - 1), "index");
+  expect(r.to_string_list() == expected, "entries");
+
+  // Appending updates the hash as building at once does
+  const variable built(variable::string_rope{ expected });
+  expect(built == v && built.hash() == v.hash(), "incremental hash");
+  expect(v.to_string() == variable(expected).to_string(), "to_string");
+
+  std::ostringstream streamed;
+  streamed << v;
+  expect(streamed.str() == v.to_string(), "streamed");
+
+  // Copies share the chunks, appends don't leak into them
+  variable copy(v);
+  copy.append("extra");
+  expect(copy != v && copy.as_string_rope().size() == n + 1, "copy on write");
+  expect(v.as_string_rope().size() == n && v == built, "source unchanged");
+
+  v.append("extra");
+  expect(copy == v && copy.hash() == v.hash(), "same appends");
+
+  // Ropes and string lists are different values
+  expect(variable(expected) != built, "rope is not a list");
+
+  bool thrown = false;
+
+  try
+  {
+    variable("text").append("more");
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "append to a string");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+encodings()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking binary and JSON of ropes" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable v;
+  for (int i = 0; i < 2500; ++i)
+    v.append(std::to_string(i));
+
+  std::vector<std::uint8_t> buffer;
+  const std::size_t n = egg::encode(v, buffer);
+
+  variable back;
+  expect(egg::decode(buffer.data(), n, back) == n && back == v, "binary round trip");
+
+  egg::variable_view view;
+  egg::decode(buffer.data(), n, view);
+
+  std::size_t count = 0;
+  view.each([&count](const char*, std::size_t) { ++count; });
+  expect(view.count() == 2500 && count == 2500, "view");
+
+  variable small;
+  small.append("a");
+  small.append("b");
+  expect(egg::json::to_string(small) == "[\"a\",\"b\"]", "JSON");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Ropes
+  ropes();
+
+  // Encodings
+  encodings();
+
+  return 0;
+}
+
+/* End of file */
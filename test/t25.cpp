@@ -0,0 +1,135 @@
+#include <vector>
+#include <thread>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable.hpp"
+#include "../include/egg/watchable_store.hpp"
+#include "expect.hpp"
+
+void
+membership()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking membership of string lists" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  // Short lists are scanned
+  const variable small(variable::stringlist{ "a", "b", "", "b" });
+
+  expect(small.contains("a") && small.contains(""), "small hits");
+  expect(!small.contains("c") && !small.contains("ab"), "small misses");
+  expect(small.find("b") == 1 && small.find("c") == variable::npos, "small find");
+
+  // Long ones are indexed, below and above the Bloom filter threshold
+  for (const std::size_t n : { std::size_t(100), std::size_t(20000) })
+  {
+    variable::stringlist entries;
+    for (std::size_t i = 0; i < n; ++i)
+      entries.push_back("host-" + std::to_string(i) + ".example.org");
+    entries.push_back("host-7.example.org");
+
+    const variable hosts(entries);
+
+    for (std::size_t i = 0; i < n; ++i)
+      expect(hosts.find("host-" + std::to_string(i) + ".example.org") == i, "indexed find");
+
+    std::size_t found = 0;
+    for (std::size_t i = n; i < 2 * n; ++i)
+      found += hosts.contains("host-" + std::to_string(i) + ".example.org") ? 1 : 0;
+
+    expect(found == 0, "indexed misses");
+    expect(!hosts.contains("host-1.example.or") && !hosts.contains(""), "prefixes");
+    expect(hosts.find("host-7.example.org") == 7, "first duplicate");
+
+    // Copies keep answering, a new value answers for its own entries
+    variable copy(hosts);
+    expect(copy.contains("host-3.example.org"), "copy");
+
+    copy = variable(variable::stringlist{ "x", "y", "z", "1", "2", "3", "4", "5", "6" });
+    expect(!copy.contains("host-3.example.org") && copy.find("6") == 8, "replaced value");
+    expect(hosts.contains("host-3.example.org"), "source kept");
+  }
+
+  bool thrown = false;
+
+  try
+  {
+    variable("text").contains("text");
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+
+  expect(thrown, "contains() of a string");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+concurrency()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking concurrent first queries and updates" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable::stringlist entries;
+  for (int i = 0; i < 5000; ++i)
+    entries.push_back("feature-" + std::to_string(i));
+
+  // Readers race to build the index
+  const variable features(entries);
+  std::vector<std::thread> readers;
+  std::vector<int> hits(4, 0);
+
+  for (int t = 0; t < 4; ++t)
+    readers.emplace_back([&features, &hits, t] {
+      for (int i = 0; i < 5000; ++i)
+        hits[t] += features.contains("feature-" + std::to_string(i)) ? 1 : 0;
+    });
+
+  for (std::thread& r : readers)
+    r.join();
+
+  for (const int h : hits)
+    expect(h == 5000, "racing readers");
+
+  // Values assigned in place drop the index
+  egg::watchable_store store;
+  variable stored;
+
+  store.set("allowed", features);
+  expect(store.get("allowed", stored) && stored.contains("feature-42"), "stored");
+
+  entries[42] = "renamed";
+  store.set("allowed", variable(entries));
+  store.get("allowed", stored);
+  expect(!stored.contains("feature-42") && stored.contains("renamed"), "updated in place");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Membership
+  membership();
+
+  // Concurrency
+  concurrency();
+
+  return 0;
+}
+
+/* End of file */
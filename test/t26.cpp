@@ -0,0 +1,130 @@
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/egg/variable.hpp"
+#include "../include/egg/binary.hpp"
+#include "../include/egg/json.hpp"
+#include "expect.hpp"
+
+void
+compact()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking compact string lists" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable::stringlist paths;
+  for (int i = 0; i < 1000; ++i)
+    paths.push_back("/usr/share/locale/" + std::to_string(i / 10) + "/LC_MESSAGES/" + std::to_string(i) + ".mo");
+
+  // Entries that share nothing, repeat, are empty or longer than 127 bytes
+  paths.push_back("");
+  paths.push_back("");
+  paths.push_back("etc");
+  paths.push_back(std::string(300, 'x'));
+  paths.push_back(std::string(200, 'x') + "y");
+
+  const variable::compact_string_list c(paths);
+  const variable v(c);
+
+  expect(v.type() == variable::content::is_compact_string_list, "type");
+  expect(v.to_type_string() == "compact string list", "type name");
+  expect(c.size() == paths.size(), "size");
+  expect(c.to_string_list() == paths, "entries");
+
+  for (std::size_t i = 0; i < paths.size(); ++i)
+    expect(c[i] == paths[i], "random access");
+
+  std::size_t i = 0;
+  c.each([&paths, &i](const std::string& s) { expect(s == paths[i++], "each"); });
+
+  // Shared prefixes are stored once
+  std::size_t plain = sizeof(variable::stringlist);
+  for (const std::string& s : paths)
+    plain += sizeof(std::string) + (s.size() > 15 ? s.size() + 1 : 0);
+
+  expect(c.bytes() * 3 < plain, "smaller than a stringlist");
+  expect(v.memory_usage() == sizeof(variable) + c.bytes(), "memory usage");
+  expect(variable(paths).memory_usage() > v.memory_usage(), "memory usage of a list");
+
+  // Built at once or entry by entry, the value is the same
+  variable::compact_string_list appended;
+  for (const std::string& s : paths)
+    appended.push_back(s);
+
+  expect(variable(appended) == v && variable(appended).hash() == v.hash(), "appended");
+  expect(variable(paths) != v, "compact is not a list");
+
+  variable::stringlist other(paths);
+  other[500] += "z";
+  expect(variable(variable::compact_string_list(other)) != v, "one entry differs");
+
+  std::ostringstream streamed;
+  streamed << v;
+  expect(streamed.str() == variable(paths).to_string() && v.to_string() == streamed.str(), "text");
+
+  const variable empty(variable::compact_string_list{});
+  expect(empty.as_compact_string_list().empty() && empty.to_string().empty(), "empty");
+
+  variable copy(v);
+  expect(copy == v && copy.as_compact_string_list()[7] == paths[7], "copy");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+void
+encodings()
+{
+  using egg::variable;
+  using std::cout;
+  using std::endl;
+
+  cout << "Checking binary and JSON of compact string lists" << endl;
+  cout << "---------------------------------------------------------" << endl;
+
+  variable::stringlist hosts;
+  for (int i = 0; i < 100; ++i)
+    hosts.push_back("node-" + std::to_string(i) + ".rack-1.example.org");
+
+  const variable v(variable::compact_string_list{ hosts });
+
+  std::vector<std::uint8_t> buffer;
+  const std::size_t n = egg::encode(v, buffer);
+
+  expect(n == egg::encoded_size(v), "encoded size");
+
+  variable back;
+  expect(egg::decode(buffer.data(), n, back) == n && back == v, "binary round trip");
+
+  egg::variable_view view;
+  egg::decode(buffer.data(), n, view);
+  expect(view.count() == 100, "view");
+
+  const variable small(variable::compact_string_list{ variable::stringlist{ "a/b", "a/c" } });
+  expect(egg::json::to_string(small) == "[\"a/b\",\"a/c\"]", "JSON");
+
+  cout  << "---------------------------------------------------------" << endl
+        << "Done." << endl << endl;
+}
+
+int
+main(
+  const int   argc,
+  const char* argv[])
+{
+  // Compact lists
+  compact();
+
+  // Encodings
+  encodings();
+
+  return 0;
+}
+
+/* End of file */